@@ -0,0 +1,433 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow/api.h"
+#include "boost/algorithm/string.hpp"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+#include "basic/stream/byte_stream.h"
+#include "basic/stream/dataframe_stream.h"
+#include "client/client.h"
+#include "io/io/arrow_ipc_io_adaptor.h"
+#include "io/io/local_io_adaptor.h"
+#include "io/io/pipeline.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+// Measures the throughput of the io adaptors, from synthetic CSV and Arrow IPC
+// (binary) inputs, through every stage of loading and exporting, i.e.,
+//
+//  - read: partitioned reads of the lines of the CSV file,
+//  - parse: partitioned reads of the CSV file parsed to tables,
+//  - byte_stream: partitioned lines written to and read from byte streams,
+//  - dataframe_stream: the lines parsed and written to a dataframe stream by
+//    a pipeline, as `parallel_local_dataframe` does,
+//  - write_csv: tables formatted and written to a CSV file,
+//  - read_ipc: partitioned reads of the record batches of the IPC file,
+//  - write_ipc: tables written to an IPC file,
+//
+// and reports the MB/s and rows/s of every stage for every number of threads.
+// The inputs are generated before the measurement, thus they are likely in
+// the page cache.
+
+namespace {
+
+struct Options {
+  int64_t rows = 4 * 1024 * 1024;
+  int64_t batch_rows = 64 * 1024;
+  std::vector<std::string> schema = {"int64", "double", "string"};
+  std::vector<size_t> threads;
+  std::vector<std::string> stages = {
+      "read",      "parse",    "byte_stream", "dataframe_stream",
+      "write_csv", "read_ipc", "write_ipc"};
+  std::string directory = "/tmp";
+};
+
+struct Measurement {
+  int64_t bytes = 0;
+  int64_t rows = 0;
+};
+
+struct Inputs {
+  std::shared_ptr<arrow::Table> table;
+  std::string csv;
+  std::string ipc;
+  int64_t csv_size = 0;
+  int64_t ipc_size = 0;
+};
+
+int64_t FileSize(std::string const& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return 0;
+  }
+  return st.st_size;
+}
+
+void RunThreads(size_t const threads, std::function<void(size_t)> const& fn) {
+  std::vector<std::thread> workers;
+  for (size_t index = 0; index < threads; ++index) {
+    workers.emplace_back(fn, index);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+std::shared_ptr<arrow::RecordBatch> MakeBatch(
+    std::shared_ptr<arrow::Schema> const& schema, int64_t const offset,
+    int64_t const length) {
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int col = 0; col < schema->num_fields(); ++col) {
+    auto type = schema->field(col)->type();
+    std::shared_ptr<arrow::Array> column;
+    if (type->Equals(arrow::int64())) {
+      arrow::Int64Builder builder;
+      for (int64_t idx = offset; idx < offset + length; ++idx) {
+        CHECK_ARROW_ERROR(builder.Append(idx * (col + 1)));
+      }
+      CHECK_ARROW_ERROR(builder.Finish(&column));
+    } else if (type->Equals(arrow::float64())) {
+      arrow::DoubleBuilder builder;
+      for (int64_t idx = offset; idx < offset + length; ++idx) {
+        CHECK_ARROW_ERROR(builder.Append(idx * 0.25 + col));
+      }
+      CHECK_ARROW_ERROR(builder.Finish(&column));
+    } else {
+      arrow::StringBuilder builder;
+      for (int64_t idx = offset; idx < offset + length; ++idx) {
+        // varied lengths, and never empty, which would be read as null
+        CHECK_ARROW_ERROR(builder.Append(
+            "v" + std::to_string(idx * 2654435761ULL % 1000003)));
+      }
+      CHECK_ARROW_ERROR(builder.Finish(&column));
+    }
+    columns.emplace_back(column);
+  }
+  return arrow::RecordBatch::Make(schema, length, columns);
+}
+
+Inputs MakeInputs(Options const& options) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (size_t col = 0; col < options.schema.size(); ++col) {
+    std::string const& type = options.schema[col];
+    std::string name = "f" + std::to_string(col);
+    if (type == "int64") {
+      fields.emplace_back(arrow::field(name, arrow::int64()));
+    } else if (type == "double") {
+      fields.emplace_back(arrow::field(name, arrow::float64()));
+    } else if (type == "string") {
+      fields.emplace_back(arrow::field(name, arrow::utf8()));
+    } else {
+      LOG(FATAL) << "Unsupported column type: " << type;
+    }
+  }
+  auto schema = arrow::schema(fields);
+
+  // the record batches are the units of partial reads of the IPC file
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int64_t offset = 0; offset < options.rows;
+       offset += options.batch_rows) {
+    batches.emplace_back(MakeBatch(
+        schema, offset, std::min(options.batch_rows, options.rows - offset)));
+  }
+
+  Inputs inputs;
+  VINEYARD_CHECK_OK(RecordBatchesToTable(batches, &inputs.table));
+  inputs.csv = options.directory + "/io_adaptor_benchmark.csv";
+  inputs.ipc = options.directory + "/io_adaptor_benchmark.arrow";
+  {
+    LocalIOAdaptor writer(inputs.csv + "#header_row=true");
+    VINEYARD_CHECK_OK(writer.Open("w"));
+    VINEYARD_CHECK_OK(writer.WriteTable(inputs.table));
+    VINEYARD_CHECK_OK(writer.Close());
+  }
+  {
+    ArrowIPCIOAdaptor writer(inputs.ipc);
+    VINEYARD_CHECK_OK(writer.Open("w"));
+    VINEYARD_CHECK_OK(writer.WriteTable(inputs.table));
+    VINEYARD_CHECK_OK(writer.Close());
+  }
+  inputs.csv_size = FileSize(inputs.csv);
+  inputs.ipc_size = FileSize(inputs.ipc);
+  return inputs;
+}
+
+std::shared_ptr<LocalIOAdaptor> OpenCSV(std::string const& path,
+                                        size_t const index,
+                                        size_t const total_parts) {
+  auto adaptor = std::make_shared<LocalIOAdaptor>(path + "#header_row=true");
+  VINEYARD_CHECK_OK(adaptor->SetPartialRead(index, total_parts));
+  VINEYARD_CHECK_OK(adaptor->Open());
+  return adaptor;
+}
+
+Measurement BenchRead(Inputs const& inputs, size_t const threads) {
+  std::atomic<int64_t> bytes(0), rows(0);
+  RunThreads(threads, [&](size_t index) {
+    AdaptorLineSource source(OpenCSV(inputs.csv, index, threads));
+    PipelineChunk chunk;
+    while (source.Next(chunk).ok()) {
+      auto data = reinterpret_cast<const char*>(chunk.buffer->data());
+      bytes += chunk.buffer->size();
+      rows += std::count(data, data + chunk.buffer->size(), '\n');
+    }
+  });
+  return Measurement{bytes.load(), rows.load()};
+}
+
+Measurement BenchParse(Inputs const& inputs, size_t const threads) {
+  std::atomic<int64_t> rows(0);
+  RunThreads(threads, [&](size_t index) {
+    auto adaptor = OpenCSV(inputs.csv, index, threads);
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(adaptor->ReadPartialTable(&table, index));
+    if (table != nullptr) {
+      rows += table->num_rows();
+    }
+    VINEYARD_CHECK_OK(adaptor->Close());
+  });
+  return Measurement{inputs.csv_size, rows.load()};
+}
+
+Measurement BenchByteStream(std::string const& ipc_socket,
+                            Inputs const& inputs, size_t const threads) {
+  std::atomic<int64_t> bytes(0), rows(0);
+  RunThreads(threads, [&](size_t index) {
+    Client client;
+    VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+    ByteStreamBuilder builder(client);
+    builder.SetParams(std::unordered_map<std::string, std::string>{});
+    auto stream = std::dynamic_pointer_cast<ByteStream>(builder.Seal(client));
+    ObjectID stream_id = stream->id();
+
+    std::thread recv_thrd([&]() {
+      Client reader_client;
+      VINEYARD_CHECK_OK(reader_client.Connect(ipc_socket));
+      auto reader = reader_client.GetObject<ByteStream>(stream_id)
+                        ->OpenReader(reader_client);
+      std::shared_ptr<arrow::Buffer> buffer;
+      while (reader->GetNext(buffer).ok()) {
+        auto data = reinterpret_cast<const char*>(buffer->data());
+        bytes += buffer->size();
+        rows += std::count(data, data + buffer->size(), '\n');
+      }
+    });
+
+    auto writer = stream->OpenWriter(client);
+    writer->SetBufferSizeLimit(2 * 1024 * 1024);
+    AdaptorLineSource source(OpenCSV(inputs.csv, index, threads));
+    PipelineChunk chunk;
+    while (source.Next(chunk).ok()) {
+      VINEYARD_CHECK_OK(writer->WriteBytes(
+          reinterpret_cast<const char*>(chunk.buffer->data()),
+          chunk.buffer->size()));
+    }
+    VINEYARD_CHECK_OK(writer->Finish());
+    recv_thrd.join();
+    VINEYARD_SUPPRESS(client.DelData(stream_id, true, true));
+  });
+  return Measurement{bytes.load(), rows.load()};
+}
+
+Measurement BenchDataframeStream(std::string const& ipc_socket,
+                                 Inputs const& inputs, size_t const threads) {
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  DataframeStreamBuilder builder(client);
+  builder.SetParams(std::unordered_map<std::string, std::string>{
+      {"framing", "schema_once"}});
+  auto stream =
+      std::dynamic_pointer_cast<DataframeStream>(builder.Seal(client));
+  ObjectID stream_id = stream->id();
+
+  int64_t rows = 0;
+  std::thread recv_thrd([&]() {
+    Client reader_client;
+    VINEYARD_CHECK_OK(reader_client.Connect(ipc_socket));
+    auto reader = reader_client.GetObject<DataframeStream>(stream_id)
+                      ->OpenReader(reader_client);
+    std::shared_ptr<arrow::RecordBatch> batch;
+    while (reader->ReadBatch(batch).ok()) {
+      rows += batch->num_rows();
+    }
+  });
+
+  std::vector<std::string> column_names;
+  for (auto const& field : inputs.table->schema()->fields()) {
+    column_names.emplace_back(field->name());
+  }
+  Pipeline pipeline(
+      std::make_shared<AdaptorLineSource>(OpenCSV(inputs.csv, 0, 1)));
+  pipeline.Then(std::make_shared<ParseCSVOperator>(',', column_names))
+      .To(std::make_shared<DataframeStreamSink>(client, stream));
+  VINEYARD_CHECK_OK(pipeline.Run(threads));
+  recv_thrd.join();
+  VINEYARD_SUPPRESS(client.DelData(stream_id, true, true));
+  client.Disconnect();
+  return Measurement{inputs.csv_size, rows};
+}
+
+Measurement BenchWriteCSV(Options const& options, Inputs const& inputs,
+                          size_t const threads) {
+  std::string path = options.directory + "/io_adaptor_benchmark.out.csv";
+  LocalIOAdaptor writer(path + "#header_row=true");
+  VINEYARD_CHECK_OK(
+      writer.Configure("write_concurrency", std::to_string(threads)));
+  VINEYARD_CHECK_OK(writer.Open("w"));
+  VINEYARD_CHECK_OK(writer.WriteTable(inputs.table));
+  VINEYARD_CHECK_OK(writer.Close());
+  return Measurement{FileSize(path), inputs.table->num_rows()};
+}
+
+Measurement BenchReadIPC(Inputs const& inputs, size_t const threads) {
+  std::atomic<int64_t> rows(0);
+  RunThreads(threads, [&](size_t index) {
+    ArrowIPCIOAdaptor reader(inputs.ipc);
+    VINEYARD_CHECK_OK(reader.SetPartialRead(index, threads));
+    VINEYARD_CHECK_OK(reader.Open());
+    VINEYARD_CHECK_OK(
+        reader.ReadTables([&](std::shared_ptr<arrow::Table> const& piece) {
+          rows += piece->num_rows();
+          return Status::OK();
+        }));
+    VINEYARD_CHECK_OK(reader.Close());
+  });
+  return Measurement{inputs.ipc_size, rows.load()};
+}
+
+Measurement BenchWriteIPC(Options const& options, Inputs const& inputs,
+                          size_t const threads) {
+  std::string path = options.directory + "/io_adaptor_benchmark.out.arrow";
+  ArrowIPCIOAdaptor writer(path);
+  VINEYARD_CHECK_OK(writer.Configure("concurrency", std::to_string(threads)));
+  VINEYARD_CHECK_OK(writer.Open("w"));
+  VINEYARD_CHECK_OK(writer.WriteTable(inputs.table));
+  VINEYARD_CHECK_OK(writer.Close());
+  return Measurement{FileSize(path), inputs.table->num_rows()};
+}
+
+Options ParseOptions(int argc, const char** argv) {
+  Options options;
+  for (int index = 2; index < argc; ++index) {
+    std::string arg = argv[index];
+    size_t pos = arg.find('=');
+    if (pos == std::string::npos) {
+      LOG(FATAL) << "Invalid argument: " << arg;
+    }
+    std::string key = arg.substr(0, pos), value = arg.substr(pos + 1);
+    if (key == "rows") {
+      options.rows = std::stoll(value);
+    } else if (key == "batch_rows") {
+      options.batch_rows = std::max<int64_t>(1, std::stoll(value));
+    } else if (key == "schema") {
+      ::boost::split(options.schema, value, ::boost::is_any_of(","));
+    } else if (key == "threads") {
+      std::vector<std::string> threads;
+      ::boost::split(threads, value, ::boost::is_any_of(","));
+      for (auto const& thread : threads) {
+        options.threads.emplace_back(std::max(1, std::stoi(thread)));
+      }
+    } else if (key == "stages") {
+      ::boost::split(options.stages, value, ::boost::is_any_of(","));
+    } else if (key == "dir") {
+      options.directory = value;
+    } else {
+      LOG(FATAL) << "Unknown argument: " << key;
+    }
+  }
+  if (options.threads.empty()) {
+    size_t concurrency = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads < concurrency; threads *= 2) {
+      options.threads.emplace_back(threads);
+    }
+    options.threads.emplace_back(concurrency);
+  }
+  return options;
+}
+
+}  // namespace
+
+int main(int argc, const char** argv) {
+  if (argc < 2) {
+    printf(
+        "usage ./io_adaptor_benchmark <ipc_socket> [rows=4194304] "
+        "[schema=int64,double,string] [threads=1,2,4] [stages=read,parse,...] "
+        "[batch_rows=65536] [dir=/tmp]\n");
+    return 1;
+  }
+  std::string ipc_socket = std::string(argv[1]);
+  Options options = ParseOptions(argc, argv);
+
+  Inputs inputs = MakeInputs(options);
+  printf("rows: %" PRId64 ", csv: %.2f MB, ipc: %.2f MB\n",
+         inputs.table->num_rows(), inputs.csv_size / 1048576.0,
+         inputs.ipc_size / 1048576.0);
+  printf("%-18s %8s %10s %10s %12s %14s\n", "stage", "threads", "seconds",
+         "MB", "MB/s", "rows/s");
+
+  for (auto const& stage : options.stages) {
+    for (size_t threads : options.threads) {
+      auto start = std::chrono::steady_clock::now();
+      Measurement measurement;
+      if (stage == "read") {
+        measurement = BenchRead(inputs, threads);
+      } else if (stage == "parse") {
+        measurement = BenchParse(inputs, threads);
+      } else if (stage == "byte_stream") {
+        measurement = BenchByteStream(ipc_socket, inputs, threads);
+      } else if (stage == "dataframe_stream") {
+        measurement = BenchDataframeStream(ipc_socket, inputs, threads);
+      } else if (stage == "write_csv") {
+        measurement = BenchWriteCSV(options, inputs, threads);
+      } else if (stage == "read_ipc") {
+        measurement = BenchReadIPC(inputs, threads);
+      } else if (stage == "write_ipc") {
+        measurement = BenchWriteIPC(options, inputs, threads);
+      } else {
+        LOG(FATAL) << "Unknown stage: " << stage;
+      }
+      double seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+      double megabytes = measurement.bytes / 1048576.0;
+      printf("%-18s %8zu %10.3f %10.2f %12.2f %14.0f\n", stage.c_str(),
+             threads, seconds, megabytes, megabytes / seconds,
+             measurement.rows / seconds);
+      fflush(stdout);
+      if (measurement.rows != inputs.table->num_rows()) {
+        LOG(WARNING) << stage << " with " << threads << " threads produces "
+                     << measurement.rows << " rows, expects "
+                     << inputs.table->num_rows();
+      }
+    }
+  }
+  return 0;
+}
@@ -59,9 +59,29 @@ class NumericArrayBuilder : public NumericArrayBaseBuilder<T> {
   NumericArrayBuilder(Client& client, std::shared_ptr<ArrayType> array)
       : NumericArrayBaseBuilder<T>(client), array_(array) {}
 
+  /**
+   * @brief Build the array upon an existing blob (e.g., an adopted stream
+   * chunk), whose `blob_offset`-th element is the first value of the array,
+   * rather than copying the values to a new blob. The array must have no nulls.
+   */
+  NumericArrayBuilder(Client& client, std::shared_ptr<ArrayType> array,
+                      std::shared_ptr<Object> blob, int64_t const blob_offset)
+      : NumericArrayBaseBuilder<T>(client),
+        array_(array),
+        blob_(blob),
+        blob_offset_(blob_offset) {}
+
   std::shared_ptr<ArrayType> GetArray() { return array_; }
 
   Status Build(Client& client) override {
+    if (blob_ != nullptr) {
+      this->set_length_(array_->length());
+      this->set_null_count_(0);
+      this->set_offset_(blob_offset_);
+      this->set_buffer_(blob_);
+      this->set_null_bitmap_(Blob::MakeEmpty(client));
+      return Status::OK();
+    }
     std::unique_ptr<BlobWriter> buffer_writer;
     RETURN_ON_ERROR(client.CreateBlob(array_->values()->size(), buffer_writer));
     memcpy(buffer_writer->data(), array_->values()->data(),
@@ -77,6 +97,8 @@ class NumericArrayBuilder : public NumericArrayBaseBuilder<T> {
 
  private:
   std::shared_ptr<ArrayType> array_;
+  std::shared_ptr<Object> blob_;
+  int64_t blob_offset_ = 0;
 };
 
 /**
@@ -297,6 +319,101 @@ inline std::shared_ptr<ObjectBuilder> BuildArray(
   return nullptr;
 }
 
+template <typename T>
+inline int64_t AdoptableOffset(std::shared_ptr<arrow::Array> const& array,
+                               std::shared_ptr<arrow::Buffer> const& chunk) {
+  auto arr =
+      std::dynamic_pointer_cast<typename ConvertToArrowType<T>::ArrayType>(
+          array);
+  if (arr == nullptr || arr->null_count() != 0 || arr->values() == nullptr) {
+    return -1;
+  }
+  const uint8_t* values = arr->values()->data();
+  if (values < chunk->data() ||
+      values + arr->values()->size() > chunk->data() + chunk->size() ||
+      (values - chunk->data()) % sizeof(T) != 0) {
+    return -1;
+  }
+  return (values - chunk->data()) / sizeof(T) + arr->offset();
+}
+
+/**
+ * @brief The element offset of the values of the array in the chunk, if the
+ * array could be built upon the chunk directly, i.e., it is a numeric array
+ * without nulls whose values lie in the chunk and are aligned, otherwise -1.
+ */
+inline int64_t AdoptableOffset(std::shared_ptr<arrow::Array> const& array,
+                               std::shared_ptr<arrow::Buffer> const& chunk) {
+  switch (array->type()->id()) {
+  case arrow::Type::INT8:
+    return AdoptableOffset<int8_t>(array, chunk);
+  case arrow::Type::UINT8:
+    return AdoptableOffset<uint8_t>(array, chunk);
+  case arrow::Type::INT16:
+    return AdoptableOffset<int16_t>(array, chunk);
+  case arrow::Type::UINT16:
+    return AdoptableOffset<uint16_t>(array, chunk);
+  case arrow::Type::INT32:
+    return AdoptableOffset<int32_t>(array, chunk);
+  case arrow::Type::UINT32:
+    return AdoptableOffset<uint32_t>(array, chunk);
+  case arrow::Type::INT64:
+    return AdoptableOffset<int64_t>(array, chunk);
+  case arrow::Type::UINT64:
+    return AdoptableOffset<uint64_t>(array, chunk);
+  case arrow::Type::FLOAT:
+    return AdoptableOffset<float>(array, chunk);
+  case arrow::Type::DOUBLE:
+    return AdoptableOffset<double>(array, chunk);
+  default:
+    return -1;
+  }
+}
+
+template <typename T>
+inline std::shared_ptr<ObjectBuilder> AdoptArray(
+    Client& client, std::shared_ptr<arrow::Array> const& array,
+    std::shared_ptr<Object> const& blob, int64_t const offset) {
+  return std::make_shared<NumericArrayBuilder<T>>(
+      client,
+      std::dynamic_pointer_cast<typename ConvertToArrowType<T>::ArrayType>(
+          array),
+      blob, offset);
+}
+
+/**
+ * @brief Build the array upon the blob that holds its values at the given
+ * element offset, see also `AdoptableOffset`.
+ */
+inline std::shared_ptr<ObjectBuilder> AdoptArray(
+    Client& client, std::shared_ptr<arrow::Array> const& array,
+    std::shared_ptr<Object> const& blob, int64_t const offset) {
+  switch (array->type()->id()) {
+  case arrow::Type::INT8:
+    return AdoptArray<int8_t>(client, array, blob, offset);
+  case arrow::Type::UINT8:
+    return AdoptArray<uint8_t>(client, array, blob, offset);
+  case arrow::Type::INT16:
+    return AdoptArray<int16_t>(client, array, blob, offset);
+  case arrow::Type::UINT16:
+    return AdoptArray<uint16_t>(client, array, blob, offset);
+  case arrow::Type::INT32:
+    return AdoptArray<int32_t>(client, array, blob, offset);
+  case arrow::Type::UINT32:
+    return AdoptArray<uint32_t>(client, array, blob, offset);
+  case arrow::Type::INT64:
+    return AdoptArray<int64_t>(client, array, blob, offset);
+  case arrow::Type::UINT64:
+    return AdoptArray<uint64_t>(client, array, blob, offset);
+  case arrow::Type::FLOAT:
+    return AdoptArray<float>(client, array, blob, offset);
+  case arrow::Type::DOUBLE:
+    return AdoptArray<double>(client, array, blob, offset);
+  default:
+    return BuildArray(client, array);
+  }
+}
+
 }  // namespace detail
 
 /**
@@ -345,19 +462,43 @@ class RecordBatchBuilder : public RecordBatchBaseBuilder {
   RecordBatchBuilder(Client& client, std::shared_ptr<arrow::RecordBatch> batch)
       : RecordBatchBaseBuilder(client), batch_(batch) {}
 
+  /**
+   * @brief Build the batch whose buffers lie in the `chunk`, where the columns
+   * that qualify `detail::AdoptableOffset` are built upon the `blob` that holds
+   * the chunk, and the others are copied.
+   */
+  RecordBatchBuilder(Client& client, std::shared_ptr<arrow::RecordBatch> batch,
+                     std::shared_ptr<arrow::Buffer> chunk,
+                     std::shared_ptr<Object> blob)
+      : RecordBatchBaseBuilder(client),
+        batch_(batch),
+        chunk_(chunk),
+        blob_(blob) {}
+
   Status Build(Client& client) override {
     this->set_column_num_(batch_->num_columns());
     this->set_row_num_(batch_->num_rows());
     this->set_schema_(
         std::make_shared<SchemaProxyBuilder>(client, batch_->schema()));
     for (int64_t idx = 0; idx < batch_->num_columns(); ++idx) {
-      this->add_columns_(detail::BuildArray(client, batch_->column(idx)));
+      int64_t offset = -1;
+      if (blob_ != nullptr) {
+        offset = detail::AdoptableOffset(batch_->column(idx), chunk_);
+      }
+      if (offset >= 0) {
+        this->add_columns_(
+            detail::AdoptArray(client, batch_->column(idx), blob_, offset));
+      } else {
+        this->add_columns_(detail::BuildArray(client, batch_->column(idx)));
+      }
     }
     return Status::OK();
   }
 
  private:
   std::shared_ptr<arrow::RecordBatch> batch_;
+  std::shared_ptr<arrow::Buffer> chunk_;
+  std::shared_ptr<Object> blob_;
 };
 
 /**
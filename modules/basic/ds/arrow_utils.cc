@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "basic/ds/arrow_utils.h"
 
+#include <cstring>
+
 #include "arrow/io/memory.h"
 #include "arrow/ipc/options.h"
 #include "arrow/ipc/reader.h"
@@ -108,6 +110,76 @@ Status GetRecordBatchStreamSize(const arrow::RecordBatch& batch, size_t* size) {
   return Status::OK();
 }
 
+Status SerializeSchema(const arrow::Schema& schema,
+                       std::shared_ptr<arrow::Buffer>* buffer) {
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(arrow::ipc::SerializeSchema(
+      schema, nullptr, arrow::default_memory_pool(), buffer));
+#elif defined(ARROW_VERSION) && ARROW_VERSION < 2000000
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      *buffer, arrow::ipc::SerializeSchema(schema, nullptr,
+                                           arrow::default_memory_pool()));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      *buffer,
+      arrow::ipc::SerializeSchema(schema, arrow::default_memory_pool()));
+#endif
+  return Status::OK();
+}
+
+Status DeserializeSchema(std::shared_ptr<arrow::Buffer> buffer,
+                         std::shared_ptr<arrow::Schema>* schema) {
+  arrow::io::BufferReader reader(buffer);
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(arrow::ipc::ReadSchema(&reader, nullptr, schema));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(*schema,
+                                   arrow::ipc::ReadSchema(&reader, nullptr));
+#endif
+  return Status::OK();
+}
+
+Status GetRecordBatchMessageSize(const arrow::RecordBatch& batch,
+                                 size_t* size) {
+  // emulates the behavior of Write without actually writing
+  arrow::io::MockOutputStream dst;
+  RETURN_ON_ERROR(WriteRecordBatchMessage(batch, &dst));
+  *size = dst.GetExtentBytesWritten();
+  return Status::OK();
+}
+
+Status WriteRecordBatchMessage(const arrow::RecordBatch& batch,
+                               arrow::io::OutputStream* stream) {
+  int32_t metadata_length = 0;
+  int64_t body_length = 0;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(
+      arrow::ipc::WriteRecordBatch(batch, 0, stream, &metadata_length,
+                                   &body_length, arrow::default_memory_pool()));
+#else
+  RETURN_ON_ARROW_ERROR(arrow::ipc::WriteRecordBatch(
+      batch, 0, stream, &metadata_length, &body_length,
+      arrow::ipc::IpcWriteOptions::Defaults()));
+#endif
+  return Status::OK();
+}
+
+Status ReadRecordBatchMessage(std::shared_ptr<arrow::Schema> const& schema,
+                              std::shared_ptr<arrow::Buffer> buffer,
+                              std::shared_ptr<arrow::RecordBatch>* batch) {
+  arrow::io::BufferReader reader(buffer);
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(
+      arrow::ipc::ReadRecordBatch(schema, nullptr, &reader, batch));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      *batch, arrow::ipc::ReadRecordBatch(
+                  schema, nullptr, arrow::ipc::IpcReadOptions::Defaults(),
+                  &reader));
+#endif
+  return Status::OK();
+}
+
 Status SerializeRecordBatchesToAllocatedBuffer(
     const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
     std::shared_ptr<arrow::Buffer>* buffer) {
@@ -216,6 +288,228 @@ Status DeserializeTable(std::shared_ptr<arrow::Buffer> buffer,
   return Status::OK();
 }
 
+Status GetCompressionCodec(std::string const& name,
+                           std::unique_ptr<arrow::util::Codec>* codec) {
+  arrow::Compression::type type;
+  if (name.empty() || name == "none") {
+    codec->reset();
+    return Status::OK();
+  } else if (name == "lz4") {
+    type = arrow::Compression::LZ4_FRAME;
+  } else if (name == "zstd") {
+    type = arrow::Compression::ZSTD;
+  } else {
+    return Status::Invalid("Unsupported compression codec: " + name);
+  }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(arrow::util::Codec::Create(type, codec));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(*codec, arrow::util::Codec::Create(type));
+#endif
+  return Status::OK();
+}
+
+Status CompressBuffer(arrow::util::Codec* codec, const uint8_t* data,
+                      int64_t const size,
+                      std::shared_ptr<arrow::Buffer>* buffer) {
+  int64_t const header_size = sizeof(int64_t);
+  int64_t max_length = codec->MaxCompressedLen(size, data);
+  std::unique_ptr<arrow::Buffer> compressed;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(arrow::AllocateBuffer(
+      arrow::default_memory_pool(), header_size + max_length, &compressed));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      compressed, arrow::AllocateBuffer(header_size + max_length,
+                                        arrow::default_memory_pool()));
+#endif
+  *reinterpret_cast<int64_t*>(compressed->mutable_data()) = size;
+  int64_t length = 0;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(
+      codec->Compress(size, data, max_length,
+                      compressed->mutable_data() + header_size, &length));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      length, codec->Compress(size, data, max_length,
+                              compressed->mutable_data() + header_size));
+#endif
+  *buffer = arrow::SliceBuffer(std::move(compressed), 0, header_size + length);
+  return Status::OK();
+}
+
+Status DecompressBuffer(arrow::util::Codec* codec, const uint8_t* data,
+                        int64_t const size,
+                        std::unique_ptr<arrow::Buffer>* buffer) {
+  int64_t const header_size = sizeof(int64_t);
+  // far beyond the size of a stream chunk, rejects a corrupt header rather
+  // than trying to allocate it.
+  int64_t const max_length = static_cast<int64_t>(1) << 36;
+  if (size < header_size) {
+    return Status::Invalid("The compressed buffer is truncated");
+  }
+  int64_t length = 0;
+  memcpy(&length, data, header_size);
+  if (length < 0 || length > max_length) {
+    return Status::Invalid(
+        "The compressed buffer is corrupt: invalid decompressed size " +
+        std::to_string(length));
+  }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(
+      arrow::AllocateBuffer(arrow::default_memory_pool(), length, buffer));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      *buffer, arrow::AllocateBuffer(length, arrow::default_memory_pool()));
+#endif
+  int64_t decompressed = 0;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  auto status =
+      codec->Decompress(size - header_size, data + header_size, length,
+                        (*buffer)->mutable_data(), &decompressed);
+#else
+  auto result = codec->Decompress(size - header_size, data + header_size,
+                                  length, (*buffer)->mutable_data());
+  auto status = result.status();
+  if (result.ok()) {
+    decompressed = result.ValueOrDie();
+  }
+#endif
+  if (!status.ok()) {
+    return Status::Invalid("The compressed buffer is corrupt: " +
+                           status.ToString());
+  }
+  if (decompressed != length) {
+    return Status::Invalid("The decompressed size mismatches");
+  }
+  return Status::OK();
+}
+
+namespace detail {
+
+Status AllocateBuffer(int64_t size, std::shared_ptr<arrow::Buffer>* buffer) {
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(
+      arrow::AllocateBuffer(arrow::default_memory_pool(), size, buffer));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      *buffer, arrow::AllocateBuffer(size, arrow::default_memory_pool()));
+#endif
+  return Status::OK();
+}
+
+Status GatherNullBitmap(const arrow::Array& array,
+                        const std::vector<int64_t>& offsets,
+                        std::shared_ptr<arrow::Buffer>* bitmap,
+                        int64_t* null_count) {
+  *null_count = 0;
+  if (array.null_count() == 0) {
+    *bitmap = nullptr;
+    return Status::OK();
+  }
+  int64_t length = static_cast<int64_t>(offsets.size());
+  RETURN_ON_ERROR(AllocateBuffer((length + 7) / 8, bitmap));
+  uint8_t* bits = (*bitmap)->mutable_data();
+  memset(bits, 0, (length + 7) / 8);
+  for (int64_t i = 0; i < length; ++i) {
+    if (array.IsValid(offsets[i])) {
+      bits[i >> 3] |= static_cast<uint8_t>(1u << (i & 7));
+    } else {
+      ++*null_count;
+    }
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status GatherFixedWidth(const std::shared_ptr<arrow::Array>& array,
+                        const std::vector<int64_t>& offsets,
+                        std::shared_ptr<arrow::Array>* out) {
+  int64_t length = static_cast<int64_t>(offsets.size());
+  std::shared_ptr<arrow::Buffer> bitmap, values;
+  int64_t null_count = 0;
+  RETURN_ON_ERROR(GatherNullBitmap(*array, offsets, &bitmap, &null_count));
+  RETURN_ON_ERROR(AllocateBuffer(length * sizeof(T), &values));
+  const T* source = array->data()->GetValues<T>(1);
+  T* target = reinterpret_cast<T*>(values->mutable_data());
+  for (int64_t i = 0; i < length; ++i) {
+    target[i] = source[offsets[i]];
+  }
+  *out = arrow::MakeArray(arrow::ArrayData::Make(
+      array->type(), length, {bitmap, values}, null_count));
+  return Status::OK();
+}
+
+Status GatherBinary(const std::shared_ptr<arrow::Array>& array,
+                    const std::vector<int64_t>& offsets,
+                    std::shared_ptr<arrow::Array>* out) {
+  auto source = std::dynamic_pointer_cast<arrow::BinaryArray>(array);
+  int64_t length = static_cast<int64_t>(offsets.size());
+  std::shared_ptr<arrow::Buffer> bitmap, value_offsets, data;
+  int64_t null_count = 0;
+  RETURN_ON_ERROR(GatherNullBitmap(*array, offsets, &bitmap, &null_count));
+  RETURN_ON_ERROR(
+      AllocateBuffer((length + 1) * sizeof(int32_t), &value_offsets));
+  int32_t* target_offsets =
+      reinterpret_cast<int32_t*>(value_offsets->mutable_data());
+  target_offsets[0] = 0;
+  for (int64_t i = 0; i < length; ++i) {
+    target_offsets[i + 1] =
+        target_offsets[i] + source->value_length(offsets[i]);
+  }
+  RETURN_ON_ERROR(AllocateBuffer(target_offsets[length], &data));
+  uint8_t* target = data->mutable_data();
+  for (int64_t i = 0; i < length; ++i) {
+    int32_t value_length = 0;
+    const uint8_t* value = source->GetValue(offsets[i], &value_length);
+    memcpy(target + target_offsets[i], value, value_length);
+  }
+  *out = arrow::MakeArray(arrow::ArrayData::Make(
+      array->type(), length, {bitmap, value_offsets, data}, null_count));
+  return Status::OK();
+}
+
+Status GatherArray(const std::shared_ptr<arrow::Array>& array,
+                   const std::vector<int64_t>& offsets,
+                   std::shared_ptr<arrow::Array>* out) {
+  auto type = array->type();
+  if (type == arrow::uint64()) {
+    return GatherFixedWidth<uint64_t>(array, offsets, out);
+  } else if (type == arrow::int64()) {
+    return GatherFixedWidth<int64_t>(array, offsets, out);
+  } else if (type == arrow::uint32()) {
+    return GatherFixedWidth<uint32_t>(array, offsets, out);
+  } else if (type == arrow::int32()) {
+    return GatherFixedWidth<int32_t>(array, offsets, out);
+  } else if (type == arrow::float32()) {
+    return GatherFixedWidth<float>(array, offsets, out);
+  } else if (type == arrow::float64()) {
+    return GatherFixedWidth<double>(array, offsets, out);
+  } else if (type == arrow::binary() || type == arrow::utf8()) {
+    return GatherBinary(array, offsets, out);
+  } else if (type == arrow::null()) {
+    *out = std::make_shared<arrow::NullArray>(offsets.size());
+    return Status::OK();
+  } else if (type->id() == arrow::Type::TIMESTAMP) {
+    return GatherFixedWidth<int64_t>(array, offsets, out);
+  }
+  return Status::NotImplemented("Unsupported type: " + type->ToString());
+}
+
+}  // namespace detail
+
+Status GatherRecordBatch(const std::shared_ptr<arrow::RecordBatch>& batch,
+                         const std::vector<int64_t>& offsets,
+                         std::shared_ptr<arrow::RecordBatch>* out) {
+  std::vector<std::shared_ptr<arrow::Array>> columns(batch->num_columns());
+  for (int i = 0; i < batch->num_columns(); ++i) {
+    RETURN_ON_ERROR(
+        detail::GatherArray(batch->column(i), offsets, &columns[i]));
+  }
+  *out = arrow::RecordBatch::Make(batch->schema(), offsets.size(), columns);
+  return Status::OK();
+}
+
 TableAppender::TableAppender(std::shared_ptr<arrow::Schema> schema) {
   for (const auto& field : schema->fields()) {
     std::shared_ptr<arrow::DataType> type = field->type();
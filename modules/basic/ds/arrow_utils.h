@@ -25,8 +25,10 @@ limitations under the License.
 #include "arrow/array/builder_binary.h"
 #include "arrow/array/builder_primitive.h"
 #include "arrow/buffer.h"
+#include "arrow/io/interfaces.h"
 #include "arrow/table.h"
 #include "arrow/table_builder.h"
+#include "arrow/util/compression.h"
 #include "arrow/util/config.h"
 #include "glog/logging.h"
 
@@ -234,6 +236,34 @@ std::shared_ptr<Column> CreateColumn(
  */
 Status GetRecordBatchStreamSize(const arrow::RecordBatch& batch, size_t* size);
 
+/**
+ * Serialize the schema as a standalone IPC schema message.
+ */
+Status SerializeSchema(const arrow::Schema& schema,
+                       std::shared_ptr<arrow::Buffer>* buffer);
+
+Status DeserializeSchema(std::shared_ptr<arrow::Buffer> buffer,
+                         std::shared_ptr<arrow::Schema>* schema);
+
+/**
+ * The size of the IPC message of a single record batch, without the schema.
+ *
+ * Used for pre-allocate buffer for `WriteRecordBatchMessage`.
+ */
+Status GetRecordBatchMessageSize(const arrow::RecordBatch& batch,
+                                 size_t* size);
+
+Status WriteRecordBatchMessage(const arrow::RecordBatch& batch,
+                               arrow::io::OutputStream* stream);
+
+/**
+ * Read a record batch written by `WriteRecordBatchMessage`, the buffers of
+ * the result batch are slices of the given buffer.
+ */
+Status ReadRecordBatchMessage(std::shared_ptr<arrow::Schema> const& schema,
+                              std::shared_ptr<arrow::Buffer> buffer,
+                              std::shared_ptr<arrow::RecordBatch>* batch);
+
 Status SerializeRecordBatchesToAllocatedBuffer(
     const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
     std::shared_ptr<arrow::Buffer>* buffer);
@@ -267,6 +297,38 @@ Status SerializeTable(std::shared_ptr<arrow::Table> table,
 Status DeserializeTable(std::shared_ptr<arrow::Buffer> buffer,
                         std::shared_ptr<arrow::Table>* table);
 
+/**
+ * Resolve the compression codec by name, i.e., "lz4" or "zstd". The `codec`
+ * will be nullptr for an empty name or "none", which means no compression.
+ */
+Status GetCompressionCodec(std::string const& name,
+                           std::unique_ptr<arrow::util::Codec>* codec);
+
+/**
+ * Compress the bytes into a self-contained buffer: the size of the original
+ * bytes as an int64_t, followed by the compressed bytes.
+ */
+Status CompressBuffer(arrow::util::Codec* codec, const uint8_t* data,
+                      int64_t const size,
+                      std::shared_ptr<arrow::Buffer>* buffer);
+
+/**
+ * Decompress the buffer produced by `CompressBuffer`. A truncated or corrupt
+ * buffer, whose header or payload doesn't decompress into exactly the size in
+ * the header, is reported as `Status::Invalid()`.
+ */
+Status DecompressBuffer(arrow::util::Codec* codec, const uint8_t* data,
+                        int64_t const size,
+                        std::unique_ptr<arrow::Buffer>* buffer);
+
+/**
+ * Gather the rows at the given offsets of the batch into a new record batch,
+ * column by column, for the column types supported by `TableAppender`.
+ */
+Status GatherRecordBatch(const std::shared_ptr<arrow::RecordBatch>& batch,
+                         const std::vector<int64_t>& offsets,
+                         std::shared_ptr<arrow::RecordBatch>* out);
+
 struct EmptyTableBuilder {
   static Status Build(const std::shared_ptr<arrow::Schema>& schema,
                       std::shared_ptr<arrow::Table>& table) {
@@ -17,6 +17,8 @@ limitations under the License.
 #define MODULES_BASIC_STREAM_DATAFRAME_STREAM_H_
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "basic/stream/dataframe_stream.vineyard.h"
@@ -33,6 +35,17 @@ class DataframeStreamBuilder : public DataframeStreamBaseBuilder {
   explicit DataframeStreamBuilder(Client& client)
       : DataframeStreamBaseBuilder(client) {}
 
+  void SetParams(
+      const std::unordered_multimap<std::string, std::string>& params) {
+    for (auto const& kv : params) {
+      this->params_.emplace(kv.first, kv.second);
+    }
+  }
+
+  void SetParams(const std::unordered_map<std::string, std::string>& params) {
+    this->params_ = params;
+  }
+
   std::shared_ptr<Object> Seal(Client& client) {
     auto bstream = DataframeStreamBaseBuilder::Seal(client);
     VINEYARD_CHECK_OK(client.CreateStream(bstream->id()));
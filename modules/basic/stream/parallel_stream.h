@@ -16,16 +16,242 @@ limitations under the License.
 #ifndef MODULES_BASIC_STREAM_PARALLEL_STREAM_H_
 #define MODULES_BASIC_STREAM_PARALLEL_STREAM_H_
 
+#include <condition_variable>
+#include <deque>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "arrow/api.h"
+
 #include "client/client.h"
 
 namespace vineyard {
 
 class ParallelStreamBaseBuilder;
 
+template <typename T>
+class ParallelStreamBuilder;
+
+namespace detail {
+
+template <typename R>
+Status ReadStreamItem(R& reader, std::shared_ptr<arrow::Buffer>& chunk) {
+  return reader.GetNext(chunk);
+}
+
+template <typename R>
+Status ReadStreamItem(R& reader, std::shared_ptr<arrow::RecordBatch>& batch) {
+  return reader.ReadBatch(batch);
+}
+
+}  // namespace detail
+
+/**
+ * @brief ParallelStreamReader consumes the sub-streams of a parallel stream in
+ * the work-stealing manner: every sub-stream is pulled by a background thread
+ * with its own connection, and readers claim the next available item from any
+ * sub-stream, rather than being bound to a fixed one, thus a slow sub-stream
+ * won't hold back the whole pipeline.
+ *
+ * Items of a sub-stream are claimed in order, but may be processed by many
+ * readers concurrently. When `ordered` is set, a sub-stream won't be claimed
+ * again until the reader that holds its last item asks for the next, i.e.,
+ * items of the same sub-stream are processed one after another.
+ *
+ * The items reference the stream chunks retained by the connections of the
+ * ParallelStreamReader, thus the reader must outlive the items. The chunks are
+ * released through a dedicated connection, rather than the ones blocked in
+ * pulling the sub-streams, thus a given up item releases its memory to the
+ * writers right away.
+ */
+template <typename T, typename Item = std::shared_ptr<arrow::Buffer>>
+class ParallelStreamReader {
+ public:
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  /**
+   * @brief An item claimed from the sub-stream `stream_index`, and `sequence`
+   * is its position in the sub-stream.
+   */
+  struct Claim {
+    size_t stream_index = npos;
+    size_t sequence = 0;
+    Item item;
+  };
+
+  ParallelStreamReader(std::string const& ipc_socket,
+                       std::vector<std::shared_ptr<T>> const& streams,
+                       bool const ordered, size_t const capacity = 4)
+      : streams_(streams),
+        ordered_(ordered),
+        capacity_(capacity),
+        queues_(streams.size()),
+        busy_(streams.size(), false),
+        pulling_(streams.size(), false),
+        running_(0),
+        cursor_(0),
+        stopped_(false) {
+    releaser_.reset(new Client());
+    status_ = releaser_->Connect(ipc_socket);
+    std::vector<size_t> connected;
+    for (size_t index = 0; index < streams_.size() && status_.ok(); ++index) {
+      clients_.emplace_back(new Client());
+      auto status = clients_.back()->Connect(ipc_socket);
+      if (status.ok()) {
+        clients_.back()->SetStreamChunkReleaser(releaser_.get());
+        connected.emplace_back(index);
+      } else {
+        status_ = status;
+      }
+    }
+    running_ = connected.size();
+    for (size_t index : connected) {
+      pulling_[index] = true;
+      pullers_.emplace_back(&ParallelStreamReader::pull, this, index);
+    }
+  }
+
+  /**
+   * n.b.: the queued items are released first, and the sub-streams that are
+   * still being pulled are stopped as failed, which wakes up the pending pulls,
+   * thus a reader that gives up early won't hang. The writers of these
+   * sub-streams would see the failure as well.
+   */
+  ~ParallelStreamReader() {
+    std::vector<std::deque<std::pair<size_t, Item>>> released;
+    std::vector<size_t> unfinished;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+      for (size_t index = 0; index < queues_.size(); ++index) {
+        released.emplace_back(std::move(queues_[index]));
+        queues_[index].clear();
+        if (pulling_[index]) {
+          unfinished.emplace_back(index);
+        }
+      }
+    }
+    writable_.notify_all();
+    // returns the memory of the queued chunks to the writers.
+    released.clear();
+    for (size_t index : unfinished) {
+      VINEYARD_SUPPRESS(releaser_->StopStream(streams_[index]->id(), true));
+    }
+    for (auto& puller : pullers_) {
+      puller.join();
+    }
+  }
+
+  /**
+   * @brief Claim the next available item from any sub-stream. The claim
+   * passed in, if any, is given up first.
+   *
+   * @return Status::EndOfFile() when all sub-streams have been drained, or the
+   * error of the failed sub-stream.
+   */
+  Status ReadNext(Claim& claim) {
+    // n.b.: the given up item is destructed (i.e., its chunk is released)
+    // outside the lock.
+    Item released = std::move(claim.item);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (claim.stream_index != npos) {
+      busy_[claim.stream_index] = false;
+      claim.stream_index = npos;
+      readable_.notify_all();
+    }
+    size_t index = npos;
+    readable_.wait(lock, [&]() {
+      index = claimable();
+      return index != npos || (running_ == 0 && drained());
+    });
+    if (index == npos) {
+      return status_.ok() ? Status::EndOfFile() : status_;
+    }
+    claim.stream_index = index;
+    claim.sequence = queues_[index].front().first;
+    claim.item = std::move(queues_[index].front().second);
+    queues_[index].pop_front();
+    busy_[index] = ordered_;
+    writable_.notify_all();
+    return Status::OK();
+  }
+
+ private:
+  void pull(size_t const index) {
+    auto reader = streams_[index]->OpenReader(*clients_[index]);
+    size_t sequence = 0;
+    Status status;
+    while (true) {
+      Item item;
+      status = detail::ReadStreamItem(*reader, item);
+      if (!status.ok()) {
+        break;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      writable_.wait(lock, [&]() {
+        return stopped_ || queues_[index].size() < capacity_;
+      });
+      if (stopped_) {
+        break;
+      }
+      queues_[index].emplace_back(sequence++, std::move(item));
+      readable_.notify_all();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!status.ok() && !status.IsEndOfFile() && !status.IsStreamDrained() &&
+        status_.ok()) {
+      status_ = status;
+    }
+    pulling_[index] = false;
+    running_ -= 1;
+    readable_.notify_all();
+  }
+
+  // the next sub-stream to claim from, in round-robin, to avoid starvation.
+  size_t claimable() {
+    for (size_t offset = 0; offset < queues_.size(); ++offset) {
+      size_t index = (cursor_ + offset) % queues_.size();
+      if (!queues_[index].empty() && !busy_[index]) {
+        cursor_ = (index + 1) % queues_.size();
+        return index;
+      }
+    }
+    return npos;
+  }
+
+  bool drained() const {
+    for (auto const& queue : queues_) {
+      if (!queue.empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<std::shared_ptr<T>> streams_;
+  bool ordered_;
+  size_t capacity_;  // the maximum number of pending items per sub-stream.
+
+  // n.b.: the clients must be destructed after the items in queues, and the
+  // releaser after the clients.
+  std::unique_ptr<Client> releaser_;
+  std::vector<std::unique_ptr<Client>> clients_;
+  std::vector<std::thread> pullers_;
+
+  std::mutex mutex_;
+  std::condition_variable readable_, writable_;
+  std::vector<std::deque<std::pair<size_t, Item>>> queues_;
+  std::vector<bool> busy_, pulling_;
+  size_t running_, cursor_;
+  bool stopped_;
+  Status status_;
+};
+
 template <typename T>
 class ParallelStream : public Registered<ParallelStream<T>> {
  public:
@@ -53,12 +279,30 @@ class ParallelStream : public Registered<ParallelStream<T>> {
 
   size_t GetStreamSize() { return size_; }
 
+  /**
+   * @brief Open a work-stealing reader that consumes all the sub-streams, see
+   * also ParallelStreamReader.
+   *
+   * @param client The client connected to the vineyard server, the reader
+   * makes its own connections to the same server.
+   * @param ordered Whether the items of a sub-stream should be processed one
+   * after another.
+   */
+  template <typename Item = std::shared_ptr<arrow::Buffer>>
+  std::unique_ptr<ParallelStreamReader<T, Item>> OpenReader(
+      Client& client, bool const ordered = false) {
+    return std::unique_ptr<ParallelStreamReader<T, Item>>(
+        new ParallelStreamReader<T, Item>(client.IPCSocket(), streams_,
+                                          ordered));
+  }
+
  private:
   size_t size_;
   std::vector<std::shared_ptr<T>> streams_;
 
   friend class Client;
   friend class ParallelStreamBaseBuilder;
+  friend class ParallelStreamBuilder<T>;
 };
 
 /**
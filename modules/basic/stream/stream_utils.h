@@ -0,0 +1,62 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MODULES_BASIC_STREAM_STREAM_UTILS_H_
+#define MODULES_BASIC_STREAM_STREAM_UTILS_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "arrow/util/compression.h"
+
+#include "basic/ds/arrow_utils.h"
+#include "client/ds/object_meta.h"
+
+namespace vineyard {
+
+namespace detail {
+
+/**
+ * Get the value of `key` in the params of the stream, or the `value` when the
+ * key doesn't exist.
+ */
+inline std::string GetStreamParam(ObjectMeta const& meta,
+                                  std::string const& key,
+                                  std::string const& value = "") {
+  if (!meta.Haskey("params_")) {
+    return value;
+  }
+  std::unordered_map<std::string, std::string> params;
+  meta.GetKeyValue("params_", params);
+  auto iter = params.find(key);
+  return iter == params.end() ? value : iter->second;
+}
+
+/**
+ * The chunks of a stream are compressed individually when the "compression"
+ * entry in the stream params is "lz4" or "zstd". The codec will be nullptr for
+ * uncompressed streams.
+ */
+inline Status GetStreamCodec(ObjectMeta const& meta,
+                             std::unique_ptr<arrow::util::Codec>* codec) {
+  return GetCompressionCodec(GetStreamParam(meta, "compression"), codec);
+}
+
+}  // namespace detail
+
+}  // namespace vineyard
+
+#endif  // MODULES_BASIC_STREAM_STREAM_UTILS_H_
@@ -17,10 +17,12 @@ limitations under the License.
 #define MODULES_GRAPH_FRAGMENT_ARROW_FRAGMENT_H_
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -171,6 +173,12 @@ class ArrowFragment
   using nbr_unit_t = property_graph_utils::NbrUnit<vid_t, eid_t>;
   using adj_list_t = property_graph_utils::AdjList<vid_t, eid_t>;
   using raw_adj_list_t = property_graph_utils::RawAdjList<vid_t, eid_t>;
+  using compact_adj_list_t =
+      property_graph_utils::CompactAdjList<vid_t, eid_t>;
+  using narrow_nbr_unit_t =
+      property_graph_utils::NbrUnit<property_graph_types::NARROW_VID_TYPE,
+                                    property_graph_types::NARROW_EID_TYPE>;
+  using narrow_adj_list_t = property_graph_utils::NarrowAdjList<vid_t, eid_t>;
   using vertex_map_t = ArrowVertexMap<internal_oid_t, vid_t>;
   using vertex_t = grape::Vertex<vid_t>;
 
@@ -251,12 +259,17 @@ class ArrowFragment
     this->fid_ = meta.GetKeyValue<fid_t>("fid");
     this->fnum_ = meta.GetKeyValue<fid_t>("fnum");
     this->directed_ = (meta.GetKeyValue<int>("directed") != 0);
+    this->compact_edges_ = meta.Haskey("compact_edges") &&
+                           (meta.GetKeyValue<int>("compact_edges") != 0);
+    this->narrow_edges_ = meta.Haskey("narrow_edges") &&
+                          (meta.GetKeyValue<int>("narrow_edges") != 0);
     this->vertex_label_num_ = meta.GetKeyValue<label_id_t>("vertex_label_num");
     this->edge_label_num_ = meta.GetKeyValue<label_id_t>("edge_label_num");
 
     this->schema_.FromJSONString(meta.GetKeyValue("schema"));
 
     vid_parser_.Init(fnum_, vertex_label_num_);
+    narrow_converter_.Init(fnum_, vertex_label_num_);
 
     this->ivnums_.Construct(meta.GetMemberMeta("ivnums"));
     this->ovnums_.Construct(meta.GetMemberMeta("ovnums"));
@@ -274,12 +287,29 @@ class ArrowFragment
 
     CONSTRUCT_TABLE_VECTOR(edge_tables_, edge_label_num_, "edge_tables");
 
-    if (directed_) {
-      CONSTRUCT_BINARY_ARRAY_VECTOR_VECTOR(ie_lists_, vertex_label_num_,
-                                           edge_label_num_, "ie_lists");
+    if (compact_edges_) {
+      if (directed_) {
+        CONSTRUCT_BINARY_ARRAY_VECTOR_VECTOR(compact_ie_lists_,
+                                             vertex_label_num_, edge_label_num_,
+                                             "compact_ie_lists");
+        CONSTRUCT_ARRAY_VECTOR_VECTOR(int64_t, compact_ie_offsets_lists_,
+                                      vertex_label_num_, edge_label_num_,
+                                      "compact_ie_offsets_lists");
+      }
+      CONSTRUCT_BINARY_ARRAY_VECTOR_VECTOR(compact_oe_lists_,
+                                           vertex_label_num_, edge_label_num_,
+                                           "compact_oe_lists");
+      CONSTRUCT_ARRAY_VECTOR_VECTOR(int64_t, compact_oe_offsets_lists_,
+                                    vertex_label_num_, edge_label_num_,
+                                    "compact_oe_offsets_lists");
+    } else {
+      if (directed_) {
+        CONSTRUCT_BINARY_ARRAY_VECTOR_VECTOR(ie_lists_, vertex_label_num_,
+                                             edge_label_num_, "ie_lists");
+      }
+      CONSTRUCT_BINARY_ARRAY_VECTOR_VECTOR(oe_lists_, vertex_label_num_,
+                                           edge_label_num_, "oe_lists");
     }
-    CONSTRUCT_BINARY_ARRAY_VECTOR_VECTOR(oe_lists_, vertex_label_num_,
-                                         edge_label_num_, "oe_lists");
 
     if (directed_) {
       CONSTRUCT_ARRAY_VECTOR_VECTOR(int64_t, ie_offsets_lists_,
@@ -421,11 +451,19 @@ class ArrowFragment
   }
 
   int GetLocalOutDegree(const vertex_t& v, label_id_t e_label) const {
-    return GetOutgoingAdjList(v, e_label).Size();
+    vid_t vid = v.GetValue();
+    int64_t v_offset = vid_parser_.GetOffset(vid);
+    const int64_t* offset_array =
+        oe_offsets_ptr_lists_[vid_parser_.GetLabelId(vid)][e_label];
+    return offset_array[v_offset + 1] - offset_array[v_offset];
   }
 
   int GetLocalInDegree(const vertex_t& v, label_id_t e_label) const {
-    return GetIncomingAdjList(v, e_label).Size();
+    vid_t vid = v.GetValue();
+    int64_t v_offset = vid_parser_.GetOffset(vid);
+    const int64_t* offset_array =
+        ie_offsets_ptr_lists_[vid_parser_.GetLabelId(vid)][e_label];
+    return offset_array[v_offset + 1] - offset_array[v_offset];
   }
 
   // FIXME: grape message buffer compatibility
@@ -530,6 +568,7 @@ class ArrowFragment
 
   inline adj_list_t GetIncomingAdjList(const vertex_t& v,
                                        label_id_t e_label) const {
+    checkPlainAdjLists();
     vid_t vid = v.GetValue();
     label_id_t v_label = vid_parser_.GetLabelId(vid);
     int64_t v_offset = vid_parser_.GetOffset(vid);
@@ -542,6 +581,7 @@ class ArrowFragment
 
   inline raw_adj_list_t GetIncomingRawAdjList(const vertex_t& v,
                                               label_id_t e_label) const {
+    checkPlainAdjLists();
     vid_t vid = v.GetValue();
     label_id_t v_label = vid_parser_.GetLabelId(vid);
     int64_t v_offset = vid_parser_.GetOffset(vid);
@@ -553,6 +593,7 @@ class ArrowFragment
 
   inline adj_list_t GetOutgoingAdjList(const vertex_t& v,
                                        label_id_t e_label) const {
+    checkPlainAdjLists();
     vid_t vid = v.GetValue();
     label_id_t v_label = vid_parser_.GetLabelId(vid);
     int64_t v_offset = vid_parser_.GetOffset(vid);
@@ -565,6 +606,7 @@ class ArrowFragment
 
   inline raw_adj_list_t GetOutgoingRawAdjList(const vertex_t& v,
                                               label_id_t e_label) const {
+    checkPlainAdjLists();
     vid_t vid = v.GetValue();
     label_id_t v_label = vid_parser_.GetLabelId(vid);
     int64_t v_offset = vid_parser_.GetOffset(vid);
@@ -574,6 +616,70 @@ class ArrowFragment
                           &oe[offset_array[v_offset + 1]]);
   }
 
+  /**
+   * The adjacency lists of a fragment sealed with compact edges, which decode
+   * the neighbors on the fly. Such a fragment doesn't have the plain
+   * adjacency lists above.
+   */
+  inline compact_adj_list_t GetIncomingCompactAdjList(
+      const vertex_t& v, label_id_t e_label) const {
+    vid_t vid = v.GetValue();
+    label_id_t v_label = vid_parser_.GetLabelId(vid);
+    int64_t v_offset = vid_parser_.GetOffset(vid);
+    const int64_t* offset_array =
+        compact_ie_offsets_ptr_lists_[v_label][e_label];
+    const uint8_t* ie = compact_ie_ptr_lists_[v_label][e_label];
+    return compact_adj_list_t(&ie[offset_array[v_offset]],
+                              &ie[offset_array[v_offset + 1]],
+                              GetLocalInDegree(v, e_label),
+                              flatten_edge_tables_columns_[e_label]);
+  }
+
+  inline compact_adj_list_t GetOutgoingCompactAdjList(
+      const vertex_t& v, label_id_t e_label) const {
+    vid_t vid = v.GetValue();
+    label_id_t v_label = vid_parser_.GetLabelId(vid);
+    int64_t v_offset = vid_parser_.GetOffset(vid);
+    const int64_t* offset_array =
+        compact_oe_offsets_ptr_lists_[v_label][e_label];
+    const uint8_t* oe = compact_oe_ptr_lists_[v_label][e_label];
+    return compact_adj_list_t(&oe[offset_array[v_offset]],
+                              &oe[offset_array[v_offset + 1]],
+                              GetLocalOutDegree(v, e_label),
+                              flatten_edge_tables_columns_[e_label]);
+  }
+
+  /**
+   * The adjacency lists of a fragment sealed with narrow edges, see
+   * `property_graph_utils::NarrowIdConverter`. Such a fragment doesn't have
+   * the plain adjacency lists above.
+   */
+  inline narrow_adj_list_t GetIncomingNarrowAdjList(const vertex_t& v,
+                                                    label_id_t e_label) const {
+    vid_t vid = v.GetValue();
+    label_id_t v_label = vid_parser_.GetLabelId(vid);
+    int64_t v_offset = vid_parser_.GetOffset(vid);
+    const int64_t* offset_array = ie_offsets_ptr_lists_[v_label][e_label];
+    const narrow_nbr_unit_t* ie = narrow_ie_ptr_lists_[v_label][e_label];
+    return narrow_adj_list_t(&ie[offset_array[v_offset]],
+                             &ie[offset_array[v_offset + 1]],
+                             &narrow_converter_,
+                             flatten_edge_tables_columns_[e_label]);
+  }
+
+  inline narrow_adj_list_t GetOutgoingNarrowAdjList(const vertex_t& v,
+                                                    label_id_t e_label) const {
+    vid_t vid = v.GetValue();
+    label_id_t v_label = vid_parser_.GetLabelId(vid);
+    int64_t v_offset = vid_parser_.GetOffset(vid);
+    const int64_t* offset_array = oe_offsets_ptr_lists_[v_label][e_label];
+    const narrow_nbr_unit_t* oe = narrow_oe_ptr_lists_[v_label][e_label];
+    return narrow_adj_list_t(&oe[offset_array[v_offset]],
+                             &oe[offset_array[v_offset + 1]],
+                             &narrow_converter_,
+                             flatten_edge_tables_columns_[e_label]);
+  }
+
   inline grape::DestList IEDests(const vertex_t& v, label_id_t e_label) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
     auto v_label = vertex_label(v);
@@ -600,6 +706,10 @@ class ArrowFragment
 
   bool directed() const { return directed_; }
 
+  bool compact_edges() const { return compact_edges_; }
+
+  bool narrow_edges() const { return narrow_edges_; }
+
   std::shared_ptr<vertex_map_t> GetVertexMap() { return vm_ptr_; }
 
   const PropertyGraphSchema& schema() { return schema_; }
@@ -645,6 +755,8 @@ class ArrowFragment
     new_meta.AddKeyValue("fid", fid_);
     new_meta.AddKeyValue("fnum", fnum_);
     new_meta.AddKeyValue("directed", static_cast<int>(directed_));
+    new_meta.AddKeyValue("compact_edges", static_cast<int>(compact_edges_));
+    new_meta.AddKeyValue("narrow_edges", static_cast<int>(narrow_edges_));
     new_meta.AddKeyValue("oid_type", TypeName<oid_t>::Get());
     new_meta.AddKeyValue("vid_type", TypeName<vid_t>::Get());
     new_meta.AddKeyValue("vertex_label_num", vertex_label_num_);
@@ -742,14 +854,29 @@ class ArrowFragment
       }
     }
 
-    if (directed_) {
-      ASSIGNE_IDENTICAL_VEC_VEC_META("ie_lists", vertex_label_num_,
+    if (compact_edges_) {
+      if (directed_) {
+        ASSIGNE_IDENTICAL_VEC_VEC_META("compact_ie_lists", vertex_label_num_,
+                                       edge_label_num_);
+        ASSIGNE_IDENTICAL_VEC_VEC_META("compact_ie_offsets_lists",
+                                       vertex_label_num_, edge_label_num_);
+      }
+      ASSIGNE_IDENTICAL_VEC_VEC_META("compact_oe_lists", vertex_label_num_,
                                      edge_label_num_);
+      ASSIGNE_IDENTICAL_VEC_VEC_META("compact_oe_offsets_lists",
+                                     vertex_label_num_, edge_label_num_);
+    } else {
+      if (directed_) {
+        ASSIGNE_IDENTICAL_VEC_VEC_META("ie_lists", vertex_label_num_,
+                                       edge_label_num_);
+      }
+      ASSIGNE_IDENTICAL_VEC_VEC_META("oe_lists", vertex_label_num_,
+                                     edge_label_num_);
+    }
+    if (directed_) {
       ASSIGNE_IDENTICAL_VEC_VEC_META("ie_offsets_lists", vertex_label_num_,
                                      edge_label_num_);
     }
-    ASSIGNE_IDENTICAL_VEC_VEC_META("oe_lists", vertex_label_num_,
-                                   edge_label_num_);
     ASSIGNE_IDENTICAL_VEC_VEC_META("oe_offsets_lists", vertex_label_num_,
                                    edge_label_num_);
 
@@ -881,6 +1008,17 @@ class ArrowFragment
 #endif
 
  private:
+  // the plain adjacency lists are not sealed with compact or narrow edges,
+  // which must be accessed by the compact or narrow adjacency lists instead
+  inline void checkPlainAdjLists() const {
+    CHECK(!compact_edges_)
+        << "The fragment is sealed with compact edges, use "
+           "GetIncomingCompactAdjList() / GetOutgoingCompactAdjList() instead";
+    CHECK(!narrow_edges_)
+        << "The fragment is sealed with narrow edges, use "
+           "GetIncomingNarrowAdjList() / GetOutgoingNarrowAdjList() instead";
+  }
+
   void initPointers() {
     edge_tables_columns_.resize(edge_label_num_);
     flatten_edge_tables_columns_.resize(edge_label_num_);
@@ -914,6 +1052,9 @@ class ArrowFragment
 
     oe_ptr_lists_.resize(vertex_label_num_);
     oe_offsets_ptr_lists_.resize(vertex_label_num_);
+    compact_oe_ptr_lists_.resize(vertex_label_num_);
+    compact_oe_offsets_ptr_lists_.resize(vertex_label_num_);
+    narrow_oe_ptr_lists_.resize(vertex_label_num_);
 
     idst_.resize(vertex_label_num_);
     odst_.resize(vertex_label_num_);
@@ -929,8 +1070,11 @@ class ArrowFragment
       ovgid_lists_ptr_[i] = ovgid_lists_[i]->raw_values();
       ovg2l_maps_ptr_[i] = ovg2l_maps_[i].get();
 
-      oe_ptr_lists_[i].resize(edge_label_num_);
+      oe_ptr_lists_[i].resize(edge_label_num_, nullptr);
       oe_offsets_ptr_lists_[i].resize(edge_label_num_);
+      compact_oe_ptr_lists_[i].resize(edge_label_num_, nullptr);
+      compact_oe_offsets_ptr_lists_[i].resize(edge_label_num_, nullptr);
+      narrow_oe_ptr_lists_[i].resize(edge_label_num_, nullptr);
 
       idst_[i].resize(edge_label_num_);
       odst_[i].resize(edge_label_num_);
@@ -941,8 +1085,18 @@ class ArrowFragment
       iodoffset_[i].resize(edge_label_num_);
 
       for (label_id_t j = 0; j < edge_label_num_; ++j) {
-        oe_ptr_lists_[i][j] =
-            reinterpret_cast<const nbr_unit_t*>(oe_lists_[i][j]->GetValue(0));
+        if (compact_edges_) {
+          compact_oe_ptr_lists_[i][j] = compact_oe_lists_[i][j]->GetValue(0);
+          compact_oe_offsets_ptr_lists_[i][j] =
+              compact_oe_offsets_lists_[i][j]->raw_values();
+        } else if (narrow_edges_) {
+          narrow_oe_ptr_lists_[i][j] =
+              reinterpret_cast<const narrow_nbr_unit_t*>(
+                  oe_lists_[i][j]->GetValue(0));
+        } else {
+          oe_ptr_lists_[i][j] = reinterpret_cast<const nbr_unit_t*>(
+              oe_lists_[i][j]->GetValue(0));
+        }
         oe_offsets_ptr_lists_[i][j] = oe_offsets_lists_[i][j]->raw_values();
       }
     }
@@ -950,18 +1104,37 @@ class ArrowFragment
     if (directed_) {
       ie_ptr_lists_.resize(vertex_label_num_);
       ie_offsets_ptr_lists_.resize(vertex_label_num_);
+      compact_ie_ptr_lists_.resize(vertex_label_num_);
+      compact_ie_offsets_ptr_lists_.resize(vertex_label_num_);
+      narrow_ie_ptr_lists_.resize(vertex_label_num_);
       for (label_id_t i = 0; i < vertex_label_num_; ++i) {
-        ie_ptr_lists_[i].resize(edge_label_num_);
+        ie_ptr_lists_[i].resize(edge_label_num_, nullptr);
         ie_offsets_ptr_lists_[i].resize(edge_label_num_);
+        compact_ie_ptr_lists_[i].resize(edge_label_num_, nullptr);
+        compact_ie_offsets_ptr_lists_[i].resize(edge_label_num_, nullptr);
+        narrow_ie_ptr_lists_[i].resize(edge_label_num_, nullptr);
         for (label_id_t j = 0; j < edge_label_num_; ++j) {
-          ie_ptr_lists_[i][j] =
-              reinterpret_cast<const nbr_unit_t*>(ie_lists_[i][j]->GetValue(0));
+          if (compact_edges_) {
+            compact_ie_ptr_lists_[i][j] = compact_ie_lists_[i][j]->GetValue(0);
+            compact_ie_offsets_ptr_lists_[i][j] =
+                compact_ie_offsets_lists_[i][j]->raw_values();
+          } else if (narrow_edges_) {
+            narrow_ie_ptr_lists_[i][j] =
+                reinterpret_cast<const narrow_nbr_unit_t*>(
+                    ie_lists_[i][j]->GetValue(0));
+          } else {
+            ie_ptr_lists_[i][j] = reinterpret_cast<const nbr_unit_t*>(
+                ie_lists_[i][j]->GetValue(0));
+          }
           ie_offsets_ptr_lists_[i][j] = ie_offsets_lists_[i][j]->raw_values();
         }
       }
     } else {
       ie_ptr_lists_ = oe_ptr_lists_;
       ie_offsets_ptr_lists_ = oe_offsets_ptr_lists_;
+      compact_ie_ptr_lists_ = compact_oe_ptr_lists_;
+      compact_ie_offsets_ptr_lists_ = compact_oe_offsets_ptr_lists_;
+      narrow_ie_ptr_lists_ = narrow_oe_ptr_lists_;
     }
   }
 
@@ -987,21 +1160,25 @@ class ArrowFragment
         for (vid_t i = 0; i < ivnum_; ++i) {
           dstset.clear();
           if (in_edge) {
-            auto es = GetIncomingAdjList(v, e_label_id);
-            for (auto& e : es) {
-              fid_t f = GetFragId(e.neighbor());
-              if (f != fid_) {
-                dstset.insert(f);
-              }
+            if (compact_edges_) {
+              collectDestFids(GetIncomingCompactAdjList(v, e_label_id),
+                              dstset);
+            } else if (narrow_edges_) {
+              collectDestFids(GetIncomingNarrowAdjList(v, e_label_id),
+                              dstset);
+            } else {
+              collectDestFids(GetIncomingAdjList(v, e_label_id), dstset);
             }
           }
           if (out_edge) {
-            auto es = GetOutgoingAdjList(v, e_label_id);
-            for (auto& e : es) {
-              fid_t f = GetFragId(e.neighbor());
-              if (f != fid_) {
-                dstset.insert(f);
-              }
+            if (compact_edges_) {
+              collectDestFids(GetOutgoingCompactAdjList(v, e_label_id),
+                              dstset);
+            } else if (narrow_edges_) {
+              collectDestFids(GetOutgoingNarrowAdjList(v, e_label_id),
+                              dstset);
+            } else {
+              collectDestFids(GetOutgoingAdjList(v, e_label_id), dstset);
             }
           }
           id_num[i] = dstset.size();
@@ -1020,8 +1197,20 @@ class ArrowFragment
     }
   }
 
+  template <typename ADJ_LIST_T>
+  void collectDestFids(const ADJ_LIST_T& es, std::set<fid_t>& dstset) const {
+    for (auto& e : es) {
+      fid_t f = GetFragId(e.neighbor());
+      if (f != fid_) {
+        dstset.insert(f);
+      }
+    }
+  }
+
   fid_t fid_, fnum_;
   bool directed_;
+  bool compact_edges_;
+  bool narrow_edges_;
   label_id_t vertex_label_num_;
   label_id_t edge_label_num_;
 
@@ -1047,6 +1236,19 @@ class ArrowFragment
       ie_offsets_lists_, oe_offsets_lists_;
   std::vector<std::vector<const int64_t*>> ie_offsets_ptr_lists_,
       oe_offsets_ptr_lists_;
+  // the varint-encoded neighbors and their byte offsets, if compact_edges_
+  std::vector<std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>>>
+      compact_ie_lists_, compact_oe_lists_;
+  std::vector<std::vector<const uint8_t*>> compact_ie_ptr_lists_,
+      compact_oe_ptr_lists_;
+  std::vector<std::vector<std::shared_ptr<arrow::Int64Array>>>
+      compact_ie_offsets_lists_, compact_oe_offsets_lists_;
+  std::vector<std::vector<const int64_t*>> compact_ie_offsets_ptr_lists_,
+      compact_oe_offsets_ptr_lists_;
+  // the ie_lists_ / oe_lists_ of narrow units, if narrow_edges_
+  std::vector<std::vector<const narrow_nbr_unit_t*>> narrow_ie_ptr_lists_,
+      narrow_oe_ptr_lists_;
+  property_graph_utils::NarrowIdConverter<vid_t> narrow_converter_;
 
   std::vector<std::vector<std::vector<fid_t>>> idst_, odst_, iodst_;
   std::vector<std::vector<std::vector<fid_t*>>> idoffset_, odoffset_,
@@ -1082,6 +1284,8 @@ class ArrowFragmentBuilder : public vineyard::ObjectBuilder {
   void set_fid(fid_t fid) { fid_ = fid; }
   void set_fnum(fid_t fnum) { fnum_ = fnum; }
   void set_directed(bool directed) { directed_ = directed; }
+  void set_compact_edges(bool compact_edges) { compact_edges_ = compact_edges; }
+  void set_narrow_edges(bool narrow_edges) { narrow_edges_ = narrow_edges; }
 
   void set_label_num(label_id_t vertex_label_num, label_id_t edge_label_num) {
     vertex_label_num_ = vertex_label_num;
@@ -1096,17 +1300,25 @@ class ArrowFragmentBuilder : public vineyard::ObjectBuilder {
     if (directed_) {
       ie_lists_.resize(vertex_label_num_);
       ie_offsets_lists_.resize(vertex_label_num_);
+      compact_ie_lists_.resize(vertex_label_num_);
+      compact_ie_offsets_lists_.resize(vertex_label_num_);
     }
     oe_lists_.resize(vertex_label_num_);
     oe_offsets_lists_.resize(vertex_label_num_);
+    compact_oe_lists_.resize(vertex_label_num_);
+    compact_oe_offsets_lists_.resize(vertex_label_num_);
 
     for (label_id_t i = 0; i < vertex_label_num_; ++i) {
       if (directed_) {
         ie_lists_[i].resize(edge_label_num_);
         ie_offsets_lists_[i].resize(edge_label_num_);
+        compact_ie_lists_[i].resize(edge_label_num_);
+        compact_ie_offsets_lists_[i].resize(edge_label_num_);
       }
       oe_lists_[i].resize(edge_label_num_);
       oe_offsets_lists_[i].resize(edge_label_num_);
+      compact_oe_lists_[i].resize(edge_label_num_);
+      compact_oe_offsets_lists_[i].resize(edge_label_num_);
     }
   }
 
@@ -1178,6 +1390,38 @@ class ArrowFragmentBuilder : public vineyard::ObjectBuilder {
     oe_offsets_lists_[v_label][e_label] = out_edge_offsets;
   }
 
+  void set_compact_in_edge_list(
+      label_id_t v_label, label_id_t e_label,
+      std::shared_ptr<vineyard::FixedSizeBinaryArray> in_edge_list) {
+    assert(compact_ie_lists_.size() > v_label);
+    assert(compact_ie_lists_[v_label].size() > e_label);
+    compact_ie_lists_[v_label][e_label] = in_edge_list;
+  }
+
+  void set_compact_out_edge_list(
+      label_id_t v_label, label_id_t e_label,
+      std::shared_ptr<vineyard::FixedSizeBinaryArray> out_edge_list) {
+    assert(compact_oe_lists_.size() > v_label);
+    assert(compact_oe_lists_[v_label].size() > e_label);
+    compact_oe_lists_[v_label][e_label] = out_edge_list;
+  }
+
+  void set_compact_in_edge_offsets(
+      label_id_t v_label, label_id_t e_label,
+      std::shared_ptr<vineyard::NumericArray<int64_t>> in_edge_offsets) {
+    assert(compact_ie_offsets_lists_.size() > v_label);
+    assert(compact_ie_offsets_lists_[v_label].size() > e_label);
+    compact_ie_offsets_lists_[v_label][e_label] = in_edge_offsets;
+  }
+
+  void set_compact_out_edge_offsets(
+      label_id_t v_label, label_id_t e_label,
+      std::shared_ptr<vineyard::NumericArray<int64_t>> out_edge_offsets) {
+    assert(compact_oe_offsets_lists_.size() > v_label);
+    assert(compact_oe_offsets_lists_[v_label].size() > e_label);
+    compact_oe_offsets_lists_[v_label][e_label] = out_edge_offsets;
+  }
+
   void set_vertex_map(std::shared_ptr<vertex_map_t> vm_ptr) {
     vm_ptr_ = vm_ptr;
   }
@@ -1240,6 +1484,8 @@ class ArrowFragmentBuilder : public vineyard::ObjectBuilder {
     frag->fid_ = fid_;
     frag->fnum_ = fnum_;
     frag->directed_ = directed_;
+    frag->compact_edges_ = compact_edges_;
+    frag->narrow_edges_ = narrow_edges_;
     frag->vertex_label_num_ = vertex_label_num_;
     frag->edge_label_num_ = edge_label_num_;
 
@@ -1252,12 +1498,25 @@ class ArrowFragmentBuilder : public vineyard::ObjectBuilder {
 
     ASSIGN_TABLE_VECTOR(edge_tables_, frag->edge_tables_);
 
+    if (compact_edges_) {
+      if (directed_) {
+        ASSIGN_ARRAY_VECTOR_VECTOR(compact_ie_lists_, frag->compact_ie_lists_);
+        ASSIGN_ARRAY_VECTOR_VECTOR(compact_ie_offsets_lists_,
+                                   frag->compact_ie_offsets_lists_);
+      }
+      ASSIGN_ARRAY_VECTOR_VECTOR(compact_oe_lists_, frag->compact_oe_lists_);
+      ASSIGN_ARRAY_VECTOR_VECTOR(compact_oe_offsets_lists_,
+                                 frag->compact_oe_offsets_lists_);
+    } else {
+      if (directed_) {
+        ASSIGN_ARRAY_VECTOR_VECTOR(ie_lists_, frag->ie_lists_);
+      }
+      ASSIGN_ARRAY_VECTOR_VECTOR(oe_lists_, frag->oe_lists_);
+    }
+
     if (directed_) {
-      ASSIGN_ARRAY_VECTOR_VECTOR(ie_lists_, frag->ie_lists_);
       ASSIGN_ARRAY_VECTOR_VECTOR(ie_offsets_lists_, frag->ie_offsets_lists_);
     }
-
-    ASSIGN_ARRAY_VECTOR_VECTOR(oe_lists_, frag->oe_lists_);
     ASSIGN_ARRAY_VECTOR_VECTOR(oe_offsets_lists_, frag->oe_offsets_lists_);
 
     frag->meta_.SetTypeName(type_name<ArrowFragment<oid_t, vid_t>>());
@@ -1265,6 +1524,9 @@ class ArrowFragmentBuilder : public vineyard::ObjectBuilder {
     frag->meta_.AddKeyValue("fid", fid_);
     frag->meta_.AddKeyValue("fnum", fnum_);
     frag->meta_.AddKeyValue("directed", static_cast<int>(directed_));
+    frag->meta_.AddKeyValue("compact_edges",
+                            static_cast<int>(compact_edges_));
+    frag->meta_.AddKeyValue("narrow_edges", static_cast<int>(narrow_edges_));
     frag->meta_.AddKeyValue("vertex_label_num", vertex_label_num_);
     frag->meta_.AddKeyValue("oid_type", TypeName<oid_t>::Get());
     frag->meta_.AddKeyValue("vid_type", TypeName<vid_t>::Get());
@@ -1326,14 +1588,31 @@ class ArrowFragmentBuilder : public vineyard::ObjectBuilder {
     GENERATE_VEC_META("ovgid_lists", ovgid_lists_, vertex_label_num_);
     GENERATE_VEC_META("ovg2l_maps", ovg2l_maps_, vertex_label_num_);
     GENERATE_VEC_META("edge_tables", edge_tables_, edge_label_num_);
-    if (directed_) {
-      GENERATE_VEC_VEC_META("ie_lists", ie_lists_, vertex_label_num_,
+    if (compact_edges_) {
+      if (directed_) {
+        GENERATE_VEC_VEC_META("compact_ie_lists", compact_ie_lists_,
+                              vertex_label_num_, edge_label_num_);
+        GENERATE_VEC_VEC_META("compact_ie_offsets_lists",
+                              compact_ie_offsets_lists_, vertex_label_num_,
+                              edge_label_num_);
+      }
+      GENERATE_VEC_VEC_META("compact_oe_lists", compact_oe_lists_,
+                            vertex_label_num_, edge_label_num_);
+      GENERATE_VEC_VEC_META("compact_oe_offsets_lists",
+                            compact_oe_offsets_lists_, vertex_label_num_,
+                            edge_label_num_);
+    } else {
+      if (directed_) {
+        GENERATE_VEC_VEC_META("ie_lists", ie_lists_, vertex_label_num_,
+                              edge_label_num_);
+      }
+      GENERATE_VEC_VEC_META("oe_lists", oe_lists_, vertex_label_num_,
                             edge_label_num_);
+    }
+    if (directed_) {
       GENERATE_VEC_VEC_META("ie_offsets_lists", ie_offsets_lists_,
                             vertex_label_num_, edge_label_num_);
     }
-    GENERATE_VEC_VEC_META("oe_lists", oe_lists_, vertex_label_num_,
-                          edge_label_num_);
     GENERATE_VEC_VEC_META("oe_offsets_lists", oe_offsets_lists_,
                           vertex_label_num_, edge_label_num_);
 
@@ -1358,6 +1637,8 @@ class ArrowFragmentBuilder : public vineyard::ObjectBuilder {
  private:
   fid_t fid_, fnum_;
   bool directed_;
+  bool compact_edges_ = false;
+  bool narrow_edges_ = false;
   label_id_t vertex_label_num_;
   label_id_t edge_label_num_;
 
@@ -1373,6 +1654,10 @@ class ArrowFragmentBuilder : public vineyard::ObjectBuilder {
       ie_lists_, oe_lists_;
   std::vector<std::vector<std::shared_ptr<vineyard::NumericArray<int64_t>>>>
       ie_offsets_lists_, oe_offsets_lists_;
+  std::vector<std::vector<std::shared_ptr<vineyard::FixedSizeBinaryArray>>>
+      compact_ie_lists_, compact_oe_lists_;
+  std::vector<std::vector<std::shared_ptr<vineyard::NumericArray<int64_t>>>>
+      compact_ie_offsets_lists_, compact_oe_offsets_lists_;
 
   std::shared_ptr<vertex_map_t> vm_ptr_;
   PropertyGraphSchema schema_;
@@ -1392,12 +1677,16 @@ class BasicArrowFragmentBuilder : public ArrowFragmentBuilder<OID_T, VID_T> {
  public:
   explicit BasicArrowFragmentBuilder(vineyard::Client& client,
                                      std::shared_ptr<vertex_map_t> vm_ptr)
-      : ArrowFragmentBuilder<oid_t, vid_t>(client), vm_ptr_(vm_ptr) {}
+      : ArrowFragmentBuilder<oid_t, vid_t>(client),
+        concurrency_(std::thread::hardware_concurrency()),
+        vm_ptr_(vm_ptr) {}
 
   vineyard::Status Build(vineyard::Client& client) override {
     this->set_fid(fid_);
     this->set_fnum(fnum_);
     this->set_directed(directed_);
+    this->set_compact_edges(compact_edges_);
+    this->set_narrow_edges(narrow_edges_);
     this->set_label_num(vertex_label_num_, edge_label_num_);
     this->set_property_graph_schema(schema_);
     {
@@ -1440,15 +1729,42 @@ class BasicArrowFragmentBuilder : public ArrowFragmentBuilder<OID_T, VID_T> {
 
     for (label_id_t i = 0; i < vertex_label_num_; ++i) {
       for (label_id_t j = 0; j < edge_label_num_; ++j) {
-        if (directed_) {
-          vineyard::FixedSizeBinaryArrayBuilder ie_builder(client,
-                                                           ie_lists_[i][j]);
-          this->set_in_edge_list(
+        if (compact_edges_) {
+          if (directed_) {
+            vineyard::FixedSizeBinaryArrayBuilder ie_builder(
+                client, compact_ie_lists_[i][j]);
+            this->set_compact_in_edge_list(
+                i, j,
+                std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
+                    ie_builder.Seal(client)));
+            vineyard::NumericArrayBuilder<int64_t> ieo(
+                client, compact_ie_offsets_lists_[i][j]);
+            this->set_compact_in_edge_offsets(
+                i, j,
+                std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
+                    ieo.Seal(client)));
+          }
+          vineyard::FixedSizeBinaryArrayBuilder oe_builder(
+              client, compact_oe_lists_[i][j]);
+          this->set_compact_out_edge_list(
               i, j,
               std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
-                  ie_builder.Seal(client)));
-        }
-        {
+                  oe_builder.Seal(client)));
+          vineyard::NumericArrayBuilder<int64_t> oeo(
+              client, compact_oe_offsets_lists_[i][j]);
+          this->set_compact_out_edge_offsets(
+              i, j,
+              std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
+                  oeo.Seal(client)));
+        } else {
+          if (directed_) {
+            vineyard::FixedSizeBinaryArrayBuilder ie_builder(client,
+                                                             ie_lists_[i][j]);
+            this->set_in_edge_list(
+                i, j,
+                std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
+                    ie_builder.Seal(client)));
+          }
           vineyard::FixedSizeBinaryArrayBuilder oe_builder(client,
                                                            oe_lists_[i][j]);
           this->set_out_edge_list(
@@ -1483,14 +1799,18 @@ class BasicArrowFragmentBuilder : public ArrowFragmentBuilder<OID_T, VID_T> {
       fid_t fid, fid_t fnum,
       std::vector<std::shared_ptr<arrow::Table>>&& vertex_tables,
       std::vector<std::shared_ptr<arrow::Table>>&& edge_tables,
-      bool directed = true) {
+      bool directed = true, bool compact_edges = false,
+      bool narrow_edges = false) {
     fid_ = fid;
     fnum_ = fnum;
     directed_ = directed;
+    compact_edges_ = compact_edges;
+    narrow_edges_ = narrow_edges;
     vertex_label_num_ = vertex_tables.size();
     edge_label_num_ = edge_tables.size();
 
     vid_parser_.Init(fnum_, vertex_label_num_);
+    narrow_converter_.Init(fnum_, vertex_label_num_);
 
     BOOST_LEAF_CHECK(initVertices(std::move(vertex_tables)));
     BOOST_LEAF_CHECK(initEdges(std::move(edge_tables)));
@@ -1683,13 +2003,16 @@ class BasicArrowFragmentBuilder : public ArrowFragmentBuilder<OID_T, VID_T> {
       std::vector<std::shared_ptr<arrow::Int64Array>> sub_oe_offset_lists(
           vertex_label_num_);
       if (directed_) {
-        generate_directed_csr(edge_src_[e_label], edge_dst_[e_label],
-                              sub_oe_lists, sub_oe_offset_lists);
-        generate_directed_csr(edge_dst_[e_label], edge_src_[e_label],
-                              sub_ie_lists, sub_ie_offset_lists);
+        BOOST_LEAF_CHECK(generate_directed_csr(edge_src_[e_label],
+                                               edge_dst_[e_label], sub_oe_lists,
+                                               sub_oe_offset_lists));
+        BOOST_LEAF_CHECK(generate_directed_csr(edge_dst_[e_label],
+                                               edge_src_[e_label], sub_ie_lists,
+                                               sub_ie_offset_lists));
       } else {
-        generate_undirected_csr(edge_src_[e_label], edge_dst_[e_label],
-                                sub_oe_lists, sub_oe_offset_lists);
+        BOOST_LEAF_CHECK(generate_undirected_csr(
+            edge_src_[e_label], edge_dst_[e_label], sub_oe_lists,
+            sub_oe_offset_lists));
       }
 
       for (label_id_t v_label = 0; v_label < vertex_label_num_; ++v_label) {
@@ -1701,164 +2024,126 @@ class BasicArrowFragmentBuilder : public ArrowFragmentBuilder<OID_T, VID_T> {
         oe_offsets_lists_[v_label][e_label] = sub_oe_offset_lists[v_label];
       }
     }
+    if (compact_edges_) {
+      narrow_edges_ = false;
+      BOOST_LEAF_CHECK(compressEdges());
+    } else if (narrow_edges_) {
+      narrow_edges_ = narrowable();
+      if (narrow_edges_) {
+        BOOST_LEAF_CHECK(narrowEdges());
+      }
+    }
     return boost::leaf::result<void>();
   }
 
-  boost::leaf::result<void> generate_directed_csr(
-      std::shared_ptr<vid_array_t> src_list,
-      std::shared_ptr<vid_array_t> dst_list,
-      std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>>& edges,
-      std::vector<std::shared_ptr<arrow::Int64Array>>& edge_offsets) {
-    std::vector<std::vector<int>> degree(vertex_label_num_);
-    std::vector<int64_t> actual_edge_num(vertex_label_num_, 0);
-    for (label_id_t v_label = 0; v_label != vertex_label_num_; ++v_label) {
-      degree[v_label].resize(tvnums_[v_label], 0);
-    }
-    int64_t edge_num = src_list->length();
-    for (int64_t i = 0; i < edge_num; ++i) {
-      vid_t src_id = src_list->Value(i);
-      ++degree[vid_parser_.GetLabelId(src_id)][vid_parser_.GetOffset(src_id)];
-    }
-    std::vector<std::vector<int64_t>> offsets(vertex_label_num_);
-    for (label_id_t v_label = 0; v_label != vertex_label_num_; ++v_label) {
-      auto& offset_vec = offsets[v_label];
-      offset_vec.resize(tvnums_[v_label] + 1);
-      auto& degree_vec = degree[v_label];
-      offset_vec[0] = 0;
-      for (vid_t i = 0; i < tvnums_[v_label]; ++i) {
-        offset_vec[i + 1] = offset_vec[i] + degree_vec[i];
-      }
-      actual_edge_num[v_label] = offset_vec[tvnums_[v_label]];
-      arrow::Int64Builder builder;
-      ARROW_OK_OR_RAISE(builder.AppendValues(offset_vec));
-      ARROW_OK_OR_RAISE(builder.Finish(&edge_offsets[v_label]));
+  // whether the edge ids and the local vertex ids fit in the narrow layout,
+  // and the layout is actually narrower
+  bool narrowable() const {
+    std::vector<int64_t> edge_nums(edge_label_num_);
+    for (label_id_t e_label = 0; e_label < edge_label_num_; ++e_label) {
+      edge_nums[e_label] = edge_tables_[e_label]->num_rows();
     }
+    return property_graph_utils::narrow_fits<vid_t, eid_t>(narrow_converter_,
+                                                           edge_nums, tvnums_);
+  }
 
-    std::vector<vineyard::PodArrayBuilder<nbr_unit_t>> edge_builders(
-        vertex_label_num_);
-    for (label_id_t v_label = 0; v_label != vertex_label_num_; ++v_label) {
-      ARROW_OK_OR_RAISE(
-          edge_builders[v_label].Resize(actual_edge_num[v_label]));
+  // replaces the adjacency lists with the ones of narrow units in place
+  boost::leaf::result<void> narrowEdges() {
+    for (label_id_t v_label = 0; v_label < vertex_label_num_; ++v_label) {
+      for (label_id_t e_label = 0; e_label < edge_label_num_; ++e_label) {
+        if (directed_) {
+          BOOST_LEAF_CHECK(narrow_csr(ie_lists_[v_label][e_label]));
+        }
+        BOOST_LEAF_CHECK(narrow_csr(oe_lists_[v_label][e_label]));
+      }
     }
+    return boost::leaf::result<void>();
+  }
 
-    eid_t cur_eid = 0;
-
-    for (int64_t i = 0; i < edge_num; ++i) {
-      vid_t src_id = src_list->Value(i);
-      label_id_t v_label = vid_parser_.GetLabelId(src_id);
-      int64_t v_offset = vid_parser_.GetOffset(src_id);
-      nbr_unit_t* ptr =
-          edge_builders[v_label].MutablePointer(offsets[v_label][v_offset]);
-      ptr->vid = dst_list->Value(i);
-      ptr->eid = cur_eid;
-      ++cur_eid;
-      ++offsets[v_label][v_offset];
+  // replaces the adjacency lists with the compact ones, the unit offsets are
+  // kept for degrees
+  boost::leaf::result<void> compressEdges() {
+    compact_oe_lists_.resize(vertex_label_num_);
+    compact_oe_offsets_lists_.resize(vertex_label_num_);
+    if (directed_) {
+      compact_ie_lists_.resize(vertex_label_num_);
+      compact_ie_offsets_lists_.resize(vertex_label_num_);
     }
-
-    for (label_id_t v_label = 0; v_label != vertex_label_num_; ++v_label) {
-      auto& builder = edge_builders[v_label];
-      auto tvnum = tvnums_[v_label];
-      auto offsets = edge_offsets[v_label];
-      for (vid_t i = 0; i < tvnum; ++i) {
-        nbr_unit_t* begin = builder.MutablePointer(offsets->Value(i));
-        nbr_unit_t* end = builder.MutablePointer(offsets->Value(i + 1));
-        std::sort(begin, end, [](const nbr_unit_t& lhs, const nbr_unit_t& rhs) {
-          return lhs.vid < rhs.vid;
-        });
+    for (label_id_t v_label = 0; v_label < vertex_label_num_; ++v_label) {
+      compact_oe_lists_[v_label].resize(edge_label_num_);
+      compact_oe_offsets_lists_[v_label].resize(edge_label_num_);
+      if (directed_) {
+        compact_ie_lists_[v_label].resize(edge_label_num_);
+        compact_ie_offsets_lists_[v_label].resize(edge_label_num_);
+      }
+      for (label_id_t e_label = 0; e_label < edge_label_num_; ++e_label) {
+        if (directed_) {
+          BOOST_LEAF_CHECK(compress_csr(
+              ie_lists_[v_label][e_label], ie_offsets_lists_[v_label][e_label],
+              compact_ie_lists_[v_label][e_label],
+              compact_ie_offsets_lists_[v_label][e_label]));
+          ie_lists_[v_label][e_label].reset();
+        }
+        BOOST_LEAF_CHECK(compress_csr(
+            oe_lists_[v_label][e_label], oe_offsets_lists_[v_label][e_label],
+            compact_oe_lists_[v_label][e_label],
+            compact_oe_offsets_lists_[v_label][e_label]));
+        oe_lists_[v_label][e_label].reset();
       }
-      ARROW_OK_OR_RAISE(
-          edge_builders[v_label].Advance(actual_edge_num[v_label]));
-      ARROW_OK_OR_RAISE(edge_builders[v_label].Finish(&edges[v_label]));
     }
     return boost::leaf::result<void>();
   }
 
-  boost::leaf::result<void> generate_undirected_csr(
+  boost::leaf::result<void> generate_directed_csr(
       std::shared_ptr<vid_array_t> src_list,
       std::shared_ptr<vid_array_t> dst_list,
       std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>>& edges,
       std::vector<std::shared_ptr<arrow::Int64Array>>& edge_offsets) {
-    std::vector<std::vector<int>> degree(vertex_label_num_);
-    std::vector<int64_t> actual_edge_num(vertex_label_num_, 0);
-    for (label_id_t v_label = 0; v_label != vertex_label_num_; ++v_label) {
-      degree[v_label].resize(tvnums_[v_label], 0);
-    }
-    int64_t edge_num = src_list->length();
-    for (int64_t i = 0; i < edge_num; ++i) {
-      vid_t src_id = src_list->Value(i);
-      vid_t dst_id = dst_list->Value(i);
-      ++degree[vid_parser_.GetLabelId(src_id)][vid_parser_.GetOffset(src_id)];
-      ++degree[vid_parser_.GetLabelId(dst_id)][vid_parser_.GetOffset(dst_id)];
-    }
-    std::vector<std::vector<int64_t>> offsets(vertex_label_num_);
-    for (label_id_t v_label = 0; v_label != vertex_label_num_; ++v_label) {
-      auto& offset_vec = offsets[v_label];
-      offset_vec.resize(tvnums_[v_label] + 1);
-      auto& degree_vec = degree[v_label];
-      offset_vec[0] = 0;
-      for (vid_t i = 0; i < tvnums_[v_label]; ++i) {
-        offset_vec[i + 1] = offset_vec[i] + degree_vec[i];
-      }
-      actual_edge_num[v_label] = offset_vec[tvnums_[v_label]];
-      arrow::Int64Builder builder;
-      ARROW_OK_OR_RAISE(builder.AppendValues(offset_vec));
-      ARROW_OK_OR_RAISE(builder.Finish(&edge_offsets[v_label]));
-    }
-
-    std::vector<vineyard::PodArrayBuilder<nbr_unit_t>> edge_builders(
-        vertex_label_num_);
-    for (label_id_t v_label = 0; v_label != vertex_label_num_; ++v_label) {
-      ARROW_OK_OR_RAISE(
-          edge_builders[v_label].Resize(actual_edge_num[v_label]));
-    }
+    return property_graph_utils::generate_directed_csr<vid_t, eid_t>(
+        vid_parser_, src_list, dst_list, tvnums_, vertex_label_num_,
+        concurrency_, edges, edge_offsets);
+  }
 
-    eid_t cur_eid = 0;
-
-    for (int64_t i = 0; i < edge_num; ++i) {
-      vid_t src_id = src_list->Value(i);
-      vid_t dst_id = dst_list->Value(i);
-      label_id_t src_label = vid_parser_.GetLabelId(src_id);
-      int64_t src_offset = vid_parser_.GetOffset(src_id);
-      label_id_t dst_label = vid_parser_.GetLabelId(dst_id);
-      int64_t dst_offset = vid_parser_.GetOffset(dst_id);
-
-      nbr_unit_t* src_ptr = edge_builders[src_label].MutablePointer(
-          offsets[src_label][src_offset]);
-      src_ptr->vid = dst_id;
-      src_ptr->eid = cur_eid;
-      ++offsets[src_label][src_offset];
-
-      nbr_unit_t* dst_ptr = edge_builders[dst_label].MutablePointer(
-          offsets[dst_label][dst_offset]);
-      dst_ptr->vid = src_id;
-      dst_ptr->eid = cur_eid;
-      ++offsets[dst_label][dst_offset];
-
-      ++cur_eid;
+  boost::leaf::result<void> generate_undirected_csr(
+      std::shared_ptr<vid_array_t> src_list,
+      std::shared_ptr<vid_array_t> dst_list,
+      std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>>& edges,
+      std::vector<std::shared_ptr<arrow::Int64Array>>& edge_offsets) {
+    return property_graph_utils::generate_undirected_csr<vid_t, eid_t>(
+        vid_parser_, src_list, dst_list, tvnums_, vertex_label_num_,
+        concurrency_, edges, edge_offsets);
+  }
+
+  boost::leaf::result<void> narrow_csr(
+      std::shared_ptr<arrow::FixedSizeBinaryArray>& edges) {
+    std::shared_ptr<arrow::FixedSizeBinaryArray> narrow_edges;
+    auto result = property_graph_utils::narrow_csr<vid_t, eid_t>(
+        narrow_converter_, edges, concurrency_, narrow_edges);
+    if (result) {
+      edges = narrow_edges;
     }
+    return result;
+  }
 
-    for (label_id_t v_label = 0; v_label != vertex_label_num_; ++v_label) {
-      auto& builder = edge_builders[v_label];
-      auto tvnum = tvnums_[v_label];
-      auto offsets = edge_offsets[v_label];
-      for (vid_t i = 0; i < tvnum; ++i) {
-        nbr_unit_t* begin = builder.MutablePointer(offsets->Value(i));
-        nbr_unit_t* end = builder.MutablePointer(offsets->Value(i + 1));
-        std::sort(begin, end, [](const nbr_unit_t& lhs, const nbr_unit_t& rhs) {
-          return lhs.vid < rhs.vid;
-        });
-      }
-      ARROW_OK_OR_RAISE(
-          edge_builders[v_label].Advance(actual_edge_num[v_label]));
-      ARROW_OK_OR_RAISE(edge_builders[v_label].Finish(&edges[v_label]));
-    }
-    return boost::leaf::result<void>();
+  boost::leaf::result<void> compress_csr(
+      std::shared_ptr<arrow::FixedSizeBinaryArray> edges,
+      std::shared_ptr<arrow::Int64Array> edge_offsets,
+      std::shared_ptr<arrow::FixedSizeBinaryArray>& compact_edges,
+      std::shared_ptr<arrow::Int64Array>& compact_offsets) {
+    return property_graph_utils::compress_csr<vid_t, eid_t>(
+        edges, edge_offsets, concurrency_, compact_edges, compact_offsets);
   }
 
   fid_t fid_, fnum_;
   bool directed_;
+  // whether to store varint-encoded adjacency lists
+  bool compact_edges_;
+  // whether to store adjacency lists of narrow units if the ids fit
+  bool narrow_edges_;
   label_id_t vertex_label_num_;
   label_id_t edge_label_num_;
+  // the number of threads to build the CSR
+  int concurrency_;
 
   std::vector<vid_t> ivnums_, ovnums_, tvnums_;
 
@@ -1875,10 +2160,15 @@ class BasicArrowFragmentBuilder : public ArrowFragmentBuilder<OID_T, VID_T> {
       ie_lists_, oe_lists_;
   std::vector<std::vector<std::shared_ptr<arrow::Int64Array>>>
       ie_offsets_lists_, oe_offsets_lists_;
+  std::vector<std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>>>
+      compact_ie_lists_, compact_oe_lists_;
+  std::vector<std::vector<std::shared_ptr<arrow::Int64Array>>>
+      compact_ie_offsets_lists_, compact_oe_offsets_lists_;
 
   std::shared_ptr<vertex_map_t> vm_ptr_;
 
   vineyard::IdParser<vid_t> vid_parser_;
+  property_graph_utils::NarrowIdConverter<vid_t> narrow_converter_;
 
   PropertyGraphSchema schema_;
 };
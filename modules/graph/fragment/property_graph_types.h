@@ -52,6 +52,10 @@ using EID_TYPE = uint64_t;
 using VID_TYPE = uint64_t;
 // using VID_TYPE = uint32_t;
 
+// the narrow layout of adjacency lists, see `NarrowIdConverter`
+using NARROW_EID_TYPE = uint32_t;
+using NARROW_VID_TYPE = uint32_t;
+
 using PROP_ID_TYPE = int;
 using LABEL_ID_TYPE = int;
 
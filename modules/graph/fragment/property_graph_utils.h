@@ -16,16 +16,23 @@ limitations under the License.
 #ifndef MODULES_GRAPH_FRAGMENT_PROPERTY_GRAPH_UTILS_H_
 #define MODULES_GRAPH_FRAGMENT_PROPERTY_GRAPH_UTILS_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "boost/leaf/all.hpp"
 #include "grape/utils/vertex_array.h"
 
 #include "graph/fragment/property_graph_types.h"
 #include "graph/fragment/property_graph_utils.h"
+#include "graph/utils/error.h"
 
 namespace vineyard {
 
@@ -476,6 +483,406 @@ class AdjList {
   const void** edata_arrays_;
 };
 
+/**
+ * Narrow adjacency lists store NbrUnit<NARROW_VID_TYPE, NARROW_EID_TYPE> when
+ * the edge ids and the local vertex ids of a fragment fit in 32 bits. A narrow
+ * local id keeps the label at the top bits like IdParser, with fewer bits for
+ * the offset, and is widened to the local id of the fragment on access.
+ */
+template <typename VID_T>
+class NarrowIdConverter {
+  using narrow_vid_t = property_graph_types::NARROW_VID_TYPE;
+
+ public:
+  void Init(fid_t fnum, int label_num) {
+    vid_parser_.Init(fnum, label_num);
+    narrow_vid_parser_.Init(1, label_num);
+  }
+
+  /** Whether the local ids of `vnum` vertices of a label fit. */
+  bool Fits(int64_t vnum) const {
+    return vnum <= static_cast<int64_t>(narrow_vid_parser_.offset_mask()) + 1;
+  }
+
+  narrow_vid_t Narrow(VID_T v) const {
+    return narrow_vid_parser_.GenerateId(0, vid_parser_.GetLabelId(v),
+                                         vid_parser_.GetOffset(v));
+  }
+
+  VID_T Widen(narrow_vid_t v) const {
+    return vid_parser_.GenerateId(0, narrow_vid_parser_.GetLabelId(v),
+                                  narrow_vid_parser_.GetOffset(v));
+  }
+
+ private:
+  IdParser<VID_T> vid_parser_;
+  IdParser<narrow_vid_t> narrow_vid_parser_;
+};
+
+template <typename VID_T, typename EID_T>
+struct NarrowNbr {
+ private:
+  using prop_id_t = property_graph_types::PROP_ID_TYPE;
+  using narrow_nbr_unit_t =
+      NbrUnit<property_graph_types::NARROW_VID_TYPE,
+              property_graph_types::NARROW_EID_TYPE>;
+
+ public:
+  NarrowNbr() : nbr_(NULL), converter_(nullptr), edata_arrays_(nullptr) {}
+  NarrowNbr(const narrow_nbr_unit_t* nbr,
+            const NarrowIdConverter<VID_T>* converter,
+            const void** edata_arrays)
+      : nbr_(nbr), converter_(converter), edata_arrays_(edata_arrays) {}
+
+  grape::Vertex<VID_T> neighbor() const {
+    return grape::Vertex<VID_T>(converter_->Widen(nbr_->vid));
+  }
+
+  grape::Vertex<VID_T> get_neighbor() const {
+    return grape::Vertex<VID_T>(converter_->Widen(nbr_->vid));
+  }
+
+  EID_T edge_id() const { return nbr_->eid; }
+
+  template <typename T>
+  T get_data(prop_id_t prop_id) const {
+    return ValueGetter<T>::Value(edata_arrays_[prop_id], nbr_->eid);
+  }
+
+  std::string get_str(prop_id_t prop_id) const {
+    return ValueGetter<std::string>::Value(edata_arrays_[prop_id], nbr_->eid);
+  }
+
+  double get_double(prop_id_t prop_id) const {
+    return ValueGetter<double>::Value(edata_arrays_[prop_id], nbr_->eid);
+  }
+
+  int64_t get_int(prop_id_t prop_id) const {
+    return ValueGetter<int64_t>::Value(edata_arrays_[prop_id], nbr_->eid);
+  }
+
+  inline const NarrowNbr& operator++() const {
+    ++nbr_;
+    return *this;
+  }
+
+  inline NarrowNbr operator++(int) const {
+    NarrowNbr ret(*this);
+    ++nbr_;
+    return ret;
+  }
+
+  inline const NarrowNbr& operator--() const {
+    --nbr_;
+    return *this;
+  }
+
+  inline NarrowNbr operator--(int) const {
+    NarrowNbr ret(*this);
+    --nbr_;
+    return ret;
+  }
+
+  inline bool operator==(const NarrowNbr& rhs) const {
+    return nbr_ == rhs.nbr_;
+  }
+  inline bool operator!=(const NarrowNbr& rhs) const {
+    return nbr_ != rhs.nbr_;
+  }
+
+  inline bool operator<(const NarrowNbr& rhs) const { return nbr_ < rhs.nbr_; }
+
+  inline const NarrowNbr& operator*() const { return *this; }
+
+ private:
+  const mutable narrow_nbr_unit_t* nbr_;
+  const NarrowIdConverter<VID_T>* converter_;
+  const void** edata_arrays_;
+};
+
+template <typename VID_T, typename EID_T>
+class NarrowAdjList {
+  using narrow_nbr_unit_t =
+      NbrUnit<property_graph_types::NARROW_VID_TYPE,
+              property_graph_types::NARROW_EID_TYPE>;
+
+ public:
+  NarrowAdjList()
+      : begin_(NULL), end_(NULL), converter_(nullptr), edata_arrays_(nullptr) {}
+  NarrowAdjList(const narrow_nbr_unit_t* begin, const narrow_nbr_unit_t* end,
+                const NarrowIdConverter<VID_T>* converter,
+                const void** edata_arrays)
+      : begin_(begin),
+        end_(end),
+        converter_(converter),
+        edata_arrays_(edata_arrays) {}
+
+  inline NarrowNbr<VID_T, EID_T> begin() const {
+    return NarrowNbr<VID_T, EID_T>(begin_, converter_, edata_arrays_);
+  }
+
+  inline NarrowNbr<VID_T, EID_T> end() const {
+    return NarrowNbr<VID_T, EID_T>(end_, converter_, edata_arrays_);
+  }
+
+  inline size_t Size() const { return end_ - begin_; }
+
+  inline bool Empty() const { return end_ == begin_; }
+
+  inline bool NotEmpty() const { return end_ != begin_; }
+
+  size_t size() const { return end_ - begin_; }
+
+ private:
+  const narrow_nbr_unit_t* begin_;
+  const narrow_nbr_unit_t* end_;
+  const NarrowIdConverter<VID_T>* converter_;
+  const void** edata_arrays_;
+};
+
+/**
+ * Compact adjacency lists store the neighbors of a vertex, sorted by (vid,
+ * eid), as a stream of LEB128 varints, i.e., 7 bits per byte, where the high
+ * bit marks that the value continues in the next byte. Every neighbor takes
+ * two varints: the delta of its vid from the previous neighbor (from 0 for the
+ * first one), and the zigzag-encoded delta of its eid, as eids of a vertex are
+ * not monotonic.
+ *
+ * The stream is followed by `varint_padding` bytes, thus decoders may load 8
+ * bytes at a time without bounds checks.
+ */
+constexpr int64_t varint_padding = 8;
+
+inline size_t varint_size(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+inline uint8_t* varint_encode(uint64_t value, uint8_t* ptr) {
+  while (value >= 0x80) {
+    *ptr++ = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  *ptr++ = static_cast<uint8_t>(value);
+  return ptr;
+}
+
+inline const uint8_t* varint_decode(const uint8_t* ptr, uint64_t& value) {
+  uint64_t byte = *ptr++;
+  if (byte < 0x80) {
+    value = byte;
+    return ptr;
+  }
+  value = byte & 0x7f;
+  for (int shift = 7;; shift += 7) {
+    byte = *ptr++;
+    value |= (byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      return ptr;
+    }
+  }
+}
+
+inline uint64_t zigzag_encode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief Decode `n` varints to `values`.
+ *
+ * Eight bytes are loaded as a word at once: the bytes before the first
+ * continuation bit are complete values and are expanded without branching on
+ * every byte, which is the common case for the deltas of sorted neighbors.
+ */
+inline const uint8_t* varint_decode_n(const uint8_t* ptr, size_t n,
+                                      uint64_t* values) {
+  size_t i = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (i + 8 <= n) {
+    uint64_t word;
+    memcpy(&word, ptr, sizeof(word));
+    uint64_t continuation = word & 0x8080808080808080ULL;
+    if (continuation == 0) {
+      for (int k = 0; k < 8; ++k) {
+        values[i + k] = (word >> (k * 8)) & 0xff;
+      }
+      ptr += 8;
+      i += 8;
+    } else {
+      int bytes = __builtin_ctzll(continuation) >> 3;
+      for (int k = 0; k < bytes; ++k) {
+        values[i + k] = ptr[k];
+      }
+      ptr = varint_decode(ptr + bytes, values[i + bytes]);
+      i += bytes + 1;
+    }
+  }
+#endif
+  while (i < n) {
+    ptr = varint_decode(ptr, values[i++]);
+  }
+  return ptr;
+}
+
+/**
+ * @brief The iterator of a compact adjacency list, which decodes the neighbor
+ * under it on the fly.
+ */
+template <typename VID_T, typename EID_T>
+struct CompactNbr {
+ private:
+  using prop_id_t = property_graph_types::PROP_ID_TYPE;
+
+ public:
+  CompactNbr()
+      : ptr_(NULL),
+        next_(NULL),
+        end_(NULL),
+        vid_(0),
+        eid_(0),
+        edata_arrays_(nullptr) {}
+  CompactNbr(const uint8_t* ptr, const uint8_t* end,
+             const void** edata_arrays)
+      : ptr_(ptr),
+        next_(ptr),
+        end_(end),
+        vid_(0),
+        eid_(0),
+        edata_arrays_(edata_arrays) {
+    decode();
+  }
+
+  grape::Vertex<VID_T> neighbor() const {
+    return grape::Vertex<VID_T>(static_cast<VID_T>(vid_));
+  }
+
+  grape::Vertex<VID_T> get_neighbor() const {
+    return grape::Vertex<VID_T>(static_cast<VID_T>(vid_));
+  }
+
+  EID_T edge_id() const { return static_cast<EID_T>(eid_); }
+
+  template <typename T>
+  T get_data(prop_id_t prop_id) const {
+    return ValueGetter<T>::Value(edata_arrays_[prop_id], eid_);
+  }
+
+  std::string get_str(prop_id_t prop_id) const {
+    return ValueGetter<std::string>::Value(edata_arrays_[prop_id], eid_);
+  }
+
+  double get_double(prop_id_t prop_id) const {
+    return ValueGetter<double>::Value(edata_arrays_[prop_id], eid_);
+  }
+
+  int64_t get_int(prop_id_t prop_id) const {
+    return ValueGetter<int64_t>::Value(edata_arrays_[prop_id], eid_);
+  }
+
+  inline const CompactNbr& operator++() const {
+    decode();
+    return *this;
+  }
+
+  inline CompactNbr operator++(int) const {
+    CompactNbr ret(*this);
+    decode();
+    return ret;
+  }
+
+  inline bool operator==(const CompactNbr& rhs) const {
+    return ptr_ == rhs.ptr_;
+  }
+  inline bool operator!=(const CompactNbr& rhs) const {
+    return ptr_ != rhs.ptr_;
+  }
+
+  inline const CompactNbr& operator*() const { return *this; }
+
+ private:
+  // moves to the next neighbor, `ptr_` points to the encoded current one
+  inline void decode() const {
+    ptr_ = next_;
+    if (next_ != end_) {
+      uint64_t vid_delta, eid_delta;
+      next_ = varint_decode(next_, vid_delta);
+      next_ = varint_decode(next_, eid_delta);
+      vid_ += vid_delta;
+      eid_ += zigzag_decode(eid_delta);
+    }
+  }
+
+  const mutable uint8_t* ptr_;
+  const mutable uint8_t* next_;
+  const uint8_t* end_;
+  mutable uint64_t vid_;
+  mutable int64_t eid_;
+  const void** edata_arrays_;
+};
+
+template <typename VID_T, typename EID_T>
+class CompactAdjList {
+ public:
+  CompactAdjList()
+      : begin_(NULL), end_(NULL), size_(0), edata_arrays_(nullptr) {}
+  CompactAdjList(const uint8_t* begin, const uint8_t* end, size_t size,
+                 const void** edata_arrays)
+      : begin_(begin), end_(end), size_(size), edata_arrays_(edata_arrays) {}
+
+  inline CompactNbr<VID_T, EID_T> begin() const {
+    return CompactNbr<VID_T, EID_T>(begin_, end_, edata_arrays_);
+  }
+
+  inline CompactNbr<VID_T, EID_T> end() const {
+    return CompactNbr<VID_T, EID_T>(end_, end_, edata_arrays_);
+  }
+
+  inline size_t Size() const { return size_; }
+
+  inline bool Empty() const { return size_ == 0; }
+
+  inline bool NotEmpty() const { return size_ != 0; }
+
+  size_t size() const { return size_; }
+
+  /**
+   * @brief Decode all neighbors to `units`, which has room for `Size()` units,
+   * with the bulk varint decoder.
+   */
+  void Decode(NbrUnit<VID_T, EID_T>* units) const {
+    constexpr size_t batch_size = 64;
+    uint64_t values[2 * batch_size];
+    uint64_t vid = 0;
+    int64_t eid = 0;
+    const uint8_t* ptr = begin_;
+    for (size_t i = 0; i < size_; i += batch_size) {
+      size_t n = std::min(batch_size, size_ - i);
+      ptr = varint_decode_n(ptr, 2 * n, values);
+      for (size_t k = 0; k < n; ++k) {
+        vid += values[2 * k];
+        eid += zigzag_decode(values[2 * k + 1]);
+        units[i + k].vid = static_cast<VID_T>(vid);
+        units[i + k].eid = static_cast<EID_T>(eid);
+      }
+    }
+  }
+
+ private:
+  const uint8_t* begin_;
+  const uint8_t* end_;
+  size_t size_;
+  const void** edata_arrays_;
+};
+
 /**
  * OffsetAdjList will offset the outer vertices' lid, makes it between "ivnum"
  * and "tvnum" instead of "ivnum ~ tvnum - outer vertex index"
@@ -528,6 +935,355 @@ class OffsetAdjList {
   const VID_T* ivnums_;
 };
 
+/**
+ * @brief Invoke `func(begin, end)` on the chunks of [begin, end) with
+ * `concurrency` threads. Chunks are handed out on demand, since the costs of
+ * items, e.g., sorting the neighbors of a vertex, are usually skewed.
+ */
+template <typename FUNC_T>
+void parallel_for(int64_t begin, int64_t end, int concurrency,
+                  const FUNC_T& func, int64_t chunk_size = 1024) {
+  int64_t chunk_num = (end - begin + chunk_size - 1) / chunk_size;
+  concurrency = static_cast<int>(
+      std::min(static_cast<int64_t>(concurrency), chunk_num));
+  if (concurrency <= 1) {
+    if (begin < end) {
+      func(begin, end);
+    }
+    return;
+  }
+  std::atomic<int64_t> cursor(begin);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < concurrency; ++i) {
+    threads.emplace_back([&]() {
+      while (true) {
+        int64_t chunk_begin = cursor.fetch_add(chunk_size);
+        if (chunk_begin >= end) {
+          break;
+        }
+        func(chunk_begin, std::min(chunk_begin + chunk_size, end));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+/**
+ * @brief Fill `offsets[0..length]` with the exclusive prefix sums of
+ * `degrees[0..length)`: the blocks are summed in parallel first, then every
+ * block is scanned from the sum of the blocks before it.
+ */
+template <typename DEGREE_T>
+void parallel_prefix_sum(const DEGREE_T* degrees, int64_t length,
+                         int concurrency, int64_t* offsets) {
+  int64_t block_size = std::max<int64_t>(
+      (length + concurrency - 1) / std::max(concurrency, 1), 1 << 16);
+  int64_t block_num = (length + block_size - 1) / block_size;
+  std::vector<int64_t> block_offsets(block_num + 1, 0);
+  parallel_for(
+      0, block_num, concurrency,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end; ++block) {
+          int64_t sum = 0;
+          for (int64_t i = block * block_size;
+               i < std::min(length, (block + 1) * block_size); ++i) {
+            sum += degrees[i];
+          }
+          block_offsets[block + 1] = sum;
+        }
+      },
+      1);
+  for (int64_t block = 0; block < block_num; ++block) {
+    block_offsets[block + 1] += block_offsets[block];
+  }
+  parallel_for(
+      0, block_num, concurrency,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end; ++block) {
+          int64_t sum = block_offsets[block];
+          for (int64_t i = block * block_size;
+               i < std::min(length, (block + 1) * block_size); ++i) {
+            offsets[i] = sum;
+            sum += degrees[i];
+          }
+        }
+      },
+      1);
+  offsets[length] = block_offsets[block_num];
+}
+
+/**
+ * @brief Build the CSR of every vertex label from the edge list, where the
+ * i-th edge gets the edge id i, and the neighbors of every vertex are sorted
+ * by vid (then by eid, thus the result doesn't depend on the concurrency).
+ *
+ * Degree counting, prefix sums, scattering edges and sorting neighbors are
+ * all done in parallel: edges are scattered to the slots reserved by atomic
+ * increments of the per-vertex cursors.
+ *
+ * @param undirected whether an edge is stored at both of its endpoints.
+ */
+template <typename VID_T, typename EID_T>
+boost::leaf::result<void> generate_csr(
+    const IdParser<VID_T>& vid_parser,
+    std::shared_ptr<typename vineyard::ConvertToArrowType<VID_T>::ArrayType>
+        src_list,
+    std::shared_ptr<typename vineyard::ConvertToArrowType<VID_T>::ArrayType>
+        dst_list,
+    const std::vector<VID_T>& tvnums, int vertex_label_num, int concurrency,
+    bool undirected,
+    std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>>& edges,
+    std::vector<std::shared_ptr<arrow::Int64Array>>& edge_offsets) {
+  using nbr_unit_t = NbrUnit<VID_T, EID_T>;
+  constexpr int64_t edge_chunk_size = 64 * 1024;
+
+  const VID_T* src = src_list->raw_values();
+  const VID_T* dst = dst_list->raw_values();
+  int64_t edge_num = src_list->length();
+
+  std::vector<std::vector<int>> degree(vertex_label_num);
+  for (int v_label = 0; v_label != vertex_label_num; ++v_label) {
+    degree[v_label].resize(tvnums[v_label], 0);
+  }
+  auto count = [&](VID_T v) {
+    __atomic_fetch_add(
+        &degree[vid_parser.GetLabelId(v)][vid_parser.GetOffset(v)], 1,
+        __ATOMIC_RELAXED);
+  };
+  parallel_for(
+      0, edge_num, concurrency,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          count(src[i]);
+          if (undirected) {
+            count(dst[i]);
+          }
+        }
+      },
+      edge_chunk_size);
+
+  // the offsets are advanced as cursors while scattering edges
+  std::vector<std::vector<int64_t>> offsets(vertex_label_num);
+  std::vector<PodArrayBuilder<nbr_unit_t>> edge_builders(vertex_label_num);
+  for (int v_label = 0; v_label != vertex_label_num; ++v_label) {
+    auto& offset_vec = offsets[v_label];
+    offset_vec.resize(tvnums[v_label] + 1);
+    parallel_prefix_sum(degree[v_label].data(), tvnums[v_label], concurrency,
+                        offset_vec.data());
+    std::vector<int>().swap(degree[v_label]);
+
+    arrow::Int64Builder builder;
+    ARROW_OK_OR_RAISE(builder.AppendValues(offset_vec));
+    ARROW_OK_OR_RAISE(builder.Finish(&edge_offsets[v_label]));
+    ARROW_OK_OR_RAISE(edge_builders[v_label].Resize(offset_vec.back()));
+  }
+
+  auto scatter = [&](VID_T v, VID_T nbr, int64_t eid) {
+    int v_label = vid_parser.GetLabelId(v);
+    int64_t slot = __atomic_fetch_add(
+        &offsets[v_label][vid_parser.GetOffset(v)], 1, __ATOMIC_RELAXED);
+    nbr_unit_t* ptr = edge_builders[v_label].MutablePointer(slot);
+    ptr->vid = nbr;
+    ptr->eid = static_cast<EID_T>(eid);
+  };
+  parallel_for(
+      0, edge_num, concurrency,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          scatter(src[i], dst[i], i);
+          if (undirected) {
+            scatter(dst[i], src[i], i);
+          }
+        }
+      },
+      edge_chunk_size);
+  std::vector<std::vector<int64_t>>().swap(offsets);
+
+  auto nbr_less = [](const nbr_unit_t& lhs, const nbr_unit_t& rhs) {
+    return lhs.vid < rhs.vid || (lhs.vid == rhs.vid && lhs.eid < rhs.eid);
+  };
+  for (int v_label = 0; v_label != vertex_label_num; ++v_label) {
+    auto& builder = edge_builders[v_label];
+    const int64_t* offset_values = edge_offsets[v_label]->raw_values();
+    parallel_for(0, tvnums[v_label], concurrency,
+                 [&](int64_t begin, int64_t end) {
+                   for (int64_t i = begin; i < end; ++i) {
+                     std::sort(builder.MutablePointer(offset_values[i]),
+                               builder.MutablePointer(offset_values[i + 1]),
+                               nbr_less);
+                   }
+                 });
+    ARROW_OK_OR_RAISE(builder.Advance(offset_values[tvnums[v_label]]));
+    ARROW_OK_OR_RAISE(builder.Finish(&edges[v_label]));
+  }
+  return boost::leaf::result<void>();
+}
+
+template <typename VID_T, typename EID_T>
+boost::leaf::result<void> generate_directed_csr(
+    const IdParser<VID_T>& vid_parser,
+    std::shared_ptr<typename vineyard::ConvertToArrowType<VID_T>::ArrayType>
+        src_list,
+    std::shared_ptr<typename vineyard::ConvertToArrowType<VID_T>::ArrayType>
+        dst_list,
+    const std::vector<VID_T>& tvnums, int vertex_label_num, int concurrency,
+    std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>>& edges,
+    std::vector<std::shared_ptr<arrow::Int64Array>>& edge_offsets) {
+  return generate_csr<VID_T, EID_T>(vid_parser, src_list, dst_list, tvnums,
+                                    vertex_label_num, concurrency, false,
+                                    edges, edge_offsets);
+}
+
+template <typename VID_T, typename EID_T>
+boost::leaf::result<void> generate_undirected_csr(
+    const IdParser<VID_T>& vid_parser,
+    std::shared_ptr<typename vineyard::ConvertToArrowType<VID_T>::ArrayType>
+        src_list,
+    std::shared_ptr<typename vineyard::ConvertToArrowType<VID_T>::ArrayType>
+        dst_list,
+    const std::vector<VID_T>& tvnums, int vertex_label_num, int concurrency,
+    std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>>& edges,
+    std::vector<std::shared_ptr<arrow::Int64Array>>& edge_offsets) {
+  return generate_csr<VID_T, EID_T>(vid_parser, src_list, dst_list, tvnums,
+                                    vertex_label_num, concurrency, true,
+                                    edges, edge_offsets);
+}
+
+/**
+ * @brief Whether the edge ids and the local vertex ids fit in the narrow
+ * layout, and the layout is actually narrower, otherwise the 64-bit layout is
+ * kept, where `edge_nums` and `tvnums` are the numbers of edges of every edge
+ * label and of vertices of every vertex label.
+ */
+template <typename VID_T, typename EID_T>
+bool narrow_fits(const NarrowIdConverter<VID_T>& converter,
+                 const std::vector<int64_t>& edge_nums,
+                 const std::vector<VID_T>& tvnums) {
+  using narrow_nbr_unit_t =
+      NbrUnit<property_graph_types::NARROW_VID_TYPE,
+              property_graph_types::NARROW_EID_TYPE>;
+  if (sizeof(narrow_nbr_unit_t) >= sizeof(NbrUnit<VID_T, EID_T>)) {
+    return false;
+  }
+  for (auto edge_num : edge_nums) {
+    if (static_cast<uint64_t>(edge_num) >
+        std::numeric_limits<property_graph_types::NARROW_EID_TYPE>::max()) {
+      return false;
+    }
+  }
+  for (auto tvnum : tvnums) {
+    if (!converter.Fits(static_cast<int64_t>(tvnum))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Convert the CSR of a vertex label to the narrow layout, the caller
+ * makes sure that the ids fit, see `narrow_fits`.
+ */
+template <typename VID_T, typename EID_T>
+boost::leaf::result<void> narrow_csr(
+    const NarrowIdConverter<VID_T>& converter,
+    std::shared_ptr<arrow::FixedSizeBinaryArray> edges, int concurrency,
+    std::shared_ptr<arrow::FixedSizeBinaryArray>& narrow_edges) {
+  using nbr_unit_t = NbrUnit<VID_T, EID_T>;
+  using narrow_nbr_unit_t =
+      NbrUnit<property_graph_types::NARROW_VID_TYPE,
+              property_graph_types::NARROW_EID_TYPE>;
+
+  const nbr_unit_t* units =
+      reinterpret_cast<const nbr_unit_t*>(edges->GetValue(0));
+  int64_t length = edges->length();
+
+  PodArrayBuilder<narrow_nbr_unit_t> builder;
+  ARROW_OK_OR_RAISE(builder.Resize(length));
+  parallel_for(
+      0, length, concurrency,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          narrow_nbr_unit_t* ptr = builder.MutablePointer(i);
+          ptr->vid = converter.Narrow(units[i].vid);
+          ptr->eid =
+              static_cast<property_graph_types::NARROW_EID_TYPE>(units[i].eid);
+        }
+      },
+      64 * 1024);
+  ARROW_OK_OR_RAISE(builder.Advance(length));
+  ARROW_OK_OR_RAISE(builder.Finish(&narrow_edges));
+  return boost::leaf::result<void>();
+}
+
+/**
+ * @brief Encode the CSR of a vertex label as compact adjacency lists, where
+ * `compact_offsets[v]` is the byte offset of the neighbors of `v` in
+ * `compact_edges`. The encoded sizes are computed in parallel first, then
+ * vertices are encoded in parallel at their offsets.
+ */
+template <typename VID_T, typename EID_T>
+boost::leaf::result<void> compress_csr(
+    std::shared_ptr<arrow::FixedSizeBinaryArray> edges,
+    std::shared_ptr<arrow::Int64Array> edge_offsets, int concurrency,
+    std::shared_ptr<arrow::FixedSizeBinaryArray>& compact_edges,
+    std::shared_ptr<arrow::Int64Array>& compact_offsets) {
+  using nbr_unit_t = NbrUnit<VID_T, EID_T>;
+
+  const nbr_unit_t* units =
+      reinterpret_cast<const nbr_unit_t*>(edges->GetValue(0));
+  const int64_t* offsets = edge_offsets->raw_values();
+  int64_t vnum = edge_offsets->length() - 1;
+
+  std::vector<int64_t> sizes(vnum);
+  parallel_for(0, vnum, concurrency, [&](int64_t begin, int64_t end) {
+    for (int64_t v = begin; v < end; ++v) {
+      uint64_t vid = 0;
+      int64_t eid = 0;
+      int64_t size = 0;
+      for (int64_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+        size += varint_size(static_cast<uint64_t>(units[i].vid) - vid);
+        size += varint_size(
+            zigzag_encode(static_cast<int64_t>(units[i].eid) - eid));
+        vid = units[i].vid;
+        eid = units[i].eid;
+      }
+      sizes[v] = size;
+    }
+  });
+
+  std::vector<int64_t> byte_offsets(vnum + 1);
+  parallel_prefix_sum(sizes.data(), vnum, concurrency, byte_offsets.data());
+  std::vector<int64_t>().swap(sizes);
+
+  PodArrayBuilder<uint8_t> builder;
+  int64_t length = byte_offsets[vnum] + varint_padding;
+  ARROW_OK_OR_RAISE(builder.Resize(length));
+  parallel_for(0, vnum, concurrency, [&](int64_t begin, int64_t end) {
+    for (int64_t v = begin; v < end; ++v) {
+      uint8_t* ptr = builder.MutablePointer(byte_offsets[v]);
+      uint64_t vid = 0;
+      int64_t eid = 0;
+      for (int64_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+        ptr = varint_encode(static_cast<uint64_t>(units[i].vid) - vid, ptr);
+        ptr = varint_encode(
+            zigzag_encode(static_cast<int64_t>(units[i].eid) - eid), ptr);
+        vid = units[i].vid;
+        eid = units[i].eid;
+      }
+    }
+  });
+  memset(builder.MutablePointer(byte_offsets[vnum]), 0, varint_padding);
+  ARROW_OK_OR_RAISE(builder.Advance(length));
+  ARROW_OK_OR_RAISE(builder.Finish(&compact_edges));
+
+  arrow::Int64Builder offsets_builder;
+  ARROW_OK_OR_RAISE(offsets_builder.AppendValues(byte_offsets));
+  ARROW_OK_OR_RAISE(offsets_builder.Finish(&compact_offsets));
+  return boost::leaf::result<void>();
+}
+
 }  // namespace property_graph_utils
 
 inline std::string generate_type_name(
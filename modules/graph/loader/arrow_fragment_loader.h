@@ -52,7 +52,11 @@ class ArrowFragmentLoader {
   const int id_column = 0;
   const int src_column = 0;
   const int dst_column = 1;
-#ifdef HASH_PARTITION
+#if defined(DEGREE_PARTITION)
+  using partitioner_t = DegreePartitioner<oid_t>;
+#elif defined(FENNEL_PARTITION) || defined(LDG_PARTITION)
+  using partitioner_t = StreamingPartitioner<oid_t>;
+#elif defined(HASH_PARTITION)
   using partitioner_t = HashPartitioner<oid_t>;
 #else
   using partitioner_t = SegmentedPartitioner<oid_t>;
@@ -64,7 +68,8 @@ class ArrowFragmentLoader {
                       const grape::CommSpec& comm_spec,
                       label_id_t vertex_label_num, label_id_t edge_label_num,
                       std::string efile, std::string vfile,
-                      bool directed = true)
+                      bool directed = true, bool compact_edges = false,
+                      bool narrow_edges = false)
       : client_(client),
         comm_spec_(comm_spec),
         efile_(std::move(efile)),
@@ -72,6 +77,8 @@ class ArrowFragmentLoader {
         vertex_label_num_(vertex_label_num),
         edge_label_num_(edge_label_num),
         directed_(directed),
+        compact_edges_(compact_edges),
+        narrow_edges_(narrow_edges),
         basic_arrow_fragment_loader_(comm_spec) {}
 
   ArrowFragmentLoader(
@@ -79,7 +86,8 @@ class ArrowFragmentLoader {
       label_id_t vertex_label_num, label_id_t edge_label_num,
       std::vector<std::shared_ptr<arrow::Table>> const& partial_v_tables,
       std::vector<std::shared_ptr<arrow::Table>> const& partial_e_tables,
-      bool directed = true)
+      bool directed = true, bool compact_edges = false,
+      bool narrow_edges = false)
       : client_(client),
         comm_spec_(comm_spec),
         vertex_label_num_(vertex_label_num),
@@ -87,12 +95,13 @@ class ArrowFragmentLoader {
         partial_v_tables_(partial_v_tables),
         partial_e_tables_(partial_e_tables),
         directed_(directed),
+        compact_edges_(compact_edges),
+        narrow_edges_(narrow_edges),
         basic_arrow_fragment_loader_(comm_spec) {}
 
   ~ArrowFragmentLoader() = default;
 
   boost::leaf::result<vineyard::ObjectID> LoadFragment() {
-    BOOST_LEAF_CHECK(initPartitioner());
     BOOST_LEAF_CHECK(initBasicLoader());
 
     BOOST_LEAF_AUTO(frag_id, shuffleAndBuild());
@@ -287,8 +296,10 @@ class ArrowFragmentLoader {
     return boost::leaf::result<void>();
   }
 
-  boost::leaf::result<void> initPartitioner() {
-#ifdef HASH_PARTITION
+  boost::leaf::result<void> initPartitioner(
+      const std::vector<std::shared_ptr<arrow::Table>>& partial_e_tables) {
+#if defined(HASH_PARTITION) && !defined(DEGREE_PARTITION) && \
+    !defined(FENNEL_PARTITION) && !defined(LDG_PARTITION)
     partitioner_.Init(comm_spec_.fnum());
 #else
     std::vector<std::shared_ptr<arrow::Table>> vtables;
@@ -314,8 +325,62 @@ class ArrowFragmentLoader {
       }
     }
 
+#if defined(DEGREE_PARTITION)
+    std::vector<int64_t> edges, degrees(oid_list.size(), 0);
+    BOOST_LEAF_CHECK(indexEdges(oid_list, partial_e_tables, edges));
+    for (int64_t index : edges) {
+      ++degrees[index];
+    }
+    AllreduceDegrees(degrees, comm_spec_);
+    partitioner_.Init(comm_spec_.fnum(), oid_list, degrees);
+#elif defined(FENNEL_PARTITION) || defined(LDG_PARTITION)
+    std::vector<int64_t> edges, nbr_offsets, nbrs;
+    BOOST_LEAF_CHECK(indexEdges(oid_list, partial_e_tables, edges));
+    BOOST_LEAF_CHECK(AllgatherEdges(edges, comm_spec_));
+    GenerateNeighbors(oid_list.size(), edges, nbr_offsets, nbrs);
+#if defined(FENNEL_PARTITION)
+    partitioner_.Init(comm_spec_.fnum(), oid_list, nbr_offsets, nbrs, true);
+#else
+    partitioner_.Init(comm_spec_.fnum(), oid_list, nbr_offsets, nbrs, false);
+#endif
+#else
     partitioner_.Init(comm_spec_.fnum(), oid_list);
 #endif
+#endif
+    return boost::leaf::result<void>();
+  }
+
+  // the pairs of the indices in `oid_list` of the endpoints of local edges
+  boost::leaf::result<void> indexEdges(
+      const std::vector<oid_t>& oid_list,
+      const std::vector<std::shared_ptr<arrow::Table>>& partial_e_tables,
+      std::vector<int64_t>& edges) {
+    ska::flat_hash_map<oid_t, int64_t> oid_indices;
+    oid_indices.reserve(oid_list.size());
+    for (size_t i = 0; i < oid_list.size(); ++i) {
+      oid_indices.emplace(oid_list[i], static_cast<int64_t>(i));
+    }
+    for (auto& table : partial_e_tables) {
+      auto src_chunks = table->column(src_column);
+      auto dst_chunks = table->column(dst_column);
+      edges.reserve(edges.size() + 2 * table->num_rows());
+      for (int chunk_i = 0; chunk_i < src_chunks->num_chunks(); ++chunk_i) {
+        auto src_array =
+            std::dynamic_pointer_cast<oid_array_t>(src_chunks->chunk(chunk_i));
+        auto dst_array =
+            std::dynamic_pointer_cast<oid_array_t>(dst_chunks->chunk(chunk_i));
+        for (int64_t i = 0; i < src_array->length(); ++i) {
+          auto src = oid_indices.find(oid_t(src_array->GetView(i)));
+          auto dst = oid_indices.find(oid_t(dst_array->GetView(i)));
+          if (src == oid_indices.end() || dst == oid_indices.end()) {
+            RETURN_GS_ERROR(ErrorCode::kInvalidValueError,
+                            "The endpoint of an edge is not a vertex");
+          }
+          edges.push_back(src->second);
+          edges.push_back(dst->second);
+        }
+      }
+    }
     return boost::leaf::result<void>();
   }
 
@@ -335,6 +400,7 @@ class ArrowFragmentLoader {
       partial_v_tables = tmp_v;
       partial_e_tables = tmp_e;
     }
+    BOOST_LEAF_CHECK(initPartitioner(partial_e_tables));
     basic_arrow_fragment_loader_.Init(partial_v_tables, partial_e_tables);
     basic_arrow_fragment_loader_.SetPartitioner(partitioner_);
 
@@ -348,6 +414,7 @@ class ArrowFragmentLoader {
 
     BasicArrowVertexMapBuilder<typename InternalType<oid_t>::type, vid_t>
         vm_builder(client_, comm_spec_.fnum(), vertex_label_num_, oid_lists);
+    vm_builder.set_partitioner(partitioner_t::type());
     auto vm = vm_builder.Seal(client_);
     auto vm_ptr =
         std::dynamic_pointer_cast<vertex_map_t>(client_.GetObject(vm->id()));
@@ -434,7 +501,8 @@ class ArrowFragmentLoader {
 
     BOOST_LEAF_CHECK(frag_builder.Init(comm_spec_.fid(), comm_spec_.fnum(),
                                        std::move(local_v_tables),
-                                       std::move(local_e_tables), directed_));
+                                       std::move(local_e_tables), directed_,
+                                       compact_edges_, narrow_edges_));
     auto frag = std::dynamic_pointer_cast<ArrowFragment<oid_t, vid_t>>(
         frag_builder.Seal(client_));
 
@@ -608,6 +676,12 @@ class ArrowFragmentLoader {
   partitioner_t partitioner_;
 
   bool directed_;
+  // seals the adjacency lists as varint-encoded compact edges, see also
+  // `ArrowFragment::GetOutgoingCompactAdjList`
+  bool compact_edges_;
+  // seals the adjacency lists as 32-bit units if the ids fit, see also
+  // `ArrowFragment::GetOutgoingNarrowAdjList`
+  bool narrow_edges_;
   basic_loader_t basic_arrow_fragment_loader_;
 };
 
@@ -15,8 +15,11 @@ limitations under the License.
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "glog/logging.h"
 
@@ -49,6 +52,65 @@ std::string generate_path(const std::string& prefix, int part_num) {
   }
 }
 
+template <typename ADJ_LIST_T>
+std::vector<GraphType::oid_t> sorted_oids(const GraphType& frag,
+                                          const ADJ_LIST_T& adj_list) {
+  std::vector<GraphType::oid_t> oids;
+  for (auto const& e : adj_list) {
+    oids.push_back(frag.GetId(e.neighbor()));
+  }
+  std::sort(oids.begin(), oids.end());
+  return oids;
+}
+
+// the neighbors by the adjacency lists that the fragment is sealed with
+std::vector<GraphType::oid_t> neighbor_oids(const GraphType& frag,
+                                            const GraphType::vertex_t& v,
+                                            LabelType e_label, bool outgoing) {
+  if (frag.compact_edges()) {
+    return sorted_oids(frag, outgoing
+                                 ? frag.GetOutgoingCompactAdjList(v, e_label)
+                                 : frag.GetIncomingCompactAdjList(v, e_label));
+  } else if (frag.narrow_edges()) {
+    return sorted_oids(frag, outgoing
+                                 ? frag.GetOutgoingNarrowAdjList(v, e_label)
+                                 : frag.GetIncomingNarrowAdjList(v, e_label));
+  } else {
+    return sorted_oids(frag, outgoing ? frag.GetOutgoingAdjList(v, e_label)
+                                      : frag.GetIncomingAdjList(v, e_label));
+  }
+}
+
+// the compact or narrow adjacency lists have the same neighbors as the plain
+// ones, the local ids of the two fragments may differ, thus are compared by
+// oids
+void CheckEdges(const GraphType& plain, const GraphType& frag) {
+  CHECK(!plain.compact_edges() && !plain.narrow_edges());
+  CHECK_EQ(plain.vertex_label_num(), frag.vertex_label_num());
+  CHECK_EQ(plain.edge_label_num(), frag.edge_label_num());
+  for (LabelType v_label = 0; v_label < plain.vertex_label_num(); ++v_label) {
+    CHECK_EQ(plain.GetInnerVerticesNum(v_label),
+             frag.GetInnerVerticesNum(v_label));
+    for (auto v : plain.InnerVertices(v_label)) {
+      GraphType::vertex_t u;
+      CHECK(frag.GetInnerVertex(plain.GetId(v), u));
+      for (LabelType e_label = 0; e_label < plain.edge_label_num();
+           ++e_label) {
+        CHECK_EQ(plain.GetLocalOutDegree(v, e_label),
+                 frag.GetLocalOutDegree(u, e_label));
+        CHECK(neighbor_oids(plain, v, e_label, true) ==
+              neighbor_oids(frag, u, e_label, true));
+        if (plain.directed()) {
+          CHECK_EQ(plain.GetLocalInDegree(v, e_label),
+                   frag.GetLocalInDegree(u, e_label));
+          CHECK(neighbor_oids(plain, v, e_label, false) ==
+                neighbor_oids(frag, u, e_label, false));
+        }
+      }
+    }
+  }
+}
+
 int main(int argc, char** argv) {
   if (argc < 8) {
     printf(
@@ -77,14 +139,13 @@ int main(int argc, char** argv) {
   grape::CommSpec comm_spec;
   comm_spec.Init(MPI_COMM_WORLD);
 
-  vineyard::ObjectID fragment_id = InvalidObjectID();
-  {
+  auto load = [&](bool compact_edges, bool narrow_edges) {
     auto loader =
         std::make_unique<ArrowFragmentLoader<property_graph_types::OID_TYPE,
                                              property_graph_types::VID_TYPE>>(
             client, comm_spec, vertex_label_num, edge_label_num, epath, vpath,
-            directed != 0);
-    fragment_id = boost::leaf::try_handle_all(
+            directed != 0, compact_edges, narrow_edges);
+    return boost::leaf::try_handle_all(
         [&loader]() { return loader->LoadFragment(); },
         [](const GSError& e) {
           LOG(FATAL) << e.error_msg;
@@ -94,7 +155,22 @@ int main(int argc, char** argv) {
           LOG(FATAL) << "Unmatched error " << unmatched;
           return 0;
         });
-  }
+  };
+
+  vineyard::ObjectID fragment_id = load(false, false);
+  vineyard::ObjectID compact_fragment_id = load(true, false);
+  vineyard::ObjectID narrow_fragment_id = load(false, true);
+  auto frag =
+      std::dynamic_pointer_cast<GraphType>(client.GetObject(fragment_id));
+  auto compact_frag = std::dynamic_pointer_cast<GraphType>(
+      client.GetObject(compact_fragment_id));
+  auto narrow_frag = std::dynamic_pointer_cast<GraphType>(
+      client.GetObject(narrow_fragment_id));
+  CHECK(compact_frag->compact_edges());
+  CheckEdges(*frag, *compact_frag);
+  // the ids of the test graphs fit in the narrow layout
+  CHECK(narrow_frag->narrow_edges());
+  CheckEdges(*frag, *narrow_frag);
 
   grape::FinalizeMPIComm();
 
@@ -102,6 +178,11 @@ int main(int argc, char** argv) {
             << "] loaded graph to vineyard: " << VYObjectIDToString(fragment_id)
             << " ...";
 
+  LOG(INFO) << "[worker-" << comm_spec.worker_id()
+            << "] loaded graph with compact and narrow edges to vineyard: "
+            << VYObjectIDToString(compact_fragment_id) << ", "
+            << VYObjectIDToString(narrow_fragment_id) << " ...";
+
   LOG(INFO) << "Passed arrow fragment test...";
 
   return 0;
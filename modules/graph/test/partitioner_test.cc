@@ -0,0 +1,212 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "grape/worker/comm_spec.h"
+
+#include "graph/utils/error.h"
+#include "graph/utils/partitioner.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+using oid_t = int64_t;
+
+constexpr int64_t vertex_num = 10000;
+constexpr int64_t edge_num = 50000;
+constexpr int64_t community_size = 2500;
+
+// the same power-law graph on every worker: the sources are skewed towards the
+// head of the oid list, thus a few vertices hold most of the edges, and the
+// edges stay in communities, which the streaming partitioners would pack into
+// a fragment beyond the capacity
+void MakeGraph(std::vector<oid_t>& oid_list, std::vector<int64_t>& edges) {
+  std::mt19937_64 rng(42);
+  oid_list.resize(vertex_num);
+  std::iota(oid_list.begin(), oid_list.end(), 1000000);
+  std::shuffle(oid_list.begin(), oid_list.end(), rng);
+  std::uniform_real_distribution<double> skewed(0, 1);
+  std::uniform_int_distribution<int64_t> uniform(0, community_size - 1);
+  edges.clear();
+  for (int64_t e = 0; e < edge_num; ++e) {
+    double source = static_cast<double>(vertex_num) * std::pow(skewed(rng), 4);
+    int64_t community = static_cast<int64_t>(source) / community_size;
+    edges.push_back(static_cast<int64_t>(source));
+    edges.push_back(community * community_size + uniform(rng));
+  }
+}
+
+std::vector<int64_t> Degrees(const std::vector<int64_t>& edges) {
+  std::vector<int64_t> degrees(vertex_num, 0);
+  for (int64_t index : edges) {
+    ++degrees[index];
+  }
+  return degrees;
+}
+
+// every oid is assigned to a fragment, and identically on all workers
+template <typename PARTITIONER_T>
+std::vector<fid_t> CheckAssignment(const PARTITIONER_T& partitioner,
+                                   const std::vector<oid_t>& oid_list,
+                                   fid_t fnum,
+                                   const grape::CommSpec& comm_spec) {
+  std::vector<fid_t> assignment, root_assignment;
+  for (oid_t oid : oid_list) {
+    fid_t fid = partitioner.GetPartitionId(oid);
+    CHECK_LT(fid, fnum);
+    assignment.push_back(fid);
+  }
+  root_assignment = assignment;
+  MPI_Bcast(root_assignment.data(), root_assignment.size() * sizeof(fid_t),
+            MPI_CHAR, 0, comm_spec.comm());
+  CHECK(assignment == root_assignment)
+      << "The assignment differs on worker " << comm_spec.worker_id();
+  return assignment;
+}
+
+// the loader path: the degrees are summed up, and the edges are gathered,
+// from the edges held by each worker
+void TestLoaderInputs(const grape::CommSpec& comm_spec,
+                      const std::vector<int64_t>& edges,
+                      std::vector<int64_t>& degrees,
+                      std::vector<int64_t>& nbr_offsets,
+                      std::vector<int64_t>& nbrs) {
+  int64_t begin = edge_num * comm_spec.worker_id() / comm_spec.worker_num();
+  int64_t end = edge_num * (comm_spec.worker_id() + 1) / comm_spec.worker_num();
+  std::vector<int64_t> local_edges(edges.begin() + 2 * begin,
+                                   edges.begin() + 2 * end);
+
+  degrees = Degrees(local_edges);
+  AllreduceDegrees(degrees, comm_spec);
+  CHECK(degrees == Degrees(edges));
+
+  auto gathered = boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<std::vector<int64_t>> {
+        BOOST_LEAF_CHECK(AllgatherEdges(local_edges, comm_spec));
+        return local_edges;
+      },
+      [](const GSError& e) {
+        LOG(FATAL) << e.error_msg;
+        return std::vector<int64_t>();
+      },
+      [](const boost::leaf::error_info& unmatched) {
+        LOG(FATAL) << "Unmatched error " << unmatched;
+        return std::vector<int64_t>();
+      });
+  CHECK(gathered == edges);
+
+  // both directions of every edge, and nothing else
+  GenerateNeighbors(vertex_num, gathered, nbr_offsets, nbrs);
+  CHECK_EQ(nbr_offsets.back(), 2 * edge_num);
+  std::vector<std::pair<int64_t, int64_t>> expected, actual;
+  for (size_t i = 0; i < edges.size(); i += 2) {
+    expected.emplace_back(edges[i], edges[i + 1]);
+    expected.emplace_back(edges[i + 1], edges[i]);
+  }
+  for (int64_t v = 0; v < vertex_num; ++v) {
+    CHECK_EQ(nbr_offsets[v + 1] - nbr_offsets[v], degrees[v]);
+    for (int64_t i = nbr_offsets[v]; i < nbr_offsets[v + 1]; ++i) {
+      actual.emplace_back(v, nbrs[i]);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  std::sort(actual.begin(), actual.end());
+  CHECK(actual == expected);
+}
+
+// no fragment is loaded above the average by more than the heaviest vertex
+void TestDegreePartitioner(const grape::CommSpec& comm_spec, fid_t fnum,
+                           const std::vector<oid_t>& oid_list,
+                           const std::vector<int64_t>& degrees) {
+  DegreePartitioner<oid_t> partitioner;
+  partitioner.Init(fnum, oid_list, degrees);
+  auto assignment = CheckAssignment(partitioner, oid_list, fnum, comm_spec);
+
+  std::vector<int64_t> loads(fnum, 0);
+  int64_t total = 0, heaviest = 0;
+  for (int64_t v = 0; v < vertex_num; ++v) {
+    loads[assignment[v]] += degrees[v] + 1;
+    total += degrees[v] + 1;
+    heaviest = std::max(heaviest, degrees[v] + 1);
+  }
+  int64_t max_load = *std::max_element(loads.begin(), loads.end());
+  CHECK_LE(max_load, (total + fnum - 1) / fnum + heaviest);
+}
+
+// a vertex is placed above the capacity only if it fits in no fragment
+void TestStreamingPartitioner(const grape::CommSpec& comm_spec, fid_t fnum,
+                              const std::vector<oid_t>& oid_list,
+                              const std::vector<int64_t>& nbr_offsets,
+                              const std::vector<int64_t>& nbrs, bool fennel) {
+  const double slack = 1.1;
+  StreamingPartitioner<oid_t> partitioner;
+  partitioner.Init(fnum, oid_list, nbr_offsets, nbrs, fennel, slack);
+  auto assignment = CheckAssignment(partitioner, oid_list, fnum, comm_spec);
+
+  double capacity = slack * static_cast<double>(vertex_num + nbrs.size()) /
+                    static_cast<double>(fnum);
+  std::vector<double> loads(fnum, 0);
+  for (int64_t v = 0; v < vertex_num; ++v) {
+    double weight =
+        static_cast<double>(nbr_offsets[v + 1] - nbr_offsets[v] + 1);
+    if (loads[assignment[v]] + weight > capacity) {
+      for (fid_t fid = 0; fid < fnum; ++fid) {
+        CHECK_GT(loads[fid] + weight, capacity)
+            << "Vertex " << v << " overflows while fragment " << fid << " fits";
+      }
+    }
+    loads[assignment[v]] += weight;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage: ./partitioner_test <ipc_socket>\n");
+    return 1;
+  }
+
+  grape::InitMPIComm();
+  {
+    grape::CommSpec comm_spec;
+    comm_spec.Init(MPI_COMM_WORLD);
+
+    std::vector<oid_t> oid_list;
+    std::vector<int64_t> edges, degrees, nbr_offsets, nbrs;
+    MakeGraph(oid_list, edges);
+    TestLoaderInputs(comm_spec, edges, degrees, nbr_offsets, nbrs);
+
+    for (fid_t fnum : {fid_t(comm_spec.fnum()), fid_t(3), fid_t(8)}) {
+      TestDegreePartitioner(comm_spec, fnum, oid_list, degrees);
+      TestStreamingPartitioner(comm_spec, fnum, oid_list, nbr_offsets, nbrs,
+                               true);
+      TestStreamingPartitioner(comm_spec, fnum, oid_list, nbr_offsets, nbrs,
+                               false);
+    }
+
+    LOG(INFO) << "[worker-" << comm_spec.worker_id()
+              << "] Passed partitioner test...";
+  }
+  grape::FinalizeMPIComm();
+
+  return 0;
+}
@@ -0,0 +1,407 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+#include "graph/fragment/property_graph_utils.h"
+
+using namespace vineyard;                        // NOLINT(build/namespaces)
+using namespace vineyard::property_graph_utils;  // NOLINT(build/namespaces)
+
+using vid_t = property_graph_types::VID_TYPE;
+using eid_t = property_graph_types::EID_TYPE;
+using nbr_unit_t = NbrUnit<vid_t, eid_t>;
+
+// decodes the values in bulk, and one by one, from the same stream
+void CheckVarints(std::vector<uint64_t> const& values) {
+  std::vector<uint8_t> buffer(values.size() * 10 + varint_padding, 0);
+  uint8_t* end = buffer.data();
+  for (auto value : values) {
+    uint8_t* next = varint_encode(value, end);
+    CHECK_EQ(static_cast<size_t>(next - end), varint_size(value));
+    end = next;
+  }
+
+  const uint8_t* ptr = buffer.data();
+  for (auto value : values) {
+    uint64_t decoded;
+    ptr = varint_decode(ptr, decoded);
+    CHECK_EQ(decoded, value);
+  }
+  CHECK(ptr == end);
+
+  std::vector<uint64_t> decoded(values.size());
+  CHECK(varint_decode_n(buffer.data(), values.size(), decoded.data()) == end);
+  CHECK(decoded == values);
+}
+
+void TestVarint() {
+  for (int64_t value : {int64_t(0), int64_t(1), int64_t(-1), int64_t(63),
+                        int64_t(-64), std::numeric_limits<int64_t>::max(),
+                        std::numeric_limits<int64_t>::min()}) {
+    CHECK_EQ(zigzag_decode(zigzag_encode(value)), value);
+  }
+  CHECK_EQ(zigzag_encode(-1), 1ULL);
+  CHECK_EQ(zigzag_encode(1), 2ULL);
+
+  // single byte values only, which are expanded word by word
+  std::vector<uint64_t> values;
+  for (int k = 0; k < 64; ++k) {
+    values.push_back(k % 128);
+  }
+  CheckVarints(values);
+
+  // a long value at every position of the word, and at the tail
+  for (int pos = 0; pos < 17; ++pos) {
+    for (uint64_t value :
+         {uint64_t(0x80), uint64_t(0x3fff), uint64_t(0x4000),
+          uint64_t(1) << 35, std::numeric_limits<uint64_t>::max()}) {
+      values.assign(17, 5);
+      values[pos] = value;
+      CheckVarints(values);
+    }
+  }
+
+  // fewer than eight values, which skip the word-wise path
+  CheckVarints({});
+  CheckVarints({300, 1, 2});
+
+  std::mt19937_64 rng(2021);
+  for (int round = 0; round < 100; ++round) {
+    values.resize(rng() % 200);
+    for (auto& value : values) {
+      // mostly short values, as the deltas of sorted neighbors
+      value = rng() >> (rng() % 64);
+      if (rng() % 4 != 0) {
+        value &= 0x7f;
+      }
+    }
+    CheckVarints(values);
+  }
+
+  LOG(INFO) << "Passed varint test...";
+}
+
+// a CSR of vertices with 0 to 199 neighbors each, sorted by vid per vertex,
+// and eids that are not monotonic
+void MakeCSR(int64_t vnum, std::vector<nbr_unit_t>& units,
+             std::vector<int64_t>& offsets) {
+  std::mt19937_64 rng(2021);
+  offsets.assign(1, 0);
+  for (int64_t v = 0; v < vnum; ++v) {
+    int64_t degree = v % 7 == 0 ? 0 : static_cast<int64_t>(rng() % 200);
+    std::vector<nbr_unit_t> nbrs(degree);
+    for (auto& nbr : nbrs) {
+      nbr.vid = rng() % (vnum * 4);
+      nbr.eid = rng() % (vnum * 100);
+    }
+    if (v % 11 == 0 && degree > 0) {
+      nbrs[0].vid = std::numeric_limits<vid_t>::max();
+      nbrs[0].eid = std::numeric_limits<eid_t>::max();
+    }
+    std::sort(nbrs.begin(), nbrs.end(),
+              [](nbr_unit_t const& a, nbr_unit_t const& b) {
+                return a.vid < b.vid || (a.vid == b.vid && a.eid < b.eid);
+              });
+    units.insert(units.end(), nbrs.begin(), nbrs.end());
+    offsets.push_back(static_cast<int64_t>(units.size()));
+  }
+}
+
+void TestCompressCSR() {
+  int64_t vnum = 1000;
+  std::vector<nbr_unit_t> units;
+  std::vector<int64_t> offsets;
+  MakeCSR(vnum, units, offsets);
+
+  PodArrayBuilder<nbr_unit_t> edges_builder;
+  CHECK_ARROW_ERROR(edges_builder.Resize(units.size()));
+  for (size_t i = 0; i < units.size(); ++i) {
+    *edges_builder.MutablePointer(i) = units[i];
+  }
+  CHECK_ARROW_ERROR(edges_builder.Advance(units.size()));
+  std::shared_ptr<arrow::FixedSizeBinaryArray> edges;
+  CHECK_ARROW_ERROR(edges_builder.Finish(&edges));
+  arrow::Int64Builder offsets_builder;
+  CHECK_ARROW_ERROR(offsets_builder.AppendValues(offsets));
+  std::shared_ptr<arrow::Int64Array> edge_offsets;
+  CHECK_ARROW_ERROR(offsets_builder.Finish(&edge_offsets));
+
+  std::shared_ptr<arrow::FixedSizeBinaryArray> compact_edges;
+  std::shared_ptr<arrow::Int64Array> compact_offsets;
+  auto result = compress_csr<vid_t, eid_t>(edges, edge_offsets, 4,
+                                          compact_edges, compact_offsets);
+  CHECK(result);
+  CHECK_EQ(compact_offsets->length(), vnum + 1);
+  CHECK_EQ(compact_offsets->Value(0), 0);
+  CHECK_EQ(compact_edges->length(),
+           compact_offsets->Value(vnum) + varint_padding);
+  CHECK_LT(compact_edges->length(),
+           static_cast<int64_t>(units.size() * sizeof(nbr_unit_t)));
+
+  const uint8_t* data = compact_edges->GetValue(0);
+  std::vector<nbr_unit_t> decoded;
+  for (int64_t v = 0; v < vnum; ++v) {
+    size_t degree = offsets[v + 1] - offsets[v];
+    CompactAdjList<vid_t, eid_t> adj_list(data + compact_offsets->Value(v),
+                                          data + compact_offsets->Value(v + 1),
+                                          degree, nullptr);
+    CHECK_EQ(adj_list.Size(), degree);
+    CHECK_EQ(adj_list.Empty(), degree == 0);
+
+    // the iterator decodes the neighbors on the fly
+    size_t index = 0;
+    for (auto const& nbr : adj_list) {
+      CHECK_LT(index, degree);
+      auto const& unit = units[offsets[v] + index];
+      CHECK_EQ(nbr.neighbor().GetValue(), unit.vid);
+      CHECK_EQ(nbr.edge_id(), unit.eid);
+      ++index;
+    }
+    CHECK_EQ(index, degree);
+
+    // the bulk decoder
+    decoded.resize(degree);
+    adj_list.Decode(decoded.data());
+    for (size_t k = 0; k < degree; ++k) {
+      CHECK_EQ(decoded[k].vid, units[offsets[v] + k].vid);
+      CHECK_EQ(decoded[k].eid, units[offsets[v] + k].eid);
+    }
+  }
+
+  LOG(INFO) << "Passed compress csr test...";
+}
+
+void TestNarrowIdConverter() {
+  using narrow_vid_t = property_graph_types::NARROW_VID_TYPE;
+  for (int label_num : {1, 2, 5, 100}) {
+    NarrowIdConverter<vid_t> converter;
+    converter.Init(4, label_num);
+    IdParser<vid_t> vid_parser;
+    vid_parser.Init(4, label_num);
+    IdParser<narrow_vid_t> narrow_vid_parser;
+    narrow_vid_parser.Init(1, label_num);
+
+    // the local ids of the labels fit up to the narrow offset bits
+    int64_t max_vnum =
+        static_cast<int64_t>(narrow_vid_parser.offset_mask()) + 1;
+    CHECK(converter.Fits(0));
+    CHECK(converter.Fits(max_vnum));
+    CHECK(!converter.Fits(max_vnum + 1));
+
+    for (int label = 0; label < label_num; ++label) {
+      for (int64_t offset : {int64_t(0), int64_t(1), max_vnum / 2,
+                             max_vnum - 1}) {
+        vid_t lid = vid_parser.GenerateId(0, label, offset);
+        narrow_vid_t narrow = converter.Narrow(lid);
+        CHECK_EQ(narrow_vid_parser.GetLabelId(narrow), label);
+        CHECK_EQ(narrow_vid_parser.GetOffset(narrow), offset);
+        CHECK_EQ(converter.Widen(narrow), lid);
+      }
+    }
+  }
+
+  LOG(INFO) << "Passed narrow id converter test...";
+}
+
+void TestNarrowFits() {
+  NarrowIdConverter<vid_t> converter;
+  converter.Init(4, 2);
+  int64_t max_eid_num =
+      std::numeric_limits<property_graph_types::NARROW_EID_TYPE>::max();
+  IdParser<property_graph_types::NARROW_VID_TYPE> narrow_vid_parser;
+  narrow_vid_parser.Init(1, 2);
+  int64_t max_vnum = static_cast<int64_t>(narrow_vid_parser.offset_mask()) + 1;
+
+  CHECK((narrow_fits<vid_t, eid_t>(converter, {0, max_eid_num},
+                                   {0, static_cast<vid_t>(max_vnum)})));
+  // too many edges, or vertices, fall back to the 64-bit layout
+  CHECK(!(narrow_fits<vid_t, eid_t>(converter, {max_eid_num + 1}, {1})));
+  CHECK(!(narrow_fits<vid_t, eid_t>(converter, {1},
+                                    {1, static_cast<vid_t>(max_vnum + 1)})));
+  // the layout that isn't narrower is kept
+  NarrowIdConverter<uint32_t> narrow_converter;
+  narrow_converter.Init(4, 2);
+  CHECK(!(narrow_fits<uint32_t, uint32_t>(narrow_converter, {1}, {1})));
+
+  LOG(INFO) << "Passed narrow fits test...";
+}
+
+void TestNarrowCSR() {
+  using narrow_nbr_unit_t =
+      NbrUnit<property_graph_types::NARROW_VID_TYPE,
+              property_graph_types::NARROW_EID_TYPE>;
+  int label_num = 3;
+  int64_t vnum = 1000;
+  NarrowIdConverter<vid_t> converter;
+  converter.Init(4, label_num);
+  IdParser<vid_t> vid_parser;
+  vid_parser.Init(4, label_num);
+
+  // the neighbors are local ids of every label
+  std::vector<nbr_unit_t> units;
+  std::vector<int64_t> offsets;
+  MakeCSR(vnum, units, offsets);
+  for (size_t i = 0; i < units.size(); ++i) {
+    units[i].vid = vid_parser.GenerateId(0, i % label_num, units[i].vid % vnum);
+    units[i].eid %= vnum * 100;
+  }
+
+  PodArrayBuilder<nbr_unit_t> edges_builder;
+  CHECK_ARROW_ERROR(edges_builder.Resize(units.size()));
+  for (size_t i = 0; i < units.size(); ++i) {
+    *edges_builder.MutablePointer(i) = units[i];
+  }
+  CHECK_ARROW_ERROR(edges_builder.Advance(units.size()));
+  std::shared_ptr<arrow::FixedSizeBinaryArray> edges;
+  CHECK_ARROW_ERROR(edges_builder.Finish(&edges));
+
+  std::shared_ptr<arrow::FixedSizeBinaryArray> narrow_edges;
+  auto result = narrow_csr<vid_t, eid_t>(converter, edges, 4, narrow_edges);
+  CHECK(result);
+  CHECK_EQ(narrow_edges->length(), static_cast<int64_t>(units.size()));
+  CHECK_EQ(narrow_edges->byte_width(), sizeof(narrow_nbr_unit_t));
+
+  const narrow_nbr_unit_t* narrow_units =
+      reinterpret_cast<const narrow_nbr_unit_t*>(narrow_edges->GetValue(0));
+  for (int64_t v = 0; v < vnum; ++v) {
+    NarrowAdjList<vid_t, eid_t> adj_list(narrow_units + offsets[v],
+                                         narrow_units + offsets[v + 1],
+                                         &converter, nullptr);
+    CHECK_EQ(adj_list.Size(), static_cast<size_t>(offsets[v + 1] - offsets[v]));
+    int64_t index = offsets[v];
+    for (auto const& nbr : adj_list) {
+      CHECK_EQ(nbr.neighbor().GetValue(), units[index].vid);
+      CHECK_EQ(nbr.edge_id(), units[index].eid);
+      ++index;
+    }
+    CHECK_EQ(index, offsets[v + 1]);
+  }
+
+  LOG(INFO) << "Passed narrow csr test...";
+}
+
+// the CSR of every label is the same with any concurrency, and matches the
+// neighbors collected sequentially, including self loops and duplicate edges
+void TestGenerateCSR() {
+  int label_num = 3;
+  std::vector<vid_t> tvnums{1000, 300, 1};
+  IdParser<vid_t> vid_parser;
+  vid_parser.Init(1, label_num);
+
+  // more edges than a chunk of the parallel loops
+  std::mt19937_64 rng(2021);
+  auto random_vertex = [&]() {
+    int label = rng() % label_num;
+    return vid_parser.GenerateId(0, label, rng() % tvnums[label]);
+  };
+  std::vector<vid_t> srcs, dsts;
+  for (int64_t i = 0; i < 200000; ++i) {
+    vid_t src = random_vertex(), dst = random_vertex();
+    if (i % 97 == 0) {
+      dst = src;
+    }
+    srcs.push_back(src);
+    dsts.push_back(dst);
+    if (i % 13 == 0) {
+      srcs.push_back(src);
+      dsts.push_back(dst);
+    }
+  }
+  typename ConvertToArrowType<vid_t>::BuilderType src_builder, dst_builder;
+  CHECK_ARROW_ERROR(src_builder.AppendValues(srcs));
+  CHECK_ARROW_ERROR(dst_builder.AppendValues(dsts));
+  std::shared_ptr<typename ConvertToArrowType<vid_t>::ArrayType> src_list,
+      dst_list;
+  CHECK_ARROW_ERROR(src_builder.Finish(&src_list));
+  CHECK_ARROW_ERROR(dst_builder.Finish(&dst_list));
+
+  for (bool undirected : {false, true}) {
+    std::vector<std::vector<std::vector<std::pair<vid_t, eid_t>>>> expected(
+        label_num);
+    for (int label = 0; label < label_num; ++label) {
+      expected[label].resize(tvnums[label]);
+    }
+    for (size_t i = 0; i < srcs.size(); ++i) {
+      expected[vid_parser.GetLabelId(srcs[i])][vid_parser.GetOffset(srcs[i])]
+          .emplace_back(dsts[i], i);
+      if (undirected) {
+        expected[vid_parser.GetLabelId(dsts[i])]
+                [vid_parser.GetOffset(dsts[i])]
+                    .emplace_back(srcs[i], i);
+      }
+    }
+
+    for (int concurrency : {1, 2, 4, 7}) {
+      std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>> edges(
+          label_num);
+      std::vector<std::shared_ptr<arrow::Int64Array>> edge_offsets(label_num);
+      auto result = generate_csr<vid_t, eid_t>(
+          vid_parser, src_list, dst_list, tvnums, label_num, concurrency,
+          undirected, edges, edge_offsets);
+      CHECK(result);
+
+      for (int label = 0; label < label_num; ++label) {
+        auto units =
+            reinterpret_cast<const nbr_unit_t*>(edges[label]->GetValue(0));
+        int64_t offset = 0;
+        CHECK_EQ(edge_offsets[label]->Value(0), 0);
+        for (vid_t v = 0; v < tvnums[label]; ++v) {
+          auto& nbrs = expected[label][v];
+          std::sort(nbrs.begin(), nbrs.end());
+          offset += nbrs.size();
+          CHECK_EQ(edge_offsets[label]->Value(v + 1), offset);
+          int64_t index = edge_offsets[label]->Value(v);
+          for (auto const& nbr : nbrs) {
+            CHECK_EQ(units[index].vid, nbr.first);
+            CHECK_EQ(units[index].eid, nbr.second);
+            ++index;
+          }
+        }
+        CHECK_EQ(edges[label]->length(), offset);
+      }
+    }
+  }
+
+  LOG(INFO) << "Passed generate csr test...";
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage: ./property_graph_utils_test <ipc_socket>\n");
+    return 1;
+  }
+
+  TestVarint();
+  TestGenerateCSR();
+  TestCompressCSR();
+  TestNarrowIdConverter();
+  TestNarrowFits();
+  TestNarrowCSR();
+
+  LOG(INFO) << "Passed property graph utils test...";
+
+  return 0;
+}
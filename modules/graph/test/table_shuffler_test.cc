@@ -0,0 +1,219 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arrow/api.h"
+#include "glog/logging.h"
+#include "grape/worker/comm_spec.h"
+
+#include "basic/ds/arrow_utils.h"
+#include "graph/utils/error.h"
+#include "graph/utils/partitioner.h"
+#include "graph/utils/table_shuffler.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+// the rows of a worker, which are partitioned in many rounds and sent in many
+// chunks
+int64_t RowNum(int worker_id) { return 400000 + worker_id * 12345; }
+
+int64_t FirstId(int worker_id) {
+  int64_t id = 0;
+  for (int i = 0; i < worker_id; ++i) {
+    id += RowNum(i);
+  }
+  return id;
+}
+
+std::shared_ptr<arrow::Table> MakeTable(int worker_id) {
+  arrow::Int64Builder id_builder;
+  arrow::DoubleBuilder value_builder;
+  arrow::StringBuilder name_builder;
+  int64_t begin = FirstId(worker_id), end = begin + RowNum(worker_id);
+  for (int64_t id = begin; id < end; ++id) {
+    CHECK_ARROW_ERROR(id_builder.Append(id));
+    CHECK_ARROW_ERROR(value_builder.Append(id * 0.5));
+    CHECK_ARROW_ERROR(name_builder.Append("v" + std::to_string(id)));
+  }
+  std::shared_ptr<arrow::Array> ids, values, names;
+  CHECK_ARROW_ERROR(id_builder.Finish(&ids));
+  CHECK_ARROW_ERROR(value_builder.Finish(&values));
+  CHECK_ARROW_ERROR(name_builder.Finish(&names));
+  auto schema = arrow::schema({arrow::field("id", arrow::int64()),
+                               arrow::field("value", arrow::float64()),
+                               arrow::field("name", arrow::utf8())});
+  return arrow::Table::Make(schema, {ids, values, names});
+}
+
+boost::leaf::result<std::shared_ptr<arrow::Table>> Shuffle(
+    const grape::CommSpec& comm_spec, std::shared_ptr<arrow::Table>& table) {
+  HashPartitioner<int64_t> partitioner;
+  partitioner.Init(comm_spec.fnum());
+  return ShufflePropertyVertexTable(comm_spec, partitioner, table);
+}
+
+// every worker gets exactly the rows of its fragment, from all workers
+void TestShuffle(const grape::CommSpec& comm_spec) {
+  auto table = MakeTable(comm_spec.worker_id());
+  std::shared_ptr<arrow::Table> shuffled = boost::leaf::try_handle_all(
+      [&]() { return Shuffle(comm_spec, table); },
+      [](const GSError& e) {
+        LOG(FATAL) << e.error_msg;
+        return std::shared_ptr<arrow::Table>();
+      },
+      [](const boost::leaf::error_info& unmatched) {
+        LOG(FATAL) << "Unmatched error " << unmatched;
+        return std::shared_ptr<arrow::Table>();
+      });
+  CHECK(shuffled->schema()->Equals(*table->schema()));
+
+  std::vector<int64_t> expected;
+  int64_t total = FirstId(comm_spec.worker_num());
+  for (int64_t id = 0; id < total; ++id) {
+    if (static_cast<fid_t>(id % comm_spec.fnum()) == comm_spec.fid()) {
+      expected.push_back(id);
+    }
+  }
+  CHECK_EQ(shuffled->num_rows(), static_cast<int64_t>(expected.size()));
+
+  auto ids = std::dynamic_pointer_cast<arrow::Int64Array>(
+      shuffled->column(0)->chunk(0));
+  auto values = std::dynamic_pointer_cast<arrow::DoubleArray>(
+      shuffled->column(1)->chunk(0));
+  auto names = std::dynamic_pointer_cast<arrow::StringArray>(
+      shuffled->column(2)->chunk(0));
+  std::vector<int64_t> actual;
+  for (int64_t i = 0; i < shuffled->num_rows(); ++i) {
+    int64_t id = ids->Value(i);
+    CHECK_EQ(values->Value(i), id * 0.5);
+    CHECK_EQ(names->GetString(i), "v" + std::to_string(id));
+    actual.push_back(id);
+  }
+  std::sort(actual.begin(), actual.end());
+  CHECK(actual == expected);
+}
+
+// every worker streams buffers of many chunks to all the others through a
+// window of two sends, and the buffers of a worker arrive in order
+void TestBoundedStreams(const grape::CommSpec& comm_spec) {
+  int worker_id = comm_spec.worker_id(), worker_num = comm_spec.worker_num();
+  const int buffer_num = 8;
+  auto make_buffer = [](int src, int dst, int index) {
+    std::string content((index + 1) * chunk_size / 3 + src * 7 + dst, 'a');
+    for (size_t i = 0; i < content.size(); i += 4096) {
+      content[i] = static_cast<char>('a' + (src * 31 + dst * 7 + index) % 26);
+    }
+    return arrow::Buffer::FromString(content);
+  };
+
+  std::vector<int> peer_worker_ids;
+  for (int i = 1; i < worker_num; ++i) {
+    peer_worker_ids.push_back((worker_id + i) % worker_num);
+  }
+  std::thread sender_thread([&]() {
+    ArrowBufferSender sender(comm_spec.comm(), peer_worker_ids, 0, 2);
+    for (int index = 0; index < buffer_num; ++index) {
+      for (int dst : peer_worker_ids) {
+        sender.Send(make_buffer(worker_id, dst, index), dst);
+      }
+    }
+  });
+
+  ArrowBufferReceiver receiver(comm_spec.comm(), peer_worker_ids);
+  std::vector<int> received(worker_num, 0);
+  int src_worker_id = 0;
+  std::shared_ptr<arrow::Buffer> buffer;
+  while (true) {
+    auto has_next = receiver.Next(src_worker_id, buffer);
+    CHECK(has_next);
+    if (!has_next.value()) {
+      break;
+    }
+    int index = received[src_worker_id]++;
+    CHECK(buffer->Equals(*make_buffer(src_worker_id, worker_id, index)));
+  }
+  sender_thread.join();
+  for (int src : peer_worker_ids) {
+    CHECK_EQ(received[src], buffer_num);
+  }
+}
+
+// a worker fails to partition its table, which still ends its streams, thus
+// the others finish the shuffle
+void TestFailure(const grape::CommSpec& comm_spec) {
+  std::shared_ptr<arrow::Table> table;
+  if (comm_spec.worker_id() == 0) {
+    // the boolean columns cannot be gathered
+    arrow::Int64Builder id_builder;
+    arrow::BooleanBuilder flag_builder;
+    for (int64_t id = 0; id < 1000; ++id) {
+      CHECK_ARROW_ERROR(id_builder.Append(id));
+      CHECK_ARROW_ERROR(flag_builder.Append(id % 2 == 0));
+    }
+    std::shared_ptr<arrow::Array> ids, flags;
+    CHECK_ARROW_ERROR(id_builder.Finish(&ids));
+    CHECK_ARROW_ERROR(flag_builder.Finish(&flags));
+    table = arrow::Table::Make(
+        arrow::schema({arrow::field("id", arrow::int64()),
+                       arrow::field("flag", arrow::boolean())}),
+        {ids, flags});
+  } else {
+    table = MakeTable(comm_spec.worker_id());
+  }
+
+  bool failed = boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<bool> {
+        BOOST_LEAF_CHECK(Shuffle(comm_spec, table));
+        return false;
+      },
+      [](const GSError& e) { return true; },
+      [](const boost::leaf::error_info& unmatched) {
+        LOG(FATAL) << "Unmatched error " << unmatched;
+        return true;
+      });
+  CHECK_EQ(failed, comm_spec.worker_id() == 0);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage: ./table_shuffler_test <ipc_socket>\n");
+    return 1;
+  }
+
+  grape::InitMPIComm();
+  {
+    grape::CommSpec comm_spec;
+    comm_spec.Init(MPI_COMM_WORLD);
+
+    TestBoundedStreams(comm_spec);
+    TestShuffle(comm_spec);
+    TestFailure(comm_spec);
+    // the streams of the failed shuffle don't leak into the next one
+    TestShuffle(comm_spec);
+
+    LOG(INFO) << "[worker-" << comm_spec.worker_id()
+              << "] Passed table shuffler test...";
+  }
+  grape::FinalizeMPIComm();
+
+  return 0;
+}
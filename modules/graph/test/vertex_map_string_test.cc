@@ -15,6 +15,7 @@ limitations under the License.
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -24,6 +25,8 @@ limitations under the License.
 #include "glog/logging.h"
 
 #include "client/client.h"
+#include "common/util/typename.h"
+#include "graph/utils/partitioner.h"
 #include "graph/vertex_map/arrow_vertex_map.h"
 #include "io/io/local_io_adaptor.h"
 
@@ -68,6 +71,194 @@ void loadVertices(
   }
 }
 
+// probes the index directly, including the duplicated and the missing oids
+void TestStringOidIndex() {
+  // the hash of the sealed index is fixed, whichever the build
+  CHECK_EQ(detail::murmur_hash64a("", 0), 0ULL);
+  CHECK_EQ(detail::murmur_hash64a("vineyard", 8), 0xf6468687bdc4dbcbULL);
+  CHECK_EQ(detail::murmur_hash64a("hello, world", 12), 0x9659ad0699a8465fULL);
+
+  arrow::StringBuilder builder;
+  std::vector<std::string> oids;
+  for (int k = 0; k < 1000; ++k) {
+    oids.push_back("v" + std::to_string(k));
+  }
+  oids.push_back("");
+  oids.push_back("v7");  // a duplicate, the first one is found
+  for (auto const& oid : oids) {
+    CHECK_ARROW_ERROR(builder.Append(oid));
+  }
+  std::shared_ptr<arrow::StringArray> array;
+  CHECK_ARROW_ERROR(builder.Finish(&array));
+
+  size_t capacity = detail::string_oid_index_capacity(array->length());
+  CHECK_EQ(capacity, 2048);
+  std::vector<int64_t> slots(capacity);
+  detail::string_oid_index_build(*array, slots.data(), capacity);
+  CHECK_EQ(std::count(slots.begin(), slots.end(), -1),
+           static_cast<int64_t>(capacity) - array->length());
+
+  for (int64_t k = 0; k < array->length() - 1; ++k) {
+    CHECK_EQ(detail::string_oid_index_find(slots.data(), capacity, *array,
+                                           oids[k]),
+             k);
+  }
+  CHECK_EQ(
+      detail::string_oid_index_find(slots.data(), capacity, *array, "v7"), 7);
+  CHECK_EQ(
+      detail::string_oid_index_find(slots.data(), capacity, *array, "v1000"),
+      -1);
+  CHECK_EQ(detail::string_oid_index_find(slots.data(), capacity, *array, "v"),
+           -1);
+
+  LOG(INFO) << "Passed string oid index test...";
+}
+
+void CheckVertexMap(
+    std::shared_ptr<ArrowVertexMap<arrow::util::string_view, uint64_t>> const&
+        vm_ptr,
+    vineyard::fid_t fnum, int vertex_label_num, bool dump) {
+  vineyard::IdParser<uint64_t> id_parser;
+  id_parser.Init(fnum, vertex_label_num);
+
+  for (vineyard::fid_t i = 0; i < fnum; ++i) {
+    for (int j = 0; j < vertex_label_num; ++j) {
+      std::ofstream fout;
+      if (dump) {
+        fout.open("./vm_" + std::to_string(i) + "_" + std::to_string(j));
+      }
+
+      uint64_t vnum = vm_ptr->vertices_num(i, j);
+      for (uint64_t k = 0; k < vnum; ++k) {
+        uint64_t gid = id_parser.GenerateId(i, j, k);
+        arrow::util::string_view oid;
+        CHECK(vm_ptr->GetOid(gid, oid));
+        uint64_t mapped_gid;
+        CHECK(vm_ptr->GetGid(i, oid, mapped_gid));
+        CHECK_EQ(mapped_gid, gid);
+        CHECK(vm_ptr->GetGid(oid, mapped_gid));
+        CHECK_EQ(mapped_gid, gid);
+
+        if (dump) {
+          fout << oid << std::endl;
+        }
+      }
+    }
+  }
+}
+
+// the oids are hash partitioned, thus the lookups by oid are routed to the
+// owning fragment
+void TestHashPartitioned(vineyard::Client& client) {
+  vineyard::fid_t fnum = 4;
+  int vertex_label_num = 2;
+  int64_t vnum = 10000;
+  // as the loader partitions the oids
+  HashPartitioner<std::string> partitioner;
+  partitioner.Init(fnum);
+
+  std::vector<std::vector<std::shared_ptr<arrow::StringArray>>> oid_lists(
+      vertex_label_num);
+  for (int i = 0; i < vertex_label_num; ++i) {
+    std::vector<arrow::StringBuilder> builders(fnum);
+    for (int64_t k = 0; k < vnum; ++k) {
+      std::string oid = "v" + std::to_string(i) + "_" + std::to_string(k);
+      CHECK_ARROW_ERROR(
+          builders[partitioner.GetPartitionId(oid)].Append(oid));
+    }
+    oid_lists[i].resize(fnum);
+    for (vineyard::fid_t j = 0; j < fnum; ++j) {
+      CHECK_ARROW_ERROR(builders[j].Finish(&oid_lists[i][j]));
+    }
+  }
+
+  BasicArrowVertexMapBuilder<arrow::util::string_view, uint64_t> vm_builder(
+      client, fnum, vertex_label_num, oid_lists);
+  vm_builder.set_partitioner(
+      HashPartitioner<arrow::util::string_view>::type());
+  auto vm_ptr = std::dynamic_pointer_cast<
+      ArrowVertexMap<arrow::util::string_view, uint64_t>>(
+      client.GetObject(vm_builder.Seal(client)->id()));
+  CHECK(vm_ptr != nullptr);
+
+  vineyard::IdParser<uint64_t> id_parser;
+  id_parser.Init(fnum, vertex_label_num);
+  for (int i = 0; i < vertex_label_num; ++i) {
+    for (int64_t k = 0; k < vnum; ++k) {
+      std::string oid = "v" + std::to_string(i) + "_" + std::to_string(k);
+      uint64_t gid;
+      CHECK(vm_ptr->GetGid(oid, gid));
+      CHECK_EQ(id_parser.GetFid(gid), partitioner.GetPartitionId(oid));
+      CHECK_EQ(id_parser.GetLabelId(gid), i);
+      arrow::util::string_view mapped_oid;
+      CHECK(vm_ptr->GetOid(gid, mapped_oid));
+      CHECK(mapped_oid == oid);
+    }
+  }
+  uint64_t gid;
+  CHECK(!vm_ptr->GetGid("v" + std::to_string(vertex_label_num) + "_0", gid));
+
+  LOG(INFO) << "Passed hash partitioned vertex map with string oid test...";
+}
+
+// the fragments and labels of unequal sizes, including an empty one, are
+// built by many threads, and every vertex is found by its oid and gid
+void TestParallelBuild(vineyard::Client& client) {
+  vineyard::fid_t fnum = 5;
+  int vertex_label_num = 3;
+
+  for (int concurrency : {1, 3, 16}) {
+    std::vector<std::vector<std::shared_ptr<arrow::StringArray>>> oid_lists(
+        vertex_label_num);
+    int64_t next_oid = 0;
+    for (int i = 0; i < vertex_label_num; ++i) {
+      oid_lists[i].resize(fnum);
+      for (vineyard::fid_t j = 0; j < fnum; ++j) {
+        arrow::StringBuilder builder;
+        int64_t vnum = (i == 2 && j == 0) ? 0 : (i + 1) * (j * 700 + 1);
+        for (int64_t k = 0; k < vnum; ++k) {
+          std::string oid = "v" + std::to_string(next_oid++);
+          CHECK_ARROW_ERROR(builder.Append(oid));
+        }
+        CHECK_ARROW_ERROR(builder.Finish(&oid_lists[i][j]));
+      }
+    }
+
+    BasicArrowVertexMapBuilder<arrow::util::string_view, uint64_t> vm_builder(
+        client, fnum, vertex_label_num, oid_lists);
+    vm_builder.set_concurrency(concurrency);
+    auto vm_ptr = std::dynamic_pointer_cast<
+        ArrowVertexMap<arrow::util::string_view, uint64_t>>(
+        client.GetObject(vm_builder.Seal(client)->id()));
+    CHECK(vm_ptr != nullptr);
+
+    vineyard::IdParser<uint64_t> id_parser;
+    id_parser.Init(fnum, vertex_label_num);
+    for (int i = 0; i < vertex_label_num; ++i) {
+      for (vineyard::fid_t j = 0; j < fnum; ++j) {
+        auto const& oids = oid_lists[i][j];
+        CHECK_EQ(vm_ptr->vertices_num(j, i),
+                 static_cast<uint64_t>(oids->length()));
+        for (int64_t k = 0; k < oids->length(); ++k) {
+          auto oid = oids->GetView(k);
+          uint64_t gid = id_parser.GenerateId(j, i, k), mapped_gid;
+          CHECK(vm_ptr->GetGid(oid, mapped_gid));
+          CHECK_EQ(mapped_gid, gid);
+          CHECK(vm_ptr->GetGid(j, oid, mapped_gid));
+          CHECK_EQ(mapped_gid, gid);
+          arrow::util::string_view mapped_oid;
+          CHECK(vm_ptr->GetOid(gid, mapped_oid));
+          CHECK(mapped_oid == oid);
+        }
+      }
+    }
+    uint64_t gid;
+    CHECK(!vm_ptr->GetGid("v" + std::to_string(next_oid), gid));
+  }
+
+  LOG(INFO) << "Passed parallel built vertex map with string oid test...";
+}
+
 int main(int argc, char** argv) {
   if (argc < 5) {
     printf(
@@ -85,6 +276,8 @@ int main(int argc, char** argv) {
 
   LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
 
+  TestStringOidIndex();
+
   vineyard::ObjectID vm_id;
   {
     std::vector<std::vector<std::shared_ptr<arrow::Table>>> v_tables;
@@ -130,28 +323,37 @@ int main(int argc, char** argv) {
       ArrowVertexMap<arrow::util::string_view, uint64_t>>(
       client.GetObject(vm_id));
 
-  vineyard::IdParser<uint64_t> id_parser;
-  id_parser.Init(fnum, vertex_label_num);
-
-  for (vineyard::fid_t i = 0; i < fnum; ++i) {
-    for (int j = 0; j < vertex_label_num; ++j) {
-      std::string path = "./vm_" + std::to_string(i) + "_" + std::to_string(j);
-      std::ofstream fout;
-      fout.open(path);
-
-      uint64_t vnum = vm_ptr->vertices_num(i, j);
-      for (uint64_t k = 0; k < vnum; ++k) {
-        uint64_t gid = id_parser.GenerateId(i, j, k);
-        arrow::util::string_view oid;
-        CHECK(vm_ptr->GetOid(gid, oid));
+  CheckVertexMap(vm_ptr, fnum, vertex_label_num, true);
 
-        fout << oid << std::endl;
+  // a vertex map sealed without the o2g index is indexed in place
+  {
+    ObjectMeta legacy_meta;
+    legacy_meta.SetTypeName(
+        type_name<ArrowVertexMap<arrow::util::string_view, uint64_t>>());
+    legacy_meta.AddKeyValue("fnum", fnum);
+    legacy_meta.AddKeyValue("label_num",
+                            static_cast<property_graph_types::LABEL_ID_TYPE>(
+                                vertex_label_num));
+    for (vineyard::fid_t i = 0; i < fnum; ++i) {
+      for (int j = 0; j < vertex_label_num; ++j) {
+        std::string name =
+            "oid_arrays_" + std::to_string(i) + "_" + std::to_string(j);
+        legacy_meta.AddMember(name, vm_ptr->meta().GetMemberMeta(name));
       }
-
-      fout.close();
     }
+    legacy_meta.SetNBytes(0);
+    ObjectID legacy_id;
+    VINEYARD_CHECK_OK(client.CreateMetaData(legacy_meta, legacy_id));
+    auto legacy_vm_ptr = std::dynamic_pointer_cast<
+        ArrowVertexMap<arrow::util::string_view, uint64_t>>(
+        client.GetObject(legacy_id));
+    CHECK(legacy_vm_ptr != nullptr);
+    CheckVertexMap(legacy_vm_ptr, fnum, vertex_label_num, false);
   }
 
+  TestHashPartitioned(client);
+  TestParallelBuild(client);
+
   LOG(INFO) << "Passed arrow vertex map with string oid test...";
 
   return 0;
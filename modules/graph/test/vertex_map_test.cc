@@ -24,6 +24,7 @@ limitations under the License.
 #include "glog/logging.h"
 
 #include "client/client.h"
+#include "graph/utils/partitioner.h"
 #include "graph/vertex_map/arrow_vertex_map.h"
 #include "io/io/local_io_adaptor.h"
 
@@ -68,6 +69,114 @@ void loadVertices(
   }
 }
 
+// the oids are hash partitioned, thus the lookups by oid are routed to the
+// owning fragment
+void TestHashPartitioned(vineyard::Client& client) {
+  vineyard::fid_t fnum = 4;
+  int vertex_label_num = 2;
+  int64_t vnum = 10000;
+  HashPartitioner<int64_t> partitioner;
+  partitioner.Init(fnum);
+
+  std::vector<std::vector<std::shared_ptr<arrow::Int64Array>>> oid_lists(
+      vertex_label_num);
+  for (int i = 0; i < vertex_label_num; ++i) {
+    std::vector<arrow::Int64Builder> builders(fnum);
+    for (int64_t k = 0; k < vnum; ++k) {
+      int64_t oid = i * vnum + k;
+      CHECK_ARROW_ERROR(
+          builders[partitioner.GetPartitionId(oid)].Append(oid));
+    }
+    oid_lists[i].resize(fnum);
+    for (vineyard::fid_t j = 0; j < fnum; ++j) {
+      CHECK_ARROW_ERROR(builders[j].Finish(&oid_lists[i][j]));
+    }
+  }
+
+  BasicArrowVertexMapBuilder<int64_t, uint64_t> vm_builder(
+      client, fnum, vertex_label_num, oid_lists);
+  vm_builder.set_partitioner(HashPartitioner<int64_t>::type());
+  auto vm_ptr = std::dynamic_pointer_cast<ArrowVertexMap<int64_t, uint64_t>>(
+      client.GetObject(vm_builder.Seal(client)->id()));
+  CHECK(vm_ptr != nullptr);
+
+  vineyard::IdParser<uint64_t> id_parser;
+  id_parser.Init(fnum, vertex_label_num);
+  for (int i = 0; i < vertex_label_num; ++i) {
+    for (int64_t k = 0; k < vnum; ++k) {
+      int64_t oid = i * vnum + k, mapped_oid;
+      uint64_t gid;
+      CHECK(vm_ptr->GetGid(oid, gid));
+      CHECK_EQ(id_parser.GetFid(gid), partitioner.GetPartitionId(oid));
+      CHECK_EQ(id_parser.GetLabelId(gid), i);
+      CHECK(vm_ptr->GetOid(gid, mapped_oid));
+      CHECK_EQ(mapped_oid, oid);
+    }
+  }
+  uint64_t gid;
+  CHECK(!vm_ptr->GetGid(vertex_label_num * vnum, gid));
+
+  LOG(INFO) << "Passed hash partitioned vertex map test...";
+}
+
+// the fragments and labels of unequal sizes, including an empty one, are
+// built by many threads, and every vertex is found by its oid and gid
+void TestParallelBuild(vineyard::Client& client) {
+  vineyard::fid_t fnum = 5;
+  int vertex_label_num = 3;
+
+  for (int concurrency : {1, 3, 16}) {
+    std::vector<std::vector<std::shared_ptr<arrow::Int64Array>>> oid_lists(
+        vertex_label_num);
+    int64_t next_oid = 0;
+    for (int i = 0; i < vertex_label_num; ++i) {
+      oid_lists[i].resize(fnum);
+      for (vineyard::fid_t j = 0; j < fnum; ++j) {
+        arrow::Int64Builder builder;
+        int64_t vnum = (i == 2 && j == 0) ? 0 : (i + 1) * (j * 700 + 1);
+        for (int64_t k = 0; k < vnum; ++k) {
+          int64_t oid = next_oid++;
+          CHECK_ARROW_ERROR(builder.Append(oid));
+        }
+        CHECK_ARROW_ERROR(builder.Finish(&oid_lists[i][j]));
+      }
+    }
+
+    BasicArrowVertexMapBuilder<int64_t, uint64_t> vm_builder(
+        client, fnum, vertex_label_num, oid_lists);
+    vm_builder.set_concurrency(concurrency);
+    auto vm_ptr =
+        std::dynamic_pointer_cast<ArrowVertexMap<int64_t, uint64_t>>(
+            client.GetObject(vm_builder.Seal(client)->id()));
+    CHECK(vm_ptr != nullptr);
+
+    vineyard::IdParser<uint64_t> id_parser;
+    id_parser.Init(fnum, vertex_label_num);
+    for (int i = 0; i < vertex_label_num; ++i) {
+      for (vineyard::fid_t j = 0; j < fnum; ++j) {
+        auto const& oids = oid_lists[i][j];
+        CHECK_EQ(vm_ptr->vertices_num(j, i),
+                 static_cast<uint64_t>(oids->length()));
+        for (int64_t k = 0; k < oids->length(); ++k) {
+          auto oid = oids->Value(k);
+          uint64_t gid = id_parser.GenerateId(j, i, k), mapped_gid;
+          CHECK(vm_ptr->GetGid(oid, mapped_gid));
+          CHECK_EQ(mapped_gid, gid);
+          CHECK(vm_ptr->GetGid(j, oid, mapped_gid));
+          CHECK_EQ(mapped_gid, gid);
+          int64_t mapped_oid;
+          CHECK(vm_ptr->GetOid(gid, mapped_oid));
+          CHECK_EQ(mapped_oid, oid);
+        }
+      }
+    }
+    uint64_t gid;
+    CHECK(!vm_ptr->GetGid(next_oid, gid));
+  }
+
+  LOG(INFO) << "Passed parallel built vertex map test...";
+}
+
 int main(int argc, char** argv) {
   if (argc < 5) {
     printf(
@@ -143,6 +252,11 @@ int main(int argc, char** argv) {
         uint64_t gid = id_parser.GenerateId(i, j, k);
         int64_t oid;
         CHECK(vm_ptr->GetOid(gid, oid));
+        uint64_t mapped_gid;
+        CHECK(vm_ptr->GetGid(i, oid, mapped_gid));
+        CHECK_EQ(mapped_gid, gid);
+        CHECK(vm_ptr->GetGid(oid, mapped_gid));
+        CHECK_EQ(mapped_gid, gid);
 
         fout << oid << std::endl;
       }
@@ -151,6 +265,9 @@ int main(int argc, char** argv) {
     }
   }
 
+  TestHashPartitioned(client);
+  TestParallelBuild(client);
+
   LOG(INFO) << "Passed arrow vertex map test...";
 
   return 0;
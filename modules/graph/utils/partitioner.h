@@ -16,7 +16,13 @@ limitations under the License.
 #ifndef MODULES_GRAPH_UTILS_PARTITIONER_H_
 #define MODULES_GRAPH_UTILS_PARTITIONER_H_
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
 #include <string>
 #include <utility>
 #include <vector>
@@ -26,7 +32,10 @@ limitations under the License.
 #include "folly/dynamic.h"
 #endif
 
+#include "grape/worker/comm_spec.h"
+
 #include "graph/fragment/property_graph_types.h"
+#include "graph/utils/error.h"
 
 namespace vineyard {
 
@@ -40,6 +49,8 @@ class HashPartitioner {
 
   void Init(fid_t fnum) { fnum_ = fnum; }
 
+  static std::string type() { return "hash"; }
+
   inline fid_t GetPartitionId(const OID_T& oid) const {
     return static_cast<fid_t>(static_cast<uint64_t>(oid) % fnum_);
   }
@@ -73,6 +84,8 @@ class HashPartitioner<std::string> {
 
   void Init(fid_t fnum) { fnum_ = fnum; }
 
+  static std::string type() { return "hash"; }
+
   inline fid_t GetPartitionId(const oid_t& oid) const {
     return static_cast<fid_t>(
         static_cast<uint64_t>(std::hash<std::string>()(oid)) % fnum_);
@@ -98,6 +111,31 @@ class HashPartitioner<std::string> {
   fid_t fnum_;
 };
 
+/**
+ * The partitioner of the internal string oids, e.g., of the vertex map, which
+ * agrees with HashPartitioner<std::string> as the hash of a string view is the
+ * hash of the string.
+ */
+template <>
+class HashPartitioner<arrow::util::string_view> {
+ public:
+  using oid_t = arrow::util::string_view;
+
+  HashPartitioner() : fnum_(1) {}
+
+  void Init(fid_t fnum) { fnum_ = fnum; }
+
+  static std::string type() { return "hash"; }
+
+  inline fid_t GetPartitionId(const oid_t& oid) const {
+    return static_cast<fid_t>(
+        static_cast<uint64_t>(std::hash<oid_t>()(oid)) % fnum_);
+  }
+
+ private:
+  fid_t fnum_;
+};
+
 #ifdef EXPERIMENTAL_ON
 template <>
 class HashPartitioner<folly::dynamic> {
@@ -108,6 +146,8 @@ class HashPartitioner<folly::dynamic> {
 
   void Init(fid_t fnum) { fnum_ = fnum; }
 
+  static std::string type() { return "hash"; }
+
   inline fid_t GetPartitionId(const oid_t& oid) const {
     size_t hash_value;
     if (oid.isInt()) {
@@ -148,6 +188,8 @@ class SegmentedPartitioner {
 
   SegmentedPartitioner() : fnum_(1) {}
 
+  static std::string type() { return "segmented"; }
+
   void Init(fid_t fnum, const std::vector<OID_T>& oid_list) {
     fnum_ = fnum;
     size_t vnum = oid_list.size();
@@ -184,6 +226,295 @@ class SegmentedPartitioner {
   ska::flat_hash_map<OID_T, fid_t> o2f_;
 };
 
+/**
+ * @brief DegreePartitioner balances the edges of fragments: vertices are
+ * assigned in the descending order of degrees, each to the fragment with the
+ * least load so far, where a vertex weighs its degree plus one.
+ *
+ * `degrees[i]` is the degree of `oid_list[i]`, and both must be identical on
+ * all workers.
+ */
+template <typename OID_T>
+class DegreePartitioner {
+ public:
+  using oid_t = OID_T;
+
+  DegreePartitioner() : fnum_(1) {}
+
+  static std::string type() { return "degree"; }
+
+  void Init(fid_t fnum, const std::vector<OID_T>& oid_list,
+            const std::vector<int64_t>& degrees) {
+    fnum_ = fnum;
+    size_t vnum = oid_list.size();
+    std::vector<size_t> order(vnum);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+      return degrees[lhs] > degrees[rhs];
+    });
+
+    using load_t = std::pair<int64_t, fid_t>;
+    std::priority_queue<load_t, std::vector<load_t>, std::greater<load_t>>
+        loads;
+    for (fid_t fid = 0; fid < fnum_; ++fid) {
+      loads.emplace(0, fid);
+    }
+    o2f_.reserve(vnum);
+    for (size_t i : order) {
+      load_t load = loads.top();
+      loads.pop();
+      o2f_.emplace(oid_list[i], load.second);
+      load.first += degrees[i] + 1;
+      loads.push(load);
+    }
+  }
+
+  inline fid_t GetPartitionId(const OID_T& oid) const { return o2f_.at(oid); }
+
+  DegreePartitioner& operator=(const DegreePartitioner& other) {
+    if (this == &other) {
+      return *this;
+    }
+    fnum_ = other.fnum_;
+    o2f_ = other.o2f_;
+    return *this;
+  }
+
+  DegreePartitioner& operator=(DegreePartitioner&& other) {
+    if (this == &other) {
+      return *this;
+    }
+    fnum_ = other.fnum_;
+    o2f_ = std::move(other.o2f_);
+    return *this;
+  }
+
+ private:
+  fid_t fnum_;
+  ska::flat_hash_map<OID_T, fid_t> o2f_;
+};
+
+namespace detail {
+
+/**
+ * @brief Place the vertices one by one in the order of indices, each to the
+ * fragment with the highest `score(placed neighbors, load)` among the ones
+ * under `capacity`, breaking ties by the least load. A vertex weighs its
+ * degree plus one, the neighbors of vertex `i` are
+ * `nbrs[nbr_offsets[i], nbr_offsets[i + 1])`.
+ */
+template <typename SCORE_T>
+std::vector<fid_t> stream_partition(fid_t fnum,
+                                    const std::vector<int64_t>& nbr_offsets,
+                                    const std::vector<int64_t>& nbrs,
+                                    double capacity, const SCORE_T& score) {
+  size_t vnum = nbr_offsets.size() - 1;
+  std::vector<fid_t> assignment(vnum, -1);
+  std::vector<double> loads(fnum, 0);
+  std::vector<int64_t> placed(fnum, 0);
+  for (size_t v = 0; v < vnum; ++v) {
+    std::fill(placed.begin(), placed.end(), 0);
+    for (int64_t i = nbr_offsets[v]; i < nbr_offsets[v + 1]; ++i) {
+      fid_t fid = assignment[nbrs[i]];
+      if (fid != -1) {
+        ++placed[fid];
+      }
+    }
+    double weight =
+        static_cast<double>(nbr_offsets[v + 1] - nbr_offsets[v] + 1);
+    fid_t best = -1;
+    double best_score = 0;
+    for (int round = 0; round < 2 && best == -1; ++round) {
+      // the second round ignores the capacity, for the heavy vertices
+      for (fid_t fid = 0; fid < fnum; ++fid) {
+        if (round == 0 && loads[fid] + weight > capacity) {
+          continue;
+        }
+        double fid_score = score(placed[fid], loads[fid]);
+        if (best == -1 || fid_score > best_score ||
+            (fid_score == best_score && loads[fid] < loads[best])) {
+          best = fid;
+          best_score = fid_score;
+        }
+      }
+    }
+    assignment[v] = best;
+    loads[best] += weight;
+  }
+  return assignment;
+}
+
+}  // namespace detail
+
+/**
+ * @brief StreamingPartitioner places vertices in the order of the oid list,
+ * each to the fragment that holds most of its placed neighbors, penalized by
+ * the load of the fragment, where a vertex weighs its degree plus one thus the
+ * fragments are balanced by edges:
+ *
+ * - "ldg", linear deterministic greedy: |N(v) & P| * (1 - w(P) / C), where
+ *   C = slack * w(V) / fnum is the capacity of a fragment;
+ * - "fennel": |N(v) & P| - alpha * gamma * w'(P) ^ (gamma - 1), where w' is
+ *   the load in units of the average vertex weight, gamma = 1.5 and
+ *   alpha = sqrt(fnum) * |E| / |V| ^ gamma, and fragments are capped by C as
+ *   well.
+ *
+ * Fennel is used unless `fennel` is false. The neighbors of `oid_list[i]` are
+ * given as their indices in the oid list, i.e.,
+ * `nbrs[nbr_offsets[i], nbr_offsets[i + 1])`, which must be identical on all
+ * workers.
+ *
+ * N.B.: every worker holds the edges of the whole graph, as gathered by
+ * `AllgatherEdges`, and their CSR, i.e., about 32 bytes per edge, thus the
+ * graph must fit in the memory of a single worker, and has at most INT_MAX / 2
+ * edges.
+ */
+template <typename OID_T>
+class StreamingPartitioner {
+ public:
+  using oid_t = OID_T;
+
+  StreamingPartitioner() : fnum_(1) {}
+
+  static std::string type() { return "streaming"; }
+
+  void Init(fid_t fnum, const std::vector<OID_T>& oid_list,
+            const std::vector<int64_t>& nbr_offsets,
+            const std::vector<int64_t>& nbrs, bool fennel = true,
+            double slack = 1.1) {
+    fnum_ = fnum;
+    double vnum = static_cast<double>(oid_list.size());
+    double total_weight = vnum + static_cast<double>(nbrs.size());
+    double capacity = slack * total_weight / fnum_;
+
+    std::vector<fid_t> assignment;
+    if (fennel) {
+      const double gamma = 1.5;
+      double alpha = std::sqrt(static_cast<double>(fnum_)) *
+                     (static_cast<double>(nbrs.size()) / 2) /
+                     std::pow(std::max(vnum, 1.0), gamma);
+      double unit = std::max(total_weight / std::max(vnum, 1.0), 1.0);
+      assignment = detail::stream_partition(
+          fnum_, nbr_offsets, nbrs, capacity,
+          [alpha, gamma, unit](int64_t placed, double load) {
+            return static_cast<double>(placed) -
+                   alpha * gamma * std::pow(load / unit, gamma - 1);
+          });
+    } else {
+      assignment = detail::stream_partition(
+          fnum_, nbr_offsets, nbrs, capacity,
+          [capacity](int64_t placed, double load) {
+            return static_cast<double>(placed) * (1 - load / capacity);
+          });
+    }
+
+    o2f_.reserve(oid_list.size());
+    for (size_t i = 0; i < oid_list.size(); ++i) {
+      o2f_.emplace(oid_list[i], assignment[i]);
+    }
+  }
+
+  inline fid_t GetPartitionId(const OID_T& oid) const { return o2f_.at(oid); }
+
+  StreamingPartitioner& operator=(const StreamingPartitioner& other) {
+    if (this == &other) {
+      return *this;
+    }
+    fnum_ = other.fnum_;
+    o2f_ = other.o2f_;
+    return *this;
+  }
+
+  StreamingPartitioner& operator=(StreamingPartitioner&& other) {
+    if (this == &other) {
+      return *this;
+    }
+    fnum_ = other.fnum_;
+    o2f_ = std::move(other.o2f_);
+    return *this;
+  }
+
+ private:
+  fid_t fnum_;
+  ska::flat_hash_map<OID_T, fid_t> o2f_;
+};
+
+/**
+ * @brief Sum up the local degrees of the oid list on all workers, in place.
+ */
+inline void AllreduceDegrees(std::vector<int64_t>& degrees,
+                             const grape::CommSpec& comm_spec) {
+  // in batches, as MPI takes an int count
+  const int64_t batch_size = 1 << 28;
+  int64_t vnum = static_cast<int64_t>(degrees.size());
+  for (int64_t begin = 0; begin < vnum; begin += batch_size) {
+    int count = static_cast<int>(std::min(vnum - begin, batch_size));
+    MPI_Allreduce(MPI_IN_PLACE, &degrees[begin], count, MPI_INT64_T, MPI_SUM,
+                  comm_spec.comm());
+  }
+}
+
+/**
+ * @brief Gather the local edges, as pairs of indices in the oid list, of all
+ * workers in the order of worker ids, in place.
+ *
+ * The counts of MPI are ints, thus the edges of all workers are limited to
+ * INT_MAX indices, i.e., INT_MAX / 2 edges, and an error is raised on every
+ * worker beyond that, rather than overflowing.
+ */
+inline boost::leaf::result<void> AllgatherEdges(
+    std::vector<int64_t>& edges, const grape::CommSpec& comm_spec) {
+  if (static_cast<int64_t>(edges.size()) > std::numeric_limits<int>::max()) {
+    RETURN_GS_ERROR(ErrorCode::kInvalidOperationError,
+                    "Too many local edges for streaming partitioning");
+  }
+  int count = static_cast<int>(edges.size());
+  std::vector<int> counts(comm_spec.worker_num());
+  MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT,
+                comm_spec.comm());
+  int64_t total = 0;
+  for (int c : counts) {
+    total += c;
+  }
+  if (total > std::numeric_limits<int>::max()) {
+    RETURN_GS_ERROR(ErrorCode::kInvalidOperationError,
+                    "Too many edges for streaming partitioning: " +
+                        std::to_string(total / 2) + " edges, at most " +
+                        std::to_string(std::numeric_limits<int>::max() / 2));
+  }
+  std::vector<int> displs(comm_spec.worker_num(), 0);
+  for (int i = 1; i < comm_spec.worker_num(); ++i) {
+    displs[i] = displs[i - 1] + counts[i - 1];
+  }
+  std::vector<int64_t> all_edges(total);
+  MPI_Allgatherv(edges.data(), count, MPI_INT64_T, all_edges.data(),
+                 counts.data(), displs.data(), MPI_INT64_T, comm_spec.comm());
+  edges.swap(all_edges);
+  return boost::leaf::result<void>();
+}
+
+/**
+ * @brief The CSR of both directions of the edges, in the order of edges, as
+ * the neighbors taken by StreamingPartitioner.
+ */
+inline void GenerateNeighbors(size_t vnum, const std::vector<int64_t>& edges,
+                              std::vector<int64_t>& nbr_offsets,
+                              std::vector<int64_t>& nbrs) {
+  nbr_offsets.assign(vnum + 1, 0);
+  for (int64_t index : edges) {
+    ++nbr_offsets[index + 1];
+  }
+  for (size_t i = 0; i < vnum; ++i) {
+    nbr_offsets[i + 1] += nbr_offsets[i];
+  }
+  std::vector<int64_t> cursors(nbr_offsets.begin(), nbr_offsets.end() - 1);
+  nbrs.resize(edges.size());
+  for (size_t i = 0; i < edges.size(); i += 2) {
+    nbrs[cursors[edges[i]]++] = edges[i + 1];
+    nbrs[cursors[edges[i + 1]]++] = edges[i];
+  }
+}
+
 }  // namespace vineyard
 
 #endif  // MODULES_GRAPH_UTILS_PARTITIONER_H_
@@ -16,9 +16,12 @@ limitations under the License.
 #ifndef MODULES_GRAPH_UTILS_TABLE_SHUFFLER_H_
 #define MODULES_GRAPH_UTILS_TABLE_SHUFFLER_H_
 
+#include <algorithm>
+#include <deque>
 #include <future>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -26,12 +29,21 @@ limitations under the License.
 #include "grape/communication/sync_comm.h"
 #include "grape/worker/comm_spec.h"
 
+#include "basic/ds/arrow_utils.h"
+#include "graph/fragment/property_graph_utils.h"
 #include "graph/utils/error.h"
 
 namespace vineyard {
 
 const int chunk_size = 409600;
 
+// the number of rows of a slice of the table to be partitioned by a thread
+const int64_t shuffle_batch_size = 65536;
+
+// the number of sends in flight of a worker, each of at most `chunk_size`
+// bytes, while shuffling tables
+const size_t shuffle_send_window = 64;
+
 template <typename T>
 inline void send_buffer(const T* ptr, size_t len, int dst_worker_id,
                         MPI_Comm comm, int tag = 0) {
@@ -94,94 +106,306 @@ inline boost::leaf::result<std::shared_ptr<arrow::Buffer>> RecvArrowBuffer(
   return buffer;
 }
 
-template <typename PARTITIONER_T>
-boost::leaf::result<std::shared_ptr<arrow::Table>> ShufflePropertyVertexTable(
-    const grape::CommSpec& comm_spec, const PARTITIONER_T& partitioner,
-    std::shared_ptr<arrow::Table>& table_in) {
-  using oid_t = typename PARTITIONER_T::oid_t;
-  using internal_oid_t = typename InternalType<oid_t>::type;
-  using oid_array_type =
-      typename vineyard::ConvertToArrowType<oid_t>::ArrayType;
-  auto fnum = comm_spec.fnum();
-  std::vector<std::unique_ptr<arrow::RecordBatchBuilder>>
-      divided_table_builders;
-  std::vector<std::vector<std::shared_ptr<arrow::RecordBatch>>> divided_records(
-      fnum);
-  for (fid_t i = 0; i < fnum; ++i) {
-    std::unique_ptr<arrow::RecordBatchBuilder> builder;
-    ARROW_OK_OR_RAISE(arrow::RecordBatchBuilder::Make(
-        table_in->schema(), arrow::default_memory_pool(), 4096, &builder));
-    divided_table_builders.emplace_back(std::move(builder));
+/**
+ * Send arrow buffers without blocking, in the protocol of `RecvArrowBuffer`.
+ *
+ * At most `window` sends are in flight, and the buffers are kept alive until
+ * their sends complete. The stream to every destination ends with an empty
+ * buffer once the sender is finished, or destroyed, e.g., on errors, thus the
+ * receivers never hang.
+ */
+class ArrowBufferSender {
+ public:
+  ArrowBufferSender(MPI_Comm comm, const std::vector<int>& dst_worker_ids,
+                    int tag = 0, size_t window = shuffle_send_window)
+      : comm_(comm),
+        dst_worker_ids_(dst_worker_ids),
+        tag_(tag),
+        window_(std::max<size_t>(1, window)) {}
+
+  ~ArrowBufferSender() { Finish(); }
+
+  void Send(const std::shared_ptr<arrow::Buffer>& buffer, int dst_worker_id) {
+    acquire(buffer);
+    sizes_.push_back(buffer->size());
+    requests_.emplace_back();
+    MPI_Isend(&sizes_.back(), 1, MPI_INT64_T, dst_worker_id, tag_, comm_,
+              &requests_.back());
+    // the same chunks as `recv_buffer` expects
+    const uint8_t* ptr = buffer->data();
+    int64_t remaining = buffer->size();
+    while (remaining > 0) {
+      acquire(buffer);
+      int64_t len = std::min(remaining, static_cast<int64_t>(chunk_size));
+      requests_.emplace_back();
+      MPI_Isend(const_cast<uint8_t*>(ptr), static_cast<int>(len), MPI_CHAR,
+                dst_worker_id, tag_, comm_, &requests_.back());
+      ptr += len;
+      remaining -= len;
+    }
   }
-  vineyard::TableAppender appender(table_in->schema());
-  arrow::TableBatchReader tbreader(*table_in);
-  std::shared_ptr<arrow::RecordBatch> batch;
 
-  while (true) {
-    ARROW_OK_OR_RAISE(tbreader.ReadNext(&batch));
-    if (batch == nullptr) {
-      break;
+  /**
+   * End the streams to all destinations, and wait for the sends in flight.
+   */
+  void Finish() {
+    if (finished_) {
+      return;
     }
-    std::shared_ptr<oid_array_type> id_col =
-        std::dynamic_pointer_cast<oid_array_type>(batch->column(0));
-    size_t row_num = batch->num_rows();
-    for (size_t i = 0; i < row_num; ++i) {
-      internal_oid_t rs = id_col->GetView(i);
-      fid_t fid = partitioner.GetPartitionId(oid_t(rs));
-      ARROW_OK_OR_RAISE(appender.Apply(divided_table_builders[fid], batch, i,
-                                       divided_records[fid]));
+    finished_ = true;
+    auto end_of_stream = std::make_shared<arrow::Buffer>(nullptr, 0);
+    for (int dst_worker_id : dst_worker_ids_) {
+      Send(end_of_stream, dst_worker_id);
     }
+    wait();
   }
 
-  for (fid_t i = 0; i < fnum; ++i) {
-    std::unique_ptr<arrow::RecordBatchBuilder> builder =
-        std::move(divided_table_builders[i]);
-    ARROW_OK_OR_RAISE(appender.Flush(builder, divided_records[i]));
+ private:
+  // waits for the sends in flight if the window is full, and pins the buffer
+  // being sent until the next wait
+  void acquire(const std::shared_ptr<arrow::Buffer>& buffer) {
+    if (requests_.size() >= window_) {
+      wait();
+    }
+    if (buffers_.empty() || buffers_.back() != buffer) {
+      buffers_.push_back(buffer);
+    }
   }
-  divided_table_builders.clear();
 
+  void wait() {
+    MPI_Waitall(static_cast<int>(requests_.size()), requests_.data(),
+                MPI_STATUSES_IGNORE);
+    requests_.clear();
+    buffers_.clear();
+    sizes_.clear();
+  }
+
+  MPI_Comm comm_;
+  std::vector<int> dst_worker_ids_;
+  int tag_;
+  size_t window_;
+  bool finished_ = false;
+  std::deque<int64_t> sizes_;
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers_;
+  std::vector<MPI_Request> requests_;
+};
+
+/**
+ * Receive the arrow buffers of `ArrowBufferSender` from the given workers.
+ *
+ * The messages are received in the order they arrive, rather than worker by
+ * worker, as the senders, whose sends in flight are bounded, would otherwise
+ * wait for each other. Only the workers whose streams are not ended are
+ * probed, thus the messages of the next shuffle are left alone.
+ */
+class ArrowBufferReceiver {
+ public:
+  ArrowBufferReceiver(MPI_Comm comm, const std::vector<int>& src_worker_ids,
+                      int tag = 0)
+      : comm_(comm),
+        src_worker_ids_(src_worker_ids),
+        tag_(tag),
+        pending_(src_worker_ids.size()),
+        offsets_(src_worker_ids.size(), 0) {}
+
+  /**
+   * Receive the next non-empty buffer, returns false once all streams end.
+   */
+  boost::leaf::result<bool> Next(int& src_worker_id,
+                                 std::shared_ptr<arrow::Buffer>& buffer) {
+    while (!src_worker_ids_.empty()) {
+      bool received = false;
+      for (size_t i = 0; i < src_worker_ids_.size(); ++i) {
+        int flag = 0;
+        MPI_Status status;
+        MPI_Iprobe(src_worker_ids_[i], tag_, comm_, &flag, &status);
+        if (!flag) {
+          continue;
+        }
+        received = true;
+        if (pending_[i] == nullptr) {
+          int64_t size = 0;
+          MPI_Recv(&size, 1, MPI_INT64_T, src_worker_ids_[i], tag_, comm_,
+                   MPI_STATUS_IGNORE);
+          if (size == 0) {
+            src_worker_ids_.erase(src_worker_ids_.begin() + i);
+            pending_.erase(pending_.begin() + i);
+            offsets_.erase(offsets_.begin() + i);
+            break;
+          }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+          ARROW_OK_OR_RAISE(arrow::AllocateBuffer(arrow::default_memory_pool(),
+                                                  size, &pending_[i]));
+#else
+          ARROW_OK_ASSIGN_OR_RAISE(
+              pending_[i],
+              arrow::AllocateBuffer(size, arrow::default_memory_pool()));
+#endif
+          offsets_[i] = 0;
+          continue;
+        }
+        int count = 0;
+        MPI_Get_count(&status, MPI_CHAR, &count);
+        MPI_Recv(pending_[i]->mutable_data() + offsets_[i], count, MPI_CHAR,
+                 src_worker_ids_[i], tag_, comm_, MPI_STATUS_IGNORE);
+        offsets_[i] += count;
+        if (offsets_[i] == pending_[i]->size()) {
+          src_worker_id = src_worker_ids_[i];
+          buffer = std::move(pending_[i]);
+          pending_[i] = nullptr;
+          return true;
+        }
+      }
+      if (!received) {
+        std::this_thread::yield();
+      }
+    }
+    return false;
+  }
+
+ private:
+  MPI_Comm comm_;
+  std::vector<int> src_worker_ids_;
+  int tag_;
+  std::vector<std::shared_ptr<arrow::Buffer>> pending_;
+  std::vector<int64_t> offsets_;
+};
+
+/**
+ * Shuffle the rows of the table to fragments.
+ *
+ * The table is partitioned in slices of `shuffle_batch_size` rows, a round of
+ * slices at a time in parallel: `assign(batch, offset_lists)` appends the
+ * offset of every row of a slice to the lists of its destination fragments,
+ * then the rows of every destination are gathered column by column. The
+ * partitions of a round are sent without blocking while the next round is
+ * being partitioned, at most `shuffle_send_window` sends at a time, and an
+ * empty buffer ends the stream to a worker, even if the sending fails.
+ */
+template <typename ASSIGN_FUNC_T>
+boost::leaf::result<std::shared_ptr<arrow::Table>> ShuffleTableByFragment(
+    const grape::CommSpec& comm_spec, std::shared_ptr<arrow::Table>& table_in,
+    const ASSIGN_FUNC_T& assign, const std::string& error_prefix) {
+  fid_t fnum = comm_spec.fnum();
   int worker_id = comm_spec.worker_id();
   int worker_num = comm_spec.worker_num();
+  int concurrency =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> local_batches;
+  std::vector<std::vector<std::shared_ptr<arrow::RecordBatch>>>
+      received_batches(worker_num);
+
   std::vector<std::string> error_msgs;
   auto error_handlers = std::make_tuple([&](const GSError& e) {
-    auto msg = "Shuffle vertex table error: " + e.error_msg;
+    auto msg = error_prefix + e.error_msg;
     LOG(ERROR) << msg;
     error_msgs.push_back(msg);
   });
 
+  std::vector<int> peer_worker_ids;
+  for (int i = 1; i < worker_num; ++i) {
+    peer_worker_ids.push_back((worker_id + i) % worker_num);
+  }
+
   auto send_procedure = [&]() -> boost::leaf::result<void> {
-    int dst_worker_id = (worker_id + worker_num - 1) % worker_num;
-    while (dst_worker_id != worker_id) {
-      fid_t dst_fid = comm_spec.WorkerToFrag(dst_worker_id);
-      std::shared_ptr<arrow::Buffer> buffer;
-      std::vector<std::shared_ptr<arrow::RecordBatch>> batches =
-          std::move(divided_records[dst_fid]);
-      VY_OK_OR_RAISE(vineyard::SerializeRecordBatches(batches, &buffer));
-      SendArrowBuffer(buffer, dst_worker_id, comm_spec.comm());
-      dst_worker_id = (dst_worker_id + worker_num - 1) % worker_num;
+    ArrowBufferSender sender(comm_spec.comm(), peer_worker_ids);
+    arrow::TableBatchReader reader(*table_in);
+    reader.set_chunksize(shuffle_batch_size);
+
+    std::vector<std::shared_ptr<arrow::RecordBatch>> round;
+    // slice -> fid -> rows
+    std::vector<std::vector<std::shared_ptr<arrow::RecordBatch>>> divided;
+    std::vector<Status> statuses;
+    while (true) {
+      round.clear();
+      while (round.size() < static_cast<size_t>(concurrency)) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        ARROW_OK_OR_RAISE(reader.ReadNext(&batch));
+        if (batch == nullptr) {
+          break;
+        }
+        round.push_back(batch);
+      }
+      if (round.empty()) {
+        break;
+      }
+
+      divided.assign(round.size(),
+                     std::vector<std::shared_ptr<arrow::RecordBatch>>(fnum));
+      statuses.assign(round.size(), Status::OK());
+      property_graph_utils::parallel_for(
+          0, static_cast<int64_t>(round.size()), concurrency,
+          [&](int64_t begin, int64_t end) {
+            std::vector<std::vector<int64_t>> offset_lists(fnum);
+            for (int64_t i = begin; i < end; ++i) {
+              for (auto& offsets : offset_lists) {
+                offsets.clear();
+              }
+              assign(round[i], offset_lists);
+              for (fid_t fid = 0; fid < fnum && statuses[i].ok(); ++fid) {
+                if (!offset_lists[fid].empty()) {
+                  statuses[i] = GatherRecordBatch(round[i], offset_lists[fid],
+                                                  &divided[i][fid]);
+                }
+              }
+            }
+          },
+          1);
+      for (auto const& status : statuses) {
+        VY_OK_OR_RAISE(status);
+      }
+
+      for (fid_t fid = 0; fid < fnum; ++fid) {
+        std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+        for (auto& slices : divided) {
+          if (slices[fid] != nullptr) {
+            batches.push_back(std::move(slices[fid]));
+          }
+        }
+        if (batches.empty()) {
+          continue;
+        }
+        if (fid == comm_spec.fid()) {
+          local_batches.insert(local_batches.end(), batches.begin(),
+                               batches.end());
+        } else {
+          std::shared_ptr<arrow::Buffer> buffer;
+          VY_OK_OR_RAISE(vineyard::SerializeRecordBatches(batches, &buffer));
+          sender.Send(buffer, comm_spec.FragToWorker(fid));
+        }
+      }
     }
 
+    sender.Finish();
     return boost::leaf::result<void>();
   };
 
+  // the streams are drained even if a buffer is corrupt, thus the senders
+  // always finish
   auto recv_procedure = [&]() -> boost::leaf::result<void> {
-    int src_worker_id = (worker_id + 1) % worker_num;
-    while (src_worker_id != worker_id) {
-      BOOST_LEAF_AUTO(buffer, RecvArrowBuffer(src_worker_id, comm_spec.comm()));
-      std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
-      VY_OK_OR_RAISE(vineyard::DeserializeRecordBatches(buffer, &batches));
-      for (const auto& batch : batches) {
-        if (batch->num_rows() > 0) {
-          divided_records[comm_spec.fid()].push_back(batch);
-        }
+    ArrowBufferReceiver receiver(comm_spec.comm(), peer_worker_ids);
+    Status status;
+    int src_worker_id = 0;
+    std::shared_ptr<arrow::Buffer> buffer;
+    while (true) {
+      BOOST_LEAF_AUTO(has_next, receiver.Next(src_worker_id, buffer));
+      if (!has_next) {
+        break;
       }
-      src_worker_id = (src_worker_id + 1) % worker_num;
+      if (!status.ok()) {
+        continue;
+      }
+      std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+      status = vineyard::DeserializeRecordBatches(buffer, &batches);
+      auto& received = received_batches[src_worker_id];
+      received.insert(received.end(), batches.begin(), batches.end());
     }
+    VY_OK_OR_RAISE(status);
     return boost::leaf::result<void>();
   };
 
   std::vector<std::future<boost::leaf::result<void>>> fut;
-
   fut.push_back(std::async(std::launch::async, [&] {
     return boost::leaf::capture(
         boost::leaf::make_shared_context(error_handlers), send_procedure);
@@ -214,7 +438,11 @@ boost::leaf::result<std::shared_ptr<arrow::Table>> ShufflePropertyVertexTable(
     return boost::leaf::new_error(GSError(ErrorCode::kIOError, msgs));
   }
 
-  auto& batches = divided_records[comm_spec.fid()];
+  auto& batches = local_batches;
+  for (int i = 1; i < worker_num; ++i) {
+    auto& received = received_batches[(worker_id + i) % worker_num];
+    batches.insert(batches.end(), received.begin(), received.end());
+  }
   // remove empty batches
   batches.erase(std::remove_if(batches.begin(), batches.end(),
                                [](std::shared_ptr<arrow::RecordBatch>& e) {
@@ -222,6 +450,7 @@ boost::leaf::result<std::shared_ptr<arrow::Table>> ShufflePropertyVertexTable(
                                }),
                 batches.end());
 
+  // N.B.: we need an empty table for non-existing labels.
   std::shared_ptr<arrow::Table> table_out;
   if (batches.empty()) {
     VY_OK_OR_RAISE(
@@ -240,6 +469,31 @@ boost::leaf::result<std::shared_ptr<arrow::Table>> ShufflePropertyVertexTable(
   return table_out;
 }
 
+template <typename PARTITIONER_T>
+boost::leaf::result<std::shared_ptr<arrow::Table>> ShufflePropertyVertexTable(
+    const grape::CommSpec& comm_spec, const PARTITIONER_T& partitioner,
+    std::shared_ptr<arrow::Table>& table_in) {
+  using oid_t = typename PARTITIONER_T::oid_t;
+  using internal_oid_t = typename InternalType<oid_t>::type;
+  using oid_array_type =
+      typename vineyard::ConvertToArrowType<oid_t>::ArrayType;
+
+  auto assign = [&partitioner](
+                    const std::shared_ptr<arrow::RecordBatch>& batch,
+                    std::vector<std::vector<int64_t>>& offset_lists) {
+    std::shared_ptr<oid_array_type> id_col =
+        std::dynamic_pointer_cast<oid_array_type>(batch->column(0));
+    int64_t row_num = batch->num_rows();
+    for (int64_t i = 0; i < row_num; ++i) {
+      internal_oid_t rs = id_col->GetView(i);
+      fid_t fid = partitioner.GetPartitionId(oid_t(rs));
+      offset_lists[fid].push_back(i);
+    }
+  };
+  return ShuffleTableByFragment(comm_spec, table_in, assign,
+                                "Shuffle vertex table error: ");
+}
+
 template <typename T>
 inline void send_numeric_array(
     std::shared_ptr<typename vineyard::ConvertToArrowType<T>::ArrayType> array,
@@ -381,173 +635,31 @@ template <typename VID_TYPE>
 boost::leaf::result<std::shared_ptr<arrow::Table>> ShufflePropertyEdgeTable(
     const grape::CommSpec& comm_spec, vineyard::IdParser<VID_TYPE>& id_parser,
     int src_col_id, int dst_col_id, std::shared_ptr<arrow::Table>& table_in) {
-  fid_t fnum = comm_spec.fnum();
-  std::vector<std::vector<std::shared_ptr<arrow::RecordBatch>>>
-      divided_record_batches(fnum);
-
-  vineyard::TableAppender appender(table_in->schema());
-  std::vector<std::unique_ptr<arrow::RecordBatchBuilder>>
-      divided_table_builders;
-
-  for (fid_t i = 0; i < fnum; ++i) {
-    std::unique_ptr<arrow::RecordBatchBuilder> builder;
-    ARROW_OK_OR_RAISE(arrow::RecordBatchBuilder::Make(
-        table_in->schema(), arrow::default_memory_pool(), 4096, &builder));
-    divided_table_builders.emplace_back(std::move(builder));
-  }
-
-  std::vector<std::shared_ptr<arrow::RecordBatch>> tmp_batch_vec;
-  std::vector<std::shared_ptr<arrow::RecordBatch>> record_batches;
-
-  VY_OK_OR_RAISE(vineyard::TableToRecordBatches(table_in, &record_batches));
-  for (const auto& rb : record_batches) {
-    size_t row_num = rb->num_rows();
-    auto src_col = std::dynamic_pointer_cast<
-        typename vineyard::ConvertToArrowType<VID_TYPE>::ArrayType>(
-        rb->column(src_col_id));
-    auto dst_col = std::dynamic_pointer_cast<
-        typename vineyard::ConvertToArrowType<VID_TYPE>::ArrayType>(
-        rb->column(dst_col_id));
-
-    for (size_t i = 0; i < row_num; ++i) {
-      VID_TYPE src_gid = src_col->Value(i);
-      VID_TYPE dst_gid = dst_col->Value(i);
-      fid_t src_fid = id_parser.GetFid(src_gid);
-      fid_t dst_fid = id_parser.GetFid(dst_gid);
-      ARROW_OK_OR_RAISE(appender.Apply(divided_table_builders[src_fid], rb, i,
-                                       tmp_batch_vec));
-      if (!tmp_batch_vec.empty()) {
-        divided_record_batches[src_fid].emplace_back(
-            std::move(tmp_batch_vec[0]));
-        tmp_batch_vec.clear();
-      }
+  using vid_array_type =
+      typename vineyard::ConvertToArrowType<VID_TYPE>::ArrayType;
+
+  // an edge goes to the fragments of both its source and destination
+  auto assign = [&id_parser, src_col_id, dst_col_id](
+                    const std::shared_ptr<arrow::RecordBatch>& batch,
+                    std::vector<std::vector<int64_t>>& offset_lists) {
+    auto src_col = std::dynamic_pointer_cast<vid_array_type>(
+        batch->column(src_col_id));
+    auto dst_col = std::dynamic_pointer_cast<vid_array_type>(
+        batch->column(dst_col_id));
+    const VID_TYPE* src_gids = src_col->raw_values();
+    const VID_TYPE* dst_gids = dst_col->raw_values();
+    int64_t row_num = batch->num_rows();
+    for (int64_t i = 0; i < row_num; ++i) {
+      fid_t src_fid = id_parser.GetFid(src_gids[i]);
+      fid_t dst_fid = id_parser.GetFid(dst_gids[i]);
+      offset_lists[src_fid].push_back(i);
       if (src_fid != dst_fid) {
-        ARROW_OK_OR_RAISE(appender.Apply(divided_table_builders[dst_fid], rb, i,
-                                         tmp_batch_vec));
-        if (!tmp_batch_vec.empty()) {
-          divided_record_batches[dst_fid].emplace_back(
-              std::move(tmp_batch_vec[0]));
-          tmp_batch_vec.clear();
-        }
-      }
-    }
-  }
-
-  for (fid_t fid = 0; fid < fnum; ++fid) {
-    ARROW_OK_OR_RAISE(
-        appender.Flush(divided_table_builders[fid], tmp_batch_vec));
-    if (!tmp_batch_vec.empty()) {
-      divided_record_batches[fid].emplace_back(std::move(tmp_batch_vec[0]));
-      tmp_batch_vec.clear();
-    }
-  }
-
-  int worker_id = comm_spec.worker_id();
-  int worker_num = comm_spec.worker_num();
-  std::vector<std::string> error_msgs;
-  auto error_handlers = std::make_tuple([&](const GSError& e) {
-    auto msg = "Shuffle edge table error: " + e.error_msg;
-    LOG(ERROR) << msg;
-    error_msgs.push_back(msg);
-  });
-
-  auto send_procedure = [&]() -> boost::leaf::result<void> {
-    int dst_worker_id = (worker_id + worker_num - 1) % worker_num;
-    while (dst_worker_id != worker_id) {
-      fid_t dst_fid = comm_spec.WorkerToFrag(dst_worker_id);
-      std::shared_ptr<arrow::Buffer> buffer;
-      std::vector<std::shared_ptr<arrow::RecordBatch>> batches =
-          std::move(divided_record_batches[dst_fid]);
-      if (batches.empty()) {
-        std::shared_ptr<arrow::io::BufferOutputStream> out_stream;
-        ARROW_OK_ASSIGN_OR_RAISE(out_stream,
-                                 arrow::io::BufferOutputStream::Create(1024));
-        ARROW_OK_ASSIGN_OR_RAISE(buffer, out_stream->Finish());
-      } else {
-        VY_OK_OR_RAISE(vineyard::SerializeRecordBatches(batches, &buffer));
+        offset_lists[dst_fid].push_back(i);
       }
-      SendArrowBuffer(buffer, dst_worker_id, comm_spec.comm());
-      dst_worker_id = (dst_worker_id + worker_num - 1) % worker_num;
     }
-
-    return boost::leaf::result<void>();
   };
-
-  auto recv_procedure = [&]() -> boost::leaf::result<void> {
-    int src_worker_id = (worker_id + 1) % worker_num;
-
-    while (src_worker_id != worker_id) {
-      BOOST_LEAF_AUTO(buffer, RecvArrowBuffer(src_worker_id, comm_spec.comm()));
-
-      if (buffer->size() > 0) {
-        std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
-        VY_OK_OR_RAISE(vineyard::DeserializeRecordBatches(buffer, &batches));
-        for (const auto& batch : batches) {
-          divided_record_batches[comm_spec.fid()].push_back(batch);
-        }
-      }
-      src_worker_id = (src_worker_id + 1) % worker_num;
-    }
-    return boost::leaf::result<void>();
-  };
-
-  std::vector<std::future<boost::leaf::result<void>>> fut;
-  fut.push_back(std::async(std::launch::async, [&] {
-    return boost::leaf::capture(
-        boost::leaf::make_shared_context(error_handlers), send_procedure);
-  }));
-  fut.push_back(std::async(std::launch::async, [&] {
-    return boost::leaf::capture(
-        boost::leaf::make_shared_context(error_handlers), recv_procedure);
-  }));
-
-  for (auto& f : fut) {
-    f.wait();
-    boost::leaf::try_handle_some(
-        [&]() -> boost::leaf::result<void> {
-          auto res = f.get();
-          if (!res) {
-            return res.error();
-          }
-          return boost::leaf::result<void>();
-        },
-        error_handlers);
-  }
-
-  if (!error_msgs.empty()) {
-    auto msgs = std::accumulate(
-        error_msgs.begin(), error_msgs.end(), std::string(),
-        [](const std::string& a, const std::string& b) -> std::string {
-          return a + (!a.empty() ? "," : "") + b;
-        });
-
-    return boost::leaf::new_error(GSError(ErrorCode::kIOError, msgs));
-  }
-
-  auto batches = divided_record_batches[comm_spec.fid()];
-  batches.erase(std::remove_if(batches.begin(), batches.end(),
-                               [](std::shared_ptr<arrow::RecordBatch>& e) {
-                                 return e->num_rows() == 0;
-                               }),
-                batches.end());
-
-  // N.B.: we need an empty table for non-existing labels.
-  std::shared_ptr<arrow::Table> table_out;
-  if (batches.empty()) {
-    VY_OK_OR_RAISE(
-        vineyard::EmptyTableBuilder::Build(table_in->schema(), table_out));
-  } else {
-    std::shared_ptr<arrow::Table> tmp_table;
-    VY_OK_OR_RAISE(vineyard::RecordBatchesToTable(batches, &tmp_table));
-#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-    ARROW_OK_OR_RAISE(
-        tmp_table->CombineChunks(arrow::default_memory_pool(), &table_out));
-#else
-    ARROW_OK_ASSIGN_OR_RAISE(
-        table_out, tmp_table->CombineChunks(arrow::default_memory_pool()));
-#endif
-  }
-  return table_out;
+  return ShuffleTableByFragment(comm_spec, table_in, assign,
+                                "Shuffle edge table error: ");
 }
 
 }  // namespace vineyard
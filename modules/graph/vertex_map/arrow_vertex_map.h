@@ -16,8 +16,13 @@ limitations under the License.
 #ifndef MODULES_GRAPH_VERTEX_MAP_ARROW_VERTEX_MAP_H_
 #define MODULES_GRAPH_VERTEX_MAP_ARROW_VERTEX_MAP_H_
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "basic/ds/array.h"
@@ -28,6 +33,7 @@ limitations under the License.
 
 #include "graph/fragment/property_graph_types.h"
 #include "graph/fragment/property_graph_utils.h"
+#include "graph/utils/partitioner.h"
 
 namespace vineyard {
 
@@ -62,6 +68,10 @@ class ArrowVertexMap
     this->label_num_ = meta.GetKeyValue<label_id_t>("label_num");
 
     id_parser_.Init(fnum_, label_num_);
+    partitioner_.Init(fnum_);
+    hash_partitioned_ =
+        meta.Haskey("partitioner") &&
+        meta.GetKeyValue("partitioner") == HashPartitioner<oid_t>::type();
 
     o2g_.resize(fnum_);
     oid_arrays_.resize(fnum_);
@@ -101,6 +111,10 @@ class ArrowVertexMap
   }
 
   bool GetGid(oid_t oid, vid_t& gid) const {
+    // route to the owning fragment if the oids are hash partitioned
+    if (hash_partitioned_) {
+      return GetGid(partitioner_.GetPartitionId(oid), oid, gid);
+    }
     for (fid_t i = 0; i < fnum_; ++i) {
       if (GetGid(i, oid, gid)) {
         return true;
@@ -155,6 +169,10 @@ class ArrowVertexMap
 
   vineyard::IdParser<vid_t> id_parser_;
 
+  // how the oids were partitioned into fragments, see also `GetGid`
+  HashPartitioner<oid_t> partitioner_;
+  bool hash_partitioned_ = false;
+
   // frag->label->oid
   std::vector<std::vector<std::shared_ptr<oid_array_t>>> oid_arrays_;
   std::vector<vineyard::Hashmap<oid_t, vid_t>> o2g_;
@@ -166,6 +184,105 @@ class ArrowVertexMap
   friend class ArrowProjectedVertexMap;
 };
 
+namespace detail {
+
+/**
+ * @brief The o2g index of the string oids of a (fragment, label) is an open
+ * addressing hash table with linear probing, sealed as an array of slots. A
+ * slot holds the offset of an oid in the oid array, or -1 if it is empty, thus
+ * the keys are the strings in the buffers of the oid array itself.
+ *
+ * The capacity is a power of two that keeps the load factor at most 0.5.
+ */
+inline size_t string_oid_index_capacity(int64_t length) {
+  size_t capacity = 1;
+  while (capacity < static_cast<size_t>(length) * 2) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+/**
+ * @brief The hash of the sealed index, which is recorded in the metadata of
+ * the vertex map as "o2g_index". The index is probed by other processes and
+ * builds, thus the hash must not depend on the standard library.
+ */
+constexpr const char* string_oid_index_hash = "murmur64a";
+
+/**
+ * @brief MurmurHash64A by Austin Appleby (public domain), on the little-endian
+ * words of the string.
+ */
+inline uint64_t murmur_hash64a(const char* data, size_t length,
+                               uint64_t seed = 0) {
+  const uint64_t m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+  uint64_t h = seed ^ (length * m);
+  const char* end = data + (length & ~static_cast<size_t>(7));
+  for (; data != end; data += 8) {
+    uint64_t k;
+    memcpy(&k, data, sizeof(k));
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+  const unsigned char* tail = reinterpret_cast<const unsigned char*>(data);
+  if ((length & 7) != 0) {
+    uint64_t k = 0;
+    for (size_t i = length & 7; i > 0; --i) {
+      k = (k << 8) | tail[i - 1];
+    }
+    h ^= k;
+    h *= m;
+  }
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+inline size_t string_oid_index_slot(arrow::util::string_view oid,
+                                    size_t capacity) {
+  return static_cast<size_t>(murmur_hash64a(oid.data(), oid.size())) &
+         (capacity - 1);
+}
+
+/**
+ * @brief Fill the slots of the index of the oid array, where the capacity is
+ * given by `string_oid_index_capacity`.
+ */
+inline void string_oid_index_build(const arrow::StringArray& array,
+                                   int64_t* slots, size_t capacity) {
+  std::fill_n(slots, capacity, -1);
+  for (int64_t k = 0; k < array.length(); ++k) {
+    size_t slot = string_oid_index_slot(array.GetView(k), capacity);
+    // duplicated oids are kept after the first one and never found
+    while (slots[slot] != -1) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+    slots[slot] = k;
+  }
+}
+
+/**
+ * @brief Find the offset of the oid in the oid array, or -1 if not found.
+ */
+inline int64_t string_oid_index_find(const int64_t* slots, size_t capacity,
+                                     const arrow::StringArray& array,
+                                     arrow::util::string_view oid) {
+  for (size_t slot = string_oid_index_slot(oid, capacity);;
+       slot = (slot + 1) & (capacity - 1)) {
+    int64_t offset = slots[slot];
+    if (offset == -1 || array.GetView(offset) == oid) {
+      return offset;
+    }
+  }
+}
+
+}  // namespace detail
+
 template <typename VID_T>
 class ArrowVertexMap<arrow::util::string_view, VID_T>
     : public vineyard::Registered<
@@ -192,6 +309,10 @@ class ArrowVertexMap<arrow::util::string_view, VID_T>
     this->label_num_ = meta.GetKeyValue<label_id_t>("label_num");
 
     id_parser_.Init(fnum_, label_num_);
+    partitioner_.Init(fnum_);
+    hash_partitioned_ =
+        meta.Haskey("partitioner") &&
+        meta.GetKeyValue("partitioner") == HashPartitioner<oid_t>::type();
 
     oid_arrays_.resize(fnum_);
     for (fid_t i = 0; i < fnum_; ++i) {
@@ -204,7 +325,22 @@ class ArrowVertexMap<arrow::util::string_view, VID_T>
       }
     }
 
-    initHashmaps();
+    // the vertex maps sealed without the index, or with another hash, are
+    // indexed in place
+    if (meta.Haskey("o2g_index") &&
+        meta.GetKeyValue("o2g_index") == detail::string_oid_index_hash) {
+      o2g_.resize(fnum_);
+      for (fid_t i = 0; i < fnum_; ++i) {
+        o2g_[i].resize(label_num_);
+        for (label_id_t j = 0; j < label_num_; ++j) {
+          o2g_[i][j].Construct(meta.GetMemberMeta(
+              "o2g_" + std::to_string(i) + "_" + std::to_string(j)));
+        }
+      }
+    } else {
+      buildLocalO2G();
+    }
+    initO2GSlots();
   }
 
   bool GetOid(vid_t gid, oid_t& oid) const {
@@ -222,15 +358,23 @@ class ArrowVertexMap<arrow::util::string_view, VID_T>
   }
 
   bool GetGid(fid_t fid, oid_t oid, vid_t& gid) const {
-    auto iter = o2g_[fid].find(oid);
-    if (iter != o2g_[fid].end()) {
-      gid = iter->second;
-      return true;
+    for (label_id_t j = 0; j < label_num_; ++j) {
+      auto const& index = o2g_slots_[fid][j];
+      int64_t offset = detail::string_oid_index_find(
+          index.first, index.second, *oid_arrays_[fid][j], oid);
+      if (offset != -1) {
+        gid = id_parser_.GenerateId(fid, j, offset);
+        return true;
+      }
     }
     return false;
   }
 
   bool GetGid(oid_t oid, vid_t& gid) const {
+    // route to the owning fragment if the oids are hash partitioned
+    if (hash_partitioned_) {
+      return GetGid(partitioner_.GetPartitionId(oid), oid, gid);
+    }
     for (fid_t i = 0; i < fnum_; ++i) {
       if (GetGid(i, oid, gid)) {
         return true;
@@ -255,8 +399,10 @@ class ArrowVertexMap<arrow::util::string_view, VID_T>
 
   size_t GetTotalNodesNum() const {
     size_t num = 0;
-    for (auto m : o2g_) {
-      num += m.size();
+    for (auto& vec : oid_arrays_) {
+      for (auto& array : vec) {
+        num += array->length();
+      }
     }
     return num;
   }
@@ -272,7 +418,11 @@ class ArrowVertexMap<arrow::util::string_view, VID_T>
   label_id_t label_num() const { return label_num_; }
 
   vid_t vertices_num(fid_t fid) const {
-    return static_cast<vid_t>(o2g_[fid].size());
+    vid_t num = 0;
+    for (auto& array : oid_arrays_[fid]) {
+      num += static_cast<vid_t>(array->length());
+    }
+    return num;
   }
 
   vid_t vertices_num(fid_t fid, label_id_t label_id) const {
@@ -280,18 +430,39 @@ class ArrowVertexMap<arrow::util::string_view, VID_T>
   }
 
  private:
-  void initHashmaps() {
-    o2g_.resize(fnum_);
+  void buildLocalO2G() {
+    local_o2g_.resize(fnum_);
     for (fid_t i = 0; i < fnum_; ++i) {
-      for (label_id_t j = 0; j < label_num_; ++j) {
-        auto array = oid_arrays_[i][j];
-        {
-          vid_t cur_gid = id_parser_.GenerateId(i, j, 0);
-          int64_t vnum = array->length();
-          for (int64_t k = 0; k < vnum; ++k) {
-            o2g_[i].emplace(array->GetView(k), cur_gid);
-            ++cur_gid;
+      local_o2g_[i].resize(label_num_);
+    }
+    property_graph_utils::parallel_for(
+        0, static_cast<int64_t>(fnum_) * label_num_,
+        std::thread::hardware_concurrency(),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t task = begin; task < end; ++task) {
+            fid_t i = static_cast<fid_t>(task / label_num_);
+            label_id_t j = static_cast<label_id_t>(task % label_num_);
+            auto& slots = local_o2g_[i][j];
+            slots.resize(detail::string_oid_index_capacity(
+                oid_arrays_[i][j]->length()));
+            detail::string_oid_index_build(*oid_arrays_[i][j], slots.data(),
+                                           slots.size());
           }
+        },
+        1);
+  }
+
+  void initO2GSlots() {
+    o2g_slots_.resize(fnum_);
+    for (fid_t i = 0; i < fnum_; ++i) {
+      o2g_slots_[i].resize(label_num_);
+      for (label_id_t j = 0; j < label_num_; ++j) {
+        if (local_o2g_.empty()) {
+          o2g_slots_[i][j] = std::make_pair(o2g_[i][j].data(),
+                                            o2g_[i][j].size());
+        } else {
+          o2g_slots_[i][j] = std::make_pair(local_o2g_[i][j].data(),
+                                            local_o2g_[i][j].size());
         }
       }
     }
@@ -302,9 +473,18 @@ class ArrowVertexMap<arrow::util::string_view, VID_T>
 
   vineyard::IdParser<vid_t> id_parser_;
 
+  // how the oids were partitioned into fragments, see also `GetGid`
+  HashPartitioner<oid_t> partitioner_;
+  bool hash_partitioned_ = false;
+
   // frag->label->oid
   std::vector<std::vector<std::shared_ptr<oid_array_t>>> oid_arrays_;
-  std::vector<ska::flat_hash_map<oid_t, vid_t>> o2g_;
+  // frag->label->index, see also detail::string_oid_index_find
+  std::vector<std::vector<vineyard::Array<int64_t>>> o2g_;
+  // frag->label->index, built in place if the index has not been sealed
+  std::vector<std::vector<std::vector<int64_t>>> local_o2g_;
+  // frag->label->(slots, capacity), of either the sealed or the local index
+  std::vector<std::vector<std::pair<const int64_t*, size_t>>> o2g_slots_;
 
   template <typename _OID_T, typename _VID_T>
   friend class ArrowVertexMapBuilder;
@@ -322,6 +502,15 @@ class ArrowVertexMapBuilder : public vineyard::ObjectBuilder {
  public:
   explicit ArrowVertexMapBuilder(vineyard::Client& client) {}
 
+  /**
+   * @brief Record the type of the partitioner that assigned the oids to
+   * fragments, e.g., HashPartitioner<oid_t>::type(), with which the lookups
+   * of the vertex map are routed to the owning fragment.
+   */
+  void set_partitioner(const std::string& partitioner) {
+    partitioner_ = partitioner;
+  }
+
   void set_fnum_label_num(fid_t fnum, label_id_t label_num) {
     fnum_ = fnum;
     label_num_ = label_num;
@@ -352,6 +541,9 @@ class ArrowVertexMapBuilder : public vineyard::ObjectBuilder {
     vertex_map->fnum_ = fnum_;
     vertex_map->label_num_ = label_num_;
     vertex_map->id_parser_.Init(fnum_, label_num_);
+    vertex_map->partitioner_.Init(fnum_);
+    vertex_map->hash_partitioned_ =
+        partitioner_ == HashPartitioner<oid_t>::type();
 
     vertex_map->oid_arrays_.resize(fnum_);
     for (fid_t i = 0; i < fnum_; ++i) {
@@ -368,6 +560,9 @@ class ArrowVertexMapBuilder : public vineyard::ObjectBuilder {
 
     vertex_map->meta_.AddKeyValue("fnum", fnum_);
     vertex_map->meta_.AddKeyValue("label_num", label_num_);
+    if (!partitioner_.empty()) {
+      vertex_map->meta_.AddKeyValue("partitioner", partitioner_);
+    }
 
     size_t nbytes = 0;
     for (fid_t i = 0; i < fnum_; ++i) {
@@ -398,6 +593,7 @@ class ArrowVertexMapBuilder : public vineyard::ObjectBuilder {
   std::vector<std::vector<typename InternalType<oid_t>::vineyard_array_type>>
       oid_arrays_;
   std::vector<vineyard::Hashmap<oid_t, vid_t>> o2g_;
+  std::string partitioner_;
 };
 
 template <typename VID_T>
@@ -410,6 +606,15 @@ class ArrowVertexMapBuilder<arrow::util::string_view, VID_T>
  public:
   explicit ArrowVertexMapBuilder(vineyard::Client& client) {}
 
+  /**
+   * @brief Record the type of the partitioner that assigned the oids to
+   * fragments, e.g., HashPartitioner<oid_t>::type(), with which the lookups
+   * of the vertex map are routed to the owning fragment.
+   */
+  void set_partitioner(const std::string& partitioner) {
+    partitioner_ = partitioner;
+  }
+
   void set_fnum_label_num(fid_t fnum, label_id_t label_num) {
     fnum_ = fnum;
     label_num_ = label_num;
@@ -417,6 +622,10 @@ class ArrowVertexMapBuilder<arrow::util::string_view, VID_T>
     for (fid_t i = 0; i < fnum_; ++i) {
       oid_arrays_[i].resize(label_num_);
     }
+    o2g_.resize(fnum_);
+    for (fid_t i = 0; i < fnum_; ++i) {
+      o2g_[i].resize(label_num_);
+    }
   }
 
   void set_oid_array(
@@ -425,6 +634,11 @@ class ArrowVertexMapBuilder<arrow::util::string_view, VID_T>
     oid_arrays_[fid][label] = array;
   }
 
+  void set_o2g(fid_t fid, label_id_t label,
+               const vineyard::Array<int64_t>& index) {
+    o2g_[fid][label] = index;
+  }
+
   std::shared_ptr<vineyard::Object> _Seal(vineyard::Client& client) {
     // ensure the builder hasn't been sealed yet.
     ENSURE_NOT_SEALED(this);
@@ -436,6 +650,9 @@ class ArrowVertexMapBuilder<arrow::util::string_view, VID_T>
     vertex_map->fnum_ = fnum_;
     vertex_map->label_num_ = label_num_;
     vertex_map->id_parser_.Init(fnum_, label_num_);
+    vertex_map->partitioner_.Init(fnum_);
+    vertex_map->hash_partitioned_ =
+        partitioner_ == HashPartitioner<oid_t>::type();
 
     vertex_map->oid_arrays_.resize(fnum_);
     for (fid_t i = 0; i < fnum_; ++i) {
@@ -446,10 +663,18 @@ class ArrowVertexMapBuilder<arrow::util::string_view, VID_T>
       }
     }
 
+    vertex_map->o2g_ = o2g_;
+    vertex_map->initO2GSlots();
+
     vertex_map->meta_.SetTypeName(type_name<ArrowVertexMap<oid_t, vid_t>>());
 
     vertex_map->meta_.AddKeyValue("fnum", fnum_);
     vertex_map->meta_.AddKeyValue("label_num", label_num_);
+    vertex_map->meta_.AddKeyValue("o2g_index",
+                                  std::string(detail::string_oid_index_hash));
+    if (!partitioner_.empty()) {
+      vertex_map->meta_.AddKeyValue("partitioner", partitioner_);
+    }
 
     size_t nbytes = 0;
     for (fid_t i = 0; i < fnum_; ++i) {
@@ -458,6 +683,10 @@ class ArrowVertexMapBuilder<arrow::util::string_view, VID_T>
             "oid_arrays_" + std::to_string(i) + "_" + std::to_string(j),
             oid_arrays_[i][j].meta());
         nbytes += oid_arrays_[i][j].nbytes();
+        vertex_map->meta_.AddMember(
+            "o2g_" + std::to_string(i) + "_" + std::to_string(j),
+            o2g_[i][j].meta());
+        nbytes += o2g_[i][j].nbytes();
       }
     }
 
@@ -476,6 +705,8 @@ class ArrowVertexMapBuilder<arrow::util::string_view, VID_T>
 
   std::vector<std::vector<typename InternalType<oid_t>::vineyard_array_type>>
       oid_arrays_;
+  std::vector<std::vector<vineyard::Array<int64_t>>> o2g_;
+  std::string partitioner_;
 };
 
 template <typename OID_T, typename VID_T>
@@ -492,50 +723,82 @@ class BasicArrowVertexMapBuilder : public ArrowVertexMapBuilder<OID_T, VID_T> {
       : ArrowVertexMapBuilder<oid_t, vid_t>(client),
         fnum_(fnum),
         label_num_(label_num),
-        oid_arrays_(oid_arrays) {
+        oid_arrays_(oid_arrays),
+        concurrency_(std::thread::hardware_concurrency()) {
     CHECK_EQ(oid_arrays.size(), label_num);
     id_parser_.Init(fnum_, label_num_);
   }
 
+  /**
+   * @brief The number of threads that build the vertex map, which defaults to
+   * the number of hardware threads.
+   */
+  void set_concurrency(int concurrency) {
+    concurrency_ = std::max(1, concurrency);
+  }
+
   vineyard::Status Build(vineyard::Client& client) override {
     this->set_fnum_label_num(fnum_, label_num_);
 
-    for (fid_t i = 0; i < fnum_; ++i) {
-      // TODO(luoxiaojian): parallel construct hashmap
-      vineyard::HashmapBuilder<oid_t, vid_t> builder(client);
-      for (label_id_t j = 0; j < label_num_; ++j) {
-        auto array = oid_arrays_[j][i];
-        {
-          vid_t cur_gid = id_parser_.GenerateId(i, j, 0);
-          int64_t vnum = array->length();
-          for (int64_t k = 0; k < vnum; ++k) {
-            builder.emplace(array->GetView(k), cur_gid);
-            ++cur_gid;
+    // The o2g hashmap of every fragment, and the oid array of every
+    // (fragment, label), are built and sealed concurrently, the hashmaps,
+    // which are the most expensive, go first. The client serializes the
+    // requests to the server.
+    int64_t array_num = static_cast<int64_t>(fnum_) * label_num_;
+    property_graph_utils::parallel_for(
+        0, fnum_ + array_num, concurrency_,
+        [&](int64_t begin, int64_t end) {
+          for (int64_t task = begin; task < end; ++task) {
+            if (task < fnum_) {
+              buildO2G(client, static_cast<fid_t>(task));
+            } else {
+              int64_t index = task - fnum_;
+              fid_t i = static_cast<fid_t>(index / label_num_);
+              label_id_t j = static_cast<label_id_t>(index % label_num_);
+              typename InternalType<oid_t>::vineyard_builder_type
+                  array_builder(client, oid_arrays_[j][i]);
+              this->set_oid_array(
+                  i, j,
+                  *std::dynamic_pointer_cast<vineyard::NumericArray<oid_t>>(
+                      array_builder.Seal(client)));
+            }
           }
-        }
+        },
+        1);
+    return vineyard::Status::OK();
+  }
 
-        typename InternalType<oid_t>::vineyard_builder_type array_builder(
-            client, array);
-        this->set_oid_array(
-            i, j,
-            *std::dynamic_pointer_cast<vineyard::NumericArray<oid_t>>(
-                array_builder.Seal(client)));
+ private:
+  void buildO2G(vineyard::Client& client, fid_t i) {
+    vineyard::HashmapBuilder<oid_t, vid_t> builder(client);
+    int64_t vnum = 0;
+    for (label_id_t j = 0; j < label_num_; ++j) {
+      vnum += oid_arrays_[j][i]->length();
+    }
+    builder.reserve(static_cast<size_t>(vnum));
+    for (label_id_t j = 0; j < label_num_; ++j) {
+      auto array = oid_arrays_[j][i];
+      vid_t cur_gid = id_parser_.GenerateId(i, j, 0);
+      int64_t length = array->length();
+      for (int64_t k = 0; k < length; ++k) {
+        builder.emplace(array->GetView(k), cur_gid);
+        ++cur_gid;
       }
-
-      this->set_o2g(i,
-                    *std::dynamic_pointer_cast<vineyard::Hashmap<oid_t, vid_t>>(
-                        builder.Seal(client)));
     }
-    return vineyard::Status::OK();
+    this->set_o2g(i,
+                  *std::dynamic_pointer_cast<vineyard::Hashmap<oid_t, vid_t>>(
+                      builder.Seal(client)));
   }
 
- private:
   fid_t fnum_;
   label_id_t label_num_;
 
   vineyard::IdParser<vid_t> id_parser_;
 
   std::vector<std::vector<std::shared_ptr<oid_array_t>>> oid_arrays_;
+
+  // the number of threads to build the hashmaps and arrays
+  int concurrency_;
 };
 
 template <typename VID_T>
@@ -553,37 +816,66 @@ class BasicArrowVertexMapBuilder<arrow::util::string_view, VID_T>
       : ArrowVertexMapBuilder<arrow::util::string_view, vid_t>(client),
         fnum_(fnum),
         label_num_(label_num),
-        oid_arrays_(oid_arrays) {
+        oid_arrays_(oid_arrays),
+        concurrency_(std::thread::hardware_concurrency()) {
     CHECK_EQ(oid_arrays.size(), label_num);
     id_parser_.Init(fnum_, label_num_);
   }
 
+  /**
+   * @brief The number of threads that build the vertex map, which defaults to
+   * the number of hardware threads.
+   */
+  void set_concurrency(int concurrency) {
+    concurrency_ = std::max(1, concurrency);
+  }
+
   vineyard::Status Build(vineyard::Client& client) override {
     this->set_fnum_label_num(fnum_, label_num_);
 
-    for (fid_t i = 0; i < fnum_; ++i) {
-      // TODO(luoxiaojian): parallel construct hashmap
-      for (label_id_t j = 0; j < label_num_; ++j) {
-        auto array = oid_arrays_[j][i];
-        typename InternalType<oid_t>::vineyard_builder_type array_builder(
-            client, array);
-        this->set_oid_array(
-            i, j,
-            *std::dynamic_pointer_cast<
-                typename InternalType<oid_t>::vineyard_array_type>(
-                array_builder.Seal(client)));
-      }
-    }
+    // the oid array and the o2g index of every (fragment, label) are built
+    // and sealed concurrently
+    property_graph_utils::parallel_for(
+        0, static_cast<int64_t>(fnum_) * label_num_, concurrency_,
+        [&](int64_t begin, int64_t end) {
+          for (int64_t task = begin; task < end; ++task) {
+            fid_t i = static_cast<fid_t>(task / label_num_);
+            label_id_t j = static_cast<label_id_t>(task % label_num_);
+            typename InternalType<oid_t>::vineyard_builder_type array_builder(
+                client, oid_arrays_[j][i]);
+            this->set_oid_array(
+                i, j,
+                *std::dynamic_pointer_cast<
+                    typename InternalType<oid_t>::vineyard_array_type>(
+                    array_builder.Seal(client)));
+            buildO2G(client, i, j);
+          }
+        },
+        1);
     return vineyard::Status::OK();
   }
 
  private:
+  void buildO2G(vineyard::Client& client, fid_t i, label_id_t j) {
+    auto array = oid_arrays_[j][i];
+    int64_t length = array->length();
+    size_t capacity = detail::string_oid_index_capacity(length);
+    vineyard::ArrayBuilder<int64_t> builder(client, capacity);
+    detail::string_oid_index_build(*array, builder.data(), capacity);
+    this->set_o2g(i, j,
+                  *std::dynamic_pointer_cast<vineyard::Array<int64_t>>(
+                      builder.Seal(client)));
+  }
+
   fid_t fnum_;
   label_id_t label_num_;
 
   vineyard::IdParser<vid_t> id_parser_;
 
   std::vector<std::vector<std::shared_ptr<oid_array_t>>> oid_arrays_;
+
+  // the number of threads to seal the arrays
+  int concurrency_;
 };
 
 }  // namespace vineyard
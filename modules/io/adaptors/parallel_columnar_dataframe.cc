@@ -0,0 +1,80 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "basic/stream/dataframe_stream.h"
+#include "client/client.h"
+#include "io/io/io_factory.h"
+#include "io/io/utils.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+// Reads the row groups (Parquet), stripes (ORC) or record batches (Arrow IPC)
+// of a columnar file into a dataframe stream, every process reads a disjoint
+// range of them.
+int main(int argc, const char** argv) {
+  if (argc < 5) {
+    printf(
+        "usage ./parallel_columnar_dataframe <ipc_socket> <location> "
+        "<proc_num> <proc_index>\n");
+    return 1;
+  }
+  std::string ipc_socket = std::string(argv[1]);
+  std::string location = std::string(argv[2]);
+  int pnum = std::stoi(argv[3]);
+  int proc = std::stoi(argv[4]);
+
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
+
+  std::unique_ptr<IIOAdaptor> columnar_io_adaptor =
+      IOFactory::CreateIOAdaptor(location);
+  if (columnar_io_adaptor == nullptr) {
+    ReportStatus(false, "Columnar files are not supported: " + location);
+    return 1;
+  }
+  VINEYARD_CHECK_OK(columnar_io_adaptor->SetPartialRead(proc, pnum));
+  VINEYARD_CHECK_OK(columnar_io_adaptor->Open());
+
+  DataframeStreamBuilder dfbuilder(client);
+  dfbuilder.SetParams(std::unordered_map<std::string, std::string>{
+      {"framing", "schema_once"}});
+  auto bs = std::dynamic_pointer_cast<DataframeStream>(dfbuilder.Seal(client));
+  VINEYARD_CHECK_OK(client.Persist(bs->id()));
+  LOG(INFO) << "Created dataframe stream " << bs->id() << " at " << proc;
+  ReportStatus(true, bs->id());
+
+  auto writer = bs->OpenWriter(client);
+  auto status = columnar_io_adaptor->ReadTables(
+      [&writer](std::shared_ptr<arrow::Table> const& table) {
+        auto t = table;
+        return writer->WriteTable(t);
+      });
+  if (status.ok()) {
+    status = writer->Finish();
+  } else {
+    ReportStatus(false, status.ToString());
+    VINEYARD_SUPPRESS(writer->Abort());
+  }
+
+  VINEYARD_CHECK_OK(columnar_io_adaptor->Close());
+  VINEYARD_CHECK_OK(status);
+  ReportStatus("exit", "");
+  return 0;
+}
@@ -14,71 +14,24 @@ limitations under the License.
 */
 
 #include <iostream>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "arrow/api.h"
-#include "arrow/csv/api.h"
-#include "arrow/io/api.h"
 #include "arrow/util/config.h"
 
 #include "basic/stream/byte_stream.h"
 #include "basic/stream/dataframe_stream.h"
 #include "basic/stream/parallel_stream.h"
+#include "boost/algorithm/string.hpp"
 #include "client/client.h"
-#include "io/io/local_io_adaptor.h"
+#include "io/io/csv_chunk_parser.h"
 #include "io/io/utils.h"
 
 using namespace vineyard;  // NOLINT(build/namespaces)
 
-void ParseTable(std::shared_ptr<arrow::Table>* table,
-                std::unique_ptr<arrow::Buffer>& buffer, char delimiter,
-                bool header_row, std::vector<std::string> col_names) {
-  // FIXME IF NO NEED TO COPY
-  std::shared_ptr<arrow::Buffer> copied_buffer;
-#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-  CHECK_ARROW_ERROR(buffer->Copy(0, buffer->size(), &copied_buffer));
-#else
-  CHECK_ARROW_ERROR_AND_ASSIGN(copied_buffer,
-                               buffer->CopySlice(0, buffer->size()));
-#endif
-  LOG(INFO) << "copied: buffer size = " << copied_buffer->size();
-  auto buffer_reader = std::make_shared<arrow::io::BufferReader>(copied_buffer);
-
-  std::shared_ptr<arrow::io::InputStream> input =
-      arrow::io::RandomAccessFile::GetStream(buffer_reader, 0,
-                                             copied_buffer->size());
-
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
-
-  auto read_options = arrow::csv::ReadOptions::Defaults();
-  auto parse_options = arrow::csv::ParseOptions::Defaults();
-  auto convert_options = arrow::csv::ConvertOptions::Defaults();
-
-  if (col_names.size() > 0) {
-    read_options.column_names = col_names;
-  } else {
-    read_options.autogenerate_column_names = (!header_row);
-  }
-  parse_options.delimiter = delimiter;
-
-  std::shared_ptr<arrow::csv::TableReader> reader;
-  CHECK_ARROW_ERROR_AND_ASSIGN(
-      reader, arrow::csv::TableReader::Make(pool, input, read_options,
-                                            parse_options, convert_options));
-
-  CHECK_ARROW_ERROR_AND_ASSIGN(*table, reader->Read());
-
-  CHECK_ARROW_ERROR((*table)->Validate());
-
-  VLOG(2) << (*table)->num_rows() << " rows, " << (*table)->num_columns()
-          << " columns";
-  VLOG(2) << (*table)->schema()->ToString();
-
-  if (col_names.size() == 0) {
-    col_names = (*table)->ColumnNames();
-  }
-}
-
 int main(int argc, const char** argv) {
   if (argc < 3) {
     printf(
@@ -121,27 +74,54 @@ int main(int argc, const char** argv) {
   auto reader = ls->OpenReader(client);
   auto writer = bs->OpenWriter(client);
 
-  while (true) {
-    std::unique_ptr<arrow::Buffer> buffer;
-    auto status = reader->GetNext(buffer);
-    if (status.ok()) {
-      LOG(INFO) << "consumer: buffer size = " << buffer->size();
-      std::shared_ptr<arrow::Table> table;
-      if (delimiter == "\t") {
-        ParseTable(&table, buffer, '\t', header_row, col_names);
-      } else {
-        ParseTable(&table, buffer, delimiter[0], header_row, col_names);
-      }
-      auto st = writer->WriteTable(table);
-      ReportStatus(false, bs->id());
-      VINEYARD_CHECK_OK(st);
+  // the chunks are parsed in place, and the column types are carried from the
+  // first chunk to the following ones, see also `CSVChunkParser`.
+  //
+  // n.b.: the readers of the stream expect a consistent schema, thus a chunk
+  // whose column types are promoted is cast back to the schema of the first
+  // chunk written, and the stream fails if the values don't fit.
+  CSVChunkParser parser(delimiter[0], col_names);
+  CSVLineSplitter splitter;
+  std::shared_ptr<arrow::Schema> schema;
+  auto parse = [&](std::shared_ptr<arrow::Buffer> const& buffer) -> Status {
+    std::shared_ptr<arrow::Table> table;
+    RETURN_ON_ERROR(parser.Parse(buffer, table));
+    if (schema == nullptr) {
+      schema = table->schema();
+    }
+    auto status = CastCSVTable(table, schema, table);
+    if (!status.ok()) {
+      return Status::Invalid(
+          "The column types are promoted after the stream has been written: " +
+          status.ToString());
+    }
+    VLOG(2) << table->num_rows() << " rows, " << table->num_columns()
+            << " columns";
+    RETURN_ON_ERROR(writer->WriteTable(table));
+    ReportStatus(false, bs->id());
+    return Status::OK();
+  };
+
+  Status status;
+  while (status.ok()) {
+    std::shared_ptr<arrow::Buffer> chunk;
+    auto st = reader->GetNext(chunk);
+    if (st.ok()) {
+      LOG(INFO) << "consumer: buffer size = " << chunk->size();
+      status = splitter.Feed(chunk, parse);
+    } else if (st.IsStreamDrained()) {
+      LOG(INFO) << "Stream drained";
+      status = splitter.Flush(parse);
+      break;
     } else {
-      if (status.IsStreamDrained()) {
-        LOG(INFO) << "Stream drained";
-        break;
-      }
+      status = st;
     }
   }
+  if (!status.ok()) {
+    ReportStatus(false, status.ToString());
+    VINEYARD_SUPPRESS(writer->Abort());
+    return 1;
+  }
   VINEYARD_CHECK_OK(writer->Finish());
   ReportStatus("exit", "");
   return 0;
@@ -0,0 +1,73 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <string>
+
+#include "basic/stream/dataframe_stream.h"
+#include "basic/stream/parallel_stream.h"
+#include "client/client.h"
+#include "io/io/io_factory.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+// Writes the local dataframe streams of a parallel stream to a table file,
+// e.g., an Arrow IPC or Parquet file, without going through lines of text.
+int main(int argc, const char** argv) {
+  if (argc < 4) {
+    printf(
+        "usage ./parallel_dataframe_single_columnar_consumer <ipc_socket> "
+        "<stream_id> <ofile>\n");
+    return 1;
+  }
+
+  std::string ipc_socket = std::string(argv[1]);
+  ObjectID stream_id = VYObjectIDFromString(argv[2]);
+  std::string ofile = std::string(argv[3]);
+
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
+
+  auto s = std::dynamic_pointer_cast<ParallelStream<DataframeStream>>(
+      client.GetObject(stream_id));
+  LOG(INFO) << "Got parallel stream " << s->id();
+
+  std::unique_ptr<IIOAdaptor> io_adaptor = IOFactory::CreateIOAdaptor(ofile);
+  if (io_adaptor == nullptr) {
+    LOG(ERROR) << "Unsupported output location: " << ofile;
+    return 1;
+  }
+  VINEYARD_CHECK_OK(io_adaptor->Open("w"));
+
+  for (size_t i = 0; i < s->GetStreamSize(); ++i) {
+    auto ls = s->GetStream(i);
+    if (!ls->IsLocal()) {
+      continue;
+    }
+    LOG(INFO) << "Got dataframe stream " << ls->id() << " " << i;
+    // the batches are copied out of the stream chunks, thus the chunks are
+    // released as they are read, rather than held until the table is written
+    auto reader = ls->OpenReader(client);
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(reader->ReadTable(table));
+    if (table != nullptr && table->num_rows() > 0) {
+      VINEYARD_CHECK_OK(io_adaptor->WriteTable(table));
+    }
+  }
+
+  VINEYARD_CHECK_OK(io_adaptor->Close());
+  return 0;
+}
@@ -0,0 +1,86 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "basic/stream/dataframe_stream.h"
+#include "client/client.h"
+#include "io/io/io_factory.h"
+#include "io/io/utils.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+// Reads the messages of a kafka topic into a dataframe stream as record
+// batches of (partition, offset, timestamp, value), without parsing the
+// messages line by line, every process consumes a disjoint set of partitions.
+int main(int argc, const char** argv) {
+  // kafka address format: kafka://brokers/topics/group_id/partition_num
+  if (argc < 5) {
+    printf(
+        "usage ./parallel_kafka_dataframe <ipc_socket> <kafka_address> "
+        "<proc_num> <proc_index> [batch_size] [batch_bytes]\n");
+    return 1;
+  }
+  std::string ipc_socket = std::string(argv[1]);
+  std::string kafka_address = "kafka://" + std::string(argv[2]);
+  int pnum = std::stoi(argv[3]);
+  int proc = std::stoi(argv[4]);
+
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
+
+  std::unique_ptr<IIOAdaptor> kafka_io_adaptor =
+      IOFactory::CreateIOAdaptor(kafka_address);
+  if (kafka_io_adaptor == nullptr) {
+    ReportStatus(false, "Kafka is not supported: " + kafka_address);
+    return 1;
+  }
+  VINEYARD_CHECK_OK(kafka_io_adaptor->Configure(
+      "batch_size", argc > 5 ? argv[5] : std::to_string(64 * 1024)));
+  if (argc > 6) {
+    VINEYARD_CHECK_OK(kafka_io_adaptor->Configure("batch_bytes", argv[6]));
+  }
+  VINEYARD_CHECK_OK(kafka_io_adaptor->SetPartialRead(proc, pnum));
+  VINEYARD_CHECK_OK(kafka_io_adaptor->Open());
+
+  DataframeStreamBuilder dfbuilder(client);
+  dfbuilder.SetParams(std::unordered_map<std::string, std::string>{
+      {"framing", "schema_once"}});
+  auto bs = std::dynamic_pointer_cast<DataframeStream>(dfbuilder.Seal(client));
+  VINEYARD_CHECK_OK(client.Persist(bs->id()));
+  LOG(INFO) << "Created dataframe stream " << bs->id() << " at " << proc;
+  ReportStatus(true, bs->id());
+
+  auto writer = bs->OpenWriter(client);
+  auto status = kafka_io_adaptor->ReadTables(
+      [&writer](std::shared_ptr<arrow::Table> const& table) {
+        auto t = table;
+        return writer->WriteTable(t);
+      });
+  if (status.ok()) {
+    status = writer->Finish();
+  } else {
+    ReportStatus(false, status.ToString());
+    VINEYARD_SUPPRESS(writer->Abort());
+  }
+
+  VINEYARD_CHECK_OK(kafka_io_adaptor->Close());
+  VINEYARD_CHECK_OK(status);
+  ReportStatus("exit", "");
+  return 0;
+}
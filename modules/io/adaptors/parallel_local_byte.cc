@@ -19,7 +19,7 @@ limitations under the License.
 #include "basic/stream/byte_stream.h"
 #include "basic/stream/parallel_stream.h"
 #include "client/client.h"
-#include "io/io/local_io_adaptor.h"
+#include "io/io/io_factory.h"
 #include "io/io/utils.h"
 
 using namespace vineyard;  // NOLINT(build/namespaces)
@@ -40,8 +40,10 @@ int main(int argc, const char** argv) {
   VINEYARD_CHECK_OK(client.Connect(ipc_socket));
   LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
 
-  std::unique_ptr<LocalIOAdaptor> local_io_adaptor(
-      new LocalIOAdaptor(efile.c_str()));
+  // a directory or glob pattern is split among the processes by size
+  std::unique_ptr<IIOAdaptor> local_io_adaptor =
+      IOFactory::CreateIOAdaptor(efile);
+  CHECK(local_io_adaptor != nullptr) << "Unsupported location: " << efile;
 
   VINEYARD_CHECK_OK(local_io_adaptor->SetPartialRead(proc, pnum));
 
@@ -67,7 +69,6 @@ int main(int argc, const char** argv) {
   }
 
   VINEYARD_CHECK_OK(local_io_adaptor->Close());
-  local_io_adaptor->Finalize();
   VINEYARD_CHECK_OK(writer->Finish());
 
   return 0;
@@ -0,0 +1,115 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+
+#include "basic/stream/dataframe_stream.h"
+#include "client/client.h"
+#include "io/io/io_factory.h"
+#include "io/io/local_io_adaptor.h"
+#include "io/io/pipeline.h"
+#include "io/io/utils.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+// Fuses `parallel_local_byte` and `parallel_dataframe_parser` in process: the
+// lines are parsed as soon as they are read, without the byte stream in
+// between. A single file is parsed in place block by block, and every batch is
+// written to the stream before the next block is parsed.
+int main(int argc, const char** argv) {
+  if (argc < 5) {
+    printf(
+        "usage ./parallel_local_dataframe <ipc_socket> <efile> <proc_num> "
+        "<proc_index> [concurrency]\n");
+    return 1;
+  }
+  std::string ipc_socket = std::string(argv[1]);
+  std::string efile = std::string(argv[2]);
+  int pnum = std::stoi(argv[3]);
+  int proc = std::stoi(argv[4]);
+  size_t concurrency = std::thread::hardware_concurrency();
+  if (argc > 5) {
+    concurrency = std::stoi(argv[5]);
+  }
+
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
+
+  // a directory or glob pattern is split among the processes by size
+  std::shared_ptr<IIOAdaptor> local_io_adaptor =
+      IOFactory::CreateIOAdaptor(efile);
+  if (local_io_adaptor == nullptr) {
+    ReportStatus(false, "Unsupported location: " + efile);
+    return 1;
+  }
+  VINEYARD_CHECK_OK(local_io_adaptor->SetPartialRead(proc, pnum));
+  VINEYARD_CHECK_OK(local_io_adaptor->Open());
+
+  std::string header_line, delimiter = ",";
+  for (auto const& kv : local_io_adaptor->GetMeta()) {
+    if (kv.first == "header_line") {
+      header_line = kv.second;
+    } else if (kv.first == "delimiter") {
+      delimiter = kv.second;
+    }
+  }
+  std::vector<std::string> col_names;
+  if (header_line != "") {
+    ::boost::split(col_names, header_line, ::boost::is_any_of(delimiter));
+  }
+
+  // n.b.: the sink casts every chunk to the schema of the first one, and fails
+  // the stream if a later chunk promotes the column types.
+  DataframeStreamBuilder dfbuilder(client);
+  auto bs = std::dynamic_pointer_cast<DataframeStream>(dfbuilder.Seal(client));
+  VINEYARD_CHECK_OK(client.Persist(bs->id()));
+  LOG(INFO) << "Created dataframe stream " << bs->id() << " at " << proc;
+  ReportStatus(true, bs->id());
+
+  Status status;
+  auto file_io_adaptor =
+      std::dynamic_pointer_cast<LocalIOAdaptor>(local_io_adaptor);
+  if (file_io_adaptor != nullptr) {
+    // the batches are read in order, thus a single worker
+    std::shared_ptr<arrow::RecordBatchReader> reader;
+    status = file_io_adaptor->OpenPartialBatchReader(&reader, proc);
+    if (status.ok()) {
+      Pipeline pipeline(std::make_shared<BatchReaderSource>(reader));
+      pipeline.To(std::make_shared<DataframeStreamSink>(client, bs));
+      status = pipeline.Run(1);
+    }
+  } else {
+    // the lines are parsed by many workers, thus the chunks are written to
+    // the stream in the order they are parsed, rather than the order of files
+    Pipeline pipeline(std::make_shared<AdaptorLineSource>(local_io_adaptor));
+    pipeline.Then(std::make_shared<ParseCSVOperator>(delimiter[0], col_names))
+        .To(std::make_shared<DataframeStreamSink>(client, bs));
+    status = pipeline.Run(concurrency);
+  }
+  if (!status.ok()) {
+    ReportStatus(false, status.ToString());
+  }
+
+  VINEYARD_CHECK_OK(local_io_adaptor->Close());
+  VINEYARD_CHECK_OK(status);
+  ReportStatus("exit", "");
+  return 0;
+}
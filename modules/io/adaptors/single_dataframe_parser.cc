@@ -15,6 +15,7 @@ limitations under the License.
 
 #include <iostream>
 #include <string>
+#include <unordered_map>
 
 #include "arrow/api.h"
 #include "arrow/csv/api.h"
@@ -105,6 +106,9 @@ int main(int argc, const char** argv) {
   }
 
   DataframeStreamBuilder builder(client);
+  // n.b.: the column types are inferred per chunk and may be widened by a
+  // later chunk, thus every chunk carries its own schema, i.e., the default
+  // framing rather than "schema_once".
   auto bs = std::dynamic_pointer_cast<DataframeStream>(builder.Seal(client));
   VINEYARD_CHECK_OK(client.Persist(bs->id()));
   ReportStatus(true, VYObjectIDToString(bs->id()));
@@ -14,8 +14,10 @@ limitations under the License.
 */
 
 #include <iostream>
+#include <memory>
 #include <string>
 
+#include "basic/ds/arrow_utils.h"
 #include "basic/stream/dataframe_stream.h"
 #include "client/client.h"
 #include "io/io/local_io_adaptor.h"
@@ -43,17 +45,31 @@ int main(int argc, const char** argv) {
   LOG(INFO) << "Got dataframe stream: " << s->id();
   auto reader = s->OpenReader(client);
 
+  // tab-separated, as the lines of `DataframeStreamReader::ReadLine`, unless
+  // the location specifies the delimiter
+  if (ofile.find("delimiter=") == std::string::npos) {
+    ofile += "#delimiter=\\t";
+  }
   std::unique_ptr<LocalIOAdaptor> local_io_adaptor(
       new LocalIOAdaptor(ofile.c_str()));
   VINEYARD_CHECK_OK(local_io_adaptor->Open("w"));
 
-  std::string line;
-  while (reader->ReadLine(line).ok()) {
-    VINEYARD_CHECK_OK(local_io_adaptor->WriteLine(line));
+  // every batch is written, then released, before the next one is read,
+  // thus the retained chunks never pile up towards the threshold of
+  // streams
+  while (true) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    auto status = reader->ReadBatch(batch);
+    if (status.IsEndOfFile()) {
+      break;
+    }
+    VINEYARD_CHECK_OK(status);
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(RecordBatchesToTable({batch}, &table));
+    VINEYARD_CHECK_OK(local_io_adaptor->WriteTable(table));
   }
 
   VINEYARD_CHECK_OK(local_io_adaptor->Close());
-  local_io_adaptor->Finalize();
 
   return 0;
 }
@@ -0,0 +1,365 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "io/io/arrow_ipc_io_adaptor.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arrow/util/compression.h"
+#include "boost/algorithm/string.hpp"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+
+namespace vineyard {
+
+ArrowIPCIOAdaptor::ArrowIPCIOAdaptor(const std::string& location)
+    : concurrency_(std::thread::hardware_concurrency()) {
+  std::string path = location;
+  size_t pos = location.find_first_of('#');
+  if (pos != std::string::npos) {
+    path = location.substr(0, pos);
+    std::vector<std::string> config_list;
+    ::boost::split(config_list, location.substr(pos + 1),
+                   ::boost::is_any_of("&#"));
+    for (auto& iter : config_list) {
+      size_t eq = iter.find('=');
+      if (eq != std::string::npos) {
+        VINEYARD_SUPPRESS(Configure(iter.substr(0, eq), iter.substr(eq + 1)));
+      }
+    }
+  }
+  for (std::string const scheme : {"arrow", "feather", "file"}) {
+    if (path.substr(0, scheme.size() + 3) == scheme + "://") {
+      path = path.substr(scheme.size() + 3);
+      break;
+    }
+  }
+  if (::boost::algorithm::ends_with(path, ".arrows")) {
+    format_ = "stream";
+  }
+  location_ = path;
+  meta_.emplace("format", format_);
+}
+
+ArrowIPCIOAdaptor::~ArrowIPCIOAdaptor() { VINEYARD_SUPPRESS(Close()); }
+
+Status ArrowIPCIOAdaptor::Open() { return this->Open("r"); }
+
+Status ArrowIPCIOAdaptor::Open(const char* mode) {
+  if (strchr(mode, 'a') != NULL) {
+    return Status::NotImplemented("Appending to arrow files is not supported");
+  }
+  if (strchr(mode, 'w') != NULL) {
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        output_, arrow::io::FileOutputStream::Open(location_));
+    return Status::OK();
+  }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(arrow::io::MemoryMappedFile::Open(
+      location_, arrow::io::FileMode::READ, &input_));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      input_,
+      arrow::io::MemoryMappedFile::Open(location_, arrow::io::FileMode::READ));
+#endif
+  return Status::OK();
+}
+
+Status ArrowIPCIOAdaptor::Close() {
+  if (writer_ != nullptr) {
+    RETURN_ON_ARROW_ERROR(writer_->Close());
+    writer_ = nullptr;
+  } else if (output_ != nullptr && schema_ != nullptr) {
+    // the end-of-stream marker: continuation token and zero length
+    int32_t const eos[2] = {-1, 0};
+    RETURN_ON_ARROW_ERROR(output_->Write(eos, sizeof(eos)));
+  }
+  if (output_ != nullptr) {
+    RETURN_ON_ARROW_ERROR(output_->Close());
+    output_ = nullptr;
+  }
+  if (input_ != nullptr) {
+    RETURN_ON_ARROW_ERROR(input_->Close());
+    input_ = nullptr;
+  }
+  schema_ = nullptr;
+  return Status::OK();
+}
+
+Status ArrowIPCIOAdaptor::SetPartialRead(const int index,
+                                         const int total_parts) {
+  if (index < 0 || total_parts <= 0 || index >= total_parts) {
+    return Status::Invalid("Invalid partial read: " + std::to_string(index) +
+                           " of " + std::to_string(total_parts));
+  }
+  enable_partial_read_ = true;
+  index_ = index;
+  total_parts_ = total_parts;
+  return Status::OK();
+}
+
+Status ArrowIPCIOAdaptor::Configure(const std::string& key,
+                                    const std::string& value) {
+  if (key == "format") {
+    if (value != "file" && value != "stream") {
+      return Status::Invalid("Unknown arrow ipc format: " + value);
+    }
+    format_ = value;
+  } else if (key == "compression") {
+    compression_ = value;
+    meta_.emplace("compression", value);
+  } else if (key == "concurrency") {
+    concurrency_ = std::max(1, std::stoi(value));
+  }
+  return Status::OK();
+}
+
+bool ArrowIPCIOAdaptor::IsExist(const std::string& path) {
+  return access(location_.c_str(), 0) == 0;
+}
+
+Status ArrowIPCIOAdaptor::readBatches(
+    std::function<Status(std::shared_ptr<arrow::RecordBatch> const&)> const&
+        callback) {
+  if (input_ == nullptr) {
+    return Status::Invalid("The file is not opened for reading");
+  }
+  std::shared_ptr<arrow::RecordBatch> batch;
+  if (format_ == "stream") {
+    // the stream has no index of batches, the parts take them in turn, which
+    // is cheap as the skipped batches are never copied out of the mapping.
+    std::shared_ptr<arrow::ipc::RecordBatchReader> reader;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    RETURN_ON_ARROW_ERROR(
+        arrow::ipc::RecordBatchStreamReader::Open(input_, &reader));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        reader, arrow::ipc::RecordBatchStreamReader::Open(input_));
+#endif
+    for (int64_t idx = 0; true; ++idx) {
+      RETURN_ON_ARROW_ERROR(reader->ReadNext(&batch));
+      if (batch == nullptr) {
+        break;
+      }
+      if (idx % total_parts_ == index_) {
+        RETURN_ON_ERROR(callback(batch));
+      }
+    }
+    return Status::OK();
+  }
+
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(
+      arrow::ipc::RecordBatchFileReader::Open(input_, &reader));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      reader, arrow::ipc::RecordBatchFileReader::Open(input_));
+#endif
+  int64_t num_batches = reader->num_record_batches();
+  int64_t begin = num_batches * index_ / total_parts_;
+  int64_t end = num_batches * (index_ + 1) / total_parts_;
+  for (int64_t idx = begin; idx < end; ++idx) {
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    RETURN_ON_ARROW_ERROR(reader->ReadRecordBatch(idx, &batch));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(batch, reader->ReadRecordBatch(idx));
+#endif
+    RETURN_ON_ERROR(callback(batch));
+  }
+  return Status::OK();
+}
+
+Status ArrowIPCIOAdaptor::ReadTable(std::shared_ptr<arrow::Table>* table) {
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  RETURN_ON_ERROR(
+      readBatches([&batches](std::shared_ptr<arrow::RecordBatch> const& batch) {
+        batches.emplace_back(batch);
+        return Status::OK();
+      }));
+  if (batches.empty()) {
+    *table = nullptr;
+    return Status::OK();
+  }
+  return RecordBatchesToTable(batches, table);
+}
+
+Status ArrowIPCIOAdaptor::ReadTables(
+    std::function<Status(std::shared_ptr<arrow::Table> const&)> const&
+        callback) {
+  return readBatches([&](std::shared_ptr<arrow::RecordBatch> const& batch) {
+    std::shared_ptr<arrow::Table> table;
+    RETURN_ON_ERROR(RecordBatchesToTable({batch}, &table));
+    return callback(table);
+  });
+}
+
+static Status writeOptions(std::string const& compression,
+                           arrow::ipc::IpcWriteOptions& options) {
+  if (compression.empty()) {
+    return Status::OK();
+  }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 2000000
+  return Status::NotImplemented(
+      "Compressing arrow ipc files requires arrow 2.0.0 or newer");
+#else
+  auto codec = compression == "zstd" ? arrow::Compression::ZSTD
+                                     : arrow::Compression::LZ4_FRAME;
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(options.codec,
+                                   arrow::util::Codec::Create(codec));
+  return Status::OK();
+#endif
+}
+
+Status ArrowIPCIOAdaptor::openWriter(
+    std::shared_ptr<arrow::Schema> const& schema) {
+  auto options = arrow::ipc::IpcWriteOptions::Defaults();
+  RETURN_ON_ERROR(writeOptions(compression_, options));
+
+  bool has_dictionary = false;
+  for (auto const& field : schema->fields()) {
+    has_dictionary |= field->type()->id() == arrow::Type::DICTIONARY;
+  }
+  if (format_ == "stream" && !has_dictionary) {
+    // batches are serialized by `writeBatches` concurrently
+    std::shared_ptr<arrow::Buffer> buffer;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    arrow::ipc::DictionaryMemo memo;
+    RETURN_ON_ARROW_ERROR(arrow::ipc::SerializeSchema(
+        *schema, &memo, arrow::default_memory_pool(), &buffer));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(buffer,
+                                     arrow::ipc::SerializeSchema(*schema));
+#endif
+    RETURN_ON_ARROW_ERROR(output_->Write(buffer));
+    return Status::OK();
+  }
+
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  if (format_ == "stream") {
+    RETURN_ON_ARROW_ERROR(arrow::ipc::RecordBatchStreamWriter::Open(
+        output_.get(), schema, &writer_));
+  } else {
+    RETURN_ON_ARROW_ERROR(arrow::ipc::RecordBatchFileWriter::Open(
+        output_.get(), schema, &writer_));
+  }
+#elif defined(ARROW_VERSION) && ARROW_VERSION < 2000000
+  if (format_ == "stream") {
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        writer_, arrow::ipc::NewStreamWriter(output_.get(), schema, options));
+  } else {
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        writer_, arrow::ipc::NewFileWriter(output_.get(), schema, options));
+  }
+#else
+  if (format_ == "stream") {
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        writer_, arrow::ipc::MakeStreamWriter(output_, schema, options));
+  } else {
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        writer_, arrow::ipc::MakeFileWriter(output_, schema, options));
+  }
+#endif
+  return Status::OK();
+}
+
+Status ArrowIPCIOAdaptor::writeBatches(
+    std::vector<std::shared_ptr<arrow::RecordBatch>> const& batches) {
+  auto options = arrow::ipc::IpcWriteOptions::Defaults();
+  RETURN_ON_ERROR(writeOptions(compression_, options));
+#if !defined(ARROW_VERSION) || ARROW_VERSION >= 2000000
+  // parallelism comes from the batches
+  options.use_threads = false;
+#endif
+
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers(batches.size());
+  std::atomic<size_t> next(0);
+  std::mutex mutex;
+  Status status;
+  auto worker = [&]() {
+    while (true) {
+      size_t idx = next.fetch_add(1);
+      if (idx >= batches.size()) {
+        return;
+      }
+      Status s;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+      s = Status::ArrowError(arrow::ipc::SerializeRecordBatch(
+          *batches[idx], arrow::default_memory_pool(), &buffers[idx]));
+#else
+      auto result = arrow::ipc::SerializeRecordBatch(*batches[idx], options);
+      if (result.ok()) {
+        buffers[idx] = result.ValueOrDie();
+      } else {
+        s = Status::ArrowError(result.status());
+      }
+#endif
+      if (!s.ok()) {
+        next = batches.size();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (status.ok()) {
+          status = s;
+        }
+        return;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  size_t concurrency = std::min(concurrency_, batches.size());
+  for (size_t idx = 0; idx < concurrency; ++idx) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  RETURN_ON_ERROR(status);
+  for (auto const& buffer : buffers) {
+    RETURN_ON_ARROW_ERROR(output_->Write(buffer));
+  }
+  return Status::OK();
+}
+
+Status ArrowIPCIOAdaptor::WriteTable(
+    std::shared_ptr<arrow::Table> const& table) {
+  if (output_ == nullptr) {
+    return Status::Invalid("The file is not opened for writing");
+  }
+  if (schema_ == nullptr) {
+    RETURN_ON_ERROR(openWriter(table->schema()));
+    schema_ = table->schema();
+  } else if (!schema_->Equals(*table->schema())) {
+    return Status::Invalid("The schema of tables mismatches: " +
+                           table->schema()->ToString());
+  }
+  if (writer_ != nullptr) {
+    RETURN_ON_ARROW_ERROR(writer_->WriteTable(*table));
+    return Status::OK();
+  }
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  RETURN_ON_ERROR(TableToRecordBatches(table, &batches));
+  return writeBatches(batches);
+}
+
+}  // namespace vineyard
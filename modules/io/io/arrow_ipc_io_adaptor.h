@@ -0,0 +1,147 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MODULES_IO_IO_ARROW_IPC_IO_ADAPTOR_H_
+#define MODULES_IO_IO_ARROW_IPC_IO_ADAPTOR_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/io/api.h"
+#include "arrow/ipc/api.h"
+
+#include "common/util/status.h"
+#include "io/io/i_io_adaptor.h"
+
+namespace vineyard {
+
+/** I/O adaptor for Arrow IPC files, including Feather (V2) files.
+ *
+ * The location is in format:
+ *
+ *    arrow:///path/to/file#format=stream&compression=lz4
+ *    feather:///path/to/file
+ *
+ * or a file location whose suffix is ".arrow", ".arrows" (the stream format)
+ * or ".feather".
+ *
+ * Files are memory mapped, thus the record batches of uncompressed files are
+ * never parsed nor copied until they are written to vineyard. The record
+ * batches are the units of partial reads.
+ */
+class ArrowIPCIOAdaptor : public IIOAdaptor {
+ public:
+  explicit ArrowIPCIOAdaptor(const std::string& location);
+
+  ~ArrowIPCIOAdaptor() override;
+
+  Status Open() override;
+
+  Status Open(const char* mode) override;
+
+  Status Close() override;
+
+  Status SetPartialRead(const int index, const int total_parts) override;
+
+  /** Configure the adaptor, the supported items are:
+   *
+   *  - format: "file" (the default, also for Feather) or "stream".
+   *  - compression: the codec of written batches, "lz4" or "zstd".
+   *  - concurrency: the number of threads to serialize written batches.
+   */
+  Status Configure(const std::string& key, const std::string& value) override;
+
+  Status ReadLine(std::string& line) override {
+    return Status::NotImplemented();
+  }
+
+  Status WriteLine(const std::string& line) override {
+    return Status::NotImplemented();
+  }
+
+  Status Read(void* buffer, size_t size) override {
+    return Status::NotImplemented();
+  }
+
+  Status Write(void* buffer, size_t size) override {
+    return Status::NotImplemented();
+  }
+
+  /** Read the record batches of this part as a table, which is nullptr if
+   * there's no batch in this part.
+   */
+  Status ReadTable(std::shared_ptr<arrow::Table>* table) override;
+
+  /** Pass the record batches of this part to the callback one by one. */
+  Status ReadTables(
+      std::function<Status(std::shared_ptr<arrow::Table> const&)> const&
+          callback) override;
+
+  /** Append the table to the file, the schema is fixed by the first table.
+   *
+   * For the stream format, the record batches are serialized concurrently
+   * and written in order. For the file format, the writer compresses the
+   * buffers of every batch concurrently.
+   */
+  Status WriteTable(std::shared_ptr<arrow::Table> const& table) override;
+
+  Status ListDirectory(const std::string& path,
+                       std::vector<std::string>& files) override {
+    return Status::NotImplemented();
+  }
+
+  Status MakeDirectory(const std::string& path) override {
+    return Status::NotImplemented();
+  }
+
+  bool IsExist(const std::string& path) override;
+
+  std::unordered_multimap<std::string, std::string> GetMeta() override {
+    return meta_;
+  }
+
+ private:
+  Status readBatches(
+      std::function<Status(std::shared_ptr<arrow::RecordBatch> const&)> const&
+          callback);
+
+  Status openWriter(std::shared_ptr<arrow::Schema> const& schema);
+
+  Status writeBatches(
+      std::vector<std::shared_ptr<arrow::RecordBatch>> const& batches);
+
+  std::string location_;
+  std::string format_ = "file";  // "file" or "stream"
+  std::string compression_;
+  size_t concurrency_;
+
+  std::shared_ptr<arrow::io::MemoryMappedFile> input_;
+  std::shared_ptr<arrow::io::OutputStream> output_;
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer_;
+  std::shared_ptr<arrow::Schema> schema_;
+
+  bool enable_partial_read_ = false;
+  int index_ = 0;
+  int total_parts_ = 1;
+  std::unordered_multimap<std::string, std::string> meta_;
+};
+
+}  // namespace vineyard
+
+#endif  // MODULES_IO_IO_ARROW_IPC_IO_ADAPTOR_H_
@@ -0,0 +1,381 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "io/io/block_decompressor.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+
+namespace vineyard {
+
+namespace detail {
+
+static inline uint64_t load_le(const uint8_t* p, int const bytes) {
+  uint64_t value = 0;
+  for (int i = bytes - 1; i >= 0; --i) {
+    value = (value << 8) | p[i];
+  }
+  return value;
+}
+
+}  // namespace detail
+
+Status BlockDecompressor::Make(
+    std::string const& compression, const uint8_t* data, int64_t const size,
+    size_t const concurrency,
+    std::unique_ptr<BlockDecompressor>& decompressor) {
+  arrow::Compression::type type;
+  if (compression == "gzip") {
+    type = arrow::Compression::GZIP;
+  } else if (compression == "zstd") {
+    type = arrow::Compression::ZSTD;
+  } else if (compression == "bz2") {
+    type = arrow::Compression::BZ2;
+  } else {
+    return Status::Invalid("Unsupported compression: " + compression);
+  }
+  if (!arrow::util::Codec::IsAvailable(type)) {
+    return Status::NotImplemented("The arrow library is built without " +
+                                  compression);
+  }
+  decompressor.reset(new BlockDecompressor(type, data, size,
+                                           std::max<size_t>(1, concurrency)));
+
+  Status status = Status::NotImplemented();
+  if (type == arrow::Compression::GZIP) {
+    status = decompressor->indexBGZF();
+  } else if (type == arrow::Compression::ZSTD) {
+    status = decompressor->indexZSTD();
+  }
+  if (!status.ok()) {
+    VLOG(2) << "Decompress " << compression
+            << " sequentially: " << status.ToString();
+    decompressor->units_.clear();
+    decompressor->size_ = 0;
+    return decompressor->decompressAll();
+  }
+  if (decompressor->size_ > 0) {
+    // pages that are never touched, i.e., the units that are never
+    // decompressed, cost nothing.
+    void* addr = mmap(nullptr, decompressor->size_, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (addr == MAP_FAILED) {
+      return Status::IOError(strerror(errno));
+    }
+    decompressor->data_ = static_cast<char*>(addr);
+    decompressor->mapped_ = true;
+  }
+  VLOG(2) << "Indexed " << decompressor->units_.size() << " " << compression
+          << " units, " << decompressor->size_ << " bytes in total";
+  return Status::OK();
+}
+
+std::string BlockDecompressor::CompressionOf(std::string const& location) {
+  using ::boost::algorithm::ends_with;
+  if (ends_with(location, ".gz") || ends_with(location, ".bgz")) {
+    return "gzip";
+  } else if (ends_with(location, ".zst") || ends_with(location, ".zstd")) {
+    return "zstd";
+  } else if (ends_with(location, ".bz2")) {
+    return "bz2";
+  }
+  return "";
+}
+
+BlockDecompressor::~BlockDecompressor() {
+  if (mapped_ && data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+// See also: the BGZF section of https://samtools.github.io/hts-specs/SAMv1.pdf
+Status BlockDecompressor::indexBGZF() {
+  int64_t offset = 0;
+  while (offset < compressed_size_) {
+    const uint8_t* p = compressed_ + offset;
+    int64_t remaining = compressed_size_ - offset;
+    // the fixed header, the extra field length, and the trailer
+    if (remaining < 18 || p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 ||
+        (p[3] & 0x04) == 0) {
+      return Status::Invalid("Not a BGZF member at " + std::to_string(offset));
+    }
+    int64_t xlen = detail::load_le(p + 10, 2);
+    if (12 + xlen > remaining) {
+      return Status::Invalid("Truncated gzip header");
+    }
+    int64_t block_size = -1;
+    for (int64_t x = 12; x + 4 <= 12 + xlen;) {
+      int64_t slen = detail::load_le(p + x + 2, 2);
+      if (p[x] == 'B' && p[x + 1] == 'C' && slen == 2 && x + 6 <= 12 + xlen) {
+        block_size = detail::load_le(p + x + 4, 2) + 1;
+      }
+      x += 4 + slen;
+    }
+    if (block_size < 0 || block_size > remaining) {
+      return Status::Invalid("Not a BGZF member at " + std::to_string(offset));
+    }
+    int64_t content_size = detail::load_le(p + block_size - 4, 4);
+    units_.emplace_back(Unit{offset, block_size, size_, content_size, false});
+    size_ += content_size;
+    offset += block_size;
+  }
+  return Status::OK();
+}
+
+// See also: the zstd_compression_format.md of https://github.com/facebook/zstd
+Status BlockDecompressor::indexZSTD() {
+  static const int dict_id_sizes[4] = {0, 1, 2, 4};
+  int64_t offset = 0;
+  while (offset < compressed_size_) {
+    const uint8_t* p = compressed_ + offset;
+    int64_t remaining = compressed_size_ - offset;
+    if (remaining < 8) {
+      return Status::Invalid("Truncated zstd frame");
+    }
+    uint32_t magic = detail::load_le(p, 4);
+    if ((magic & 0xFFFFFFF0U) == 0x184D2A50U) {
+      // skippable frames have no content
+      offset += 8 + detail::load_le(p + 4, 4);
+      continue;
+    }
+    if (magic != 0xFD2FB528U) {
+      return Status::Invalid("Not a zstd frame at " + std::to_string(offset));
+    }
+    uint8_t descriptor = p[4];
+    int fcs_flag = descriptor >> 6;
+    bool single_segment = (descriptor >> 5) & 1;
+    bool checksum = (descriptor >> 2) & 1;
+    int fcs_size = fcs_flag == 0 ? (single_segment ? 1 : 0) : (1 << fcs_flag);
+    if (fcs_size == 0) {
+      return Status::NotImplemented("The content size of frame is unknown");
+    }
+    int64_t pos = 5 + (single_segment ? 0 : 1) + dict_id_sizes[descriptor & 3];
+    if (pos + fcs_size > remaining) {
+      return Status::Invalid("Truncated zstd frame header");
+    }
+    int64_t content_size = detail::load_le(p + pos, fcs_size);
+    if (fcs_size == 2) {
+      content_size += 256;
+    }
+    pos += fcs_size;
+    while (true) {
+      if (pos + 3 > remaining) {
+        return Status::Invalid("Truncated zstd block");
+      }
+      uint32_t header = detail::load_le(p + pos, 3);
+      bool last = header & 1;
+      int type = (header >> 1) & 3;
+      if (type == 3) {
+        return Status::Invalid("Reserved zstd block type");
+      }
+      // the RLE block has a single byte of content
+      pos += 3 + (type == 1 ? 1 : (header >> 3));
+      if (last) {
+        break;
+      }
+    }
+    pos += checksum ? 4 : 0;
+    if (pos > remaining) {
+      return Status::Invalid("Truncated zstd frame");
+    }
+    units_.emplace_back(Unit{offset, pos, size_, content_size, false});
+    size_ += content_size;
+    offset += pos;
+  }
+  return Status::OK();
+}
+
+Status BlockDecompressor::decompressAll() {
+#if defined(ARROW_VERSION) && ARROW_VERSION < 1000000
+  return Status::NotImplemented(
+      "Decompressing files requires arrow 1.0.0 or newer");
+#else
+  std::unique_ptr<arrow::util::Codec> codec;
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(codec, arrow::util::Codec::Create(type_));
+  std::shared_ptr<arrow::util::Decompressor> decompressor;
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(decompressor, codec->MakeDecompressor());
+  std::unique_ptr<arrow::ResizableBuffer> buffer;
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      buffer, arrow::AllocateResizableBuffer(
+                  std::max<int64_t>(compressed_size_ * 4, 1 << 20)));
+
+  int64_t consumed = 0, produced = 0;
+  while (true) {
+    if (produced == buffer->size()) {
+      RETURN_ON_ARROW_ERROR(buffer->Resize(buffer->size() * 2));
+    }
+    arrow::util::Decompressor::DecompressResult progress;
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        progress, decompressor->Decompress(
+                    compressed_size_ - consumed, compressed_ + consumed,
+                    buffer->size() - produced,
+                    buffer->mutable_data() + produced));
+    consumed += progress.bytes_read;
+    produced += progress.bytes_written;
+    if (decompressor->IsFinished()) {
+      if (consumed >= compressed_size_) {
+        break;
+      }
+      // the file is a concatenation of members, e.g., by `cat a.gz b.gz`
+      RETURN_ON_ARROW_ERROR(decompressor->Reset());
+    } else if (progress.need_more_output) {
+      RETURN_ON_ARROW_ERROR(buffer->Resize(buffer->size() * 2));
+    } else if (consumed >= compressed_size_ ||
+               (progress.bytes_read == 0 && progress.bytes_written == 0)) {
+      return Status::Invalid("The compressed file is truncated");
+    }
+  }
+  RETURN_ON_ARROW_ERROR(buffer->Resize(produced, false));
+  buffer_ = std::move(buffer);
+  data_ = reinterpret_cast<char*>(buffer_->mutable_data());
+  size_ = produced;
+  return Status::OK();
+#endif
+}
+
+Status BlockDecompressor::decompressUnits(std::vector<size_t> const& units) {
+#if defined(ARROW_VERSION) && ARROW_VERSION < 1000000
+  return Status::NotImplemented(
+      "Decompressing files requires arrow 1.0.0 or newer");
+#else
+  std::atomic<size_t> next(0);
+  std::mutex mutex;
+  Status status;
+  auto worker = [&]() {
+    // codecs are stateful, e.g., the z_stream of gzip, thus not shared
+    std::unique_ptr<arrow::util::Codec> codec;
+    auto codec_result = arrow::util::Codec::Create(type_);
+    Status s = Status::ArrowError(codec_result.status());
+    if (s.ok()) {
+      codec = std::move(codec_result).ValueOrDie();
+    }
+    while (s.ok()) {
+      size_t idx = next.fetch_add(1);
+      if (idx >= units.size()) {
+        break;
+      }
+      Unit& unit = units_[units[idx]];
+      if (unit.size > 0) {
+        auto result = codec->Decompress(
+            unit.compressed_size, compressed_ + unit.compressed_offset,
+            unit.size, reinterpret_cast<uint8_t*>(data_ + unit.offset));
+        if (!result.ok()) {
+          s = Status::ArrowError(result.status());
+        } else if (result.ValueOrDie() != unit.size) {
+          s = Status::Invalid("Corrupted unit at " +
+                              std::to_string(unit.compressed_offset));
+        }
+      }
+      unit.decompressed = s.ok();
+    }
+    if (!s.ok()) {
+      next = units.size();
+      std::lock_guard<std::mutex> lock(mutex);
+      if (status.ok()) {
+        status = s;
+      }
+    }
+  };
+  size_t concurrency = std::min(concurrency_, units.size());
+  if (concurrency <= 1) {
+    worker();
+    return status;
+  }
+  std::vector<std::thread> threads;
+  for (size_t idx = 0; idx < concurrency; ++idx) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return status;
+#endif
+}
+
+size_t BlockDecompressor::unitOf(int64_t const offset) const {
+  auto iter = std::upper_bound(
+      units_.begin(), units_.end(), offset,
+      [](int64_t const offset, Unit const& unit) {
+        return offset < unit.offset;
+      });
+  return iter == units_.begin() ? 0 : (iter - units_.begin()) - 1;
+}
+
+Status BlockDecompressor::Ensure(int64_t begin, int64_t end) {
+  begin = std::max<int64_t>(begin, 0);
+  end = std::min(end, size_);
+  if (units_.empty() || begin >= end) {
+    return Status::OK();
+  }
+  std::vector<size_t> pending;
+  for (size_t idx = unitOf(begin);
+       idx < units_.size() && units_[idx].offset < end; ++idx) {
+    if (!units_[idx].decompressed) {
+      pending.emplace_back(idx);
+    }
+  }
+  if (pending.empty()) {
+    return Status::OK();
+  }
+  return decompressUnits(pending);
+}
+
+Status BlockDecompressor::Find(int64_t const offset, char const c,
+                               int64_t const readahead, int64_t& position) {
+  position = size_;
+  if (offset >= size_) {
+    return Status::OK();
+  }
+  if (units_.empty()) {
+    const void* found = memchr(data_ + offset, c, size_ - offset);
+    if (found != nullptr) {
+      position = static_cast<const char*>(found) - data_;
+    }
+    return Status::OK();
+  }
+  for (size_t idx = unitOf(offset); idx < units_.size(); ++idx) {
+    Unit const& unit = units_[idx];
+    if (!unit.decompressed) {
+      RETURN_ON_ERROR(Ensure(unit.offset, unit.offset + std::max<int64_t>(
+                                                            readahead, 1)));
+    }
+    int64_t begin = std::max(offset, unit.offset);
+    int64_t end = unit.offset + unit.size;
+    if (begin >= end) {
+      continue;
+    }
+    const void* found = memchr(data_ + begin, c, end - begin);
+    if (found != nullptr) {
+      position = static_cast<const char*>(found) - data_;
+      return Status::OK();
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace vineyard
@@ -0,0 +1,127 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MODULES_IO_IO_BLOCK_DECOMPRESSOR_H_
+#define MODULES_IO_IO_BLOCK_DECOMPRESSOR_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/util/compression.h"
+
+#include "common/util/status.h"
+
+namespace vineyard {
+
+/**
+ * @brief A decompressed view of a compressed file that is already in memory.
+ *
+ * The file is split into independent units if the format permits, i.e., the
+ * members of a bgzip file and the frames of a zstd file whose content sizes
+ * are recorded in the frame headers. The decompressed size and the offset of
+ * every unit are known without decompressing, thus the units are decompressed
+ * on demand, in parallel, and only the units that are touched are ever
+ * decompressed, e.g., by a partial read.
+ *
+ * Otherwise, e.g., plain gzip and bzip2 files, the whole file is decompressed
+ * sequentially when the view is created.
+ *
+ * The compressed data must outlive the view.
+ */
+class BlockDecompressor {
+ public:
+  /**
+   * @brief Create a view of the compressed data.
+   *
+   * @param compression "gzip", "zstd" or "bz2".
+   * @param concurrency the number of threads to decompress units.
+   */
+  static Status Make(std::string const& compression, const uint8_t* data,
+                     int64_t const size, size_t const concurrency,
+                     std::unique_ptr<BlockDecompressor>& decompressor);
+
+  /**
+   * @brief The compression of a file location, by its suffix, or empty if the
+   * location is not compressed.
+   */
+  static std::string CompressionOf(std::string const& location);
+
+  ~BlockDecompressor();
+
+  /** The base address of the decompressed content. */
+  const char* data() const { return data_; }
+
+  /** The size of the decompressed content. */
+  int64_t size() const { return size_; }
+
+  /** The number of units that can be decompressed independently. */
+  size_t units() const { return units_.size(); }
+
+  /**
+   * @brief Make sure the content in [begin, end) has been decompressed.
+   */
+  Status Ensure(int64_t begin, int64_t end);
+
+  /**
+   * @brief Find the first byte `c` at or after the offset, decompressing the
+   * content on the way. The result is `size()` if not found.
+   *
+   * @param readahead once a unit needs to be decompressed, the following
+   * units in this many bytes are decompressed as well, in parallel, which
+   * suits sequential reads.
+   */
+  Status Find(int64_t const offset, char const c, int64_t const readahead,
+              int64_t& position);
+
+ private:
+  struct Unit {
+    int64_t compressed_offset;
+    int64_t compressed_size;
+    int64_t offset;  // of the decompressed content
+    int64_t size;
+    bool decompressed;
+  };
+
+  BlockDecompressor(arrow::Compression::type const type, const uint8_t* data,
+                    int64_t const size, size_t const concurrency)
+      : type_(type),
+        compressed_(data),
+        compressed_size_(size),
+        concurrency_(concurrency) {}
+
+  Status indexBGZF();
+  Status indexZSTD();
+  Status decompressAll();
+  Status decompressUnits(std::vector<size_t> const& units);
+  size_t unitOf(int64_t const offset) const;
+
+  arrow::Compression::type type_;
+  const uint8_t* compressed_;
+  int64_t compressed_size_;
+  size_t concurrency_;
+
+  std::vector<Unit> units_;
+  // an anonymous mapping if the file has units, otherwise a buffer
+  char* data_ = nullptr;
+  int64_t size_ = 0;
+  bool mapped_ = false;
+  std::shared_ptr<arrow::ResizableBuffer> buffer_;
+};
+
+}  // namespace vineyard
+
+#endif  // MODULES_IO_IO_BLOCK_DECOMPRESSOR_H_
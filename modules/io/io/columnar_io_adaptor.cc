@@ -0,0 +1,519 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "io/io/columnar_io_adaptor.h"
+
+#if defined(PARQUET_ENABLED) || defined(ORC_ENABLED)
+
+#include <unistd.h>
+
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+#include "glog/logging.h"
+
+#ifdef PARQUET_ENABLED
+#include "parquet/arrow/reader.h"
+#include "parquet/arrow/writer.h"
+#include "parquet/metadata.h"
+#include "parquet/statistics.h"
+#endif
+#ifdef ORC_ENABLED
+#include "arrow/adapters/orc/adapter.h"
+#endif
+
+#include "basic/ds/arrow_utils.h"
+
+namespace vineyard {
+
+Status ColumnPredicate::Parse(std::string const& expr,
+                              ColumnPredicate& predicate) {
+  static const std::regex pattern(
+      R"(^\s*([^\s=!<>]+)\s*(==|!=|<=|>=|<|>)\s*(\S+)\s*$)");
+  std::smatch match;
+  if (!std::regex_match(expr, match, pattern)) {
+    return Status::Invalid("Invalid predicate: " + expr);
+  }
+  predicate.column = match[1];
+  predicate.op = match[2];
+  try {
+    predicate.value = std::stod(match[3]);
+  } catch (std::exception const&) {
+    return Status::Invalid("Only numeric predicates are supported: " + expr);
+  }
+  return Status::OK();
+}
+
+bool ColumnPredicate::MayMatch(double const min, double const max) const {
+  if (op == "==") {
+    return min <= value && value <= max;
+  } else if (op == "!=") {
+    return !(min == value && max == value);
+  } else if (op == "<") {
+    return min < value;
+  } else if (op == "<=") {
+    return min <= value;
+  } else if (op == ">") {
+    return max > value;
+  } else if (op == ">=") {
+    return max >= value;
+  }
+  return true;
+}
+
+struct ColumnarIOAdaptor::Reader {
+#ifdef PARQUET_ENABLED
+  std::unique_ptr<parquet::arrow::FileReader> parquet;
+#endif
+#ifdef ORC_ENABLED
+  std::unique_ptr<arrow::adapters::orc::ORCFileReader> orc;
+#endif
+};
+
+struct ColumnarIOAdaptor::Writer {
+#ifdef PARQUET_ENABLED
+  std::unique_ptr<parquet::arrow::FileWriter> parquet;
+#endif
+};
+
+ColumnarIOAdaptor::ColumnarIOAdaptor(const std::string& location)
+    : concurrency_(std::thread::hardware_concurrency()) {
+  std::string path = location;
+  size_t pos = location.find_first_of('#');
+  if (pos != std::string::npos) {
+    path = location.substr(0, pos);
+    std::vector<std::string> config_list;
+    ::boost::split(config_list, location.substr(pos + 1),
+                   ::boost::is_any_of("&#"));
+    for (auto& iter : config_list) {
+      size_t eq = iter.find('=');
+      if (eq != std::string::npos) {
+        VINEYARD_SUPPRESS(Configure(iter.substr(0, eq), iter.substr(eq + 1)));
+      }
+    }
+  }
+  for (std::string const scheme : {"parquet", "orc", "file"}) {
+    if (path.substr(0, scheme.size() + 3) == scheme + "://") {
+      if (scheme != "file") {
+        format_ = scheme;
+      }
+      path = path.substr(scheme.size() + 3);
+      break;
+    }
+  }
+  if (format_.empty()) {
+    format_ = ::boost::algorithm::ends_with(path, ".orc") ? "orc" : "parquet";
+  }
+  location_ = path;
+  meta_.emplace("format", format_);
+}
+
+ColumnarIOAdaptor::~ColumnarIOAdaptor() { VINEYARD_SUPPRESS(Close()); }
+
+Status ColumnarIOAdaptor::Open() { return this->Open("r"); }
+
+Status ColumnarIOAdaptor::Open(const char* mode) {
+  if (strchr(mode, 'w') != NULL || strchr(mode, 'a') != NULL) {
+    if (format_ != "parquet" || strchr(mode, 'a') != NULL) {
+      return Status::NotImplemented("Only writing parquet files is supported");
+    }
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        output_, arrow::io::FileOutputStream::Open(location_));
+    writer_.reset(new Writer());
+    return Status::OK();
+  }
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(file_,
+                                   arrow::io::ReadableFile::Open(location_));
+  Reader reader;
+  RETURN_ON_ERROR(openReader(reader));
+  return selectUnits(reader);
+}
+
+Status ColumnarIOAdaptor::Close() {
+#ifdef PARQUET_ENABLED
+  if (writer_ != nullptr && writer_->parquet != nullptr) {
+    RETURN_ON_ARROW_ERROR(writer_->parquet->Close());
+  }
+#endif
+  writer_.reset();
+  if (output_ != nullptr) {
+    RETURN_ON_ARROW_ERROR(output_->Close());
+    output_ = nullptr;
+  }
+  if (file_ != nullptr) {
+    RETURN_ON_ARROW_ERROR(file_->Close());
+    file_ = nullptr;
+  }
+  return Status::OK();
+}
+
+Status ColumnarIOAdaptor::SetPartialRead(const int index,
+                                         const int total_parts) {
+  if (index < 0 || total_parts <= 0 || index >= total_parts) {
+    return Status::Invalid("Invalid partial read: " + std::to_string(index) +
+                           " of " + std::to_string(total_parts));
+  }
+  if (file_ != nullptr) {
+    return Status::Invalid("Set partial read after open has no effect");
+  }
+  enable_partial_read_ = true;
+  index_ = index;
+  total_parts_ = total_parts;
+  return Status::OK();
+}
+
+Status ColumnarIOAdaptor::Configure(const std::string& key,
+                                    const std::string& value) {
+  if (key == "columns") {
+    columns_.clear();
+    ::boost::split(columns_, value, ::boost::is_any_of(","));
+    meta_.emplace("columns", value);
+  } else if (key == "filter") {
+    ColumnPredicate predicate;
+    RETURN_ON_ERROR(ColumnPredicate::Parse(value, predicate));
+    predicates_.emplace_back(predicate);
+    meta_.emplace("filter", value);
+  } else if (key == "concurrency") {
+    concurrency_ = std::max(1, std::stoi(value));
+  } else if (key == "compression") {
+    compression_ = value;
+  } else if (key == "row_group_size") {
+    row_group_size_ = std::max<int64_t>(1, std::stoll(value));
+  }
+  return Status::OK();
+}
+
+bool ColumnarIOAdaptor::IsExist(const std::string& path) {
+  return access(location_.c_str(), 0) == 0;
+}
+
+Status ColumnarIOAdaptor::openReader(Reader& reader) {
+  if (format_ == "parquet") {
+#ifdef PARQUET_ENABLED
+#if defined(ARROW_VERSION) && ARROW_VERSION < 19000000
+    RETURN_ON_ARROW_ERROR(parquet::arrow::OpenFile(
+        file_, arrow::default_memory_pool(), &reader.parquet));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        reader.parquet,
+        parquet::arrow::OpenFile(file_, arrow::default_memory_pool()));
+#endif
+    return Status::OK();
+#endif
+  } else if (format_ == "orc") {
+#ifdef ORC_ENABLED
+#if defined(ARROW_VERSION) && ARROW_VERSION < 5000000
+    RETURN_ON_ARROW_ERROR(arrow::adapters::orc::ORCFileReader::Open(
+        file_, arrow::default_memory_pool(), &reader.orc));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        reader.orc, arrow::adapters::orc::ORCFileReader::Open(
+                        file_, arrow::default_memory_pool()));
+#endif
+    return Status::OK();
+#endif
+  }
+  return Status::NotImplemented("Unsupported columnar format: " + format_);
+}
+
+#ifdef PARQUET_ENABLED
+// the statistics are compared as doubles, thus only plain signed integers and
+// floats are comparable, rather than, e.g., decimals, unsigned integers or
+// timestamps, whose physical values differ from the logical ones
+static bool IsComparableColumn(parquet::ColumnDescriptor const* column) {
+  auto const& logical_type = column->logical_type();
+  if (logical_type == nullptr || logical_type->is_none()) {
+    return true;
+  }
+  if (logical_type->is_int()) {
+    return std::static_pointer_cast<const parquet::IntLogicalType>(
+               logical_type)
+        ->is_signed();
+  }
+  return false;
+}
+#endif
+
+Status ColumnarIOAdaptor::selectUnits(Reader& reader) {
+  int64_t total_units = 0;
+  column_indices_.clear();
+  units_.clear();
+#ifdef PARQUET_ENABLED
+  std::shared_ptr<parquet::FileMetaData> metadata;
+  if (reader.parquet != nullptr) {
+    metadata = reader.parquet->parquet_reader()->metadata();
+    total_units = reader.parquet->num_row_groups();
+    for (auto const& column : columns_) {
+      int index = metadata->schema()->ColumnIndex(column);
+      if (index < 0) {
+        return Status::Invalid("Column not found: " + column);
+      }
+      column_indices_.emplace_back(index);
+    }
+  }
+#endif
+#ifdef ORC_ENABLED
+  if (reader.orc != nullptr) {
+    total_units = reader.orc->NumberOfStripes();
+    std::shared_ptr<arrow::Schema> schema;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 5000000
+    RETURN_ON_ARROW_ERROR(reader.orc->ReadSchema(&schema));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(schema, reader.orc->ReadSchema());
+#endif
+    for (auto const& column : columns_) {
+      int index = schema->GetFieldIndex(column);
+      if (index < 0) {
+        return Status::Invalid("Column not found: " + column);
+      }
+      column_indices_.emplace_back(index);
+    }
+  }
+#endif
+
+  int64_t begin = 0, end = total_units;
+  if (enable_partial_read_) {
+    begin = total_units * index_ / total_parts_;
+    end = total_units * (index_ + 1) / total_parts_;
+  }
+  for (int64_t unit = begin; unit < end; ++unit) {
+    bool selected = true;
+#ifdef PARQUET_ENABLED
+    if (metadata != nullptr) {
+      auto row_group = metadata->RowGroup(unit);
+      for (auto const& predicate : predicates_) {
+        int index = metadata->schema()->ColumnIndex(predicate.column);
+        if (index < 0) {
+          return Status::Invalid("Column not found: " + predicate.column);
+        }
+        if (!IsComparableColumn(metadata->schema()->Column(index))) {
+          continue;
+        }
+        auto stats = row_group->ColumnChunk(index)->statistics();
+        if (stats == nullptr || !stats->HasMinMax()) {
+          continue;
+        }
+        double min = 0, max = 0;
+        switch (stats->physical_type()) {
+        case parquet::Type::INT32: {
+          auto typed =
+              std::static_pointer_cast<parquet::Int32Statistics>(stats);
+          min = typed->min(), max = typed->max();
+          break;
+        }
+        case parquet::Type::INT64: {
+          auto typed =
+              std::static_pointer_cast<parquet::Int64Statistics>(stats);
+          min = typed->min(), max = typed->max();
+          break;
+        }
+        case parquet::Type::FLOAT: {
+          auto typed =
+              std::static_pointer_cast<parquet::FloatStatistics>(stats);
+          min = typed->min(), max = typed->max();
+          break;
+        }
+        case parquet::Type::DOUBLE: {
+          auto typed =
+              std::static_pointer_cast<parquet::DoubleStatistics>(stats);
+          min = typed->min(), max = typed->max();
+          break;
+        }
+        default:
+          continue;
+        }
+        if (!predicate.MayMatch(min, max)) {
+          selected = false;
+          break;
+        }
+      }
+    }
+#endif
+    if (selected) {
+      units_.emplace_back(unit);
+    }
+  }
+  VLOG(2) << "[" << format_ << "-" << location_ << "] selects "
+          << units_.size() << " of " << (end - begin) << " units";
+  return Status::OK();
+}
+
+Status ColumnarIOAdaptor::readUnit(Reader& reader, int64_t const unit,
+                                   std::shared_ptr<arrow::Table>* table) {
+#ifdef PARQUET_ENABLED
+  if (reader.parquet != nullptr) {
+    if (columns_.empty()) {
+      RETURN_ON_ARROW_ERROR(reader.parquet->ReadRowGroup(unit, table));
+    } else {
+      RETURN_ON_ARROW_ERROR(
+          reader.parquet->ReadRowGroup(unit, column_indices_, table));
+    }
+    return Status::OK();
+  }
+#endif
+#ifdef ORC_ENABLED
+  if (reader.orc != nullptr) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 5000000
+    if (columns_.empty()) {
+      RETURN_ON_ARROW_ERROR(reader.orc->ReadStripe(unit, &batch));
+    } else {
+      RETURN_ON_ARROW_ERROR(
+          reader.orc->ReadStripe(unit, column_indices_, &batch));
+    }
+#else
+    if (columns_.empty()) {
+      RETURN_ON_ARROW_ERROR_AND_ASSIGN(batch, reader.orc->ReadStripe(unit));
+    } else {
+      RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+          batch, reader.orc->ReadStripe(unit, column_indices_));
+    }
+#endif
+    return RecordBatchesToTable({batch}, table);
+  }
+#endif
+  return Status::Invalid("The reader is not opened");
+}
+
+Status ColumnarIOAdaptor::readUnits(
+    std::function<Status(size_t const, std::shared_ptr<arrow::Table> const&)>
+        const& callback) {
+  if (file_ == nullptr) {
+    return Status::Invalid("The file is not opened");
+  }
+  std::atomic<size_t> next(0);
+  std::mutex mutex;
+  Status status;
+  // every thread reads with its own reader, on the shared file
+  auto worker = [&]() {
+    Reader reader;
+    auto s = openReader(reader);
+    while (s.ok()) {
+      size_t pos = next.fetch_add(1);
+      if (pos >= units_.size()) {
+        break;
+      }
+      std::shared_ptr<arrow::Table> table;
+      s = readUnit(reader, units_[pos], &table);
+      if (s.ok()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        s = callback(pos, table);
+      }
+    }
+    if (!s.ok()) {
+      next = units_.size();
+      std::lock_guard<std::mutex> lock(mutex);
+      if (status.ok()) {
+        status = s;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  size_t concurrency = std::min(concurrency_, units_.size());
+  for (size_t idx = 0; idx < concurrency; ++idx) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return status;
+}
+
+Status ColumnarIOAdaptor::ReadTable(std::shared_ptr<arrow::Table>* table) {
+  std::vector<std::shared_ptr<arrow::Table>> tables(units_.size());
+  RETURN_ON_ERROR(readUnits(
+      [&](size_t const pos, std::shared_ptr<arrow::Table> const& piece) {
+        tables[pos] = piece;
+        return Status::OK();
+      }));
+  if (tables.empty()) {
+    *table = nullptr;
+    return Status::OK();
+  }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(arrow::ConcatenateTables(tables, table));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(*table, arrow::ConcatenateTables(tables));
+#endif
+  return Status::OK();
+}
+
+Status ColumnarIOAdaptor::ReadTables(
+    std::function<Status(std::shared_ptr<arrow::Table> const&)> const&
+        callback) {
+  return readUnits(
+      [&](size_t const, std::shared_ptr<arrow::Table> const& piece) {
+        return callback(piece);
+      });
+}
+
+Status ColumnarIOAdaptor::WriteTable(
+    std::shared_ptr<arrow::Table> const& table) {
+  if (writer_ == nullptr) {
+    return Status::Invalid("The file is not opened for writing: " + location_);
+  }
+#ifdef PARQUET_ENABLED
+  if (writer_->parquet == nullptr) {
+    parquet::WriterProperties::Builder builder;
+    if (compression_ == "snappy") {
+      builder.compression(parquet::Compression::SNAPPY);
+    } else if (compression_ == "gzip") {
+      builder.compression(parquet::Compression::GZIP);
+    } else if (compression_ == "zstd") {
+      builder.compression(parquet::Compression::ZSTD);
+    } else if (compression_ == "brotli") {
+      builder.compression(parquet::Compression::BROTLI);
+    } else if (compression_ == "none") {
+      builder.compression(parquet::Compression::UNCOMPRESSED);
+    } else {
+      return Status::Invalid("Unsupported parquet compression: " +
+                             compression_);
+    }
+    parquet::ArrowWriterProperties::Builder arrow_builder;
+#if !defined(ARROW_VERSION) || ARROW_VERSION >= 9000000
+    // encodes the column chunks of a row group in arrow's cpu thread pool
+    arrow_builder.set_use_threads(concurrency_ > 1);
+#endif
+#if defined(ARROW_VERSION) && ARROW_VERSION < 9000000
+    RETURN_ON_ARROW_ERROR(parquet::arrow::FileWriter::Open(
+        *table->schema(), arrow::default_memory_pool(), output_,
+        builder.build(), arrow_builder.build(), &writer_->parquet));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        writer_->parquet,
+        parquet::arrow::FileWriter::Open(
+            *table->schema(), arrow::default_memory_pool(), output_,
+            builder.build(), arrow_builder.build()));
+#endif
+  }
+  RETURN_ON_ARROW_ERROR(writer_->parquet->WriteTable(*table, row_group_size_));
+  return Status::OK();
+#else
+  return Status::NotImplemented("Writing parquet files is not supported");
+#endif
+}
+
+}  // namespace vineyard
+
+#endif  // PARQUET_ENABLED || ORC_ENABLED
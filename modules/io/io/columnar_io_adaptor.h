@@ -0,0 +1,188 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MODULES_IO_IO_COLUMNAR_IO_ADAPTOR_H_
+#define MODULES_IO_IO_COLUMNAR_IO_ADAPTOR_H_
+
+#if defined(PARQUET_ENABLED) || defined(ORC_ENABLED)
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/io/api.h"
+
+#include "common/util/status.h"
+#include "io/io/i_io_adaptor.h"
+
+namespace vineyard {
+
+/**
+ * A predicate on a numeric column, e.g., "age>=18", which prunes the row
+ * groups whose statistics cannot satisfy it.
+ */
+struct ColumnPredicate {
+  std::string column;
+  std::string op;  // one of "==", "!=", "<", "<=", ">", ">="
+  double value;
+
+  static Status Parse(std::string const& expr, ColumnPredicate& predicate);
+
+  /** Whether any value in [min, max] may satisfy the predicate. */
+  bool MayMatch(double const min, double const max) const;
+};
+
+/** I/O adaptor for columnar files, i.e., Parquet and ORC.
+ *
+ * The location is in format:
+ *
+ *    parquet:///path/to/file#columns=a,b&filter=a>10&filter=b<=0.5
+ *    orc:///path/to/file#columns=a,b
+ *
+ * or a file location whose suffix is ".parquet" or ".orc".
+ *
+ * Only the given columns are read. The row groups (Parquet) or stripes (ORC)
+ * are the units of partial reads, and are read concurrently. The filters prune
+ * Parquet row groups by the min/max statistics of the columns, i.e., the rows
+ * in the remaining row groups are not filtered one by one. Only the columns of
+ * plain signed integers and floats are used for pruning, e.g., the decimal and
+ * unsigned columns are never pruned. ORC stripes are not pruned, as the
+ * statistics are not exposed by Arrow's ORC adaptor.
+ *
+ * Parquet files could be written as well, where the column chunks of a row
+ * group are encoded concurrently.
+ */
+class ColumnarIOAdaptor : public IIOAdaptor {
+ public:
+  explicit ColumnarIOAdaptor(const std::string& location);
+
+  ~ColumnarIOAdaptor() override;
+
+  Status Open() override;
+
+  Status Open(const char* mode) override;
+
+  Status Close() override;
+
+  Status SetPartialRead(const int index, const int total_parts) override;
+
+  /** Configure the adaptor, the supported items are:
+   *
+   *  - columns: the comma-separated names of columns to read.
+   *  - filter: a predicate to prune row groups, could be configured many times.
+   *  - concurrency: the number of threads to read row groups or stripes,
+   *    and the column chunks are encoded concurrently when writing if it is
+   *    greater than 1.
+   *  - compression: of the written parquet files, "snappy" (by default),
+   *    "gzip", "zstd", "brotli" or "none".
+   *  - row_group_size: the maximum rows of a written row group.
+   */
+  Status Configure(const std::string& key, const std::string& value) override;
+
+  Status ReadLine(std::string& line) override {
+    return Status::NotImplemented();
+  }
+
+  Status WriteLine(const std::string& line) override {
+    return Status::NotImplemented();
+  }
+
+  Status Read(void* buffer, size_t size) override {
+    return Status::NotImplemented();
+  }
+
+  Status Write(void* buffer, size_t size) override {
+    return Status::NotImplemented();
+  }
+
+  /** Read the selected row groups as a table, which is nullptr if none of the
+   * row groups is selected.
+   */
+  Status ReadTable(std::shared_ptr<arrow::Table>* table) override;
+
+  /** Pass every selected row group to the callback once it has been read,
+   * which is out of order, and the calls are serialized.
+   */
+  Status ReadTables(
+      std::function<Status(std::shared_ptr<arrow::Table> const&)> const&
+          callback) override;
+
+  /** Append the table to the Parquet file as row groups, the tables must
+   * share the same schema.
+   */
+  Status WriteTable(std::shared_ptr<arrow::Table> const& table) override;
+
+  Status ListDirectory(const std::string& path,
+                       std::vector<std::string>& files) override {
+    return Status::NotImplemented();
+  }
+
+  Status MakeDirectory(const std::string& path) override {
+    return Status::NotImplemented();
+  }
+
+  bool IsExist(const std::string& path) override;
+
+  std::unordered_multimap<std::string, std::string> GetMeta() override {
+    return meta_;
+  }
+
+  /** The row groups (or stripes) that will be read. */
+  std::vector<int64_t> const& units() const { return units_; }
+
+ private:
+  struct Reader;
+  struct Writer;
+
+  Status openReader(Reader& reader);
+
+  Status readUnit(Reader& reader, int64_t const unit,
+                  std::shared_ptr<arrow::Table>* table);
+
+  Status readUnits(std::function<Status(size_t const,
+                                        std::shared_ptr<arrow::Table> const&)>
+                       const& callback);
+
+  Status selectUnits(Reader& reader);
+
+  std::string location_;
+  std::string format_;  // "parquet" or "orc"
+  std::vector<std::string> columns_;
+  std::vector<ColumnPredicate> predicates_;
+  size_t concurrency_;
+
+  std::shared_ptr<arrow::io::RandomAccessFile> file_;
+
+  std::string compression_ = "snappy";
+  int64_t row_group_size_ = 1024 * 1024;
+  std::shared_ptr<arrow::io::OutputStream> output_;
+  std::unique_ptr<Writer> writer_;
+  std::vector<int> column_indices_;
+  std::vector<int64_t> units_;
+
+  bool enable_partial_read_ = false;
+  int index_ = 0;
+  int total_parts_ = 1;
+  std::unordered_multimap<std::string, std::string> meta_;
+};
+
+}  // namespace vineyard
+
+#endif  // PARQUET_ENABLED || ORC_ENABLED
+
+#endif  // MODULES_IO_IO_COLUMNAR_IO_ADAPTOR_H_
@@ -0,0 +1,283 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "io/io/csv_chunk_parser.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(ARROW_VERSION) && ARROW_VERSION < 1000000
+#include "arrow/compute/context.h"
+#include "arrow/compute/kernels/cast.h"
+#else
+#include "arrow/compute/cast.h"
+#endif
+#include "arrow/csv/api.h"
+#include "arrow/io/api.h"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+
+namespace vineyard {
+
+namespace detail {
+
+inline bool isCSVInteger(arrow::Type::type const type) {
+  switch (type) {
+  case arrow::Type::INT8:
+  case arrow::Type::INT16:
+  case arrow::Type::INT32:
+  case arrow::Type::INT64:
+  case arrow::Type::UINT8:
+  case arrow::Type::UINT16:
+  case arrow::Type::UINT32:
+  case arrow::Type::UINT64:
+    return true;
+  default:
+    return false;
+  }
+}
+
+inline bool isCSVNumber(arrow::Type::type const type) {
+  return isCSVInteger(type) || type == arrow::Type::HALF_FLOAT ||
+         type == arrow::Type::FLOAT || type == arrow::Type::DOUBLE;
+}
+
+}  // namespace detail
+
+std::shared_ptr<arrow::DataType> PromoteCSVType(
+    std::shared_ptr<arrow::DataType> const& a,
+    std::shared_ptr<arrow::DataType> const& b) {
+  if (a == nullptr || a->id() == arrow::Type::NA) {
+    return b;
+  }
+  if (b == nullptr || b->id() == arrow::Type::NA || a->Equals(b)) {
+    return a;
+  }
+  if (detail::isCSVInteger(a->id()) && detail::isCSVInteger(b->id())) {
+    return arrow::int64();
+  }
+  if (detail::isCSVNumber(a->id()) && detail::isCSVNumber(b->id())) {
+    return arrow::float64();
+  }
+  return arrow::utf8();
+}
+
+Status PromoteCSVSchema(
+    std::vector<std::shared_ptr<arrow::Table>> const& tables,
+    std::shared_ptr<arrow::Schema>& schema) {
+  schema = nullptr;
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (auto const& table : tables) {
+    auto const& other = table->schema();
+    if (schema == nullptr) {
+      schema = other;
+      fields = other->fields();
+      continue;
+    }
+    if (other->num_fields() != static_cast<int>(fields.size())) {
+      return Status::Invalid("The tables have different columns: " +
+                             schema->ToString() + " vs. " + other->ToString());
+    }
+    for (size_t idx = 0; idx < fields.size(); ++idx) {
+      auto const& field = other->field(idx);
+      if (field->name() != fields[idx]->name()) {
+        return Status::Invalid("The tables have different columns: " +
+                               schema->ToString() + " vs. " +
+                               other->ToString());
+      }
+      fields[idx] = fields[idx]->WithType(
+          PromoteCSVType(fields[idx]->type(), field->type()));
+    }
+  }
+  if (schema != nullptr) {
+    schema = arrow::schema(fields, schema->metadata());
+  }
+  return Status::OK();
+}
+
+Status CastCSVTable(std::shared_ptr<arrow::Table> const& table,
+                    std::shared_ptr<arrow::Schema> const& schema,
+                    std::shared_ptr<arrow::Table>& out) {
+  if (table->schema()->Equals(*schema, false)) {
+    out = table;
+    return Status::OK();
+  }
+  if (table->num_columns() != schema->num_fields()) {
+    return Status::Invalid("Cannot cast the table of " +
+                           table->schema()->ToString() + " to " +
+                           schema->ToString());
+  }
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int idx = 0; idx < table->num_columns(); ++idx) {
+    auto const& column = table->column(idx);
+    auto const& type = schema->field(idx)->type();
+    if (table->schema()->field(idx)->name() != schema->field(idx)->name()) {
+      return Status::Invalid("Cannot cast the table of " +
+                             table->schema()->ToString() + " to " +
+                             schema->ToString());
+    }
+    if (column->type()->Equals(type)) {
+      columns.emplace_back(column);
+      continue;
+    }
+    std::vector<std::shared_ptr<arrow::Array>> chunks;
+    for (auto const& chunk : column->chunks()) {
+      std::shared_ptr<arrow::Array> cast;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 1000000
+      arrow::compute::FunctionContext context(arrow::default_memory_pool());
+      RETURN_ON_ARROW_ERROR(arrow::compute::Cast(
+          &context, *chunk, type, arrow::compute::CastOptions::Safe(), &cast));
+#else
+      RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+          cast, arrow::compute::Cast(*chunk, type,
+                                     arrow::compute::CastOptions::Safe()));
+#endif
+      chunks.emplace_back(cast);
+    }
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(chunks, type));
+  }
+  out = arrow::Table::Make(schema, columns, table->num_rows());
+  return Status::OK();
+}
+
+Status CSVLineSplitter::Feed(std::shared_ptr<arrow::Buffer> const& chunk,
+                             piece_callback_t const& callback) {
+  const char* data = reinterpret_cast<const char*>(chunk->data());
+  const char* last =
+      static_cast<const char*>(memrchr(data, '\n', chunk->size()));
+  if (last == nullptr) {
+    carry_.append(data, chunk->size());
+    return Status::OK();
+  }
+  int64_t begin = 0, end = last - data + 1;
+  if (!carry_.empty()) {
+    const char* first =
+        static_cast<const char*>(memchr(data, '\n', chunk->size()));
+    begin = first - data + 1;
+    carry_.append(data, begin);
+    auto piece = arrow::Buffer::FromString(std::move(carry_));
+    carry_.clear();
+    RETURN_ON_ERROR(callback(piece));
+  }
+  if (end > begin) {
+    RETURN_ON_ERROR(callback(arrow::SliceBuffer(chunk, begin, end - begin)));
+  }
+  carry_.assign(last + 1, chunk->size() - end);
+  return Status::OK();
+}
+
+Status CSVLineSplitter::Flush(piece_callback_t const& callback) {
+  if (carry_.empty()) {
+    return Status::OK();
+  }
+  auto piece = arrow::Buffer::FromString(std::move(carry_));
+  carry_.clear();
+  return callback(piece);
+}
+
+Status CSVChunkParser::Parse(std::shared_ptr<arrow::Buffer> const& buffer,
+                             std::shared_ptr<arrow::Table>& table) {
+  // every round either returns, or strictly widens the pinned types, thus
+  // there are at most a few rounds.
+  for (int round = 0; round < 8; ++round) {
+    types_t types;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto const& item : types_) {
+        // the columns that have been empty so far are still inferred
+        if (item.second->id() != arrow::Type::NA) {
+          types.emplace(item);
+        }
+      }
+    }
+    auto status = parse(buffer, types, table);
+    if (!status.ok()) {
+      if (types.empty()) {
+        return status;
+      }
+      // the values don't fit the pinned types, infer the types of this chunk
+      VLOG(2) << "Re-parse the chunk as it doesn't fit the column types: "
+              << status.ToString();
+      RETURN_ON_ERROR(parse(buffer, {}, table));
+    }
+
+    bool fits = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& field : table->schema()->fields()) {
+      auto& type = types_[field->name()];
+      auto promoted = PromoteCSVType(type, field->type());
+      if (!promoted->Equals(field->type())) {
+        // the table is narrower than the pinned types, e.g., another chunk
+        // has been parsed in the meantime.
+        fits = false;
+      }
+      if (type == nullptr || !promoted->Equals(type)) {
+        if (type != nullptr) {
+          VLOG(2) << "Promote the column '" << field->name() << "' from "
+                  << type->ToString() << " to " << promoted->ToString();
+        }
+        type = promoted;
+      }
+    }
+    if (fits) {
+      return Status::OK();
+    }
+  }
+  return Status::Invalid("Failed to unify the column types of CSV chunks");
+}
+
+std::unordered_map<std::string, std::shared_ptr<arrow::DataType>>
+CSVChunkParser::Types() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return types_;
+}
+
+Status CSVChunkParser::parse(std::shared_ptr<arrow::Buffer> const& buffer,
+                             types_t const& types,
+                             std::shared_ptr<arrow::Table>& table) {
+  auto buffer_reader = std::make_shared<arrow::io::BufferReader>(buffer);
+  std::shared_ptr<arrow::io::InputStream> input =
+      arrow::io::RandomAccessFile::GetStream(buffer_reader, 0, buffer->size());
+
+  auto read_options = arrow::csv::ReadOptions::Defaults();
+  auto parse_options = arrow::csv::ParseOptions::Defaults();
+  auto convert_options = arrow::csv::ConvertOptions::Defaults();
+  if (column_names_.size() > 0) {
+    read_options.column_names = column_names_;
+  } else {
+    read_options.autogenerate_column_names = true;
+  }
+  read_options.use_threads = use_threads_;
+  parse_options.delimiter = delimiter_;
+  convert_options.column_types = types;
+  convert_options.include_columns = include_columns_;
+
+  std::shared_ptr<arrow::csv::TableReader> reader;
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      reader,
+      arrow::csv::TableReader::Make(arrow::default_memory_pool(), input,
+                                    read_options, parse_options,
+                                    convert_options));
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(table, reader->Read());
+  RETURN_ON_ARROW_ERROR(table->Validate());
+  return Status::OK();
+}
+
+}  // namespace vineyard
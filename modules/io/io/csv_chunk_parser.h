@@ -0,0 +1,155 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MODULES_IO_IO_CSV_CHUNK_PARSER_H_
+#define MODULES_IO_IO_CSV_CHUNK_PARSER_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow/api.h"
+
+#include "common/util/status.h"
+
+namespace vineyard {
+
+/**
+ * @brief The narrowest type that holds the values of both types, when a column
+ * is inferred as `a` in some chunks and `b` in the others: integers are widened
+ * to int64, mixed integers and floating numbers to double, and any other mix to
+ * string. The null type yields the other type.
+ */
+std::shared_ptr<arrow::DataType> PromoteCSVType(
+    std::shared_ptr<arrow::DataType> const& a,
+    std::shared_ptr<arrow::DataType> const& b);
+
+/**
+ * @brief The schema that holds all the tables, whose columns are the same by
+ * names and in order, with the column types promoted by `PromoteCSVType`.
+ */
+Status PromoteCSVSchema(
+    std::vector<std::shared_ptr<arrow::Table>> const& tables,
+    std::shared_ptr<arrow::Schema>& schema);
+
+/**
+ * @brief Cast the columns of the table to the types of the schema, whose
+ * columns are the same as the table's by names and in order, e.g., to unify
+ * the tables parsed before and after the column types are promoted.
+ *
+ * The cast is safe, i.e., fails when a value doesn't fit the type, e.g., a
+ * promoted table can't be cast back to the narrower types.
+ */
+Status CastCSVTable(std::shared_ptr<arrow::Table> const& table,
+                    std::shared_ptr<arrow::Schema> const& schema,
+                    std::shared_ptr<arrow::Table>& out);
+
+/**
+ * @brief Split the chunks of a byte stream at line breaks, so that every piece
+ * passed to the callback consists of complete lines.
+ *
+ * The pieces are slices of the chunks, except the lines that span chunks,
+ * which are the only bytes that are copied.
+ */
+class CSVLineSplitter {
+ public:
+  using piece_callback_t =
+      std::function<Status(std::shared_ptr<arrow::Buffer> const&)>;
+
+  /**
+   * @brief Pass the complete lines of the chunk to the callback, and keep the
+   * trailing partial line until the following chunks complete it.
+   */
+  Status Feed(std::shared_ptr<arrow::Buffer> const& chunk,
+              piece_callback_t const& callback);
+
+  /**
+   * @brief Pass the pending partial line, if any, as the last piece.
+   */
+  Status Flush(piece_callback_t const& callback);
+
+ private:
+  std::string carry_;
+};
+
+/**
+ * @brief Parse chunks of CSV lines into tables of a consistent schema.
+ *
+ * The column types are inferred from the first chunk, and pinned for the
+ * following chunks, thus a chunk whose values happen to fit a narrower type,
+ * e.g., integral values of a double column, or an empty column, won't change
+ * the schema. When the values of a chunk don't fit the pinned types, the types
+ * are promoted by `PromoteCSVType`, and the tables parsed afterwards have the
+ * wider schema, while the tables returned before are kept as they are.
+ *
+ * `Parse` can be invoked by many threads concurrently.
+ */
+class CSVChunkParser {
+ public:
+  /**
+   * @param delimiter The delimiter of fields.
+   * @param column_names The names of columns, or "f0", "f1", ... are generated
+   * when empty, i.e., the chunks never contain the header line.
+   * @param use_threads Whether a chunk is parsed by the threads of arrow.
+   * @param include_columns The columns of the tables, or all columns when
+   * empty.
+   */
+  CSVChunkParser(char const delimiter,
+                 std::vector<std::string> const& column_names,
+                 bool const use_threads = true,
+                 std::vector<std::string> const& include_columns = {})
+      : delimiter_(delimiter),
+        column_names_(column_names),
+        use_threads_(use_threads),
+        include_columns_(include_columns) {}
+
+  /**
+   * @brief Parse the buffer of complete lines in place, i.e., the table
+   * references the buffer.
+   *
+   * @return The error of arrow if the lines are malformed, e.g., the number of
+   * fields doesn't match.
+   */
+  Status Parse(std::shared_ptr<arrow::Buffer> const& buffer,
+               std::shared_ptr<arrow::Table>& table);
+
+  /**
+   * @brief The pinned types of columns, which is empty before the first chunk
+   * is parsed.
+   */
+  std::unordered_map<std::string, std::shared_ptr<arrow::DataType>> Types();
+
+ private:
+  using types_t =
+      std::unordered_map<std::string, std::shared_ptr<arrow::DataType>>;
+
+  Status parse(std::shared_ptr<arrow::Buffer> const& buffer,
+               types_t const& types, std::shared_ptr<arrow::Table>& table);
+
+  char delimiter_;
+  std::vector<std::string> column_names_;
+  bool use_threads_;
+  std::vector<std::string> include_columns_;
+
+  std::mutex mutex_;
+  types_t types_;
+};
+
+}  // namespace vineyard
+
+#endif  // MODULES_IO_IO_CSV_CHUNK_PARSER_H_
@@ -0,0 +1,242 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "io/io/csv_formatter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "basic/ds/arrow_utils.h"
+
+namespace vineyard {
+
+namespace detail {
+
+using CSVCellFormatter = std::function<void(int64_t, std::string&)>;
+
+template <typename T>
+typename std::enable_if<std::is_signed<T>::value, bool>::type isNegative(
+    T const value) {
+  return value < 0;
+}
+
+template <typename T>
+typename std::enable_if<!std::is_signed<T>::value, bool>::type isNegative(
+    T const) {
+  return false;
+}
+
+template <typename T>
+void appendInteger(T const value, std::string& out) {
+  using U = typename std::make_unsigned<T>::type;
+  char buffer[24];
+  char* end = buffer + sizeof(buffer);
+  char* p = end;
+  bool negative = isNegative(value);
+  U v = negative ? U(0) - static_cast<U>(value) : static_cast<U>(value);
+  do {
+    *--p = static_cast<char>('0' + v % 10);
+    v /= 10;
+  } while (v != 0);
+  if (negative) {
+    *--p = '-';
+  }
+  out.append(p, end - p);
+}
+
+// the shortest of the two precisions that keeps the value
+template <typename T>
+void appendFloating(T const value, int const digits, int const max_digits,
+                    std::string& out) {
+  if (std::isnan(value)) {
+    out.append("nan");
+    return;
+  }
+  if (std::isinf(value)) {
+    out.append(value < 0 ? "-inf" : "inf");
+    return;
+  }
+  char buffer[32];
+  int length = snprintf(buffer, sizeof(buffer), "%.*g", digits,
+                        static_cast<double>(value));
+  if (static_cast<T>(strtod(buffer, nullptr)) != value) {
+    length = snprintf(buffer, sizeof(buffer), "%.*g", max_digits,
+                      static_cast<double>(value));
+  }
+  out.append(buffer, length);
+}
+
+void appendString(const char* data, size_t const size, char const delimiter,
+                  std::string& out) {
+  bool quoted = false;
+  for (size_t i = 0; i < size && !quoted; ++i) {
+    quoted = data[i] == delimiter || data[i] == '"' || data[i] == '\n' ||
+             data[i] == '\r';
+  }
+  if (!quoted) {
+    out.append(data, size);
+    return;
+  }
+  out.push_back('"');
+  for (size_t i = 0; i < size; ++i) {
+    if (data[i] == '"') {
+      out.push_back('"');
+    }
+    out.push_back(data[i]);
+  }
+  out.push_back('"');
+}
+
+template <typename ArrayType>
+CSVCellFormatter makeIntegerFormatter(
+    std::shared_ptr<arrow::Array> const& array) {
+  auto values = std::static_pointer_cast<ArrayType>(array);
+  return [values](int64_t const index, std::string& out) {
+    appendInteger(values->Value(index), out);
+  };
+}
+
+template <typename ArrayType>
+CSVCellFormatter makeStringFormatter(std::shared_ptr<arrow::Array> const& array,
+                                     char const delimiter) {
+  auto values = std::static_pointer_cast<ArrayType>(array);
+  return [values, delimiter](int64_t const index, std::string& out) {
+    auto view = values->GetView(index);
+    appendString(view.data(), view.size(), delimiter, out);
+  };
+}
+
+Status makeFormatter(std::shared_ptr<arrow::Array> const& array,
+                     char const delimiter, CSVCellFormatter& formatter) {
+  switch (array->type_id()) {
+  case arrow::Type::BOOL: {
+    auto values = std::static_pointer_cast<arrow::BooleanArray>(array);
+    formatter = [values](int64_t const index, std::string& out) {
+      out.append(values->Value(index) ? "true" : "false");
+    };
+    break;
+  }
+  case arrow::Type::INT8:
+    formatter = makeIntegerFormatter<arrow::Int8Array>(array);
+    break;
+  case arrow::Type::INT16:
+    formatter = makeIntegerFormatter<arrow::Int16Array>(array);
+    break;
+  case arrow::Type::INT32:
+    formatter = makeIntegerFormatter<arrow::Int32Array>(array);
+    break;
+  case arrow::Type::INT64:
+    formatter = makeIntegerFormatter<arrow::Int64Array>(array);
+    break;
+  case arrow::Type::UINT8:
+    formatter = makeIntegerFormatter<arrow::UInt8Array>(array);
+    break;
+  case arrow::Type::UINT16:
+    formatter = makeIntegerFormatter<arrow::UInt16Array>(array);
+    break;
+  case arrow::Type::UINT32:
+    formatter = makeIntegerFormatter<arrow::UInt32Array>(array);
+    break;
+  case arrow::Type::UINT64:
+    formatter = makeIntegerFormatter<arrow::UInt64Array>(array);
+    break;
+  case arrow::Type::FLOAT: {
+    auto values = std::static_pointer_cast<arrow::FloatArray>(array);
+    formatter = [values](int64_t const index, std::string& out) {
+      appendFloating(values->Value(index), 6, 9, out);
+    };
+    break;
+  }
+  case arrow::Type::DOUBLE: {
+    auto values = std::static_pointer_cast<arrow::DoubleArray>(array);
+    formatter = [values](int64_t const index, std::string& out) {
+      appendFloating(values->Value(index), 15, 17, out);
+    };
+    break;
+  }
+  case arrow::Type::STRING:
+    formatter = makeStringFormatter<arrow::StringArray>(array, delimiter);
+    break;
+  case arrow::Type::BINARY:
+    formatter = makeStringFormatter<arrow::BinaryArray>(array, delimiter);
+    break;
+  case arrow::Type::LARGE_STRING:
+    formatter = makeStringFormatter<arrow::LargeStringArray>(array, delimiter);
+    break;
+  case arrow::Type::LARGE_BINARY:
+    formatter = makeStringFormatter<arrow::LargeBinaryArray>(array, delimiter);
+    break;
+  default:
+#if defined(ARROW_VERSION) && ARROW_VERSION < 1000000
+    return Status::NotImplemented("Unsupported type in CSV: " +
+                                  array->type()->ToString());
+#else
+    formatter = [array, delimiter](int64_t const index, std::string& out) {
+      auto scalar = array->GetScalar(index);
+      if (scalar.ok()) {
+        std::string value = scalar.ValueOrDie()->ToString();
+        appendString(value.data(), value.size(), delimiter, out);
+      }
+    };
+#endif
+  }
+  return Status::OK();
+}
+
+}  // namespace detail
+
+void FormatCSVHeader(std::shared_ptr<arrow::Schema> const& schema,
+                     char const delimiter, std::string& out) {
+  for (int i = 0; i < schema->num_fields(); ++i) {
+    if (i > 0) {
+      out.push_back(delimiter);
+    }
+    auto const& name = schema->field(i)->name();
+    detail::appendString(name.data(), name.size(), delimiter, out);
+  }
+  out.push_back('\n');
+}
+
+Status FormatCSV(std::shared_ptr<arrow::RecordBatch> const& batch,
+                 char const delimiter, std::string& out) {
+  std::vector<std::shared_ptr<arrow::Array>> columns(batch->num_columns());
+  std::vector<detail::CSVCellFormatter> formatters(batch->num_columns());
+  for (int i = 0; i < batch->num_columns(); ++i) {
+    columns[i] = batch->column(i);
+    RETURN_ON_ERROR(
+        detail::makeFormatter(columns[i], delimiter, formatters[i]));
+  }
+  for (int64_t row = 0; row < batch->num_rows(); ++row) {
+    for (int i = 0; i < batch->num_columns(); ++i) {
+      if (i > 0) {
+        out.push_back(delimiter);
+      }
+      if (!columns[i]->IsNull(row)) {
+        formatters[i](row, out);
+      }
+    }
+    out.push_back('\n');
+  }
+  return Status::OK();
+}
+
+}  // namespace vineyard
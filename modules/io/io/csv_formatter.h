@@ -0,0 +1,47 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MODULES_IO_IO_CSV_FORMATTER_H_
+#define MODULES_IO_IO_CSV_FORMATTER_H_
+
+#include <memory>
+#include <string>
+
+#include "arrow/api.h"
+
+#include "common/util/status.h"
+
+namespace vineyard {
+
+/**
+ * @brief Formats the header line, i.e., the names of fields, to the end of
+ * `out`.
+ */
+void FormatCSVHeader(std::shared_ptr<arrow::Schema> const& schema,
+                     char const delimiter, std::string& out);
+
+/**
+ * @brief Formats the rows of the batch as lines of CSV to the end of `out`.
+ *
+ * The nulls are empty, and the strings that contain the delimiter, quotes or
+ * line breaks are quoted. The floating numbers are in the shortest form that
+ * can be parsed back to the same value.
+ */
+Status FormatCSV(std::shared_ptr<arrow::RecordBatch> const& batch,
+                 char const delimiter, std::string& out);
+
+}  // namespace vineyard
+
+#endif  // MODULES_IO_IO_CSV_FORMATTER_H_
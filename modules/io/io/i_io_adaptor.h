@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef MODULES_IO_IO_I_IO_ADAPTOR_H_
 #define MODULES_IO_IO_I_IO_ADAPTOR_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -83,6 +84,39 @@ class IIOAdaptor {
     return Status::OK();
   }
 
+  /**
+   * [Read the table piece by piece]
+   *
+   * The pieces, e.g., the row groups of a parquet file, are passed to the
+   * callback as soon as they are read. By default the whole table is read by
+   * `ReadTable` as a single piece.
+   *
+   * @param  callback [invoked for every piece]
+   * @return
+   */
+  virtual Status ReadTables(
+      std::function<Status(std::shared_ptr<arrow::Table> const&)> const&
+          callback) {
+    std::shared_ptr<arrow::Table> table;
+    RETURN_ON_ERROR(ReadTable(&table));
+    if (table == nullptr) {
+      return Status::OK();
+    }
+    return callback(table);
+  }
+
+  /**
+   * [Write a table to the location]
+   *
+   * Only the adaptors of table formats, e.g., arrow ipc files, support it.
+   *
+   * @param  table [the table to append]
+   * @return
+   */
+  virtual Status WriteTable(std::shared_ptr<arrow::Table> const& table) {
+    return Status::NotImplemented("Writing tables is not supported");
+  }
+
   // dir or file related:
   virtual Status ListDirectory(const std::string& path,
                                std::vector<std::string>& files) = 0;
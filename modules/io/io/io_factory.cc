@@ -24,8 +24,13 @@ limitations under the License.
 #include "network/uri.hpp"
 #include "network/uri/uri_io.hpp"
 
+#include "boost/algorithm/string.hpp"
+
+#include "io/io/arrow_ipc_io_adaptor.h"
+#include "io/io/columnar_io_adaptor.h"
 #include "io/io/kafka_io_adaptor.h"
 #include "io/io/local_io_adaptor.h"
+#include "io/io/multi_file_io_adaptor.h"
 #include "io/io/oss_io_adaptor.h"
 
 namespace vineyard {
@@ -51,7 +56,31 @@ std::unique_ptr<IIOAdaptor> IOFactory::CreateIOAdaptor(
     scheme = "file";
   }
 
+  std::string path = location.substr(0, location.find_first_of('#'));
+  if (scheme == "arrow" || scheme == "feather" ||
+      (scheme == "file" &&
+       (::boost::algorithm::ends_with(path, ".arrow") ||
+        ::boost::algorithm::ends_with(path, ".arrows") ||
+        ::boost::algorithm::ends_with(path, ".feather")))) {
+    return std::unique_ptr<ArrowIPCIOAdaptor>(
+        new ArrowIPCIOAdaptor(location));
+  }
+#if defined(PARQUET_ENABLED) || defined(ORC_ENABLED)
+  // the filters, e.g., "a>10", may fail the uri parser, thus check the prefix
+  if (::boost::algorithm::starts_with(path, "parquet://") ||
+      ::boost::algorithm::starts_with(path, "orc://") ||
+      (scheme == "file" &&
+       (::boost::algorithm::ends_with(path, ".parquet") ||
+        ::boost::algorithm::ends_with(path, ".orc")))) {
+    return std::unique_ptr<ColumnarIOAdaptor>(
+        new ColumnarIOAdaptor(location));
+  }
+#endif
   if (scheme == "file") {
+    if (MultiFileIOAdaptor::IsMultiFile(location)) {
+      return std::unique_ptr<MultiFileIOAdaptor>(
+          new MultiFileIOAdaptor(location));
+    }
     return std::unique_ptr<LocalIOAdaptor>(new LocalIOAdaptor(location));
 #ifdef KAFKA_ENABLED
   } else if (scheme == "kafka") {
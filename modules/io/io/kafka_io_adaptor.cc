@@ -17,6 +17,8 @@ limitations under the License.
 
 #include "io/io/kafka_io_adaptor.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -27,6 +29,8 @@ limitations under the License.
 #include "librdkafka/rdkafka.h"
 #include "librdkafka/rdkafkacpp.h"
 
+#include "basic/ds/arrow_utils.h"
+
 namespace vineyard {
 
 KafkaIOAdaptor::KafkaIOAdaptor(const std::string& location) {
@@ -34,19 +38,30 @@ KafkaIOAdaptor::KafkaIOAdaptor(const std::string& location) {
   parseLocation(location);
 }
 
-KafkaIOAdaptor::~KafkaIOAdaptor() {}
+KafkaIOAdaptor::~KafkaIOAdaptor() { stopFetch(); }
+
+std::shared_ptr<arrow::Schema> KafkaIOAdaptor::Schema() {
+  return arrow::schema({arrow::field("partition", arrow::int32()),
+                        arrow::field("offset", arrow::int64()),
+                        arrow::field("timestamp", arrow::int64()),
+                        arrow::field("value", arrow::utf8())});
+}
 
 Status KafkaIOAdaptor::Open() {
+  partitions_.clear();
   if (partial_read_) {
-    local_partition_num_ = partition_num_ / total_parts_;
-    if (partition_num_ % total_parts_ > partial_index_) {
-      local_partition_num_++;
+    for (int i = partial_index_; i < partition_num_; i += total_parts_) {
+      partitions_.push_back(i);
     }
   } else {
-    local_partition_num_ = partition_num_;
+    for (int i = 0; i < partition_num_; ++i) {
+      partitions_.push_back(i);
+    }
     group_id_ = group_id_ + std::to_string(partial_index_);
   }
-  batch_size_per_partition_ = batch_size_ / local_partition_num_;
+  local_partition_num_ = partitions_.size();
+  batch_size_per_partition_ =
+      std::max(1, batch_size_ / std::max(1, local_partition_num_));
   RdKafka::Conf* conf = RdKafka::Conf::create(RdKafka::Conf::CONF_GLOBAL);
   std::string rdkafka_err;
   if (conf->set("metadata.broker.list", brokers_, rdkafka_err) !=
@@ -65,31 +80,27 @@ Status KafkaIOAdaptor::Open() {
     LOG(WARNING) << "Failed to set auto.offset.reset: " << rdkafka_err;
   }
 
-  message_queue_.resize(local_partition_num_);
   for (int i = 0; i < local_partition_num_; ++i) {
     consumer_ptrs_[i] = std::shared_ptr<RdKafka::KafkaConsumer>(
         RdKafka::KafkaConsumer::create(conf, rdkafka_err));
     if (!consumer_ptrs_[i]) {
-      LOG(ERROR) << "Failed to create rdkafka consumer for partition "
-                 << rdkafka_err;
-    }
-    std::vector<RdKafka::TopicPartition*> topic_partitions;
-    RdKafka::TopicPartition* topic_partition;
-    if (partial_read_) {
-      topic_partition = RdKafka::TopicPartition::create(
-          topic_, partial_index_ + i * total_parts_);
-    } else {
-      topic_partition = RdKafka::TopicPartition::create(topic_, i);
+      delete conf;
+      return Status::IOError(
+          "Failed to create rdkafka consumer for partition: " + rdkafka_err);
     }
-    consumer_ptrs_[i]->assign({topic_partition});
+    // the partition is assigned explicitly, rather than subscribing the
+    // topic, otherwise the rebalance of group overrides the assignment.
+    RdKafka::TopicPartition* topic_partition =
+        RdKafka::TopicPartition::create(topic_, partitions_[i]);
+    RdKafka::ErrorCode err = consumer_ptrs_[i]->assign({topic_partition});
     delete topic_partition;
     topic_partition = nullptr;
-    consumer_ptrs_[i]->subscribe({topic_});
-
-    message_queue_[i] =
-        std::make_shared<PCBlockingQueue<std::vector<std::string>>>();
-    message_queue_[i]->SetLimit(16);
-    message_queue_[i]->SetProducerNum(1);
+    if (err != RdKafka::ERR_NO_ERROR) {
+      delete conf;
+      return Status::IOError("Failed to assign the partition " +
+                             std::to_string(partitions_[i]) + ": " +
+                             RdKafka::err2str(err));
+    }
   }
   delete conf;  // release the memory resource
   startFetch();
@@ -136,7 +147,8 @@ Status KafkaIOAdaptor::Configure(const std::string& key,
     group_id_ = value;
   } else if (key == "batch_size") {
     batch_size_ = std::stoi(value);
-    batch_size_per_partition_ = batch_size_ / local_partition_num_;
+  } else if (key == "batch_bytes") {
+    batch_bytes_ = std::stoll(value);
   } else if (key == "time_interval") {
     time_interval_ms_ = std::stoi(value) * 1000;
   }
@@ -151,31 +163,30 @@ Status KafkaIOAdaptor::SetPartialRead(const int index, const int total_parts) {
 }
 
 Status KafkaIOAdaptor::ReadLine(std::string& line) {
-  if (message_offset_ < message_list_.size()) {
-    line = message_list_[message_offset_];
-    ++message_offset_;
-    return Status::OK();
-  } else {
-    message_list_.clear();
-    message_offset_ = 0;
-    bool end = false;
-    while (!end) {
-      end = true;
-      for (int i = 0; i < local_partition_num_; ++i) {
-        end = end & message_queue_[i]->End();
-        if (message_queue_[i]->Size()) {
-          message_queue_[i]->Get(message_list_);
-          break;
-        }
-      }
-      if (message_list_.size()) {
-        line = message_list_[message_offset_];
-        ++message_offset_;
-        return Status::OK();
-      }
+  while (values_ == nullptr || value_offset_ >= values_->length()) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    if (!batch_queue_.Get(batch)) {
+      values_ = nullptr;
+      return Status::EndOfFile();
     }
-    return Status::EndOfFile();
+    values_ = std::dynamic_pointer_cast<arrow::StringArray>(batch->column(3));
+    value_offset_ = 0;
+  }
+  line = values_->GetString(value_offset_++);
+  return Status::OK();
+}
+
+Status KafkaIOAdaptor::ReadTables(
+    std::function<Status(std::shared_ptr<arrow::Table> const&)> const&
+        callback) {
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (batch_queue_.Get(batch)) {
+    std::shared_ptr<arrow::Table> table;
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(table,
+                                     arrow::Table::FromRecordBatches({batch}));
+    RETURN_ON_ERROR(callback(table));
   }
+  return Status::OK();
 }
 
 Status KafkaIOAdaptor::WriteLine(const std::string& line) {
@@ -211,7 +222,10 @@ Status KafkaIOAdaptor::Write(void* buffer, size_t size) {
   return Status::OK();
 }
 
-Status KafkaIOAdaptor::Close() { return Status::OK(); }
+Status KafkaIOAdaptor::Close() {
+  stopFetch();
+  return Status::OK();
+}
 
 void KafkaIOAdaptor::parseLocation(const std::string& location) {
   std::string tmp_location(location);
@@ -237,94 +251,143 @@ void KafkaIOAdaptor::parseLocation(const std::string& location) {
 }
 
 void KafkaIOAdaptor::startFetch() {
+  stopping_ = false;
+  batch_queue_.SetLimit(16);
+  batch_queue_.SetProducerNum(local_partition_num_);
   for (int i = 0; i < local_partition_num_; ++i) {
-    std::thread t = std::thread([&, i] {
-      while (!message_queue_[i]->End()) {
-        std::vector<std::string> msg;
-        fetchMessage(i, msg);
-        message_queue_[i]->Put(std::move(msg));
+    fetch_threads_.emplace_back([this, i] {
+      bool end = false;
+      while (!end && !stopping_) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        auto status = fetchBatch(i, batch, end);
+        if (!status.ok()) {
+          LOG(ERROR) << "Failed to fetch from partition " << partitions_[i]
+                     << ": " << status.ToString();
+          end = true;
+        }
+        if (batch != nullptr) {
+          batch_queue_.Put(std::move(batch));
+        }
       }
+      batch_queue_.DecProducerNum();
     });
-    t.detach();
     LOG(INFO) << "[partition" << partial_index_
-              << "] start fetch thread on partition " << i;
+              << "] start fetch thread on partition " << partitions_[i];
   }
 }
 
-void KafkaIOAdaptor::fetchMessage(int partition_index,
-                                  std::vector<std::string>& messages) {
-  messages.reserve(batch_size_per_partition_);
-  // Create a consumer dispatcher
-  auto consumer_ptr_ = consumer_ptrs_[partition_index];
+void KafkaIOAdaptor::stopFetch() {
+  if (fetch_threads_.empty()) {
+    return;
+  }
+  stopping_ = true;
+  // unblock the fetching threads that are waiting for the space of queue
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (batch_queue_.Get(batch)) {
+  }
+  for (auto& thread : fetch_threads_) {
+    thread.join();
+  }
+  fetch_threads_.clear();
+  for (auto& kv : consumer_ptrs_) {
+    kv.second->close();
+  }
+  consumer_ptrs_.clear();
+}
 
-  int msg_cnt = 0;
-  int64_t first_msg_ts = 0, cur_msg_ts = 0;
+Status KafkaIOAdaptor::fetchBatch(int partition_index,
+                                  std::shared_ptr<arrow::RecordBatch>& batch,
+                                  bool& end) {
+  auto consumer_ptr = consumer_ptrs_[partition_index];
 
-  int msg_len;
-  const char* msg_payload;
-  int64_t timestamp;
-  std::string msg_data;
+  arrow::Int64Builder offset_builder, timestamp_builder;
+  arrow::StringBuilder value_builder;
+  int64_t msg_cnt = 0, msg_bytes = 0;
+  auto first_msg_time = std::chrono::steady_clock::now();
 
-  auto process = [&](int partition_index, RdKafka::Message* message) -> bool {
+  // appends the message to the batch, or marks the partition as finished
+  auto process = [&](RdKafka::Message* message) -> Status {
     switch (message->err()) {
     case RdKafka::ERR__TIMED_OUT:
-      if (msg_cnt) {
-        msg_cnt = 0;
-        first_msg_ts = 0;
-        return false;
-      }
-      message_queue_[partition_index]->DecProducerNum();
-      return true;
+      // idle for a whole interval
+      end = msg_cnt == 0;
+      return Status::OK();
 
-    case RdKafka::ERR_NO_ERROR:
+    case RdKafka::ERR_NO_ERROR: {
       /* process message */
-      msg_len = message->len();
-      msg_payload = static_cast<char*>(message->payload());
-      timestamp = message->timestamp().timestamp;
-
-      msg_data = std::string(msg_payload, msg_len);
-      if (!msg_data.empty()) {
-        messages.push_back(msg_data);
-        ++msg_cnt;
-      }
-      if (!first_msg_ts) {
-        first_msg_ts = timestamp;
+      if (message->len() == 0) {
+        return Status::OK();
       }
-      cur_msg_ts = timestamp;
-      if (msg_cnt >= this->batch_size_per_partition_ ||
-          cur_msg_ts - first_msg_ts > this->time_interval_ms_) {
-        msg_cnt = 0;
-        first_msg_ts = 0;
-        return false;
-      } else {
-        return true;
+      if (msg_cnt == 0) {
+        first_msg_time = std::chrono::steady_clock::now();
       }
+      RETURN_ON_ARROW_ERROR(offset_builder.Append(message->offset()));
+      RETURN_ON_ARROW_ERROR(
+          timestamp_builder.Append(message->timestamp().timestamp));
+      RETURN_ON_ARROW_ERROR(
+          value_builder.Append(static_cast<const char*>(message->payload()),
+                               message->len()));
+      msg_cnt += 1;
+      msg_bytes += message->len();
+      return Status::OK();
+    }
 
     case RdKafka::ERR__PARTITION_EOF:
-      LOG(ERROR) << "Reached EOF on partition";
-      message_queue_[partition_index]->DecProducerNum();
-      return true;
+      VLOG(10) << "Reached EOF on partition " << partitions_[partition_index];
+      end = true;
+      return Status::OK();
 
     case RdKafka::ERR__UNKNOWN_TOPIC:
     case RdKafka::ERR__UNKNOWN_PARTITION:
-      LOG(ERROR) << "Topic or partition error: " << message->errstr();
-      message_queue_[partition_index]->DecProducerNum();
-      return true;
+      end = true;
+      return Status::IOError("Topic or partition error: " +
+                             message->errstr());
 
     default:
       LOG(ERROR) << "Unhandled kafka error: " << message->errstr();
-      return false;
+      return Status::OK();
     }
   };
 
-  while (true) {
-    RdKafka::Message* message = consumer_ptr_->consume(time_interval_ms_);
-    bool cont = process(partition_index, message);
+  while (!end && !stopping_ && msg_cnt < batch_size_per_partition_ &&
+         msg_bytes < batch_bytes_) {
+    int timeout = time_interval_ms_;
+    if (msg_cnt > 0) {
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - first_msg_time)
+                         .count();
+      if (elapsed >= time_interval_ms_) {
+        break;
+      }
+      timeout = time_interval_ms_ - elapsed;
+    }
+    RdKafka::Message* message = consumer_ptr->consume(timeout);
+    auto status = process(message);
+    bool timed_out = message->err() == RdKafka::ERR__TIMED_OUT;
     delete message;
-    if (!cont) {
+    RETURN_ON_ERROR(status);
+    if (timed_out) {
       break;
     }
   }
+
+  batch = nullptr;
+  if (msg_cnt == 0) {
+    return Status::OK();
+  }
+  std::shared_ptr<arrow::Array> partitions, offsets, timestamps, values;
+  {
+    arrow::Int32Builder partition_builder;
+    RETURN_ON_ARROW_ERROR(partition_builder.AppendValues(
+        std::vector<int32_t>(msg_cnt, partitions_[partition_index])));
+    RETURN_ON_ARROW_ERROR(partition_builder.Finish(&partitions));
+  }
+  RETURN_ON_ARROW_ERROR(offset_builder.Finish(&offsets));
+  RETURN_ON_ARROW_ERROR(timestamp_builder.Finish(&timestamps));
+  RETURN_ON_ARROW_ERROR(value_builder.Finish(&values));
+  batch = arrow::RecordBatch::Make(Schema(), msg_cnt,
+                                   {partitions, offsets, timestamps, values});
+  return Status::OK();
 }
 }  // namespace vineyard
 
@@ -18,12 +18,16 @@ limitations under the License.
 
 #ifdef KAFKA_ENABLED
 
+#include <atomic>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "arrow/api.h"
 #include "librdkafka/rdkafka.h"
 #include "librdkafka/rdkafkacpp.h"
 
@@ -34,6 +38,19 @@ limitations under the License.
 
 namespace vineyard {
 
+/**
+ * @brief Reads messages from (or writes messages to) a kafka topic.
+ *
+ * When reading, every assigned partition is consumed by a thread, which
+ * accumulates the messages into a record batch of the `Schema()`, until
+ * the batch reaches "batch_size" messages (split among the partitions),
+ * "batch_bytes" bytes of payload, or spans "time_interval" seconds. The
+ * batches are read either as lines by `ReadLine`, or as tables of one batch
+ * each by `ReadTables`.
+ *
+ * A partition is finished once it is idle for "time_interval" seconds, or
+ * reaches its end.
+ */
 class KafkaIOAdaptor : public IIOAdaptor {
  public:
   /** Constructor.
@@ -59,8 +76,27 @@ class KafkaIOAdaptor : public IIOAdaptor {
     return Status::NotImplemented();
   }
 
+  /** Configure the adaptor, the supported items are:
+   *
+   *  - group_id: the consumer group.
+   *  - batch_size: the number of messages in a batch of all partitions.
+   *  - batch_bytes: the bytes of payload in a batch of a partition.
+   *  - time_interval: in seconds, see also the class comment.
+   */
   Status Configure(const std::string& key, const std::string& value) override;
 
+  /** Read the messages as tables of one record batch each, until all
+   * partitions are finished.
+   */
+  Status ReadTables(
+      std::function<Status(std::shared_ptr<arrow::Table> const&)> const&
+          callback) override;
+
+  /** The schema of batches: the partition, the offset, the timestamp (in
+   * milliseconds) and the payload of messages.
+   */
+  static std::shared_ptr<arrow::Schema> Schema();
+
   Status WriteLine(const std::string& line) override;
 
   Status Read(void* buffer, size_t size) override {
@@ -85,31 +121,42 @@ class KafkaIOAdaptor : public IIOAdaptor {
 
   void startFetch();
 
-  void fetchMessage(int partition, std::vector<std::string>& messages);
+  void stopFetch();
+
+  // fetches a batch from the partition, `end` is set if the partition is
+  // finished, and the batch may be nullptr if no message arrives.
+  Status fetchBatch(int partition_index,
+                    std::shared_ptr<arrow::RecordBatch>& batch, bool& end);
 
   static const constexpr int internal_buffer_size_ = 1024 * 1024;
 
-  bool consumer_;
+  bool consumer_ = false;
   int batch_size_ = 50;
+  int64_t batch_bytes_ = 4 * 1024 * 1024;
   int partition_num_;
-  int local_partition_num_;
+  int local_partition_num_ = 0;
   int batch_size_per_partition_;
   int time_interval_ms_ = 1000 * 10;
-  size_t message_offset_ = 0;
 
   bool partial_read_ = false;
-  int partial_index_;
-  int total_parts_;
+  int partial_index_ = 0;
+  int total_parts_ = 1;
+
+  // batches of all partitions, every fetching thread is a producer
+  PCBlockingQueue<std::shared_ptr<arrow::RecordBatch>> batch_queue_;
+  std::vector<std::thread> fetch_threads_;
+  std::atomic<bool> stopping_{false};
+
+  // the batch being read by `ReadLine`
+  std::shared_ptr<arrow::StringArray> values_;
+  int64_t value_offset_ = 0;
 
-  template <typename T>
-  using mq_t = std::shared_ptr<PCBlockingQueue<std::vector<T>>>;
-  std::vector<mq_t<std::string>> message_queue_;
-  std::vector<std::string> message_list_;
   std::string group_id_;
   std::string brokers_;
   std::string topic_;
   std::unique_ptr<RdKafka::Producer> producer_;
   std::map<int, std::shared_ptr<RdKafka::KafkaConsumer>> consumer_ptrs_;
+  std::vector<int> partitions_;  // the assigned partition ids
 };
 }  // namespace vineyard
 
@@ -16,12 +16,20 @@ limitations under the License.
 #include "io/io/local_io_adaptor.h"
 
 #include <dirent.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "arrow/csv/api.h"
@@ -31,12 +39,101 @@ limitations under the License.
 #include "glog/logging.h"
 
 #include "basic/ds/arrow_utils.h"
+#include "io/io/csv_chunk_parser.h"
+#include "io/io/csv_formatter.h"
 
 namespace vineyard {
+
+// the bytes decompressed ahead of sequential reads, in parallel
+static constexpr int64_t kDecompressReadahead = 16 * 1024 * 1024;
+
+// the rows formatted as a block by `WriteTable`
+static constexpr int64_t kWriteBlockRows = 64 * 1024;
+
+// the bytes parsed as a block by `OpenPartialBatchReader`, as arrow's default
+static constexpr int64_t kDefaultStreamingBlockSize = 1 << 20;
+
+namespace detail {
+
+/**
+ * Parses the input block by block at line breaks, and the column types are
+ * inferred from the first block and promoted by the later blocks, see also
+ * `CSVChunkParser`, rather than failing like arrow's `StreamingReader` when a
+ * later block doesn't fit the types of the first one.
+ */
+class CSVBlockReader : public arrow::RecordBatchReader {
+ public:
+  CSVBlockReader(std::shared_ptr<arrow::io::InputStream> input,
+                 int64_t const block_size, char const delimiter,
+                 std::vector<std::string> const& column_names,
+                 std::vector<std::string> const& include_columns)
+      : input_(input),
+        block_size_(block_size),
+        parser_(delimiter, column_names, true, include_columns) {}
+
+  // the schema of the last batch, as the types may be promoted
+  std::shared_ptr<arrow::Schema> schema() const override { return schema_; }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    while (batches_.empty() && !exhausted_) {
+      auto status = readBlock();
+      if (!status.ok()) {
+        return arrow::Status::IOError(status.ToString());
+      }
+    }
+    if (batches_.empty()) {
+      *batch = nullptr;
+    } else {
+      *batch = batches_.front();
+      batches_.pop_front();
+    }
+    return arrow::Status::OK();
+  }
+
+ private:
+  Status readBlock() {
+    auto parse = [this](std::shared_ptr<arrow::Buffer> const& piece) {
+      std::shared_ptr<arrow::Table> table;
+      RETURN_ON_ERROR(parser_.Parse(piece, table));
+      schema_ = table->schema();
+      arrow::TableBatchReader reader(*table);
+      std::shared_ptr<arrow::RecordBatch> batch;
+      while (true) {
+        RETURN_ON_ARROW_ERROR(reader.ReadNext(&batch));
+        if (batch == nullptr) {
+          return Status::OK();
+        }
+        batches_.emplace_back(batch);
+      }
+    };
+    std::shared_ptr<arrow::Buffer> block;
+    // zero-copy for the mapped input
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(block, input_->Read(block_size_));
+    if (block->size() == 0) {
+      exhausted_ = true;
+      return splitter_.Flush(parse);
+    }
+    return splitter_.Feed(block, parse);
+  }
+
+  std::shared_ptr<arrow::io::InputStream> input_;
+  int64_t block_size_;
+  CSVLineSplitter splitter_;
+  CSVChunkParser parser_;
+  bool exhausted_ = false;
+  std::shared_ptr<arrow::Schema> schema_;
+  std::deque<std::shared_ptr<arrow::RecordBatch>> batches_;
+};
+
+}  // namespace detail
+
 LocalIOAdaptor::LocalIOAdaptor(const std::string& location)
     : file_(nullptr),
       location_(location),
       using_std_getline_(false),
+      using_mmap_(true),
+      decompress_concurrency_(std::thread::hardware_concurrency()),
+      write_concurrency_(std::thread::hardware_concurrency()),
       header_row_(false),
       enable_partial_read_(false),
       total_parts_(0),
@@ -83,9 +180,15 @@ LocalIOAdaptor::LocalIOAdaptor(const std::string& location)
     }
     location_ = location_.substr(begin_pos, pos - begin_pos);
   }
+  compression_ = BlockDecompressor::CompressionOf(location_);
+  auto compression = meta_.find("compression");
+  if (compression != meta_.end()) {
+    compression_ = compression->second == "none" ? "" : compression->second;
+  }
 }
 
 LocalIOAdaptor::~LocalIOAdaptor() {
+  unmapFile();
   if (file_ != nullptr) {
     fclose(file_);
     file_ = nullptr;
@@ -98,36 +201,52 @@ LocalIOAdaptor::~LocalIOAdaptor() {
 Status LocalIOAdaptor::Open() { return this->Open("r"); }
 
 Status LocalIOAdaptor::Open(const char* mode) {
-  std::string tag = ".gz";
-  size_t pos = location_.find(tag);
-  if (pos != location_.size() - tag.size()) {
-    if (strchr(mode, 'w') != NULL || strchr(mode, 'a') != NULL) {
-      int t = location_.find_last_of('/');
-      if (t != -1) {
-        std::string folder_path = location_.substr(0, t);
-        if (access(folder_path.c_str(), 0) != 0) {
-          RETURN_ON_ERROR(MakeDirectory(folder_path));
-        }
-      }
+  if (!compression_.empty()) {
+    if (strchr(mode, 'w') != NULL || strchr(mode, 'a') != NULL ||
+        strchr(mode, '+') != NULL) {
+      return Status::NotImplemented("Writing compressed files is unsupported");
     }
-    if (using_std_getline_) {
-      if (strchr(mode, 'b') != NULL) {
-        fs_.open(location_.c_str(),
-                 std::ios::binary | std::ios::in | std::ios::out);
-      } else if (strchr(mode, 'a') != NULL) {
-        fs_.open(location_.c_str(),
-                 std::ios::out | std::ios::in | std::ios::app);
-      } else if (strchr(mode, 'w') != NULL || strchr(mode, '+') != NULL) {
-        fs_.open(location_.c_str(),
-                 std::ios::out | std::ios::in | std::ios::trunc);
-      } else if (strchr(mode, 'r') != NULL) {
-        fs_.open(location_.c_str(), std::ios::in);
+    if (using_std_getline_ || !using_mmap_) {
+      return Status::Invalid("Compressed files are only read through mmap");
+    }
+  }
+  if (strchr(mode, 'w') != NULL || strchr(mode, 'a') != NULL) {
+    int t = location_.find_last_of('/');
+    if (t != -1) {
+      std::string folder_path = location_.substr(0, t);
+      if (access(folder_path.c_str(), 0) != 0) {
+        RETURN_ON_ERROR(MakeDirectory(folder_path));
       }
-    } else {
-      file_ = fopen(location_.c_str(), mode);
+    }
+  }
+  if (using_std_getline_) {
+    if (strchr(mode, 'b') != NULL) {
+      fs_.open(location_.c_str(),
+               std::ios::binary | std::ios::in | std::ios::out);
+    } else if (strchr(mode, 'a') != NULL) {
+      fs_.open(location_.c_str(), std::ios::out | std::ios::in | std::ios::app);
+    } else if (strchr(mode, 'w') != NULL || strchr(mode, '+') != NULL) {
+      fs_.open(location_.c_str(),
+               std::ios::out | std::ios::in | std::ios::trunc);
+    } else if (strchr(mode, 'r') != NULL) {
+      fs_.open(location_.c_str(), std::ios::in);
     }
   } else {
-    return Status::NotImplemented();
+    file_ = fopen(location_.c_str(), mode);
+    if (file_ != nullptr && using_mmap_ && strchr(mode, 'r') != NULL &&
+        strchr(mode, '+') == NULL) {
+      auto status = mapFile();
+      if (status.ok() && !compression_.empty()) {
+        status = decompressFile();
+      }
+      if (!status.ok()) {
+        if (!compression_.empty()) {
+          return status;
+        }
+        VLOG(2) << "Fallback to fgets for '" << location_
+                << "': " << status.ToString();
+      }
+    }
   }
 
   if ((using_std_getline_ && !fs_) ||
@@ -136,7 +255,9 @@ Status LocalIOAdaptor::Open(const char* mode) {
   }
 
   // check the partial read flag
-  if (enable_partial_read_) {
+  if (strchr(mode, 'w') != NULL || strchr(mode, 'a') != NULL) {
+    // nothing to read
+  } else if (enable_partial_read_) {
     RETURN_ON_ERROR(setPartialReadImpl());
   } else {
     RETURN_ON_ERROR(ReadLine(header_line_));
@@ -157,9 +278,81 @@ Status LocalIOAdaptor::Configure(const std::string& key,
       using_std_getline_ = true;
     }
   }
+  if (key == "block_size") {
+    block_size_ = std::stoll(value);
+  }
+  if (key == "compression") {
+    compression_ = value == "none" ? "" : value;
+  }
+  if (key == "decompress_concurrency") {
+    decompress_concurrency_ = std::max(1, std::stoi(value));
+  }
+  if (key == "write_concurrency") {
+    write_concurrency_ = std::max(1, std::stoi(value));
+  }
+  if (key == "using_mmap") {
+    if (value == "false") {
+      using_mmap_ = false;
+    } else if (value == "true") {
+      using_mmap_ = true;
+    }
+  }
+  return Status::OK();
+}
+
+Status LocalIOAdaptor::mapFile() {
+  int fd = fileno(file_);
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return Status::IOError(strerror(errno));
+  }
+  if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+    return Status::IOError("Not a non-empty regular file");
+  }
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (addr == MAP_FAILED) {
+    return Status::IOError(strerror(errno));
+  }
+  // the file is scanned once from the beginning to the end of the partition
+  if (madvise(addr, st.st_size, MADV_SEQUENTIAL) != 0) {
+    VLOG(2) << "madvise failed: " << strerror(errno);
+  }
+  mapped_ = static_cast<const char*>(addr);
+  mapped_size_ = st.st_size;
+  cursor_ = 0;
+  return Status::OK();
+}
+
+Status LocalIOAdaptor::decompressFile() {
+  compressed_ = mapped_;
+  compressed_size_ = mapped_size_;
+  RETURN_ON_ERROR(BlockDecompressor::Make(
+      compression_, reinterpret_cast<const uint8_t*>(compressed_),
+      compressed_size_, decompress_concurrency_, decompressor_));
+  mapped_ = decompressor_->data();
+  mapped_size_ = decompressor_->size();
+  cursor_ = 0;
+  meta_.emplace("compression", compression_);
   return Status::OK();
 }
 
+void LocalIOAdaptor::unmapFile() {
+  if (compressed_ != nullptr) {
+    decompressor_.reset();
+    munmap(const_cast<char*>(compressed_), compressed_size_);
+    compressed_ = nullptr;
+    compressed_size_ = 0;
+    mapped_ = nullptr;
+    mapped_size_ = 0;
+    cursor_ = 0;
+  } else if (mapped_ != nullptr) {
+    munmap(const_cast<char*>(mapped_), mapped_size_);
+    mapped_ = nullptr;
+    mapped_size_ = 0;
+    cursor_ = 0;
+  }
+}
+
 Status LocalIOAdaptor::SetPartialRead(const int index, const int total_parts) {
   // make sure that the bytes of each line of the file
   // is smaller than macro FINELINE
@@ -179,6 +372,18 @@ Status LocalIOAdaptor::SetPartialRead(const int index, const int total_parts) {
   return Status::OK();
 }
 
+Status LocalIOAdaptor::SetPartialRange(const int64_t begin,
+                                       const int64_t end) {
+  if (begin < 0 || end < begin) {
+    return Status::Invalid("Invalid partial range: [" + std::to_string(begin) +
+                           ", " + std::to_string(end) + ")");
+  }
+  RETURN_ON_ERROR(SetPartialRead(0, 1));
+  range_begin_ = begin;
+  range_end_ = end;
+  return Status::OK();
+}
+
 Status LocalIOAdaptor::GetPartialReadDetail(int64_t& offset, int64_t& nbytes) {
   if (!enable_partial_read_) {
     LOG(ERROR) << "Partial read is disabled, you probably want to"
@@ -223,6 +428,22 @@ Status LocalIOAdaptor::setPartialReadImpl() {
   partial_read_offset_[0] = start_pos;
   partial_read_offset_[total_parts_] = total_file_size;
 
+  if (range_end_ >= 0) {
+    // the ends of the range are moved to the next of the nearest character
+    // '\n' as well, thus adjacent ranges share the same breakpoint.
+    partial_read_offset_[0] = std::max<int64_t>(range_begin_, start_pos);
+    partial_read_offset_[1] = std::max(partial_read_offset_[0],
+                                       std::min(range_end_, total_file_size));
+    for (int i = 0; i < 2; ++i) {
+      if (partial_read_offset_[i] > start_pos &&
+          partial_read_offset_[i] < total_file_size) {
+        int64_t dis = getDistanceToLineBreak(i);
+        partial_read_offset_[i] =
+            std::min(partial_read_offset_[i] + dis + 1, total_file_size);
+      }
+    }
+  }
+
   // move breakpoint to the next of nearest character '\n'
   for (int i = 1; i < total_parts_; ++i) {
     partial_read_offset_[i] = i * part_size + start_pos;
@@ -249,25 +470,122 @@ Status LocalIOAdaptor::ReadTable(std::shared_ptr<arrow::Table>* table) {
   return Status::OK();
 }
 
-Status LocalIOAdaptor::ReadPartialTable(std::shared_ptr<arrow::Table>* table,
-                                        int index) {
+Status LocalIOAdaptor::WriteTable(std::shared_ptr<arrow::Table> const& table) {
+  if (!header_written_) {
+    if (header_row_) {
+      std::string header;
+      FormatCSVHeader(table->schema(), delimiter_, header);
+      RETURN_ON_ERROR(Write(&header[0], header.size()));
+    }
+    header_written_ = true;
+  }
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches, blocks;
+  RETURN_ON_ERROR(TableToRecordBatches(table, &batches));
+  for (auto const& batch : batches) {
+    for (int64_t offset = 0; offset < batch->num_rows();
+         offset += kWriteBlockRows) {
+      blocks.emplace_back(batch->Slice(offset, kWriteBlockRows));
+    }
+  }
+
+  // the blocks are formatted concurrently, and written in order, at most
+  // `window` blocks are formatted but not written yet.
+  size_t const window = 2 * write_concurrency_;
+  std::vector<std::string> formatted(blocks.size());
+  std::vector<bool> ready(blocks.size(), false);
+  std::atomic<size_t> next_block(0);
+  size_t written = 0;
+  std::mutex mutex;
+  std::condition_variable cv;
+  Status status;
+
+  auto format = [&]() {
+    while (true) {
+      size_t index = next_block++;
+      if (index >= blocks.size()) {
+        return;
+      }
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock,
+                [&]() { return index < written + window || !status.ok(); });
+        if (!status.ok()) {
+          return;
+        }
+      }
+      std::string content;
+      auto s = FormatCSV(blocks[index], delimiter_, content);
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!s.ok() && status.ok()) {
+        status = s;
+      }
+      formatted[index] = std::move(content);
+      ready[index] = true;
+      cv.notify_all();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < std::min(write_concurrency_, blocks.size()); ++i) {
+    threads.emplace_back(format);
+  }
+  for (size_t index = 0; index < blocks.size(); ++index) {
+    std::string content;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return ready[index] || !status.ok(); });
+      if (!status.ok()) {
+        break;
+      }
+      content = std::move(formatted[index]);
+    }
+    auto s =
+        content.empty() ? Status::OK() : Write(&content[0], content.size());
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!s.ok()) {
+      status = s;
+      cv.notify_all();
+      break;
+    }
+    written = index + 1;
+    cv.notify_all();
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return status;
+}
+
+Status LocalIOAdaptor::openPartialInput(
+    int index, std::shared_ptr<arrow::io::InputStream>* input) {
+  int64_t offset = partial_read_offset_[index];
+  int64_t nbytes =
+      partial_read_offset_[index + 1] - partial_read_offset_[index];
+  if (mapped_ != nullptr) {
+    if (decompressor_ != nullptr) {
+      RETURN_ON_ERROR(decompressor_->Ensure(offset, offset + nbytes));
+    }
+    // parse the mapped range in place, which outlives the reader.
+    *input = std::make_shared<arrow::io::BufferReader>(
+        std::make_shared<arrow::Buffer>(
+            reinterpret_cast<const uint8_t*>(mapped_) + offset, nbytes));
+    return Status::OK();
+  }
   std::unique_ptr<arrow::fs::LocalFileSystem> arrow_lfs(
       new arrow::fs::LocalFileSystem());
   std::shared_ptr<arrow::io::RandomAccessFile> file_in;
   RETURN_ON_ARROW_ERROR_AND_ASSIGN(file_in,
                                    arrow_lfs->OpenInputFile(location_));
+  *input = arrow::io::RandomAccessFile::GetStream(file_in, offset, nbytes);
+  return Status::OK();
+}
 
-  int64_t offset = partial_read_offset_[index];
-  int64_t nbytes =
-      partial_read_offset_[index + 1] - partial_read_offset_[index];
-  std::shared_ptr<arrow::io::InputStream> input =
-      arrow::io::RandomAccessFile::GetStream(file_in, offset, nbytes);
-
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
-
-  auto read_options = arrow::csv::ReadOptions::Defaults();
-  auto parse_options = arrow::csv::ParseOptions::Defaults();
-  auto convert_options = arrow::csv::ConvertOptions::Defaults();
+void LocalIOAdaptor::csvOptions(arrow::csv::ReadOptions& read_options,
+                                arrow::csv::ParseOptions& parse_options,
+                                arrow::csv::ConvertOptions& convert_options) {
+  read_options = arrow::csv::ReadOptions::Defaults();
+  parse_options = arrow::csv::ParseOptions::Defaults();
+  convert_options = arrow::csv::ConvertOptions::Defaults();
 
   if (!header_row_) {
     read_options.autogenerate_column_names = true;
@@ -277,7 +595,23 @@ Status LocalIOAdaptor::ReadPartialTable(std::shared_ptr<arrow::Table>* table,
       convert_options.include_columns = columns_;
     }
   }
+  if (block_size_ > 0) {
+    read_options.block_size = block_size_;
+  }
   parse_options.delimiter = delimiter_;
+}
+
+Status LocalIOAdaptor::ReadPartialTable(std::shared_ptr<arrow::Table>* table,
+                                        int index) {
+  std::shared_ptr<arrow::io::InputStream> input;
+  RETURN_ON_ERROR(openPartialInput(index, &input));
+
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+
+  arrow::csv::ReadOptions read_options;
+  arrow::csv::ParseOptions parse_options;
+  arrow::csv::ConvertOptions convert_options;
+  csvOptions(read_options, parse_options, convert_options);
 
   std::shared_ptr<arrow::csv::TableReader> reader;
   RETURN_ON_ARROW_ERROR_AND_ASSIGN(
@@ -304,18 +638,68 @@ Status LocalIOAdaptor::ReadPartialTable(std::shared_ptr<arrow::Table>* table,
   return Status::OK();
 }
 
+Status LocalIOAdaptor::OpenPartialBatchReader(
+    std::shared_ptr<arrow::RecordBatchReader>* reader, int index) {
+  if (partial_read_offset_[index + 1] <= partial_read_offset_[index]) {
+    *reader = nullptr;
+    return Status::OK();
+  }
+  std::shared_ptr<arrow::io::InputStream> input;
+  RETURN_ON_ERROR(openPartialInput(index, &input));
+
+  std::vector<std::string> column_names, include_columns;
+  if (header_row_) {
+    column_names = original_columns_;
+    include_columns = columns_;
+  }
+  *reader = std::make_shared<detail::CSVBlockReader>(
+      input, block_size_ > 0 ? block_size_ : kDefaultStreamingBlockSize,
+      delimiter_, column_names, include_columns);
+  return Status::OK();
+}
+
+Status LocalIOAdaptor::findLineBreak(int64_t const offset,
+                                     int64_t const readahead,
+                                     int64_t& position) {
+  if (decompressor_ != nullptr) {
+    return decompressor_->Find(offset, '\n', readahead, position);
+  }
+  // `memchr` is vectorized by libc, rather than comparing byte by byte.
+  const void* lf = memchr(mapped_ + offset, '\n', mapped_size_ - offset);
+  position =
+      lf == nullptr ? mapped_size_ : static_cast<const char*>(lf) - mapped_;
+  return Status::OK();
+}
+
 int64_t LocalIOAdaptor::getDistanceToLineBreak(const int index) {
+  if (mapped_ != nullptr) {
+    int64_t offset = std::min<int64_t>(partial_read_offset_[index],
+                                       mapped_size_);
+    // only the block around the breakpoint is decompressed
+    int64_t position = mapped_size_;
+    VINEYARD_CHECK_OK(findLineBreak(offset, 0, position));
+    return position - offset;
+  }
   VINEYARD_CHECK_OK(seek(partial_read_offset_[index], kFileLocationBegin));
   int64_t dis = 0;
+  char buffer[4096];
   while (true) {
-    char buffer[1];
-    // std::memset(buff, 0, sizeof(buffer));
-    auto status = Read(buffer, 1);
-    if (!status.ok() || buffer[0] == '\n') {
-      break;
+    int64_t size = 0;
+    if (using_std_getline_) {
+      fs_.read(buffer, sizeof(buffer));
+      size = fs_.gcount();
     } else {
-      dis++;
+      size = fread(buffer, 1, sizeof(buffer), file_);
     }
+    if (size <= 0) {
+      break;
+    }
+    const void* lf = memchr(buffer, '\n', size);
+    if (lf != nullptr) {
+      dis += static_cast<const char*>(lf) - buffer;
+      break;
+    }
+    dis += size;
   }
   return dis;
 }
@@ -324,6 +708,18 @@ Status LocalIOAdaptor::ReadLine(std::string& line) {
   if (enable_partial_read_ && tell() >= partial_read_offset_[index_ + 1]) {
     return Status::EndOfFile();
   }
+  if (mapped_ != nullptr) {
+    if (cursor_ >= mapped_size_) {
+      return Status::EndOfFile();
+    }
+    int64_t position = mapped_size_;
+    RETURN_ON_ERROR(findLineBreak(cursor_, kDecompressReadahead, position));
+    int64_t length = position == mapped_size_ ? mapped_size_ - cursor_
+                                              : position - cursor_ + 1;
+    line.assign(mapped_ + cursor_, length);
+    cursor_ += length;
+    return Status::OK();
+  }
   if (using_std_getline_) {
     getline(fs_, line);
     if (line.empty()) {
@@ -365,6 +761,9 @@ int64_t LocalIOAdaptor::GetFullSize() {
 }
 
 int64_t LocalIOAdaptor::tell() {
+  if (mapped_ != nullptr) {
+    return cursor_;
+  }
   if (using_std_getline_) {
     return fs_.tellg();
   } else {
@@ -374,6 +773,18 @@ int64_t LocalIOAdaptor::tell() {
 
 Status LocalIOAdaptor::seek(const int64_t offset,
                             const FileLocation seek_from) {
+  if (mapped_ != nullptr) {
+    int64_t target = offset;
+    if (seek_from == kFileLocationCurrent) {
+      target += cursor_;
+    } else if (seek_from == kFileLocationEnd) {
+      target += mapped_size_;
+    } else if (seek_from != kFileLocationBegin) {
+      return Status::Invalid();
+    }
+    cursor_ = std::max<int64_t>(0, std::min<int64_t>(target, mapped_size_));
+    return Status::OK();
+  }
   if (using_std_getline_) {
     fs_.clear();
     if (seek_from == kFileLocationBegin) {
@@ -400,6 +811,18 @@ Status LocalIOAdaptor::seek(const int64_t offset,
 }
 
 Status LocalIOAdaptor::Read(void* buffer, size_t size) {
+  if (mapped_ != nullptr) {
+    size_t nbytes = std::min<size_t>(size, mapped_size_ - cursor_);
+    if (nbytes == 0) {
+      return Status::EndOfFile();
+    }
+    if (decompressor_ != nullptr) {
+      RETURN_ON_ERROR(decompressor_->Ensure(cursor_, cursor_ + nbytes));
+    }
+    memcpy(buffer, mapped_ + cursor_, nbytes);
+    cursor_ += nbytes;
+    return Status::OK();
+  }
   if (using_std_getline_) {
     fs_.read(static_cast<char*>(buffer), size);
     if (!fs_) {
@@ -440,6 +863,7 @@ Status LocalIOAdaptor::Write(void* buffer, size_t size) {
 }
 
 Status LocalIOAdaptor::Close() {
+  unmapFile();
   if (using_std_getline_) {
     if (fs_.is_open()) {
       fs_.close();
@@ -23,9 +23,12 @@ limitations under the License.
 #include <vector>
 
 #include "arrow/api.h"
+#include "arrow/csv/api.h"
+#include "arrow/io/api.h"
 
 #include "common/util/functions.h"
 #include "common/util/status.h"
+#include "io/io/block_decompressor.h"
 #include "io/io/i_io_adaptor.h"
 
 namespace vineyard {
@@ -70,6 +73,31 @@ class LocalIOAdaptor : public IIOAdaptor {
    * */
   Status SetPartialRead(const int index, const int total_parts) override;
 
+  /** Read the lines in the byte range [begin, end) of the file, where both
+   * ends are moved to the next of the nearest character '\n' in the same way
+   * as `SetPartialRead`, thus adjacent ranges never share a line.
+   *
+   * Must be called before `Open`.
+   */
+  Status SetPartialRange(const int64_t begin, const int64_t end);
+
+  /** Configure the adaptor, the supported items are:
+   *
+   *  - using_std_getline: read lines by `std::getline` rather than `fgets`.
+   *  - using_mmap: map the file into memory when opened for read, which is
+   *    enabled by default, and falls back to `fgets` if the file cannot be
+   *    mapped, e.g., it is empty or not a regular file.
+   *  - block_size: the number of bytes that are parsed as a record batch
+   *    by `ReadPartialTable` and `OpenPartialBatchReader`.
+   *  - compression: "gzip", "zstd", "bz2" or "none", which is inferred from
+   *    the suffix of the location by default, e.g., ".gz". Compressed files
+   *    are read only, and through mmap. The partitions are split on the
+   *    decompressed content.
+   *  - decompress_concurrency: the number of threads to decompress the
+   *    independent blocks of bgzip and zstd files.
+   *  - write_concurrency: the number of threads to format the rows in
+   *    `WriteTable`.
+   */
   Status Configure(const std::string& key, const std::string& value) override;
 
   Status WriteLine(const std::string& line) override;
@@ -97,6 +125,25 @@ class LocalIOAdaptor : public IIOAdaptor {
 
   Status ReadPartialTable(std::shared_ptr<arrow::Table>* table, int index);
 
+  /** Append the rows of table as lines of CSV, see also `FormatCSV`, and the
+   * header line before the first table if "header_row" is true.
+   *
+   * The rows are formatted by blocks concurrently, and written in order.
+   */
+  Status WriteTable(std::shared_ptr<arrow::Table> const& table) override;
+
+  /** Open a streaming reader that parses the part of file block by block,
+   * i.e., a record batch is available as soon as its block is parsed, rather
+   * than after the whole part, see also "block_size" in `Configure`. The
+   * column types are inferred from the first block, and promoted if a later
+   * block has wider values, thus the schema of batches may change.
+   *
+   * The reader must not outlive the adaptor, and is nullptr if the part is
+   * empty.
+   */
+  Status OpenPartialBatchReader(
+      std::shared_ptr<arrow::RecordBatchReader>* reader, int index);
+
   Status Seek(const int64_t offset);
 
   int64_t GetFullSize();
@@ -110,16 +157,44 @@ class LocalIOAdaptor : public IIOAdaptor {
   Status seek(const int64_t offset, const FileLocation seek_from);
   Status setPartialReadImpl();
   int64_t getDistanceToLineBreak(const int index);
+  Status mapFile();
+  Status decompressFile();
+  void unmapFile();
+  Status findLineBreak(int64_t const offset, int64_t const readahead,
+                       int64_t& position);
+  Status openPartialInput(int index,
+                          std::shared_ptr<arrow::io::InputStream>* input);
+  void csvOptions(arrow::csv::ReadOptions& read_options,
+                  arrow::csv::ParseOptions& parse_options,
+                  arrow::csv::ConvertOptions& convert_options);
 
   FILE* file_;
   std::fstream fs_;
   std::string location_;
   bool using_std_getline_;
+
+  // the file is read from the mapped memory, rather than `file_`, if mapped.
+  bool using_mmap_;
+  const char* mapped_ = nullptr;
+  int64_t mapped_size_ = 0;
+  int64_t cursor_ = 0;
+
+  // for compressed files, the mapped memory is the decompressed content, and
+  // the mapped file is kept in `compressed_`.
+  std::string compression_;
+  size_t decompress_concurrency_;
+  const char* compressed_ = nullptr;
+  int64_t compressed_size_ = 0;
+  std::unique_ptr<BlockDecompressor> decompressor_;
+
+  size_t write_concurrency_;
+  bool header_written_ = false;
   char buff[LINESIZE];
 
   // for arrow
   std::vector<std::string> columns_;
   char delimiter_ = ',';
+  int64_t block_size_ = 0;  // 0 means the arrow's default
   bool header_row_;
   std::string header_line_ = "";
   // schema of header row
@@ -129,6 +204,9 @@ class LocalIOAdaptor : public IIOAdaptor {
   std::vector<int64_t> partial_read_offset_;
   int total_parts_;
   int index_;
+  // see also `SetPartialRange`, the end is -1 if not set
+  int64_t range_begin_ = 0;
+  int64_t range_end_ = -1;
   std::unordered_multimap<std::string, std::string> meta_;
 };
 }  // namespace vineyard
@@ -0,0 +1,342 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "io/io/multi_file_io_adaptor.h"
+
+#include <dirent.h>
+#include <glob.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+
+#include "basic/ds/arrow_utils.h"
+#include "io/io/block_decompressor.h"
+
+namespace vineyard {
+
+static constexpr int64_t kDefaultMinSplitSize = 16 * 1024 * 1024;
+
+static std::string pathOf(const std::string& location) {
+  std::string path = location.substr(0, location.find_first_of('#'));
+  if (::boost::algorithm::starts_with(path, "file://")) {
+    path = path.substr(strlen("file://"));
+  }
+  return path;
+}
+
+MultiFileIOAdaptor::MultiFileIOAdaptor(const std::string& location)
+    : location_(location),
+      path_(pathOf(location)),
+      min_split_size_(kDefaultMinSplitSize),
+      index_(0),
+      total_parts_(1) {
+  size_t pos = location.find_first_of('#');
+  if (pos != std::string::npos) {
+    config_ = location.substr(pos);
+  }
+}
+
+MultiFileIOAdaptor::~MultiFileIOAdaptor() { VINEYARD_SUPPRESS(Close()); }
+
+bool MultiFileIOAdaptor::IsMultiFile(const std::string& location) {
+  std::string path = pathOf(location);
+  if (path.find_first_of("*?[") != std::string::npos) {
+    return true;
+  }
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+std::vector<MultiFileIOAdaptor::FileRange> MultiFileIOAdaptor::Schedule(
+    std::vector<std::pair<std::string, int64_t>> const& files,
+    int64_t const min_split_size, int const index, int const total_parts) {
+  // the files are concatenated into one byte space
+  std::vector<int64_t> offsets(files.size() + 1, 0);
+  for (size_t i = 0; i < files.size(); ++i) {
+    offsets[i + 1] = offsets[i] + files[i].second;
+  }
+  auto splittable = [&](size_t const i) {
+    return files[i].second >= min_split_size &&
+           BlockDecompressor::CompressionOf(files[i].first).empty();
+  };
+
+  // split the space evenly, and move the breakpoints that fall into an
+  // unsplittable file to its nearer edge.
+  int64_t total = offsets.back();
+  std::vector<int64_t> bounds(total_parts + 1, 0);
+  bounds[total_parts] = total;
+  for (int k = 1; k < total_parts; ++k) {
+    int64_t bound = total / total_parts * k + total % total_parts * k /
+                                                  total_parts;
+    size_t i = std::upper_bound(offsets.begin(), offsets.end(), bound) -
+               offsets.begin() - 1;
+    if (i < files.size() && bound > offsets[i] && !splittable(i)) {
+      bound = bound - offsets[i] < offsets[i + 1] - bound ? offsets[i]
+                                                          : offsets[i + 1];
+    }
+    bounds[k] = std::max(bound, bounds[k - 1]);
+  }
+
+  std::vector<FileRange> ranges;
+  for (size_t i = 0; i < files.size(); ++i) {
+    int64_t begin = std::max(bounds[index], offsets[i]);
+    int64_t end = std::min(bounds[index + 1], offsets[i + 1]);
+    if (end <= begin) {
+      continue;
+    }
+    if (splittable(i)) {
+      ranges.emplace_back(
+          FileRange{files[i].first, begin - offsets[i], end - offsets[i]});
+    } else {
+      ranges.emplace_back(
+          FileRange{files[i].first, 0, std::numeric_limits<int64_t>::max()});
+    }
+  }
+  return ranges;
+}
+
+Status MultiFileIOAdaptor::listFiles(
+    std::vector<std::pair<std::string, int64_t>>& files) {
+  std::vector<std::string> paths;
+  struct stat st;
+  if (stat(path_.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+    DIR* dir = opendir(path_.c_str());
+    if (dir == nullptr) {
+      return Status::IOError("Failed to open the directory: " + path_);
+    }
+    struct dirent* rent;
+    while ((rent = readdir(dir))) {
+      std::string name = rent->d_name;
+      if (name[0] != '.' && name[0] != '_') {
+        paths.emplace_back(path_ + "/" + name);
+      }
+    }
+    closedir(dir);
+  } else {
+    glob_t matches;
+    int ret = glob(path_.c_str(), 0, nullptr, &matches);
+    if (ret != 0 && ret != GLOB_NOMATCH) {
+      globfree(&matches);
+      return Status::IOError("Failed to match the pattern: " + path_);
+    }
+    for (size_t i = 0; i < matches.gl_pathc; ++i) {
+      paths.emplace_back(matches.gl_pathv[i]);
+    }
+    globfree(&matches);
+  }
+
+  std::sort(paths.begin(), paths.end());
+  for (auto const& path : paths) {
+    if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+      files.emplace_back(path, st.st_size);
+    }
+  }
+  if (files.empty()) {
+    return Status::IOError("No files found in " + location_);
+  }
+  return Status::OK();
+}
+
+Status MultiFileIOAdaptor::Open() {
+  std::vector<std::pair<std::string, int64_t>> files;
+  RETURN_ON_ERROR(listFiles(files));
+  // the options of location, e.g., "#compression=gzip", are applied before
+  // the configured ones, see also `openRange`.
+  std::vector<std::string> options;
+  ::boost::split(options, config_, ::boost::is_any_of("&#"));
+  std::string compression;
+  for (auto const& option : options) {
+    size_t eq = option.find('=');
+    if (eq != std::string::npos && option.substr(0, eq) == "compression") {
+      compression = option.substr(eq + 1);
+    }
+  }
+  for (auto const& kv : configs_) {
+    if (kv.first == "compression") {
+      compression = kv.second;
+    }
+  }
+  int64_t min_split_size = min_split_size_;
+  if (!compression.empty() && compression != "none") {
+    // the byte ranges of compressed files are meaningless
+    min_split_size = std::numeric_limits<int64_t>::max();
+  }
+  ranges_ = Schedule(files, min_split_size, index_, total_parts_);
+  if (ranges_.empty()) {
+    // an empty range of the first file, for the meta
+    ranges_.emplace_back(FileRange{files[0].first, 0, 0});
+  }
+
+  cursor_ = 0;
+  RETURN_ON_ERROR(openRange(cursor_, current_));
+  meta_ = current_->GetMeta();
+  meta_.emplace("files", std::to_string(files.size()));
+  return Status::OK();
+}
+
+Status MultiFileIOAdaptor::Open(const char* mode) {
+  if (strchr(mode, 'w') != nullptr || strchr(mode, 'a') != nullptr) {
+    return Status::NotImplemented(
+        "Writing to a directory or glob pattern is not supported");
+  }
+  return Open();
+}
+
+Status MultiFileIOAdaptor::Close() {
+  if (current_ != nullptr) {
+    RETURN_ON_ERROR(current_->Close());
+    current_.reset();
+  }
+  return Status::OK();
+}
+
+Status MultiFileIOAdaptor::SetPartialRead(const int index,
+                                          const int total_parts) {
+  if (index < 0 || total_parts <= 0 || index >= total_parts) {
+    return Status::Invalid("Invalid partial read: [" + std::to_string(index) +
+                           ", " + std::to_string(total_parts) + "]");
+  }
+  index_ = index;
+  total_parts_ = total_parts;
+  return Status::OK();
+}
+
+Status MultiFileIOAdaptor::Configure(const std::string& key,
+                                     const std::string& value) {
+  if (key == "min_split_size") {
+    min_split_size_ = std::stoll(value);
+  } else {
+    configs_.emplace_back(key, value);
+  }
+  return Status::OK();
+}
+
+Status MultiFileIOAdaptor::openRange(size_t const index,
+                                     std::unique_ptr<LocalIOAdaptor>& adaptor) {
+  auto const& range = ranges_[index];
+  adaptor.reset(new LocalIOAdaptor(range.path + config_));
+  for (auto const& kv : configs_) {
+    RETURN_ON_ERROR(adaptor->Configure(kv.first, kv.second));
+  }
+  RETURN_ON_ERROR(adaptor->SetPartialRange(range.begin, range.end));
+  return adaptor->Open();
+}
+
+Status MultiFileIOAdaptor::nextRange() {
+  RETURN_ON_ERROR(Close());
+  if (++cursor_ < ranges_.size()) {
+    RETURN_ON_ERROR(openRange(cursor_, current_));
+  }
+  return Status::OK();
+}
+
+Status MultiFileIOAdaptor::ReadLine(std::string& line) {
+  while (current_ != nullptr) {
+    auto status = current_->ReadLine(line);
+    if (!status.IsEndOfFile()) {
+      return status;
+    }
+    RETURN_ON_ERROR(nextRange());
+  }
+  return Status::EndOfFile();
+}
+
+Status MultiFileIOAdaptor::WriteLine(const std::string& line) {
+  return Status::NotImplemented(
+      "Writing to a directory or glob pattern is not supported");
+}
+
+Status MultiFileIOAdaptor::Read(void* buffer, size_t size) {
+  while (current_ != nullptr) {
+    auto status = current_->Read(buffer, size);
+    if (!status.IsEndOfFile()) {
+      return status;
+    }
+    RETURN_ON_ERROR(nextRange());
+  }
+  return Status::EndOfFile();
+}
+
+Status MultiFileIOAdaptor::Write(void* buffer, size_t size) {
+  return Status::NotImplemented(
+      "Writing to a directory or glob pattern is not supported");
+}
+
+Status MultiFileIOAdaptor::ReadTable(std::shared_ptr<arrow::Table>* table) {
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  RETURN_ON_ERROR(ReadTables([&](std::shared_ptr<arrow::Table> const& piece) {
+    tables.emplace_back(piece);
+    return Status::OK();
+  }));
+  if (tables.empty()) {
+    *table = nullptr;
+    return Status::OK();
+  }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(arrow::ConcatenateTables(tables, table));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(*table, arrow::ConcatenateTables(tables));
+#endif
+  return Status::OK();
+}
+
+Status MultiFileIOAdaptor::ReadTables(
+    std::function<Status(std::shared_ptr<arrow::Table> const&)> const&
+        callback) {
+  for (size_t index = 0; index < ranges_.size(); ++index) {
+    if (ranges_[index].end <= ranges_[index].begin) {
+      continue;
+    }
+    std::unique_ptr<LocalIOAdaptor> adaptor;
+    RETURN_ON_ERROR(openRange(index, adaptor));
+    std::shared_ptr<arrow::Table> table;
+    RETURN_ON_ERROR(adaptor->ReadTable(&table));
+    RETURN_ON_ERROR(adaptor->Close());
+    if (table != nullptr && table->num_rows() > 0) {
+      RETURN_ON_ERROR(callback(table));
+    }
+  }
+  return Status::OK();
+}
+
+Status MultiFileIOAdaptor::ListDirectory(const std::string& path,
+                                         std::vector<std::string>& files) {
+  return LocalIOAdaptor(path).ListDirectory(path, files);
+}
+
+Status MultiFileIOAdaptor::MakeDirectory(const std::string& path) {
+  return LocalIOAdaptor(path).MakeDirectory(path);
+}
+
+bool MultiFileIOAdaptor::IsExist(const std::string& path) {
+  std::vector<std::pair<std::string, int64_t>> files;
+  return listFiles(files).ok();
+}
+
+std::unordered_multimap<std::string, std::string>
+MultiFileIOAdaptor::GetMeta() {
+  return meta_;
+}
+
+}  // namespace vineyard
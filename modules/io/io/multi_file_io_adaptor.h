@@ -0,0 +1,143 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MODULES_IO_IO_MULTI_FILE_IO_ADAPTOR_H_
+#define MODULES_IO_IO_MULTI_FILE_IO_ADAPTOR_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "arrow/api.h"
+
+#include "common/util/status.h"
+#include "io/io/i_io_adaptor.h"
+#include "io/io/local_io_adaptor.h"
+
+namespace vineyard {
+
+/**
+ * @brief Reads a directory, or the files that match a glob pattern, as one
+ * dataset, e.g., "/data/part-*.csv#header_row=true".
+ *
+ * The files are sorted by name and concatenated, then the bytes are split
+ * evenly among the `total_parts` workers, thus every worker reads a similar
+ * amount of data no matter how the sizes of files skew: small files are
+ * assigned as a whole, large files are split into byte ranges at line breaks.
+ * Files that cannot be split, i.e., compressed files and files smaller than
+ * "min_split_size", are never shared by two workers.
+ *
+ * In a directory, the hidden files and the files whose name begins with '_',
+ * e.g., "_SUCCESS", are skipped.
+ *
+ * Every piece is read by a `LocalIOAdaptor`, with the same configuration in
+ * the location and `Configure`.
+ */
+class MultiFileIOAdaptor : public IIOAdaptor {
+ public:
+  struct FileRange {
+    std::string path;
+    int64_t begin;
+    int64_t end;  // the whole file if unsplittable
+  };
+
+  explicit MultiFileIOAdaptor(const std::string& location);
+
+  ~MultiFileIOAdaptor();
+
+  /** Whether the location is a directory or a glob pattern. */
+  static bool IsMultiFile(const std::string& location);
+
+  /** Assign the pieces of files to the worker `index` in `total_parts`.
+   *
+   * @param files the files with their sizes, in order.
+   * @param min_split_size files smaller than this are never split.
+   */
+  static std::vector<FileRange> Schedule(
+      std::vector<std::pair<std::string, int64_t>> const& files,
+      int64_t const min_split_size, int const index, int const total_parts);
+
+  Status Open() override;
+
+  Status Open(const char* mode) override;
+
+  Status Close() override;
+
+  Status SetPartialRead(const int index, const int total_parts) override;
+
+  /** Configure the adaptor, the supported items are:
+   *
+   *  - min_split_size: files smaller than this number of bytes are read by
+   *    a single worker, 16MB by default.
+   *
+   * Other items are passed to every `LocalIOAdaptor`.
+   */
+  Status Configure(const std::string& key, const std::string& value) override;
+
+  Status ReadLine(std::string& line) override;
+
+  Status WriteLine(const std::string& line) override;
+
+  Status Read(void* buffer, size_t size) override;
+
+  Status Write(void* buffer, size_t size) override;
+
+  Status ReadTable(std::shared_ptr<arrow::Table>* table) override;
+
+  /** Read the pieces one by one, the callback is called once per piece. */
+  Status ReadTables(
+      std::function<Status(std::shared_ptr<arrow::Table> const&)> const&
+          callback) override;
+
+  Status ListDirectory(const std::string& path,
+                       std::vector<std::string>& files) override;
+
+  Status MakeDirectory(const std::string& path) override;
+
+  bool IsExist(const std::string& path) override;
+
+  std::unordered_multimap<std::string, std::string> GetMeta() override;
+
+  /** The pieces assigned to this worker, available after `Open`. */
+  std::vector<FileRange> const& ranges() const { return ranges_; }
+
+ private:
+  Status listFiles(std::vector<std::pair<std::string, int64_t>>& files);
+  Status openRange(size_t const index,
+                   std::unique_ptr<LocalIOAdaptor>& adaptor);
+  Status nextRange();
+
+  std::string location_;
+  std::string path_;
+  std::string config_;  // the "#..." part of location, may be empty
+
+  int64_t min_split_size_;
+  std::vector<std::pair<std::string, std::string>> configs_;
+
+  int index_;
+  int total_parts_;
+
+  std::vector<FileRange> ranges_;
+  size_t cursor_ = 0;
+  std::unique_ptr<LocalIOAdaptor> current_;
+  std::unordered_multimap<std::string, std::string> meta_;
+};
+
+}  // namespace vineyard
+
+#endif  // MODULES_IO_IO_MULTI_FILE_IO_ADAPTOR_H_
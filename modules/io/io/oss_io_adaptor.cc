@@ -23,6 +23,7 @@ limitations under the License.
 #include <fstream>
 #include <memory>
 #include <random>
+#include <streambuf>
 #include <thread>
 
 #include "alibabacloud/oss/OssClient.h"
@@ -59,6 +60,36 @@ using AlibabaCloud::OSS::ShutdownSdk;
 
 namespace vineyard {
 
+namespace detail {
+
+// a stream over a preallocated buffer, thus the response of a ranged download
+// is written straight into the chunk, rather than copied out of a
+// `std::stringstream`.
+class ChunkStreamBuf : public std::streambuf {
+ public:
+  ChunkStreamBuf(char* data, size_t size) {
+    setp(data, data + size);
+    setg(data, data, data + size);
+  }
+
+  size_t written() const { return pptr() - pbase(); }
+};
+
+class ChunkStream : public std::iostream {
+ public:
+  ChunkStream(char* data, size_t size)
+      : std::iostream(nullptr), buffer_(data, size) {
+    rdbuf(&buffer_);
+  }
+
+  size_t written() const { return buffer_.written(); }
+
+ private:
+  ChunkStreamBuf buffer_;
+};
+
+}  // namespace detail
+
 class UserRetryStrategy : public RetryStrategy {
  public:
   /* maxRetries表示最大重试次数，scaleFactor为重试等待时间的尺度因子。*/
@@ -125,11 +156,11 @@ OSSIOAdaptor::OSSIOAdaptor(const std::string& location) : location_(location) {
   // There are two kinds of objects. one end with .meta, one end with .tsv,
   // We only want .tsv file
   suffix_ = FLAGS_oss_suffix;
-  current_object_ = 0;
 
   producer_num_ = FLAGS_oss_concurrency;
+  window_ = 2 * producer_num_;
+  next_range_ = 0;
 
-  exited_producers_ = 0;
   buffer_next_ = 0;
 
   // default connections is 16. Use high value if specified.
@@ -153,14 +184,21 @@ OSSIOAdaptor::OSSIOAdaptor(const std::string& location) : location_(location) {
   VLOG(2) << "prefix: " << prefix_;
   VLOG(2) << "suffix: " << suffix_;
   VLOG(2) << "concurrency: " << producer_num_;
+
+  client_ = std::make_shared<OssClient>(oss_endpoint_, access_id_,
+                                       access_key_, conf_);
 }
 
-OSSIOAdaptor::~OSSIOAdaptor() {
-  for (auto& thrd : producers_) {
-    if (thrd.joinable()) {
-      thrd.join();
-    }
+OSSIOAdaptor::~OSSIOAdaptor() { VINEYARD_SUPPRESS(Close()); }
+
+Status OSSIOAdaptor::Configure(const std::string& key,
+                               const std::string& value) {
+  if (key == "chunk_size") {
+    chunk_size_ = std::max<int64_t>(1, std::stoll(value));
+  } else if (key == "window") {
+    window_ = std::max<size_t>(1, std::stoul(value));
   }
+  return Status::OK();
 }
 
 void OSSIOAdaptor::parseOssCredentials(const std::string& file_name) {
@@ -291,8 +329,11 @@ Status OSSIOAdaptor::Open() {
   if (partial_read_) {
     selectObjects();
   }
-  producer_num_ = std::min(producer_num_, objects_.size());
+  splitRanges();
+  producer_num_ = std::max<size_t>(
+      1, std::min(producer_num_, std::min(window_, ranges_.size())));
   producers_.resize(producer_num_);
+  queue_.SetLimit(window_);
   queue_.SetProducerNum(producer_num_);
   for (size_t i = 0; i < producer_num_; ++i) {
     producers_[i] = std::thread(&OSSIOAdaptor::producerRoutine, this);
@@ -303,14 +344,30 @@ Status OSSIOAdaptor::Open() {
 Status OSSIOAdaptor::ReadLine(std::string& line) {
   while (true) {
     if (buffer_next_ >= current_buffer_.size()) {
-      if (exited_producers_ == producer_num_ && queue_.Size() == 0) {
-        return Status::EndOfFile();
+      Chunk chunk;
+      if (!queue_.Get(chunk)) {
+        if (!pending_.empty()) {
+          line.swap(pending_);
+          pending_.clear();
+          return Status::OK();
+        }
+        std::lock_guard<std::mutex> lock(reorder_mutex_);
+        return error_.ok() ? Status::EndOfFile() : error_;
       }
-      queue_.Get(current_buffer_);
+      current_buffer_ = std::move(chunk.content);
+      current_last_ = chunk.last;
       buffer_next_ = 0;
     } else {
       auto next = current_buffer_.find('\n', buffer_next_);
-      line = current_buffer_.substr(buffer_next_, next - buffer_next_);
+      if (next == std::string::npos && !current_last_) {
+        // the line continues in the next chunk
+        pending_.append(current_buffer_, buffer_next_, std::string::npos);
+        buffer_next_ = current_buffer_.size();
+        continue;
+      }
+      line = pending_ +
+             current_buffer_.substr(buffer_next_, next - buffer_next_);
+      pending_.clear();
       buffer_next_ = next == std::string::npos ? next : next + 1;
       return Status::OK();
     }
@@ -319,10 +376,14 @@ Status OSSIOAdaptor::ReadLine(std::string& line) {
 
 Status OSSIOAdaptor::ReadTable(std::shared_ptr<arrow::Table>* table) {
   arrow::BufferBuilder builder;
-  std::string buffer;
-  while (!(exited_producers_ == producer_num_ && queue_.Size() == 0)) {
-    queue_.Get(buffer);
-    RETURN_ON_ARROW_ERROR(builder.Append(buffer.c_str(), buffer.size()));
+  Chunk chunk;
+  while (queue_.Get(chunk)) {
+    RETURN_ON_ARROW_ERROR(
+        builder.Append(chunk.content.data(), chunk.content.size()));
+  }
+  {
+    std::lock_guard<std::mutex> lock(reorder_mutex_);
+    RETURN_ON_ERROR(error_);
   }
   std::shared_ptr<arrow::Buffer> buf;
   RETURN_ON_ARROW_ERROR(builder.Finish(&buf));
@@ -346,12 +407,11 @@ Status OSSIOAdaptor::ReadTable(std::shared_ptr<arrow::Table>* table) {
 }
 
 Status OSSIOAdaptor::Write(void* buffer, size_t size) {
-  OssClient client(oss_endpoint_, access_id_, access_key_, conf_);
   std::shared_ptr<std::iostream> content =
       std::make_shared<std::stringstream>();
   *content << static_cast<char*>(buffer);
   PutObjectRequest request(bucket_name_, prefix_, content);
-  auto outcome = client.PutObject(request);
+  auto outcome = client_->PutObject(request);
   if (!outcome.isSuccess()) {
     LOG(ERROR) << "Put object failed, code: " << outcome.error().Code()
                << ", message: " << outcome.error().Message()
@@ -366,17 +426,19 @@ void OSSIOAdaptor::selectObjects() {
           << " total = " << part_num_;
   size_t object_num = objects_.size();
   std::vector<std::string> selected;
+  std::vector<int64_t> selected_sizes;
   for (size_t i = 0; i < object_num; ++i) {
     if (i % part_num_ == part_id_) {
       selected.emplace_back(objects_[i]);
+      selected_sizes.emplace_back(object_sizes_[i]);
     }
   }
   objects_.swap(selected);
+  object_sizes_.swap(selected_sizes);
 }
 
 Status OSSIOAdaptor::listAllObjects(const std::string& prefix,
                                     const std::string& suffix) {
-  OssClient client(oss_endpoint_, access_id_, access_key_, conf_);
 
   std::string next_marker;
   bool IsTruncated = false;
@@ -384,7 +446,7 @@ Status OSSIOAdaptor::listAllObjects(const std::string& prefix,
     ListObjectsRequest request(bucket_name_);
     request.setPrefix(prefix);
     request.setMarker(next_marker);
-    auto outcome = client.ListObjects(request);
+    auto outcome = client_->ListObjects(request);
     if (!outcome.isSuccess()) {
       LOG(ERROR) << "List object fail, code: " << outcome.error().Code()
                  << ", message: " << outcome.error().Message()
@@ -395,6 +457,7 @@ Status OSSIOAdaptor::listAllObjects(const std::string& prefix,
       auto name = object.Key();
       if (suffix.empty() || boost::ends_with(name, suffix)) {
         objects_.push_back(name);
+        object_sizes_.push_back(object.Size());
       }
     }
     next_marker = outcome.result().NextMarker();
@@ -408,42 +471,102 @@ Status OSSIOAdaptor::listAllObjects(const std::string& prefix,
   return Status::OK();
 }
 
-Status OSSIOAdaptor::producerRoutine() {
+void OSSIOAdaptor::splitRanges() {
+  ranges_.clear();
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    int64_t begin = 0;
+    do {
+      int64_t end = std::min(begin + chunk_size_, object_sizes_[i]);
+      ranges_.emplace_back(Range{i, begin, end});
+      begin = end;
+    } while (begin < object_sizes_[i]);
+  }
+  VLOG(2) << "Split " << objects_.size() << " objects into " << ranges_.size()
+          << " ranges";
+}
+
+void OSSIOAdaptor::producerRoutine() {
   while (true) {
-    size_t index = __sync_fetch_and_add(&current_object_, 1);
-    if (index >= objects_.size()) {
+    size_t index = next_range_++;
+    if (index >= ranges_.size() || stopping_) {
       break;
     }
-    std::string content;
-    auto st = getObjectToBuffer(objects_[index], content);
+    {
+      // bounds the chunks that are downloaded but not read yet, wakes up
+      // periodically to see `stopping_`
+      std::unique_lock<std::mutex> lock(reorder_mutex_);
+      auto ready = [&]() {
+        return index < next_delivery_ + window_ || !error_.ok() || stopping_;
+      };
+      while (!reorder_cv_.wait_for(lock, std::chrono::milliseconds(100),
+                                   ready)) {
+      }
+      if (!error_.ok() || stopping_) {
+        break;
+      }
+    }
+    auto const& range = ranges_[index];
+    Chunk chunk;
+    auto st = getRangeToBuffer(range, chunk.content);
     if (!st.ok()) {
       LOG(ERROR) << "IOException: OSS Exception: get object failed.";
-      return st;
+      std::lock_guard<std::mutex> lock(reorder_mutex_);
+      if (error_.ok()) {
+        error_ = st;
+      }
+      reorder_cv_.notify_all();
+      break;
     }
-    queue_.Put(std::move(content));
+    chunk.last = range.end == object_sizes_[range.object];
+    deliver(index, std::move(chunk));
   }
-  ++exited_producers_;
   queue_.DecProducerNum();
-  return Status::OK();
 }
 
-Status OSSIOAdaptor::getObjectToBuffer(const std::string& object_name,
-                                       std::string& content) {
-  OssClient client(oss_endpoint_, access_id_, access_key_, conf_);
-  GetObjectRequest request(bucket_name_, object_name);
-  auto outcome = client.GetObject(request);
+void OSSIOAdaptor::deliver(size_t const index, Chunk&& chunk) {
+  std::lock_guard<std::mutex> lock(reorder_mutex_);
+  reorder_buffer_.emplace(index, std::move(chunk));
+  auto iter = reorder_buffer_.begin();
+  while (iter != reorder_buffer_.end() && iter->first == next_delivery_) {
+    queue_.Put(std::move(iter->second));
+    iter = reorder_buffer_.erase(iter);
+    ++next_delivery_;
+  }
+  reorder_cv_.notify_all();
+}
+
+Status OSSIOAdaptor::getRangeToBuffer(Range const& range,
+                                      std::string& content) {
+  content.resize(range.end - range.begin);
+  if (content.empty()) {
+    return Status::OK();
+  }
+  GetObjectRequest request(bucket_name_, objects_[range.object]);
+  request.setRange(range.begin, range.end - 1);  // inclusive
+  // the factory is invoked again by every retry, thus a retry writes from the
+  // beginning of the buffer, rather than after the bytes of the failed one.
+  std::shared_ptr<detail::ChunkStream> stream;
+  char* data = &content[0];
+  size_t const size = content.size();
+  request.setResponseStreamFactory(
+      [&stream, data, size]() -> std::shared_ptr<std::iostream> {
+        stream = std::make_shared<detail::ChunkStream>(data, size);
+        return stream;
+      });
+  auto outcome = client_->GetObject(request);
 
   if (outcome.isSuccess()) {
-    int content_length = outcome.result().Metadata().ContentLength();
-    VLOG(2) << "getObjectToBuffer success, Content-Length: " << content_length;
-    content.clear();
-    content.resize(content_length);
-    auto stream = outcome.result().Content();
-    for (int i = 0; i < content_length; ++i) {
-      stream->get(content[i]);
+    VLOG(2) << "getRangeToBuffer success, object: " << objects_[range.object]
+            << ", range: [" << range.begin << ", " << range.end << ")";
+    size_t written = stream == nullptr ? 0 : stream->written();
+    if (written != size) {
+      return Status::IOError("Incomplete download of " +
+                             objects_[range.object] + ": " +
+                             std::to_string(written) + " of " +
+                             std::to_string(size) + " bytes");
     }
   } else {
-    LOG(ERROR) << "getObjectToBuffer fail, code: " << outcome.error().Code()
+    LOG(ERROR) << "getRangeToBuffer fail, code: " << outcome.error().Code()
                << ", message: " << outcome.error().Message()
                << ", requestId: " << outcome.error().RequestId();
     return Status::IOError(outcome.error().Message());
@@ -452,6 +575,13 @@ Status OSSIOAdaptor::getObjectToBuffer(const std::string& object_name,
 }
 
 Status OSSIOAdaptor::Close() {
+  if (!producers_.empty()) {
+    // stops downloading, and unblocks the producers waiting for the queue
+    stopping_ = true;
+    Chunk chunk;
+    while (queue_.Get(chunk)) {
+    }
+  }
   for (auto& thrd : producers_) {
     if (thrd.joinable()) {
       thrd.join();
@@ -474,8 +604,7 @@ Status OSSIOAdaptor::SetPartialRead(int index, int total_parts) {
 }
 
 bool OSSIOAdaptor::IsExist(const std::string& path) {
-  OssClient client(oss_endpoint_, access_id_, access_key_, conf_);
-  return client.DoesObjectExist(bucket_name_, prefix_);
+  return client_->DoesObjectExist(bucket_name_, prefix_);
 }
 }  // namespace vineyard
 
@@ -19,8 +19,11 @@ limitations under the License.
 #ifdef OSS_ENABLED
 
 #include <atomic>
+#include <condition_variable>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <utility>
@@ -40,6 +43,15 @@ DECLARE_int32(oss_concurrency);
 DECLARE_int32(oss_retries);
 
 namespace vineyard {
+
+/**
+ * @brief Reads the objects under a prefix of an OSS bucket.
+ *
+ * The objects are split into ranges of "chunk_size" bytes, which are
+ * downloaded by `oss_concurrency` threads with a shared client, at most
+ * "window" ranges are in flight (or waiting to be read) at a time. The ranges
+ * are reordered, thus read in the order of objects and offsets.
+ */
 class OSSIOAdaptor : public IIOAdaptor {
  public:
   explicit OSSIOAdaptor(const std::string& location);
@@ -54,9 +66,13 @@ class OSSIOAdaptor : public IIOAdaptor {
 
   Status SetPartialRead(int index, int total_parts) override;
 
-  Status Configure(const std::string& key, const std::string& value) override {
-    return Status::OK();
-  }
+  /** Configure the adaptor, the supported items are:
+   *
+   *  - chunk_size: the bytes of a ranged download, 8MB by default.
+   *  - window: the number of ranges in flight, twice of the concurrency by
+   *    default.
+   */
+  Status Configure(const std::string& key, const std::string& value) override;
 
   Status ReadLine(std::string& line) override;
 
@@ -92,9 +108,27 @@ class OSSIOAdaptor : public IIOAdaptor {
 
   void selectObjects();
 
-  Status producerRoutine();
+  // a range of an object, the last range of an object is marked, thus the
+  // lines across ranges are concatenated.
+  struct Chunk {
+    std::string content;
+    bool last;
+  };
+
+  struct Range {
+    size_t object;
+    int64_t begin;
+    int64_t end;
+  };
+
+  void splitRanges();
 
-  Status getObjectToBuffer(const std::string& object_name, std::string& block);
+  void producerRoutine();
+
+  Status getRangeToBuffer(Range const& range, std::string& content);
+
+  // delivers the downloaded chunks to the queue in order
+  void deliver(size_t const index, Chunk&& chunk);
 
   void parseOssCredentials(const std::string& file_name);
   void parseOssEnvironmentVariables();
@@ -107,9 +141,13 @@ class OSSIOAdaptor : public IIOAdaptor {
   const char* OSS_ENDPOINT = "host";
 
   AlibabaCloud::OSS::ClientConfiguration conf_;
+  // shared by the downloading threads
+  std::shared_ptr<AlibabaCloud::OSS::OssClient> client_;
 
   std::string current_buffer_;
+  bool current_last_ = true;
   size_t buffer_next_;
+  std::string pending_;  // the incomplete line of the previous chunk
 
   std::string location_;
 
@@ -124,16 +162,28 @@ class OSSIOAdaptor : public IIOAdaptor {
   std::string suffix_;
 
   std::vector<std::string> objects_;
-  size_t current_object_;
+  std::vector<int64_t> object_sizes_;
+
+  int64_t chunk_size_ = 8 * 1024 * 1024;
+  size_t window_;
+  std::vector<Range> ranges_;
+  std::atomic<size_t> next_range_;
+
+  // the chunks that have been downloaded but not delivered yet
+  std::mutex reorder_mutex_;
+  std::condition_variable reorder_cv_;
+  std::map<size_t, Chunk> reorder_buffer_;
+  size_t next_delivery_ = 0;
+  Status error_;
 
   bool opened_ = false;
   bool partial_read_ = false;
 
   size_t producer_num_;
-  std::atomic<size_t> exited_producers_;
   std::vector<std::thread> producers_;
+  std::atomic<bool> stopping_{false};
 
-  PCBlockingQueue<std::string> queue_;
+  PCBlockingQueue<Chunk> queue_;
 
   size_t part_num_;
   size_t part_id_;
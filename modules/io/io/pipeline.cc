@@ -0,0 +1,217 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "io/io/pipeline.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+
+namespace vineyard {
+
+Status Pipeline::Run(size_t concurrency) {
+  if (sink_ == nullptr) {
+    return Status::Invalid("The pipeline has no sink");
+  }
+  if (concurrency == 0) {
+    concurrency = 1;
+  }
+  std::vector<std::thread> workers;
+  for (size_t idx = 0; idx < concurrency; ++idx) {
+    workers.emplace_back(&Pipeline::work, this);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (!status_.ok()) {
+    VINEYARD_SUPPRESS(sink_->Abort());
+    return status_;
+  }
+  return sink_->Finish();
+}
+
+void Pipeline::work() {
+  while (true) {
+    PipelineChunk chunk;
+    {
+      std::lock_guard<std::mutex> lock(source_mutex_);
+      if (exhausted_) {
+        return;
+      }
+      auto status = source_->Next(chunk);
+      if (status.IsEndOfFile()) {
+        exhausted_ = true;
+        return;
+      }
+      if (!status.ok()) {
+        exhausted_ = true;
+        fail(status);
+        return;
+      }
+      chunk.sequence = {sequence_++};
+    }
+    auto status = process(0, chunk);
+    if (!status.ok()) {
+      // stops the other workers as well
+      {
+        std::lock_guard<std::mutex> lock(source_mutex_);
+        exhausted_ = true;
+      }
+      fail(status);
+      return;
+    }
+  }
+}
+
+Status Pipeline::process(size_t const index, PipelineChunk const& chunk) {
+  if (index == operators_.size()) {
+    std::lock_guard<std::mutex> lock(sink_mutex_);
+    return sink_->Consume(chunk);
+  }
+  size_t emitted = 0;
+  return operators_[index]->Process(
+      chunk, [this, index, &chunk, &emitted](PipelineChunk const& output) {
+        PipelineChunk tagged = output;
+        tagged.sequence = chunk.sequence;
+        tagged.sequence.emplace_back(emitted++);
+        return process(index + 1, tagged);
+      });
+}
+
+void Pipeline::fail(Status const& status) {
+  std::lock_guard<std::mutex> lock(status_mutex_);
+  if (status_.ok()) {
+    status_ = status;
+  }
+}
+
+Status AdaptorLineSource::Next(PipelineChunk& chunk) {
+  std::string content, line;
+  while (content.size() < chunk_size_ && adaptor_->ReadLine(line).ok()) {
+    content.append(line);
+  }
+  if (content.empty()) {
+    return Status::EndOfFile();
+  }
+  chunk.buffer = arrow::Buffer::FromString(std::move(content));
+  return Status::OK();
+}
+
+Status BatchReaderSource::Next(PipelineChunk& chunk) {
+  if (reader_ == nullptr) {
+    return Status::EndOfFile();
+  }
+  std::shared_ptr<arrow::RecordBatch> batch;
+  RETURN_ON_ARROW_ERROR(reader_->ReadNext(&batch));
+  if (batch == nullptr) {
+    return Status::EndOfFile();
+  }
+  return RecordBatchesToTable({batch}, &chunk.table);
+}
+
+ByteStreamSource::ByteStreamSource(Client& client,
+                                   std::shared_ptr<ByteStream> stream)
+    : releaser_(new Client()), puller_(new Client()) {
+  status_ = releaser_->Connect(client.IPCSocket());
+  if (status_.ok()) {
+    status_ = puller_->Connect(client.IPCSocket());
+  }
+  if (status_.ok()) {
+    puller_->SetStreamChunkReleaser(releaser_.get());
+    reader_ = stream->OpenReader(*puller_);
+  }
+}
+
+Status ByteStreamSource::Next(PipelineChunk& chunk) {
+  RETURN_ON_ERROR(status_);
+  auto status = reader_->GetNext(chunk.buffer);
+  if (status.IsStreamDrained()) {
+    return Status::EndOfFile();
+  }
+  return status;
+}
+
+Status ParseCSVOperator::Process(PipelineChunk const& chunk,
+                                 PipelineEmitter const& emit) {
+  if (chunk.buffer == nullptr) {
+    return Status::Invalid("Expect a buffer of CSV lines");
+  }
+  // the buffer is kept alive by the chunk, thus no copy is required.
+  PipelineChunk output;
+  RETURN_ON_ERROR(parser_.Parse(chunk.buffer, output.table));
+  VLOG(2) << "Parsed " << output.table->num_rows() << " rows from "
+          << chunk.buffer->size() << " bytes";
+  return emit(output);
+}
+
+Status DataframeStreamSink::Consume(PipelineChunk const& chunk) {
+  if (chunk.table == nullptr) {
+    return Status::Invalid("Expect a table for the dataframe stream");
+  }
+  if (schema_ == nullptr) {
+    schema_ = chunk.table->schema();
+  }
+  std::shared_ptr<arrow::Table> table;
+  auto status = CastCSVTable(chunk.table, schema_, table);
+  if (!status.ok()) {
+    return Status::Invalid(
+        "The column types are promoted after the stream has been written: " +
+        status.ToString());
+  }
+  return writer_->WriteTable(table);
+}
+
+Status TableCollector::Consume(PipelineChunk const& chunk) {
+  if (chunk.table == nullptr) {
+    return Status::Invalid("Expect a table to collect");
+  }
+  tables_.emplace_back(chunk.sequence, chunk.table);
+  return Status::OK();
+}
+
+Status TableCollector::GetTable(std::shared_ptr<arrow::Table>& table) {
+  if (tables_.empty()) {
+    return Status::Invalid("No table has been collected");
+  }
+  std::sort(tables_.begin(), tables_.end(),
+            [](decltype(tables_)::value_type const& lhs,
+               decltype(tables_)::value_type const& rhs) {
+              return lhs.first < rhs.first;
+            });
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  for (auto const& item : tables_) {
+    tables.emplace_back(item.second);
+  }
+  std::shared_ptr<arrow::Schema> schema;
+  RETURN_ON_ERROR(PromoteCSVSchema(tables, schema));
+  for (auto& item : tables) {
+    RETURN_ON_ERROR(CastCSVTable(item, schema, item));
+  }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(arrow::ConcatenateTables(tables, &table));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(table, arrow::ConcatenateTables(tables));
+#endif
+  return Status::OK();
+}
+
+}  // namespace vineyard
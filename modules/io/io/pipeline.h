@@ -0,0 +1,261 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MODULES_IO_IO_PIPELINE_H_
+#define MODULES_IO_IO_PIPELINE_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "arrow/api.h"
+
+#include "basic/stream/byte_stream.h"
+#include "basic/stream/dataframe_stream.h"
+#include "client/client.h"
+#include "common/util/status.h"
+#include "io/io/csv_chunk_parser.h"
+#include "io/io/i_io_adaptor.h"
+
+namespace vineyard {
+
+/**
+ * @brief The unit of data that flows through a pipeline, either a buffer of
+ * bytes or a table, which is passed between operators by reference.
+ *
+ * The `sequence` is assigned by the pipeline: the index of the chunk in the
+ * source, followed by its index among the chunks emitted by every operator,
+ * thus the chunks are in the order of the source when sorted by sequences.
+ */
+struct PipelineChunk {
+  std::shared_ptr<arrow::Buffer> buffer;
+  std::shared_ptr<arrow::Table> table;
+  std::vector<size_t> sequence;
+};
+
+using PipelineEmitter = std::function<Status(PipelineChunk const&)>;
+
+/**
+ * @brief The head of a pipeline. The calls to `Next` are serialized by the
+ * pipeline, and it returns Status::EndOfFile() once exhausted.
+ */
+class PipelineSource {
+ public:
+  virtual ~PipelineSource() {}
+
+  virtual Status Next(PipelineChunk& chunk) = 0;
+};
+
+/**
+ * @brief An intermediate stage of a pipeline, which emits zero or more chunks
+ * for every input chunk. `Process` is invoked by many workers concurrently.
+ */
+class PipelineOperator {
+ public:
+  virtual ~PipelineOperator() {}
+
+  virtual Status Process(PipelineChunk const& chunk,
+                         PipelineEmitter const& emit) = 0;
+};
+
+/**
+ * @brief The tail of a pipeline. The calls to `Consume` are serialized by the
+ * pipeline, then either `Finish` or `Abort` is called once.
+ */
+class PipelineSink {
+ public:
+  virtual ~PipelineSink() {}
+
+  virtual Status Consume(PipelineChunk const& chunk) = 0;
+
+  virtual Status Finish() { return Status::OK(); }
+
+  virtual Status Abort() { return Status::OK(); }
+};
+
+/**
+ * @brief Pipeline chains a source, operators and a sink in process.
+ *
+ * The operators are fused: a worker takes a chunk from the source and pushes
+ * it through all the operators, down to the sink, on the same thread, thus
+ * chunks are never copied nor queued between stages. All stages share the
+ * same pool of workers, thus with more than one worker, the chunks reach the
+ * sink out of order, and a sink that cares restores the order by the
+ * sequences of chunks, e.g., the `TableCollector`.
+ *
+ * Vineyard streams are only needed at the boundaries of a pipeline, see also
+ * the `ByteStreamSource` and `DataframeStreamSink` below.
+ */
+class Pipeline {
+ public:
+  explicit Pipeline(std::shared_ptr<PipelineSource> source)
+      : source_(source) {}
+
+  Pipeline& Then(std::shared_ptr<PipelineOperator> op) {
+    operators_.emplace_back(op);
+    return *this;
+  }
+
+  Pipeline& To(std::shared_ptr<PipelineSink> sink) {
+    sink_ = sink;
+    return *this;
+  }
+
+  /**
+   * @brief Run the pipeline until the source is exhausted, or any stage fails,
+   * in which case the sink is aborted and the first error is returned.
+   */
+  Status Run(size_t concurrency = std::thread::hardware_concurrency());
+
+ private:
+  void work();
+
+  Status process(size_t const index, PipelineChunk const& chunk);
+
+  void fail(Status const& status);
+
+  std::shared_ptr<PipelineSource> source_;
+  std::vector<std::shared_ptr<PipelineOperator>> operators_;
+  std::shared_ptr<PipelineSink> sink_;
+
+  std::mutex source_mutex_, sink_mutex_, status_mutex_;
+  bool exhausted_ = false;
+  size_t sequence_ = 0;
+  Status status_;
+};
+
+/**
+ * @brief Read chunks of complete lines from an io adaptor, e.g., a partition
+ * of a local file.
+ */
+class AdaptorLineSource : public PipelineSource {
+ public:
+  AdaptorLineSource(std::shared_ptr<IIOAdaptor> adaptor,
+                    size_t const chunk_size = 2 * 1024 * 1024)
+      : adaptor_(adaptor), chunk_size_(chunk_size) {}
+
+  Status Next(PipelineChunk& chunk) override;
+
+ private:
+  std::shared_ptr<IIOAdaptor> adaptor_;
+  size_t chunk_size_;
+};
+
+/**
+ * @brief Read record batches from a streaming reader, e.g., the
+ * `LocalIOAdaptor::OpenPartialBatchReader`, as tables of one batch each, thus
+ * every batch reaches the sink as soon as it has been parsed.
+ */
+class BatchReaderSource : public PipelineSource {
+ public:
+  explicit BatchReaderSource(std::shared_ptr<arrow::RecordBatchReader> reader)
+      : reader_(reader) {}
+
+  Status Next(PipelineChunk& chunk) override;
+
+ private:
+  std::shared_ptr<arrow::RecordBatchReader> reader_;
+};
+
+/**
+ * @brief Read chunks from a byte stream, without copying them.
+ *
+ * The chunks are pulled through a connection of the source, and released
+ * through another one, since a pull holds its connection until the writer
+ * produces the next chunk, see also `Client::SetStreamChunkReleaser`. Thus the
+ * source must outlive the chunks.
+ */
+class ByteStreamSource : public PipelineSource {
+ public:
+  ByteStreamSource(Client& client, std::shared_ptr<ByteStream> stream);
+
+  Status Next(PipelineChunk& chunk) override;
+
+ private:
+  std::unique_ptr<Client> releaser_, puller_;
+  std::unique_ptr<ByteStreamReader> reader_;
+  Status status_;
+};
+
+/**
+ * @brief Parse chunks of CSV lines into tables. The column types of the first
+ * chunk are carried forward to the following chunks, and promoted when a chunk
+ * doesn't fit them, see also `CSVChunkParser`.
+ */
+class ParseCSVOperator : public PipelineOperator {
+ public:
+  ParseCSVOperator(char const delimiter,
+                   std::vector<std::string> const& column_names)
+      : parser_(delimiter, column_names, false) {}
+
+  Status Process(PipelineChunk const& chunk,
+                 PipelineEmitter const& emit) override;
+
+ private:
+  // parallelism comes from the pipeline workers
+  CSVChunkParser parser_;
+};
+
+/**
+ * @brief Write the tables to a dataframe stream, in the order they reach the
+ * sink.
+ *
+ * The readers of the stream expect a consistent schema, thus the tables are
+ * cast to the schema of the first table written, e.g., when the column types
+ * are promoted by `ParseCSVOperator`, and the sink fails if the values don't
+ * fit, see also `CastCSVTable`.
+ */
+class DataframeStreamSink : public PipelineSink {
+ public:
+  DataframeStreamSink(Client& client, std::shared_ptr<DataframeStream> stream)
+      : writer_(stream->OpenWriter(client)) {}
+
+  Status Consume(PipelineChunk const& chunk) override;
+
+  Status Finish() override { return writer_->Finish(); }
+
+  Status Abort() override { return writer_->Abort(); }
+
+ private:
+  std::unique_ptr<DataframeStreamWriter> writer_;
+  std::shared_ptr<arrow::Schema> schema_;
+};
+
+/**
+ * @brief Collect the tables in process.
+ */
+class TableCollector : public PipelineSink {
+ public:
+  Status Consume(PipelineChunk const& chunk) override;
+
+  /**
+   * @brief Concatenate the collected tables in the order of the source, which
+   * requires at least one. The column types of tables are unified by
+   * `PromoteCSVSchema`, as the types may be promoted by a later chunk.
+   */
+  Status GetTable(std::shared_ptr<arrow::Table>& table);
+
+ private:
+  std::vector<std::pair<std::vector<size_t>, std::shared_ptr<arrow::Table>>>
+      tables_;
+};
+
+}  // namespace vineyard
+
+#endif  // MODULES_IO_IO_PIPELINE_H_
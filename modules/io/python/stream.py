@@ -127,8 +127,33 @@ def parallel_dataframe_parser(client, byte_stream, num_workers=4, **kwargs):
     return client.get_object(ObjectID(r))
 
 
-def parallel_local_dataframe(client, path, **kwargs):
-    return parallel_dataframe_parser(client, parallel_local_byte(client, path, **kwargs), **kwargs)
+def parallel_local_dataframe(client, path, num_workers=4, **kwargs):
+    ''' Read and parse local files in process, without the byte stream in between.
+    '''
+    launcher = ParallelStreamLauncher(num_workers)
+    launcher.run(get_executable('parallel_local_dataframe'), client.ipc_socket, path, **kwargs)
+    r = launcher.wait()
+    return client.get_object(ObjectID(r))
+
+
+def parallel_columnar_dataframe(client, path, num_workers=4, **kwargs):
+    ''' Read the row groups (or stripes, record batches) of a Parquet (or ORC, Arrow IPC)
+        file in parallel.
+    '''
+    launcher = ParallelStreamLauncher(num_workers)
+    launcher.run(get_executable('parallel_columnar_dataframe'), client.ipc_socket, path, **kwargs)
+    r = launcher.wait()
+    return client.get_object(ObjectID(r))
+
+
+def parallel_kafka_dataframe(client, path, num_workers=4, **kwargs):
+    ''' Read the messages of a kafka topic as record batches, every worker consumes a disjoint
+        set of partitions.
+    '''
+    launcher = ParallelStreamLauncher(num_workers)
+    launcher.run(get_executable('parallel_kafka_dataframe'), client.ipc_socket, path, **kwargs)
+    r = launcher.wait()
+    return client.get_object(ObjectID(r))
 
 
 def single_dataframe_dataframe(client, path, **kwargs):
@@ -141,6 +166,11 @@ def single_dataframe_dataframe(client, path, **kwargs):
 
 vineyard.read.register('single', 'vineyard', single_dataframe_dataframe)
 vineyard.read.register('parallel', 'file', parallel_local_dataframe)
+vineyard.read.register('parallel', 'parquet', parallel_columnar_dataframe)
+vineyard.read.register('parallel', 'orc', parallel_columnar_dataframe)
+vineyard.read.register('parallel', 'arrow', parallel_columnar_dataframe)
+vineyard.read.register('parallel', 'feather', parallel_columnar_dataframe)
+vineyard.read.register('parallel', 'kafka', parallel_kafka_dataframe)
 vineyard.read.register('single', 'file', single_local_byte)
 vineyard.read.register('single', 'file', single_local_dataframe)
 vineyard.read.register('single', 'oss', single_oss_dataframe)
@@ -157,6 +187,10 @@ def parallel_write_file(client, ofile, stream):
     write_file(client, 'parallel_dataframe_single_local_consumer', ofile, stream)
 
 
+def parallel_write_columnar_file(client, ofile, stream):
+    write_file(client, 'parallel_dataframe_single_columnar_consumer', ofile, stream)
+
+
 def single_write_file(client, ofile, stream):
     write_file(client, 'single_dataframe_single_local_consumer', ofile, stream)
 
@@ -166,5 +200,8 @@ def single_write_kafka(client, path, stream):
 
 
 vineyard.write.register('parallel', 'file', parallel_write_file)
+vineyard.write.register('parallel', 'arrow', parallel_write_columnar_file)
+vineyard.write.register('parallel', 'feather', parallel_write_columnar_file)
+vineyard.write.register('parallel', 'parquet', parallel_write_columnar_file)
 vineyard.write.register('single', 'file', single_write_file)
 vineyard.write.register('single', 'kafka', single_write_kafka)
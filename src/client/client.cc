@@ -192,6 +192,102 @@ Status Client::PullNextStreamChunk(ObjectID const id,
   return Status::OK();
 }
 
+namespace detail {
+
+/**
+ * @brief A stream chunk retained by the client, which will be released back to
+ * vineyard when destructed.
+ */
+class RetainedStreamChunk : public arrow::Buffer {
+ public:
+  RetainedStreamChunk(Client& client, Client& releaser,
+                      ObjectID const stream_id, ObjectID const chunk_id,
+                      const uint8_t* data, const int64_t size)
+      : arrow::Buffer(data, size),
+        client_(client),
+        releaser_(releaser),
+        stream_id_(stream_id),
+        chunk_id_(chunk_id) {}
+
+  ~RetainedStreamChunk() override {
+    if (!adopted_) {
+      VINEYARD_SUPPRESS(releaser_.ReleaseStreamChunk(stream_id_, chunk_id_));
+    }
+  }
+
+  Client& client() const { return client_; }
+
+  ObjectID stream_id() const { return stream_id_; }
+
+  ObjectID chunk_id() const { return chunk_id_; }
+
+  bool adopted() const { return adopted_; }
+
+  void set_adopted() { adopted_ = true; }
+
+ private:
+  Client& client_;
+  Client& releaser_;
+  ObjectID stream_id_;
+  ObjectID chunk_id_;
+  bool adopted_ = false;
+};
+
+}  // namespace detail
+
+Status Client::PullNextStreamChunk(ObjectID const id,
+                                   std::shared_ptr<arrow::Buffer>& blob) {
+  ENSURE_CONNECTED(this);
+  std::string message_out;
+  WritePullNextStreamChunkRequest(id, true, message_out);
+  RETURN_ON_ERROR(doWrite(message_out));
+  ptree message_in;
+  RETURN_ON_ERROR(doRead(message_in));
+  Payload object;
+  RETURN_ON_ERROR(ReadPullNextStreamChunkReply(message_in, object));
+  uint8_t* mmapped_ptr = nullptr;
+  RETURN_ON_ERROR(
+      mmapToClient(object.store_fd, object.map_size, true, &mmapped_ptr));
+  blob = std::make_shared<detail::RetainedStreamChunk>(
+      *this, releaser_ == nullptr ? *this : *releaser_, id, object.object_id,
+      mmapped_ptr + object.data_offset, object.data_size);
+  return Status::OK();
+}
+
+Status Client::ReleaseStreamChunk(ObjectID const id, ObjectID const chunk) {
+  ENSURE_CONNECTED(this);
+  std::string message_out;
+  WriteReleaseStreamChunkRequest(id, chunk, true, message_out);
+  RETURN_ON_ERROR(doWrite(message_out));
+  ptree message_in;
+  RETURN_ON_ERROR(doRead(message_in));
+  RETURN_ON_ERROR(ReadReleaseStreamChunkReply(message_in));
+  return Status::OK();
+}
+
+Status Client::AdoptStreamChunk(std::shared_ptr<arrow::Buffer> const& chunk,
+                                std::unique_ptr<BlobWriter>& blob) {
+  ENSURE_CONNECTED(this);
+  auto retained = std::dynamic_pointer_cast<detail::RetainedStreamChunk>(chunk);
+  if (retained == nullptr || &retained->client() != this ||
+      retained->adopted()) {
+    return Status::Invalid("The buffer is not a chunk retained by the client");
+  }
+  std::string message_out;
+  WriteReleaseStreamChunkRequest(retained->stream_id(), retained->chunk_id(),
+                                 false, message_out);
+  RETURN_ON_ERROR(doWrite(message_out));
+  ptree message_in;
+  RETURN_ON_ERROR(doRead(message_in));
+  RETURN_ON_ERROR(ReadReleaseStreamChunkReply(message_in));
+  retained->set_adopted();
+  blob.reset(new BlobWriter(
+      retained->chunk_id(),
+      std::make_shared<arrow::MutableBuffer>(
+          const_cast<uint8_t*>(retained->data()), retained->size())));
+  return Status::OK();
+}
+
 Status Client::StopStream(ObjectID const id, const bool failed) {
   ENSURE_CONNECTED(this);
   std::string message_out;
@@ -230,6 +230,63 @@ class Client : public ClientBase {
   Status PullNextStreamChunk(ObjectID const id,
                              std::unique_ptr<arrow::Buffer>& blob);
 
+  /**
+   * @brief Poll a chunk from a stream, the same as the method above, except
+   * that the chunk won't be dropped by the next pull, but stays alive until
+   * the returned buffer is destructed. Buffers that reference the chunk, e.g.,
+   * arrays deserialized from it, can be used without copying.
+   *
+   * Note that retained chunks still count towards the memory threshold of
+   * streams, and the client (as well as the releaser, see
+   * `SetStreamChunkReleaser`) must outlive the returned buffer.
+   *
+   * @param id The id of the stream.
+   * @param blob The immutable chunk generated by the writer of the stream.
+   *
+   * @return Status that indicates whether the polling has succeeded.
+   */
+  Status PullNextStreamChunk(ObjectID const id,
+                             std::shared_ptr<arrow::Buffer>& blob);
+
+  /**
+   * @brief Release a chunk retained by the `PullNextStreamChunk` above. It is
+   * invoked when the retained buffer is destructed.
+   *
+   * @param id The id of the stream.
+   * @param chunk The id of the retained chunk.
+   *
+   * @return Status that indicates whether the request has succeeded.
+   */
+  Status ReleaseStreamChunk(ObjectID const id, ObjectID const chunk);
+
+  /**
+   * @brief Release the chunks retained by the following pulls of this client
+   * through another connection to the same vineyard server.
+   *
+   * A pull holds the connection until the writer of the stream produces the
+   * next chunk, thus releasing a chunk through the pulling connection waits
+   * for the writer, which may in turn wait for the released memory.
+   *
+   * @param releaser The client that sends the release requests, or nullptr to
+   * release the chunks through this client.
+   */
+  void SetStreamChunkReleaser(Client* releaser) { releaser_ = releaser; }
+
+  /**
+   * @brief Take the ownership of a chunk retained by the `PullNextStreamChunk`
+   * above, as a blob, rather than releasing it. The chunk won't be deleted by
+   * the stream, and the returned blob writer is expected to be sealed, then the
+   * chunk will be deleted as a member blob of some object.
+   *
+   * @param chunk The chunk retained by this client.
+   * @param blob The blob writer that holds the chunk.
+   *
+   * @return Status::Invalid() if the buffer is not a chunk retained by this
+   * client, or has already been adopted.
+   */
+  Status AdoptStreamChunk(std::shared_ptr<arrow::Buffer> const& chunk,
+                          std::unique_ptr<BlobWriter>& blob);
+
   /**
    * @brief Stop a stream, mark it as finished or aborted.
    *
@@ -348,6 +405,9 @@ class Client : public ClientBase {
 
   std::unordered_map<int, std::unique_ptr<MmapEntry>> mmap_table_;
 
+  // the client that releases the retained chunks, if not this client.
+  Client* releaser_ = nullptr;
+
   friend class Blob;
   friend class BlobWriter;
 };
@@ -75,6 +75,8 @@ CommandType ParseCommandType(const std::string& str_type) {
     return CommandType::PullNextStreamChunkRequest;
   } else if (str_type == "stop_stream_request") {
     return CommandType::StopStreamRequest;
+  } else if (str_type == "release_stream_chunk_request") {
+    return CommandType::ReleaseStreamChunkRequest;
   } else if (str_type == "put_name_request") {
     return CommandType::PutNameRequest;
   } else if (str_type == "get_name_request") {
@@ -688,17 +690,31 @@ Status ReadGetNextStreamChunkReply(const ptree& root, Payload& object) {
 
 void WritePullNextStreamChunkRequest(const ObjectID stream_id,
                                      std::string& msg) {
+  WritePullNextStreamChunkRequest(stream_id, false, msg);
+}
+
+void WritePullNextStreamChunkRequest(const ObjectID stream_id,
+                                     const bool retain, std::string& msg) {
   ptree root;
   root.put("type", "pull_next_stream_chunk_request");
   root.put("id", stream_id);
+  root.put("retain", retain);
 
   encode_msg(root, msg);
 }
 
 Status ReadPullNextStreamChunkRequest(const ptree& root, ObjectID& stream_id) {
+  bool retain;
+  return ReadPullNextStreamChunkRequest(root, stream_id, retain);
+}
+
+Status ReadPullNextStreamChunkRequest(const ptree& root, ObjectID& stream_id,
+                                      bool& retain) {
   RETURN_ON_ASSERT(root.get<std::string>("type") ==
                    "pull_next_stream_chunk_request");
   stream_id = root.get<ObjectID>("id");
+  // the "retain" field is absent in requests from older clients.
+  retain = root.get<bool>("retain", false);
   return Status::OK();
 }
 
@@ -749,6 +765,40 @@ Status ReadStopStreamReply(const ptree& root) {
   return Status::OK();
 }
 
+void WriteReleaseStreamChunkRequest(const ObjectID stream_id,
+                                    const ObjectID chunk_id, const bool drop,
+                                    std::string& msg) {
+  ptree root;
+  root.put("type", "release_stream_chunk_request");
+  root.put("id", stream_id);
+  root.put("chunk", chunk_id);
+  root.put("drop", drop);
+
+  encode_msg(root, msg);
+}
+
+Status ReadReleaseStreamChunkRequest(const ptree& root, ObjectID& stream_id,
+                                     ObjectID& chunk_id, bool& drop) {
+  RETURN_ON_ASSERT(root.get<std::string>("type") ==
+                   "release_stream_chunk_request");
+  stream_id = root.get<ObjectID>("id");
+  chunk_id = root.get<ObjectID>("chunk");
+  drop = root.get<bool>("drop", true);
+  return Status::OK();
+}
+
+void WriteReleaseStreamChunkReply(std::string& msg) {
+  ptree root;
+  root.put("type", "release_stream_chunk_reply");
+
+  encode_msg(root, msg);
+}
+
+Status ReadReleaseStreamChunkReply(const ptree& root) {
+  CHECK_IPC_ERROR(root, "release_stream_chunk_reply");
+  return Status::OK();
+}
+
 void WriteShallowCopyRequest(const ObjectID id, std::string& msg) {
   ptree root;
   root.put("type", "shallow_copy_request");
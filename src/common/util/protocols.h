@@ -52,6 +52,7 @@ enum class CommandType {
   GetNextStreamChunkRequest = 20,
   PullNextStreamChunkRequest = 21,
   StopStreamRequest = 22,
+  ReleaseStreamChunkRequest = 23,
   IfPersistRequest = 25,
   InstanceStatusRequest = 26,
   ShallowCopyRequest = 27,
@@ -230,8 +231,14 @@ Status ReadGetNextStreamChunkReply(const ptree& root, Payload& object);
 void WritePullNextStreamChunkRequest(const ObjectID stream_id,
                                      std::string& msg);
 
+void WritePullNextStreamChunkRequest(const ObjectID stream_id,
+                                     const bool retain, std::string& msg);
+
 Status ReadPullNextStreamChunkRequest(const ptree& root, ObjectID& stream_id);
 
+Status ReadPullNextStreamChunkRequest(const ptree& root, ObjectID& stream_id,
+                                      bool& retain);
+
 void WritePullNextStreamChunkReply(std::shared_ptr<Payload>& object,
                                    std::string& msg);
 
@@ -247,6 +254,17 @@ void WriteStopStreamReply(std::string& msg);
 
 Status ReadStopStreamReply(const ptree& root);
 
+void WriteReleaseStreamChunkRequest(const ObjectID stream_id,
+                                    const ObjectID chunk_id, const bool drop,
+                                    std::string& msg);
+
+Status ReadReleaseStreamChunkRequest(const ptree& root, ObjectID& stream_id,
+                                     ObjectID& chunk_id, bool& drop);
+
+void WriteReleaseStreamChunkReply(std::string& msg);
+
+Status ReadReleaseStreamChunkReply(const ptree& root);
+
 void WriteShallowCopyRequest(const ObjectID id, std::string& msg);
 
 Status ReadShallowCopyRequest(const ptree& root, ObjectID& id);
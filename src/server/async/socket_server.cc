@@ -365,10 +365,11 @@ bool SocketConnection::processMessage(const std::string& message_in) {
   } break;
   case CommandType::PullNextStreamChunkRequest: {
     ObjectID stream_id;
-    TRY_READ_REQUEST(ReadPullNextStreamChunkRequest(root, stream_id));
+    bool retain;
+    TRY_READ_REQUEST(ReadPullNextStreamChunkRequest(root, stream_id, retain));
     this->associated_streams_.emplace(stream_id);
     RESPONSE_ON_ERROR(server_ptr_->GetStreamStore()->Pull(
-        stream_id, [self](const Status& status, const ObjectID chunk) {
+        stream_id, retain, [self](const Status& status, const ObjectID chunk) {
           std::string message_out;
           if (status.ok()) {
             std::shared_ptr<Payload> object;
@@ -403,6 +404,17 @@ bool SocketConnection::processMessage(const std::string& message_in) {
     WriteStopStreamReply(message_out);
     this->doWrite(message_out);
   } break;
+  case CommandType::ReleaseStreamChunkRequest: {
+    ObjectID stream_id, chunk_id;
+    bool drop;
+    TRY_READ_REQUEST(
+        ReadReleaseStreamChunkRequest(root, stream_id, chunk_id, drop));
+    RESPONSE_ON_ERROR(
+        server_ptr_->GetStreamStore()->Release(stream_id, chunk_id, drop));
+    std::string message_out;
+    WriteReleaseStreamChunkReply(message_out);
+    this->doWrite(message_out);
+  } break;
   case CommandType::PutNameRequest: {
     ObjectID object_id;
     std::string name;
@@ -98,6 +98,11 @@ Status StreamStore::Get(ObjectID const stream_id, size_t const size,
 // for consumer: read current chunk
 Status StreamStore::Pull(ObjectID const stream_id,
                          callback_t<const ObjectID> callback) {
+  return Pull(stream_id, false, callback);
+}
+
+Status StreamStore::Pull(ObjectID const stream_id, bool const retain,
+                         callback_t<const ObjectID> callback) {
   if (streams_.find(stream_id) == streams_.end()) {
     return callback(Status::ObjectNotExists(), InvalidObjectID());
   }
@@ -106,11 +111,15 @@ Status StreamStore::Pull(ObjectID const stream_id,
   // precondition: there's no unsatistified reader
   CHECK_STREAM_STATE(!stream->reader_);
 
-  // drop current reading
+  // drop current reading, unless it is retained by the consumer
   if (stream->current_reading_) {
-    auto status = store_->ProcessDeleteRequest(stream->current_reading_.get());
-    if (!status.ok()) {
-      return callback(status, InvalidObjectID());
+    auto chunk = stream->current_reading_.get();
+    if (stream->retained_chunks_.find(chunk) ==
+        stream->retained_chunks_.end()) {
+      auto status = store_->ProcessDeleteRequest(chunk);
+      if (!status.ok()) {
+        return callback(status, InvalidObjectID());
+      }
     }
     stream->current_reading_ = boost::none;
   }
@@ -118,25 +127,15 @@ Status StreamStore::Pull(ObjectID const stream_id,
   if (stream->writer_) {
     // should be no writing chunk
     CHECK_STREAM_STATE(!stream->current_writing_);
-    auto writer = stream->writer_.get();
-    if (allocatable(stream, writer.first)) {
-      ObjectID chunk;
-      std::shared_ptr<Payload> object;
-      auto status = store_->ProcessCreateRequest(writer.first, chunk, object);
-      if (!status.ok()) {
-        VINEYARD_SUPPRESS(writer.second(status, InvalidObjectID()));
-      } else {
-        stream->current_writing_ = chunk;
-        VINEYARD_SUPPRESS(
-            writer.second(Status::OK(), stream->current_writing_.get()));
-        stream->writer_ = boost::none;
-      }
-    }
+    wakeupWriter(stream);
   }
 
   if (!stream->ready_chunks_.empty()) {
     stream->current_reading_ = stream->ready_chunks_.front();
     stream->ready_chunks_.pop();
+    if (retain) {
+      stream->retained_chunks_.emplace(stream->current_reading_.get());
+    }
     return callback(Status::OK(), stream->current_reading_.get());
   } else {
     // if stream has been stoped, return a proper status.
@@ -146,12 +145,47 @@ Status StreamStore::Pull(ObjectID const stream_id,
       return callback(Status::StreamFailed(), InvalidObjectID());
     } else {
       // pending the reader
-      stream->reader_ = callback;
+      if (retain) {
+        // n.b.: capture the raw pointer to avoid a reference cycle.
+        StreamHolder* holder = stream.get();
+        stream->reader_ = [holder, callback](const Status& status,
+                                             const ObjectID chunk) {
+          if (status.ok()) {
+            holder->retained_chunks_.emplace(chunk);
+          }
+          return callback(status, chunk);
+        };
+      } else {
+        stream->reader_ = callback;
+      }
       return Status::OK();
     }
   }
 }
 
+Status StreamStore::Release(ObjectID const stream_id, ObjectID const chunk,
+                            bool const drop) {
+  if (streams_.find(stream_id) == streams_.end()) {
+    return Status::ObjectNotExists();
+  }
+  auto stream = streams_.at(stream_id);
+  if (stream->retained_chunks_.erase(chunk) == 0) {
+    return Status::InvalidStreamState("The chunk is not retained");
+  }
+  if (stream->current_reading_ && stream->current_reading_.get() == chunk) {
+    stream->current_reading_ = boost::none;
+  }
+  if (!drop) {
+    return Status::OK();
+  }
+  RETURN_ON_ERROR(store_->ProcessDeleteRequest(chunk));
+  // the released memory may satisfy the pending writer
+  if (stream->writer_ && !stream->current_writing_) {
+    wakeupWriter(stream);
+  }
+  return Status::OK();
+}
+
 Status StreamStore::Stop(ObjectID const stream_id, bool failed) {
   if (streams_.find(stream_id) == streams_.end()) {
     return Status::ObjectNotExists();
@@ -161,9 +195,15 @@ Status StreamStore::Stop(ObjectID const stream_id, bool failed) {
   if (stream->drained || stream->failed) {
     return Status::InvalidStreamState("Stream already stoped");
   }
-  // no pending writer
+  // no pending writer, unless the stream is failed (e.g., cancelled by the
+  // reader), which fails the pending writer as well.
   if (stream->writer_) {
-    return Status::InvalidStreamState("Still pending writer on stream");
+    if (!failed) {
+      return Status::InvalidStreamState("Still pending writer on stream");
+    }
+    auto writer = stream->writer_.get();
+    stream->writer_ = boost::none;
+    VINEYARD_SUPPRESS(writer.second(Status::StreamFailed(), InvalidObjectID()));
   }
   // seal current writing chunk
   if (stream->current_writing_) {
@@ -230,9 +270,33 @@ Status StreamStore::Drop(ObjectID const stream_id) {
         store_->ProcessDeleteRequest(stream->ready_chunks_.front()));
     stream->ready_chunks_.pop();
   }
+  // drop the retained chunks as well, except the reading one
+  for (auto chunk : stream->retained_chunks_) {
+    if (!stream->current_reading_ || stream->current_reading_.get() != chunk) {
+      RETURN_ON_ERROR(store_->ProcessDeleteRequest(chunk));
+    }
+  }
+  stream->retained_chunks_.clear();
   return Status::OK();
 }
 
+void StreamStore::wakeupWriter(std::shared_ptr<StreamHolder> stream) {
+  auto writer = stream->writer_.get();
+  if (allocatable(stream, writer.first)) {
+    ObjectID chunk;
+    std::shared_ptr<Payload> object;
+    auto status = store_->ProcessCreateRequest(writer.first, chunk, object);
+    if (!status.ok()) {
+      VINEYARD_SUPPRESS(writer.second(status, InvalidObjectID()));
+    } else {
+      stream->current_writing_ = chunk;
+      VINEYARD_SUPPRESS(
+          writer.second(Status::OK(), stream->current_writing_.get()));
+      stream->writer_ = boost::none;
+    }
+  }
+}
+
 bool StreamStore::allocatable(std::shared_ptr<StreamHolder> stream,
                               size_t size) {
   if (store_->Footprint() + size <
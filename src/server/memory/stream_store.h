@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <memory>
 #include <queue>
+#include <set>
 #include <unordered_map>
 #include <utility>
 
@@ -36,6 +37,9 @@ namespace vineyard {
 struct StreamHolder {
   boost::optional<ObjectID> current_writing_, current_reading_;
   std::queue<ObjectID> ready_chunks_;
+  // chunks pulled with "retain", which won't be dropped by the next pull but
+  // until the consumer releases them.
+  std::set<ObjectID> retained_chunks_;
   boost::optional<callback_t<ObjectID>> reader_;
   boost::optional<std::pair<size_t, callback_t<ObjectID>>> writer_;
   bool drained{false}, failed{false};
@@ -67,6 +71,25 @@ class StreamStore {
    */
   Status Pull(ObjectID const stream_id, callback_t<const ObjectID> callback);
 
+  /**
+   * @brief The same as the Pull above, but when `retain` is true the returned
+   * chunk stays alive after the next pull, until it is released by the
+   * consumer, that allows the consumer to reference the chunk without copying.
+   *
+   */
+  Status Pull(ObjectID const stream_id, bool const retain,
+              callback_t<const ObjectID> callback);
+
+  /**
+   * @brief The consumer invokes this function to release a retained chunk.
+   * When `drop` is false the chunk is detached from the stream rather than
+   * being deleted, i.e., the consumer takes the ownership of the chunk, and
+   * is responsible for deleting it, e.g., as a blob.
+   *
+   */
+  Status Release(ObjectID const stream_id, ObjectID const chunk,
+                 bool const drop = true);
+
   /**
    * @brief Function stop is called by the vineyard clients.
    *
@@ -83,6 +106,8 @@ class StreamStore {
  private:
   bool allocatable(std::shared_ptr<StreamHolder> stream, size_t size);
 
+  void wakeupWriter(std::shared_ptr<StreamHolder> stream);
+
   std::shared_ptr<BulkStore> store_;
   size_t threshold_;
   std::unordered_map<ObjectID, std::shared_ptr<StreamHolder>> streams_;
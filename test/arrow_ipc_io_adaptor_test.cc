@@ -0,0 +1,102 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arrow/api.h"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+#include "io/io/arrow_ipc_io_adaptor.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+constexpr int64_t batch_num = 16;
+constexpr int64_t batch_rows = 1000;
+constexpr int part_num = 3;
+
+std::shared_ptr<arrow::Table> MakeTable() {
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  auto schema = arrow::schema({arrow::field("id", arrow::int64()),
+                               arrow::field("value", arrow::float64())});
+  for (int64_t b = 0; b < batch_num; ++b) {
+    arrow::Int64Builder id_builder;
+    arrow::DoubleBuilder value_builder;
+    for (int64_t idx = b * batch_rows; idx < (b + 1) * batch_rows; ++idx) {
+      CHECK_ARROW_ERROR(id_builder.Append(idx));
+      CHECK_ARROW_ERROR(value_builder.Append(idx * 0.5));
+    }
+    std::shared_ptr<arrow::Array> ids, values;
+    CHECK_ARROW_ERROR(id_builder.Finish(&ids));
+    CHECK_ARROW_ERROR(value_builder.Finish(&values));
+    batches.emplace_back(
+        arrow::RecordBatch::Make(schema, batch_rows, {ids, values}));
+  }
+  std::shared_ptr<arrow::Table> table;
+  VINEYARD_CHECK_OK(RecordBatchesToTable(batches, &table));
+  return table;
+}
+
+void TestRoundTrip(std::shared_ptr<arrow::Table> const& table,
+                   std::string const& location) {
+  {
+    ArrowIPCIOAdaptor writer(location);
+    VINEYARD_CHECK_OK(writer.Open("w"));
+    VINEYARD_CHECK_OK(writer.WriteTable(table));
+    VINEYARD_CHECK_OK(writer.WriteTable(table));
+    VINEYARD_CHECK_OK(writer.Close());
+  }
+
+  int64_t rows = 0, sum = 0;
+  for (int index = 0; index < part_num; ++index) {
+    ArrowIPCIOAdaptor reader(location);
+    VINEYARD_CHECK_OK(reader.SetPartialRead(index, part_num));
+    VINEYARD_CHECK_OK(reader.Open());
+    VINEYARD_CHECK_OK(
+        reader.ReadTables([&](std::shared_ptr<arrow::Table> const& piece) {
+          CHECK(piece->schema()->Equals(*table->schema()));
+          auto ids = std::dynamic_pointer_cast<arrow::Int64Array>(
+              piece->column(0)->chunk(0));
+          for (int64_t idx = 0; idx < ids->length(); ++idx) {
+            sum += ids->Value(idx);
+          }
+          rows += piece->num_rows();
+          return Status::OK();
+        }));
+    VINEYARD_CHECK_OK(reader.Close());
+  }
+  int64_t total = batch_num * batch_rows;
+  CHECK_EQ(rows, 2 * total);
+  CHECK_EQ(sum, total * (total - 1));
+
+  LOG(INFO) << "Passed round trip tests with " << location;
+}
+
+int main(int argc, char** argv) {
+  auto table = MakeTable();
+
+  TestRoundTrip(table, "/tmp/arrow_ipc_io_adaptor_test.arrow");
+  TestRoundTrip(table, "/tmp/arrow_ipc_io_adaptor_test.arrows");
+  TestRoundTrip(table,
+                "/tmp/arrow_ipc_io_adaptor_test.feather#compression=lz4");
+  TestRoundTrip(table,
+                "/tmp/arrow_ipc_io_adaptor_test.arrows#compression=zstd");
+
+  LOG(INFO) << "Passed arrow ipc io adaptor tests...";
+
+  return 0;
+}
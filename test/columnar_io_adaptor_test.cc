@@ -0,0 +1,215 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/io/api.h"
+#include "glog/logging.h"
+
+#ifdef ORC_ENABLED
+#include "arrow/adapters/orc/adapter.h"
+#endif
+
+#include "basic/ds/arrow_utils.h"
+#include "io/io/columnar_io_adaptor.h"
+
+#if defined(PARQUET_ENABLED) || defined(ORC_ENABLED)
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+constexpr int64_t row_num = 10000;
+constexpr int part_num = 3;
+
+std::shared_ptr<arrow::Table> MakeTable() {
+  arrow::Int64Builder id_builder;
+  arrow::DoubleBuilder value_builder;
+  for (int64_t idx = 0; idx < row_num; ++idx) {
+    CHECK_ARROW_ERROR(id_builder.Append(idx));
+    CHECK_ARROW_ERROR(value_builder.Append(idx * 0.5));
+  }
+  std::shared_ptr<arrow::Array> ids, values;
+  CHECK_ARROW_ERROR(id_builder.Finish(&ids));
+  CHECK_ARROW_ERROR(value_builder.Finish(&values));
+  auto schema = arrow::schema({arrow::field("id", arrow::int64()),
+                               arrow::field("value", arrow::float64())});
+  return arrow::Table::Make(schema, {ids, values});
+}
+
+int64_t SumOfIds(std::shared_ptr<arrow::Table> const& table) {
+  int64_t sum = 0;
+  VINEYARD_CHECK_OK(IterateChunkedArray<arrow::Int64Array>(
+      table->GetColumnByName("id"),
+      [&](int64_t value, size_t) { sum += value; }));
+  return sum;
+}
+
+// the whole file is read back as it was, and the parts cover every row once
+void TestRead(std::string const& location,
+              std::shared_ptr<arrow::Table> const& expected) {
+  {
+    ColumnarIOAdaptor adaptor(location);
+    VINEYARD_CHECK_OK(adaptor.Open());
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(adaptor.ReadTable(&table));
+    CHECK(table != nullptr);
+    CHECK(table->schema()->Equals(*expected->schema(), false));
+    CHECK_EQ(table->num_rows(), row_num);
+    for (int col = 0; col < table->num_columns(); ++col) {
+      CHECK(table->column(col)->Equals(expected->column(col)));
+    }
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+
+  int64_t rows = 0, sum = 0;
+  for (int index = 0; index < part_num; ++index) {
+    ColumnarIOAdaptor adaptor(location + "#columns=id");
+    VINEYARD_CHECK_OK(adaptor.SetPartialRead(index, part_num));
+    VINEYARD_CHECK_OK(adaptor.Open());
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(adaptor.ReadTable(&table));
+    if (table != nullptr) {
+      CHECK_EQ(table->num_columns(), 1);
+      rows += table->num_rows();
+      sum += SumOfIds(table);
+    }
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+  CHECK_EQ(rows, row_num);
+  CHECK_EQ(sum, row_num * (row_num - 1) / 2);
+
+  LOG(INFO) << "Passed columnar read tests with " << location;
+}
+
+#ifdef PARQUET_ENABLED
+void TestParquet(std::shared_ptr<arrow::Table> const& table) {
+  std::string path = "/tmp/columnar_io_adaptor_test.parquet";
+  {
+    ColumnarIOAdaptor adaptor(path);
+    VINEYARD_CHECK_OK(adaptor.Configure("row_group_size", "1000"));
+    VINEYARD_CHECK_OK(adaptor.Open("w"));
+    VINEYARD_CHECK_OK(adaptor.WriteTable(table));
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+  TestRead(path, table);
+  TestRead("parquet://" + path, table);
+
+  // the row groups of ids in [0, 1000) and [9000, 10000) are kept only
+  ColumnarIOAdaptor adaptor(path + "#filter=id<1000&filter=id!=5000");
+  VINEYARD_CHECK_OK(adaptor.Open());
+  CHECK_EQ(adaptor.units().size(), 1);
+  std::shared_ptr<arrow::Table> pruned;
+  VINEYARD_CHECK_OK(adaptor.ReadTable(&pruned));
+  CHECK_EQ(pruned->num_rows(), 1000);
+  CHECK_EQ(SumOfIds(pruned), 1000 * 999 / 2);
+  VINEYARD_CHECK_OK(adaptor.Close());
+
+  LOG(INFO) << "Passed parquet round-trip tests";
+}
+
+// the statistics of unsigned columns are stored as signed physical values,
+// thus the values above INT64_MAX look negative and must not be pruned
+void TestParquetUnsigned() {
+  std::string path = "/tmp/columnar_io_adaptor_test_unsigned.parquet";
+  {
+    arrow::UInt64Builder builder;
+    for (int64_t idx = 0; idx < row_num; ++idx) {
+      CHECK_ARROW_ERROR(builder.Append((uint64_t(1) << 63) + idx));
+    }
+    std::shared_ptr<arrow::Array> values;
+    CHECK_ARROW_ERROR(builder.Finish(&values));
+    auto table = arrow::Table::Make(
+        arrow::schema({arrow::field("value", arrow::uint64())}), {values});
+
+    ColumnarIOAdaptor adaptor(path);
+    VINEYARD_CHECK_OK(adaptor.Configure("row_group_size", "1000"));
+    VINEYARD_CHECK_OK(adaptor.Open("w"));
+    VINEYARD_CHECK_OK(adaptor.WriteTable(table));
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+
+  ColumnarIOAdaptor adaptor(path + "#filter=value>1");
+  VINEYARD_CHECK_OK(adaptor.Open());
+  CHECK_EQ(adaptor.units().size(), row_num / 1000);
+  std::shared_ptr<arrow::Table> table;
+  VINEYARD_CHECK_OK(adaptor.ReadTable(&table));
+  CHECK_EQ(table->num_rows(), row_num);
+  VINEYARD_CHECK_OK(adaptor.Close());
+
+  LOG(INFO) << "Passed parquet unsigned pruning tests";
+}
+#endif  // PARQUET_ENABLED
+
+#ifdef ORC_ENABLED
+void TestORC(std::shared_ptr<arrow::Table> const& table) {
+  std::string path = "/tmp/columnar_io_adaptor_test.orc";
+  // the adaptor doesn't write ORC files, thus writes by arrow
+#if defined(ARROW_VERSION) && ARROW_VERSION < 4000000
+  LOG(INFO) << "Skipped orc round-trip tests, requires arrow >= 4.0";
+  return;
+#else
+  {
+    std::shared_ptr<arrow::io::FileOutputStream> output;
+    CHECK_ARROW_ERROR_AND_ASSIGN(output,
+                                 arrow::io::FileOutputStream::Open(path));
+    std::unique_ptr<arrow::adapters::orc::ORCFileWriter> writer;
+    CHECK_ARROW_ERROR_AND_ASSIGN(
+        writer, arrow::adapters::orc::ORCFileWriter::Open(output.get()));
+    CHECK_ARROW_ERROR(writer->Write(*table));
+    CHECK_ARROW_ERROR(writer->Close());
+    CHECK_ARROW_ERROR(output->Close());
+  }
+  TestRead(path, table);
+  TestRead("orc://" + path, table);
+
+  // writing ORC files is not supported by the adaptor
+  ColumnarIOAdaptor adaptor(path);
+  CHECK(adaptor.Open("w").IsNotImplemented());
+
+  LOG(INFO) << "Passed orc round-trip tests";
+#endif
+}
+#endif  // ORC_ENABLED
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage ./columnar_io_adaptor_test <ipc_socket>");
+    return 1;
+  }
+
+  auto table = MakeTable();
+#ifdef PARQUET_ENABLED
+  TestParquet(table);
+  TestParquetUnsigned();
+#endif
+#ifdef ORC_ENABLED
+  TestORC(table);
+#endif
+
+  LOG(INFO) << "Passed columnar io adaptor tests...";
+  return 0;
+}
+
+#else
+
+int main(int argc, char** argv) {
+  LOG(INFO) << "Skipped columnar io adaptor tests, parquet and orc are not "
+               "enabled";
+  return 0;
+}
+
+#endif  // PARQUET_ENABLED || ORC_ENABLED
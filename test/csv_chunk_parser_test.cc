@@ -0,0 +1,238 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/status.h"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+#include "io/io/csv_chunk_parser.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+// split the content into chunks of the given sizes, the last one takes the
+// rest.
+std::vector<std::shared_ptr<arrow::Buffer>> MakeChunks(
+    std::string const& content, std::vector<size_t> const& sizes) {
+  std::vector<std::shared_ptr<arrow::Buffer>> chunks;
+  size_t offset = 0;
+  for (size_t size : sizes) {
+    chunks.emplace_back(
+        arrow::Buffer::FromString(content.substr(offset, size)));
+    offset += size;
+  }
+  chunks.emplace_back(arrow::Buffer::FromString(content.substr(offset)));
+  return chunks;
+}
+
+void TestLineSplitter() {
+  std::string content = "1,a\n22,bb\n333,ccc\n4444,dddd\n55555,eeeee";
+  // a line spans three chunks, a chunk has no line break, and a chunk ends
+  // right after a line break.
+  auto chunks = MakeChunks(content, {6, 3, 2, 8, 10});
+
+  CSVLineSplitter splitter;
+  std::string joined;
+  std::vector<std::string> pieces;
+  auto collect = [&](std::shared_ptr<arrow::Buffer> const& piece) {
+    pieces.emplace_back(piece->ToString());
+    joined.append(piece->ToString());
+    return Status::OK();
+  };
+  for (auto const& chunk : chunks) {
+    VINEYARD_CHECK_OK(splitter.Feed(chunk, collect));
+  }
+  // all but the last piece consist of complete lines
+  for (auto const& piece : pieces) {
+    CHECK(!piece.empty() && piece.back() == '\n');
+  }
+  VINEYARD_CHECK_OK(splitter.Flush(collect));
+  CHECK_EQ(pieces.back(), "55555,eeeee");
+  CHECK_EQ(joined, content);
+
+  // the lines within a chunk are sliced, rather than copied
+  CSVLineSplitter slicer;
+  auto chunk = arrow::Buffer::FromString("1,a\n2,b\n3,");
+  VINEYARD_CHECK_OK(
+      slicer.Feed(chunk, [&](std::shared_ptr<arrow::Buffer> const& piece) {
+        CHECK_EQ(piece->data(), chunk->data());
+        CHECK_EQ(piece->size(), 8);
+        return Status::OK();
+      }));
+
+  LOG(INFO) << "Passed csv line splitter tests";
+}
+
+void TestTypePromotion() {
+  auto promoted = [](std::shared_ptr<arrow::DataType> const& a,
+                     std::shared_ptr<arrow::DataType> const& b,
+                     std::shared_ptr<arrow::DataType> const& expected) {
+    return PromoteCSVType(a, b)->Equals(expected);
+  };
+  CHECK(promoted(arrow::null(), arrow::int64(), arrow::int64()));
+  CHECK(promoted(arrow::int64(), arrow::null(), arrow::int64()));
+  CHECK(promoted(arrow::int64(), arrow::float64(), arrow::float64()));
+  CHECK(promoted(arrow::float64(), arrow::utf8(), arrow::utf8()));
+  CHECK(promoted(arrow::boolean(), arrow::int64(), arrow::utf8()));
+
+  CSVChunkParser parser(',', {"id", "value", "name"});
+  std::shared_ptr<arrow::Table> table;
+
+  // the empty column is inferred as null
+  VINEYARD_CHECK_OK(
+      parser.Parse(arrow::Buffer::FromString("1,1.5,\n2,2.5,\n"), table));
+  CHECK(table->schema()->field(0)->type()->Equals(arrow::int64()));
+  CHECK(table->schema()->field(1)->type()->Equals(arrow::float64()));
+
+  // integral values of the double column, and the previously empty column,
+  // are parsed as the pinned types
+  VINEYARD_CHECK_OK(
+      parser.Parse(arrow::Buffer::FromString("3,3,x\n4,4,y\n"), table));
+  CHECK(table->schema()->field(1)->type()->Equals(arrow::float64()));
+  CHECK(table->schema()->field(2)->type()->Equals(arrow::utf8()));
+
+  // a wider value promotes the column, rather than failing
+  VINEYARD_CHECK_OK(
+      parser.Parse(arrow::Buffer::FromString("5.5,5,z\n6,6,w\n"), table));
+  CHECK(table->schema()->field(0)->type()->Equals(arrow::float64()));
+  CHECK_EQ(table->num_rows(), 2);
+  VINEYARD_CHECK_OK(
+      parser.Parse(arrow::Buffer::FromString("seven,7,v\n"), table));
+  CHECK(table->schema()->field(0)->type()->Equals(arrow::utf8()));
+
+  // the promoted types stay pinned
+  VINEYARD_CHECK_OK(parser.Parse(arrow::Buffer::FromString("8,8,u\n"), table));
+  CHECK(table->schema()->field(0)->type()->Equals(arrow::utf8()));
+  CHECK(parser.Types()["id"]->Equals(arrow::utf8()));
+  CHECK(parser.Types()["value"]->Equals(arrow::float64()));
+
+  // malformed lines are reported, rather than aborting
+  CHECK(!parser.Parse(arrow::Buffer::FromString("9,9,t,extra\n"), table).ok());
+
+  LOG(INFO) << "Passed csv type promotion tests";
+}
+
+void TestUnifyTables() {
+  CSVChunkParser parser(',', {"id", "value", "name"});
+  std::vector<std::shared_ptr<arrow::Table>> tables(3);
+  VINEYARD_CHECK_OK(
+      parser.Parse(arrow::Buffer::FromString("1,1,\n2,2,\n"), tables[0]));
+  VINEYARD_CHECK_OK(
+      parser.Parse(arrow::Buffer::FromString("3,3.5,c\n"), tables[1]));
+  VINEYARD_CHECK_OK(
+      parser.Parse(arrow::Buffer::FromString("four,4,d\n"), tables[2]));
+
+  auto narrow_schema = tables[0]->schema();
+  std::shared_ptr<arrow::Schema> schema;
+  VINEYARD_CHECK_OK(PromoteCSVSchema(tables, schema));
+  CHECK(schema->field(0)->type()->Equals(arrow::utf8()));
+  CHECK(schema->field(1)->type()->Equals(arrow::float64()));
+  CHECK(schema->field(2)->type()->Equals(arrow::utf8()));
+
+  // the tables parsed before the promotion are widened
+  for (auto& table : tables) {
+    VINEYARD_CHECK_OK(CastCSVTable(table, schema, table));
+    CHECK(table->schema()->Equals(*schema, false));
+  }
+  std::shared_ptr<arrow::Table> table;
+  CHECK_ARROW_ERROR_AND_ASSIGN(table, arrow::ConcatenateTables(tables));
+  CHECK_EQ(table->num_rows(), 4);
+  auto ids = std::dynamic_pointer_cast<arrow::StringArray>(
+      table->column(0)->chunk(0));
+  CHECK_EQ(ids->GetString(0), "1");
+  auto values = std::dynamic_pointer_cast<arrow::DoubleArray>(
+      table->column(1)->chunk(0));
+  CHECK_EQ(values->Value(1), 2.0);
+
+  // while the promoted values don't fit the narrower types
+  std::shared_ptr<arrow::Table> narrow;
+  CHECK(!CastCSVTable(table, narrow_schema, narrow).ok());
+
+  // and the columns must match
+  CSVChunkParser other(',', {"id", "other", "name"});
+  VINEYARD_CHECK_OK(
+      other.Parse(arrow::Buffer::FromString("6,6,f\n"), tables[0]));
+  CHECK(PromoteCSVSchema(tables, schema).IsInvalid());
+
+  LOG(INFO) << "Passed csv table unifying tests";
+}
+
+void TestSplitAndParse() {
+  // the values of the second column are integral in the first lines only
+  const int64_t row_num = 1000;
+  std::string content;
+  for (int64_t idx = 0; idx < row_num; ++idx) {
+    content += std::to_string(idx) + "," +
+               (idx < row_num / 2 ? std::to_string(idx)
+                                  : std::to_string(idx) + ".5") +
+               "\n";
+  }
+
+  std::vector<size_t> sizes;
+  for (size_t offset = 0; offset + 97 < content.size(); offset += 97) {
+    sizes.emplace_back(97);
+  }
+  auto chunks = MakeChunks(content, sizes);
+
+  CSVLineSplitter splitter;
+  CSVChunkParser parser(',', {"id", "value"}, false);
+  int64_t rows = 0, id_sum = 0;
+  double value_sum = 0;
+  auto parse = [&](std::shared_ptr<arrow::Buffer> const& piece) {
+    std::shared_ptr<arrow::Table> table;
+    RETURN_ON_ERROR(parser.Parse(piece, table));
+    rows += table->num_rows();
+    RETURN_ON_ERROR(IterateChunkedArray<arrow::Int64Array>(
+        table->column(0), [&](int64_t value, size_t) { id_sum += value; }));
+    auto const& type = table->schema()->field(1)->type();
+    if (type->Equals(arrow::int64())) {
+      return IterateChunkedArray<arrow::Int64Array>(
+          table->column(1),
+          [&](int64_t value, size_t) { value_sum += value; });
+    }
+    return IterateChunkedArray<arrow::DoubleArray>(
+        table->column(1), [&](double value, size_t) { value_sum += value; });
+  };
+  for (auto const& chunk : chunks) {
+    VINEYARD_CHECK_OK(splitter.Feed(chunk, parse));
+  }
+  VINEYARD_CHECK_OK(splitter.Flush(parse));
+
+  CHECK_EQ(rows, row_num);
+  CHECK_EQ(id_sum, row_num * (row_num - 1) / 2);
+  CHECK_EQ(value_sum, row_num * (row_num - 1) / 2.0 + (row_num / 2) * 0.5);
+  CHECK(parser.Types()["value"]->Equals(arrow::float64()));
+
+  LOG(INFO) << "Passed csv split and parse tests";
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage ./csv_chunk_parser_test <ipc_socket>");
+    return 1;
+  }
+
+  TestLineSplitter();
+  TestTypePromotion();
+  TestUnifyTables();
+  TestSplitAndParse();
+
+  LOG(INFO) << "Passed csv chunk parser tests...";
+  return 0;
+}
@@ -0,0 +1,290 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/status.h"
+#include "arrow/util/io_util.h"
+#include "arrow/util/logging.h"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow.h"
+#include "basic/ds/arrow_utils.h"
+#include "basic/stream/dataframe_stream.h"
+#include "client/client.h"
+#include "client/ds/object_meta.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+std::shared_ptr<arrow::RecordBatch> MakeBatch(int64_t base, int64_t rows) {
+  arrow::Int64Builder b1;
+  arrow::DoubleBuilder b2;
+  for (int64_t i = 0; i < rows; ++i) {
+    CHECK_ARROW_ERROR(b1.Append(base + i));
+    CHECK_ARROW_ERROR(b2.Append((base + i) * 0.5));
+  }
+  std::shared_ptr<arrow::Array> a1, a2;
+  CHECK_ARROW_ERROR(b1.Finish(&a1));
+  CHECK_ARROW_ERROR(b2.Finish(&a2));
+  auto schema = arrow::schema({arrow::field("id", arrow::int64()),
+                               arrow::field("value", arrow::float64())});
+  return arrow::RecordBatch::Make(schema, rows, {a1, a2});
+}
+
+void TestFraming(Client& client, std::string const& ipc_socket,
+                 std::string const& framing,
+                 std::string const& compression = "none",
+                 bool const retain = false) {
+  ObjectID stream_id = InvalidObjectID();
+  {
+    DataframeStreamBuilder builder(client);
+    builder.SetParams(std::unordered_map<std::string, std::string>{
+        {"framing", framing}, {"compression", compression}});
+    auto dstream =
+        std::dynamic_pointer_cast<DataframeStream>(builder.Seal(client));
+    stream_id = dstream->id();
+    CHECK(stream_id != InvalidObjectID());
+  }
+
+  const size_t batch_num = 8;
+  const int64_t batch_rows = 100;
+
+  std::thread send_thrd([&]() {
+    Client writer_client;
+    VINEYARD_CHECK_OK(writer_client.Connect(ipc_socket));
+
+    auto dstream = writer_client.GetObject<DataframeStream>(stream_id);
+    CHECK(dstream != nullptr);
+    CHECK_EQ(dstream->GetParams()["framing"], framing);
+
+    auto writer = dstream->OpenWriter(writer_client);
+    for (size_t idx = 0; idx < batch_num; ++idx) {
+      auto batch = MakeBatch(idx * batch_rows, batch_rows);
+      VINEYARD_CHECK_OK(writer->WriteBatch(batch));
+    }
+    VINEYARD_CHECK_OK(writer->Finish());
+  });
+
+  std::thread recv_thrd([&]() {
+    Client reader_client;
+    VINEYARD_CHECK_OK(reader_client.Connect(ipc_socket));
+
+    auto dstream = reader_client.GetObject<DataframeStream>(stream_id);
+    CHECK(dstream != nullptr);
+
+    // when retained, the table references the stream chunks retained by
+    // `reader_client`, otherwise the chunks are copied.
+    std::shared_ptr<arrow::Table> table;
+    auto reader = dstream->OpenReader(reader_client);
+    VINEYARD_CHECK_OK(reader->ReadTable(table, retain));
+
+    CHECK_EQ(table->num_rows(), batch_num * batch_rows);
+    CHECK_EQ(table->num_columns(), 2);
+    int64_t expected = 0;
+    CHECK(IterateChunkedArray<arrow::Int64Array>(
+              table->column(0),
+              [&](int64_t value, size_t) { CHECK_EQ(value, expected++); })
+              .ok());
+  });
+
+  send_thrd.join();
+  recv_thrd.join();
+
+  LOG(INFO) << "Passed dataframe stream tests with framing " << framing
+            << ", compression " << compression << " and retain " << retain;
+}
+
+// a failed stream is reported to the reader, rather than a truncated table
+void TestFailure(Client& client, std::string const& ipc_socket,
+                 std::string const& framing) {
+  ObjectID stream_id = InvalidObjectID();
+  {
+    DataframeStreamBuilder builder(client);
+    builder.SetParams(std::unordered_map<std::string, std::string>{
+        {"framing", framing}});
+    stream_id = builder.Seal(client)->id();
+  }
+
+  std::thread send_thrd([&]() {
+    Client writer_client;
+    VINEYARD_CHECK_OK(writer_client.Connect(ipc_socket));
+    auto writer =
+        writer_client.GetObject<DataframeStream>(stream_id)->OpenWriter(
+            writer_client);
+    for (int64_t idx = 0; idx < 3; ++idx) {
+      auto batch = MakeBatch(idx * 100, 100);
+      VINEYARD_CHECK_OK(writer->WriteBatch(batch));
+    }
+    VINEYARD_CHECK_OK(writer->Abort());
+  });
+
+  std::shared_ptr<arrow::Table> table;
+  auto reader =
+      client.GetObject<DataframeStream>(stream_id)->OpenReader(client);
+  auto status = reader->ReadTable(table);
+  send_thrd.join();
+  CHECK(status.IsStreamFailed()) << status.ToString();
+
+  LOG(INFO) << "Passed dataframe stream failure tests with framing "
+            << framing;
+}
+
+// a truncated or corrupt frame is an error of the read, rather than the end
+void TestCorruptFrames(Client& client) {
+  std::unique_ptr<arrow::util::Codec> codec;
+  VINEYARD_CHECK_OK(GetCompressionCodec("lz4", &codec));
+  std::vector<int64_t> values(1024);
+  for (size_t idx = 0; idx < values.size(); ++idx) {
+    values[idx] = idx;
+  }
+  std::shared_ptr<arrow::Buffer> compressed;
+  VINEYARD_CHECK_OK(
+      CompressBuffer(codec.get(), reinterpret_cast<uint8_t*>(values.data()),
+                     values.size() * sizeof(int64_t), &compressed));
+  std::string frame = compressed->ToString();
+  std::unique_ptr<arrow::Buffer> decompressed;
+  auto decompress = [&](std::string const& frame) {
+    return DecompressBuffer(codec.get(),
+                            reinterpret_cast<const uint8_t*>(frame.data()),
+                            frame.size(), &decompressed);
+  };
+  VINEYARD_CHECK_OK(decompress(frame));
+  CHECK_EQ(decompressed->size(), values.size() * sizeof(int64_t));
+
+  auto with_length = [&](int64_t length) {
+    std::string corrupt = frame;
+    memcpy(&corrupt[0], &length, sizeof(int64_t));
+    return corrupt;
+  };
+  CHECK(decompress(frame.substr(0, 4)).IsInvalid());
+  CHECK(decompress(frame.substr(0, frame.size() / 2)).IsInvalid());
+  CHECK(decompress(with_length(-1)).IsInvalid());
+  CHECK(decompress(with_length(std::numeric_limits<int64_t>::max()))
+            .IsInvalid());
+  CHECK(decompress(with_length(values.size() * sizeof(int64_t) + 1))
+            .IsInvalid());
+
+  // a corrupt chunk in a compressed stream fails the read
+  ObjectID stream_id = InvalidObjectID();
+  {
+    DataframeStreamBuilder builder(client);
+    builder.SetParams(std::unordered_map<std::string, std::string>{
+        {"compression", "lz4"}});
+    stream_id = builder.Seal(client)->id();
+  }
+  std::string corrupt = with_length(-1);
+  std::unique_ptr<arrow::MutableBuffer> chunk;
+  VINEYARD_CHECK_OK(
+      client.GetNextStreamChunk(stream_id, corrupt.size(), chunk));
+  memcpy(chunk->mutable_data(), corrupt.data(), corrupt.size());
+  VINEYARD_CHECK_OK(client.StopStream(stream_id, false));
+
+  std::shared_ptr<arrow::Table> table;
+  auto reader =
+      client.GetObject<DataframeStream>(stream_id)->OpenReader(client);
+  CHECK(reader->ReadTable(table).IsInvalid());
+
+  LOG(INFO) << "Passed dataframe stream corrupt frame tests";
+}
+
+void TestMaterialize(Client& client, std::string const& ipc_socket,
+                     std::string const& compression) {
+  ObjectID stream_id = InvalidObjectID();
+  {
+    DataframeStreamBuilder builder(client);
+    builder.SetParams(std::unordered_map<std::string, std::string>{
+        {"framing", "schema_once"}, {"compression", compression}});
+    stream_id = builder.Seal(client)->id();
+  }
+
+  const size_t batch_num = 8;
+  const int64_t batch_rows = 100;
+
+  std::thread send_thrd([&]() {
+    Client writer_client;
+    VINEYARD_CHECK_OK(writer_client.Connect(ipc_socket));
+    auto writer =
+        writer_client.GetObject<DataframeStream>(stream_id)->OpenWriter(
+            writer_client);
+    for (size_t idx = 0; idx < batch_num; ++idx) {
+      auto batch = MakeBatch(idx * batch_rows, batch_rows);
+      VINEYARD_CHECK_OK(writer->WriteBatch(batch));
+    }
+    VINEYARD_CHECK_OK(writer->Finish());
+  });
+
+  ObjectID table_id = InvalidObjectID();
+  {
+    DataframeStreamMaterializer materializer(
+        client, client.GetObject<DataframeStream>(stream_id));
+    table_id = materializer.Seal(client)->id();
+  }
+  send_thrd.join();
+
+  auto table = client.GetObject<Table>(table_id);
+  CHECK_EQ(table->num_rows(), batch_num * batch_rows);
+  CHECK_EQ(table->batch_num(), batch_num);
+  int64_t expected = 0;
+  CHECK(IterateChunkedArray<arrow::Int64Array>(
+            table->GetTable()->column(0),
+            [&](int64_t value, size_t) { CHECK_EQ(value, expected++); })
+            .ok());
+
+  // columns of a batch share the adopted chunk, unless compressed.
+  auto const& columns = table->batches()[0]->columns();
+  bool shared = columns[0]->meta().GetMemberMeta("buffer_").GetId() ==
+                columns[1]->meta().GetMemberMeta("buffer_").GetId();
+  CHECK_EQ(shared, compression == "none");
+
+  LOG(INFO) << "Passed dataframe stream materialize tests with compression "
+            << compression;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage ./dataframe_stream_test <ipc_socket>");
+    return 1;
+  }
+  std::string ipc_socket = std::string(argv[1]);
+
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
+
+  TestFraming(client, ipc_socket, "stream");
+  TestFraming(client, ipc_socket, "schema_once");
+  TestFraming(client, ipc_socket, "stream", "lz4");
+  TestFraming(client, ipc_socket, "schema_once", "zstd");
+  TestFraming(client, ipc_socket, "stream", "none", true);
+  TestFraming(client, ipc_socket, "schema_once", "none", true);
+  TestFailure(client, ipc_socket, "stream");
+  TestFailure(client, ipc_socket, "schema_once");
+  TestCorruptFrames(client);
+  TestMaterialize(client, ipc_socket, "none");
+  TestMaterialize(client, ipc_socket, "lz4");
+
+  LOG(INFO) << "Passed dataframe stream tests...";
+
+  client.Disconnect();
+
+  return 0;
+}
@@ -0,0 +1,282 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/status.h"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+#include "basic/stream/dataframe_stream.h"
+#include "client/client.h"
+#include "io/io/local_io_adaptor.h"
+#include "io/io/pipeline.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+constexpr int64_t row_num = 10000;
+
+std::string MakeCSVFile() {
+  std::string path = "/tmp/io_pipeline_test.csv";
+  std::ofstream ofs(path);
+  ofs << "id,value\n";
+  for (int64_t idx = 0; idx < row_num; ++idx) {
+    ofs << idx << "," << idx * 0.5 << "\n";
+  }
+  return path;
+}
+
+// the values are integers but in the last rows, thus the last chunks promote
+// the value column to doubles
+std::string MakePromotedCSVFile() {
+  std::string path = "/tmp/io_pipeline_test_promoted.csv";
+  std::ofstream ofs(path);
+  ofs << "id,value\n";
+  for (int64_t idx = 0; idx < row_num; ++idx) {
+    if (idx < row_num - 10) {
+      ofs << idx << "," << idx << "\n";
+    } else {
+      ofs << idx << "," << idx << ".5\n";
+    }
+  }
+  return path;
+}
+
+std::shared_ptr<AdaptorLineSource> MakeSource(std::string const& path) {
+  auto adaptor = std::make_shared<LocalIOAdaptor>(path);
+  VINEYARD_CHECK_OK(adaptor->Open());
+  // small chunks, to exercise many workers
+  return std::make_shared<AdaptorLineSource>(adaptor, 4096);
+}
+
+// emits the batches of a source, but blocks after the first batch until the
+// consumer of the sink has received it.
+class GatedSource : public PipelineSource {
+ public:
+  explicit GatedSource(std::shared_ptr<PipelineSource> source)
+      : source_(source) {}
+
+  Status Next(PipelineChunk& chunk) override {
+    if (emitted_ == 1) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      CHECK(cond_.wait_for(lock, std::chrono::seconds(60),
+                           [this]() { return received_; }))
+          << "The first batch is not visible before the input is parsed";
+    }
+    emitted_ += 1;
+    return source_->Next(chunk);
+  }
+
+  void Received() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    received_ = true;
+    cond_.notify_all();
+  }
+
+ private:
+  std::shared_ptr<PipelineSource> source_;
+  int64_t emitted_ = 0;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool received_ = false;
+};
+
+void CheckTable(std::shared_ptr<arrow::Table> const& table, bool ordered) {
+  CHECK_EQ(table->num_rows(), row_num);
+  CHECK_EQ(table->num_columns(), 2);
+  CHECK_EQ(table->schema()->field(0)->name(), "id");
+  // chunks are written to a stream out of order, but collected in order
+  int64_t sum = 0, expected = 0;
+  CHECK(IterateChunkedArray<arrow::Int64Array>(
+            table->column(0),
+            [&](int64_t value, size_t) {
+              sum += value;
+              if (ordered) {
+                CHECK_EQ(value, expected++);
+              }
+            })
+            .ok());
+  CHECK_EQ(sum, row_num * (row_num - 1) / 2);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage ./io_pipeline_test <ipc_socket>");
+    return 1;
+  }
+  std::string ipc_socket = std::string(argv[1]);
+
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
+
+  std::string path = MakeCSVFile();
+  std::vector<std::string> col_names{"id", "value"};
+
+  // in process
+  {
+    auto collector = std::make_shared<TableCollector>();
+    Pipeline pipeline(MakeSource(path));
+    pipeline.Then(std::make_shared<ParseCSVOperator>(',', col_names))
+        .To(collector);
+    VINEYARD_CHECK_OK(pipeline.Run(4));
+
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(collector->GetTable(table));
+    CheckTable(table, true);
+  }
+
+  // the tables are cast to the promoted column types when collected
+  {
+    auto collector = std::make_shared<TableCollector>();
+    Pipeline pipeline(MakeSource(MakePromotedCSVFile()));
+    pipeline.Then(std::make_shared<ParseCSVOperator>(',', col_names))
+        .To(collector);
+    VINEYARD_CHECK_OK(pipeline.Run(4));
+
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(collector->GetTable(table));
+    CheckTable(table, true);
+    CHECK(table->schema()->field(1)->type()->Equals(arrow::float64()));
+    double sum = 0;
+    CHECK(IterateChunkedArray<arrow::DoubleArray>(
+              table->column(1), [&](double value, size_t) { sum += value; })
+              .ok());
+    CHECK_EQ(sum, row_num * (row_num - 1) / 2 + 10 * 0.5);
+  }
+
+  // to a dataframe stream at the boundary
+  {
+    DataframeStreamBuilder builder(client);
+    builder.SetParams(std::unordered_map<std::string, std::string>{
+        {"framing", "schema_once"}});
+    auto stream =
+        std::dynamic_pointer_cast<DataframeStream>(builder.Seal(client));
+    ObjectID stream_id = stream->id();
+
+    std::thread recv_thrd([&]() {
+      Client reader_client;
+      VINEYARD_CHECK_OK(reader_client.Connect(ipc_socket));
+      auto dstream = reader_client.GetObject<DataframeStream>(stream_id);
+      std::shared_ptr<arrow::Table> table;
+      VINEYARD_CHECK_OK(dstream->OpenReader(reader_client)->ReadTable(table));
+      CheckTable(table, false);
+    });
+
+    Pipeline pipeline(MakeSource(path));
+    pipeline.Then(std::make_shared<ParseCSVOperator>(',', col_names))
+        .To(std::make_shared<DataframeStreamSink>(client, stream));
+    VINEYARD_CHECK_OK(pipeline.Run(4));
+    recv_thrd.join();
+  }
+
+  // a stream fails rather than changing its schema after the first chunk
+  {
+    DataframeStreamBuilder builder(client);
+    auto stream =
+        std::dynamic_pointer_cast<DataframeStream>(builder.Seal(client));
+    ObjectID stream_id = stream->id();
+
+    std::thread recv_thrd([&]() {
+      Client reader_client;
+      VINEYARD_CHECK_OK(reader_client.Connect(ipc_socket));
+      auto dstream = reader_client.GetObject<DataframeStream>(stream_id);
+      std::shared_ptr<arrow::Table> table;
+      auto reader = dstream->OpenReader(reader_client);
+      CHECK(reader->ReadTable(table).IsStreamFailed());
+    });
+
+    Pipeline pipeline(MakeSource(MakePromotedCSVFile()));
+    pipeline.Then(std::make_shared<ParseCSVOperator>(',', col_names))
+        .To(std::make_shared<DataframeStreamSink>(client, stream));
+    CHECK(pipeline.Run(1).IsInvalid());
+    recv_thrd.join();
+  }
+
+  // batches of the streaming reader are visible before the file is parsed
+  {
+    auto adaptor = std::make_shared<LocalIOAdaptor>(path + "#header_row=true");
+    VINEYARD_CHECK_OK(adaptor->Configure("block_size", "4096"));
+    VINEYARD_CHECK_OK(adaptor->SetPartialRead(0, 1));
+    VINEYARD_CHECK_OK(adaptor->Open());
+    std::shared_ptr<arrow::RecordBatchReader> reader;
+    VINEYARD_CHECK_OK(adaptor->OpenPartialBatchReader(&reader, 0));
+    auto source = std::make_shared<GatedSource>(
+        std::make_shared<BatchReaderSource>(reader));
+
+    DataframeStreamBuilder builder(client);
+    auto stream =
+        std::dynamic_pointer_cast<DataframeStream>(builder.Seal(client));
+    ObjectID stream_id = stream->id();
+
+    std::thread recv_thrd([&]() {
+      Client reader_client;
+      VINEYARD_CHECK_OK(reader_client.Connect(ipc_socket));
+      auto dstream = reader_client.GetObject<DataframeStream>(stream_id);
+      auto stream_reader = dstream->OpenReader(reader_client);
+      int64_t rows = 0, batches = 0, sum = 0;
+      while (true) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        auto status = stream_reader->ReadBatch(batch);
+        if (status.IsEndOfFile()) {
+          break;
+        }
+        VINEYARD_CHECK_OK(status);
+        if (batches == 0) {
+          source->Received();
+        }
+        auto ids =
+            std::dynamic_pointer_cast<arrow::Int64Array>(batch->column(0));
+        for (int64_t idx = 0; idx < ids->length(); ++idx) {
+          sum += ids->Value(idx);
+        }
+        rows += batch->num_rows();
+        batches += 1;
+      }
+      CHECK_EQ(rows, row_num);
+      CHECK_EQ(sum, row_num * (row_num - 1) / 2);
+      CHECK_GT(batches, 1);
+    });
+
+    Pipeline pipeline(source);
+    pipeline.To(std::make_shared<DataframeStreamSink>(client, stream));
+    VINEYARD_CHECK_OK(pipeline.Run(1));
+    recv_thrd.join();
+    VINEYARD_CHECK_OK(adaptor->Close());
+  }
+
+  // failures abort the sink
+  {
+    auto collector = std::make_shared<TableCollector>();
+    Pipeline pipeline(MakeSource(path));
+    pipeline.To(collector);
+    CHECK(pipeline.Run(4).IsInvalid());
+  }
+
+  LOG(INFO) << "Passed io pipeline tests...";
+
+  client.Disconnect();
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "arrow/api.h"
+#include "glog/logging.h"
+
+#ifdef KAFKA_ENABLED
+#include "librdkafka/rdkafka_mock.h"
+#include "librdkafka/rdkafkacpp.h"
+#endif
+
+#include "io/io/kafka_io_adaptor.h"
+
+#ifdef KAFKA_ENABLED
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+constexpr int partition_num = 3;
+constexpr int message_num = 1000;
+constexpr int part_num = 2;
+
+// produces "message-<i>" to the partition i % partition_num
+void Produce(std::string const& brokers, std::string const& topic) {
+  std::string err;
+  std::unique_ptr<RdKafka::Conf> conf(
+      RdKafka::Conf::create(RdKafka::Conf::CONF_GLOBAL));
+  CHECK_EQ(conf->set("bootstrap.servers", brokers, err),
+           RdKafka::Conf::CONF_OK)
+      << err;
+  std::unique_ptr<RdKafka::Producer> producer(
+      RdKafka::Producer::create(conf.get(), err));
+  CHECK(producer != nullptr) << err;
+  for (int i = 0; i < message_num; ++i) {
+    std::string message = "message-" + std::to_string(i);
+    CHECK_EQ(producer->produce(topic, i % partition_num,
+                               RdKafka::Producer::RK_MSG_COPY,
+                               const_cast<char*>(message.data()),
+                               message.size(), nullptr, 0, 0, nullptr),
+             RdKafka::ERR_NO_ERROR);
+  }
+  CHECK_EQ(producer->flush(10 * 1000), RdKafka::ERR_NO_ERROR);
+}
+
+void TestReadTables(std::string const& location) {
+  std::set<std::string> messages;
+  int64_t batches = 0;
+  for (int index = 0; index < part_num; ++index) {
+    KafkaIOAdaptor adaptor(location);
+    VINEYARD_CHECK_OK(adaptor.Configure("time_interval", "1"));
+    VINEYARD_CHECK_OK(adaptor.Configure("batch_size", "128"));
+    VINEYARD_CHECK_OK(adaptor.SetPartialRead(index, part_num));
+    VINEYARD_CHECK_OK(adaptor.Open());
+    VINEYARD_CHECK_OK(
+        adaptor.ReadTables([&](std::shared_ptr<arrow::Table> const& table) {
+          CHECK(table->schema()->Equals(KafkaIOAdaptor::Schema()));
+          CHECK_LE(table->num_rows(), 128);
+          auto partitions = std::dynamic_pointer_cast<arrow::Int32Array>(
+              table->column(0)->chunk(0));
+          auto offsets = std::dynamic_pointer_cast<arrow::Int64Array>(
+              table->column(1)->chunk(0));
+          auto values = std::dynamic_pointer_cast<arrow::StringArray>(
+              table->column(3)->chunk(0));
+          for (int64_t i = 0; i < table->num_rows(); ++i) {
+            // the partitions are split among the workers
+            CHECK_EQ(partitions->Value(i) % part_num, index);
+            int id = std::stoi(values->GetString(i).substr(strlen("message-")));
+            CHECK_EQ(id % partition_num, partitions->Value(i));
+            CHECK_EQ(id / partition_num, offsets->Value(i));
+            messages.insert(values->GetString(i));
+          }
+          batches += 1;
+          return Status::OK();
+        }));
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+  CHECK_EQ(messages.size(), message_num);
+  CHECK_GT(batches, partition_num);
+  LOG(INFO) << "Passed read tables tests with " << batches << " batches";
+}
+
+void TestReadLine(std::string const& location) {
+  KafkaIOAdaptor adaptor(location);
+  VINEYARD_CHECK_OK(adaptor.Configure("group_id", "line"));
+  VINEYARD_CHECK_OK(adaptor.Configure("time_interval", "1"));
+  VINEYARD_CHECK_OK(adaptor.Configure("batch_bytes", "1024"));
+  VINEYARD_CHECK_OK(adaptor.Open());
+  std::set<std::string> messages;
+  std::string line;
+  while (adaptor.ReadLine(line).ok()) {
+    messages.insert(line);
+  }
+  VINEYARD_CHECK_OK(adaptor.Close());
+  CHECK_EQ(messages.size(), message_num);
+  LOG(INFO) << "Passed read line tests";
+}
+
+int main(int argc, char** argv) {
+  // an in-process mock cluster, see also librdkafka's rdkafka_mock.h
+  std::string err;
+  std::unique_ptr<RdKafka::Conf> conf(
+      RdKafka::Conf::create(RdKafka::Conf::CONF_GLOBAL));
+  std::unique_ptr<RdKafka::Producer> handle(
+      RdKafka::Producer::create(conf.get(), err));
+  CHECK(handle != nullptr) << err;
+  rd_kafka_mock_cluster_t* cluster =
+      rd_kafka_mock_cluster_new(handle->c_ptr(), 1);
+  CHECK(cluster != nullptr);
+  std::string brokers = rd_kafka_mock_cluster_bootstraps(cluster);
+  std::string topic = "kafka_io_adaptor_test";
+  CHECK_EQ(rd_kafka_mock_topic_create(cluster, topic.c_str(), partition_num, 1),
+           0);
+
+  Produce(brokers, topic);
+  // kafka://brokers/topic/group_id/partition_num
+  std::string location = "kafka://" + brokers + "/" + topic + "/tables/" +
+                         std::to_string(partition_num);
+  TestReadTables(location);
+  TestReadLine(location);
+
+  rd_kafka_mock_cluster_destroy(cluster);
+  LOG(INFO) << "Passed kafka io adaptor tests...";
+  return 0;
+}
+
+#else
+
+int main(int argc, char** argv) {
+  LOG(INFO) << "Skipped kafka io adaptor tests, kafka is not enabled";
+  return 0;
+}
+
+#endif  // KAFKA_ENABLED
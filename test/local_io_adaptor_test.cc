@@ -0,0 +1,405 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/util/compression.h"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+#include "io/io/block_decompressor.h"
+#include "io/io/local_io_adaptor.h"
+#include "io/io/multi_file_io_adaptor.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+constexpr int64_t row_num = 10000;
+constexpr int part_num = 7;
+
+std::string MakeCSVFile() {
+  std::string path = "/tmp/local_io_adaptor_test.csv";
+  std::ofstream ofs(path);
+  ofs << "id,value\n";
+  for (int64_t idx = 0; idx < row_num; ++idx) {
+    ofs << idx << "," << idx * 0.5 << "\n";
+  }
+  return path;
+}
+
+std::string ReadFile(std::string const& path) {
+  std::ifstream ifs(path, std::ios::binary);
+  std::stringstream content;
+  content << ifs.rdbuf();
+  return content.str();
+}
+
+// compresses every 64KB as a gzip member (or zstd frame) respectively
+std::string MakeCompressedFile(std::string const& path,
+                               arrow::Compression::type type,
+                               std::string const& suffix) {
+  std::string data = ReadFile(path);
+
+  std::unique_ptr<arrow::util::Codec> codec;
+  CHECK_ARROW_ERROR_AND_ASSIGN(codec, arrow::util::Codec::Create(type));
+  std::ofstream ofs(path + suffix, std::ios::binary);
+  for (size_t offset = 0; offset < data.size(); offset += 65536) {
+    size_t size = std::min<size_t>(65536, data.size() - offset);
+    auto input = reinterpret_cast<const uint8_t*>(data.data()) + offset;
+    std::string output(codec->MaxCompressedLen(size, input), '\0');
+    int64_t length = 0;
+    CHECK_ARROW_ERROR_AND_ASSIGN(
+        length, codec->Compress(size, input, output.size(),
+                                reinterpret_cast<uint8_t*>(&output[0])));
+    ofs.write(output.data(), length);
+  }
+  return path + suffix;
+}
+
+// compresses every 16KB as a BGZF member, i.e., a gzip member whose FEXTRA
+// field "BC" records the size of the member, like `bgzip`.
+std::string MakeBGZFFile(std::string const& path) {
+  std::string data = ReadFile(path);
+
+  std::unique_ptr<arrow::util::Codec> codec;
+  CHECK_ARROW_ERROR_AND_ASSIGN(
+      codec, arrow::util::Codec::Create(arrow::Compression::GZIP));
+  std::ofstream ofs(path + ".bgz", std::ios::binary);
+  for (size_t offset = 0; offset < data.size(); offset += 16384) {
+    size_t size = std::min<size_t>(16384, data.size() - offset);
+    auto input = reinterpret_cast<const uint8_t*>(data.data()) + offset;
+    std::string output(codec->MaxCompressedLen(size, input), '\0');
+    int64_t length = 0;
+    CHECK_ARROW_ERROR_AND_ASSIGN(
+        length, codec->Compress(size, input, output.size(),
+                                reinterpret_cast<uint8_t*>(&output[0])));
+    // a plain gzip member: the 10 bytes header without optional fields, the
+    // deflate stream, then the CRC32 and the size of input
+    CHECK_GT(length, 18);
+    CHECK_EQ(static_cast<uint8_t>(output[3]), 0);
+    std::string body = output.substr(10, length - 10);
+    int64_t block_size = 10 + 8 + body.size();
+    CHECK_LE(block_size, 65536);
+    std::string header = {'\x1f', '\x8b', '\x08', '\x04', 0, 0, 0, 0,
+                          0, '\xff', 6, 0, 'B', 'C', 2, 0,
+                          static_cast<char>((block_size - 1) & 0xff),
+                          static_cast<char>((block_size - 1) >> 8)};
+    ofs.write(header.data(), header.size());
+    ofs.write(body.data(), body.size());
+  }
+  return path + ".bgz";
+}
+
+// the BGZF and zstd files are indexed into units, which are decompressed in
+// parallel, while plain gzip files are decompressed sequentially.
+void TestBlockDecompressor(std::string const& path,
+                           std::string const& compressed,
+                           size_t const expected_units) {
+  std::string data = ReadFile(path);
+  std::string content = ReadFile(compressed);
+  std::unique_ptr<BlockDecompressor> decompressor;
+  VINEYARD_CHECK_OK(BlockDecompressor::Make(
+      BlockDecompressor::CompressionOf(compressed),
+      reinterpret_cast<const uint8_t*>(content.data()), content.size(), 4,
+      decompressor));
+  CHECK_EQ(decompressor->units(), expected_units);
+  CHECK_EQ(decompressor->size(), data.size());
+
+  // a line break in the middle only decompresses the units on the way
+  int64_t position = 0;
+  VINEYARD_CHECK_OK(decompressor->Find(data.size() / 2, '\n', 0, position));
+  CHECK_EQ(position, data.find('\n', data.size() / 2));
+  VINEYARD_CHECK_OK(decompressor->Ensure(0, decompressor->size()));
+  CHECK(std::string(decompressor->data(), decompressor->size()) == data);
+
+  LOG(INFO) << "Passed block decompressor tests with " << compressed << ", "
+            << decompressor->units() << " units";
+}
+
+void TestPartialRead(std::string const& path, std::string const& using_mmap) {
+  int64_t lines = 0, rows = 0, sum = 0;
+  for (int index = 0; index < part_num; ++index) {
+    LocalIOAdaptor adaptor(path + "#header_row=true");
+    VINEYARD_CHECK_OK(adaptor.Configure("using_mmap", using_mmap));
+    VINEYARD_CHECK_OK(adaptor.SetPartialRead(index, part_num));
+    VINEYARD_CHECK_OK(adaptor.Open());
+
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(adaptor.ReadPartialTable(&table, index));
+    if (table != nullptr) {
+      rows += table->num_rows();
+    }
+
+    // partitions are split at line breaks
+    std::string line;
+    while (adaptor.ReadLine(line).ok()) {
+      CHECK_EQ(line.back(), '\n');
+      sum += std::stoll(line.substr(0, line.find(',')));
+      lines += 1;
+    }
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+  CHECK_EQ(lines, row_num);
+  CHECK_EQ(rows, row_num);
+  CHECK_EQ(sum, row_num * (row_num - 1) / 2);
+
+  LOG(INFO) << "Passed partial read tests with using_mmap = " << using_mmap;
+}
+
+void TestStreamingRead(std::string const& path) {
+  int64_t rows = 0, batches = 0;
+  for (int index = 0; index < part_num; ++index) {
+    LocalIOAdaptor adaptor(path + "#header_row=true");
+    VINEYARD_CHECK_OK(adaptor.Configure("block_size", "4096"));
+    VINEYARD_CHECK_OK(adaptor.SetPartialRead(index, part_num));
+    VINEYARD_CHECK_OK(adaptor.Open());
+
+    std::shared_ptr<arrow::RecordBatchReader> reader;
+    VINEYARD_CHECK_OK(adaptor.OpenPartialBatchReader(&reader, index));
+    CHECK(reader != nullptr);
+    while (true) {
+      std::shared_ptr<arrow::RecordBatch> batch;
+      CHECK_ARROW_ERROR(reader->ReadNext(&batch));
+      if (batch == nullptr) {
+        break;
+      }
+      CHECK_EQ(batch->num_columns(), 2);
+      rows += batch->num_rows();
+      batches += 1;
+    }
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+  CHECK_EQ(rows, row_num);
+  // every block of 4KB is parsed as a batch
+  CHECK_GT(batches, part_num);
+
+  LOG(INFO) << "Passed streaming read tests with " << batches << " batches";
+}
+
+// splits the rows into files of skewed sizes, one of which is compressed
+std::string MakeCSVDirectory() {
+  std::string path = "/tmp/local_io_adaptor_test_dir";
+  VINEYARD_SUPPRESS(LocalIOAdaptor(path).MakeDirectory(path + "/"));
+  std::vector<int64_t> splits = {0, 10, 100, 3000, 3100, 8000, row_num};
+  for (size_t file = 0; file + 1 < splits.size(); ++file) {
+    std::string name = path + "/part-" + std::to_string(file) + ".csv";
+    std::ofstream ofs(name);
+    ofs << "id,value\n";
+    for (int64_t idx = splits[file]; idx < splits[file + 1]; ++idx) {
+      ofs << idx << "," << idx * 0.5 << "\n";
+    }
+    ofs.close();
+    if (file == 1) {
+      MakeCompressedFile(name, arrow::Compression::GZIP, ".gz");
+      std::remove(name.c_str());
+    }
+  }
+  // skipped
+  std::ofstream(path + "/_SUCCESS") << "id,value\n-1,-1\n";
+  return path;
+}
+
+// compressed files without the suffix of compression, which must be read
+// with the location option "compression"
+std::string MakeCompressedDirectory() {
+  std::string path = "/tmp/local_io_adaptor_test_compressed_dir";
+  VINEYARD_SUPPRESS(LocalIOAdaptor(path).MakeDirectory(path + "/"));
+  std::vector<int64_t> splits = {0, 5000, row_num};
+  for (size_t file = 0; file + 1 < splits.size(); ++file) {
+    std::string name = path + "/part-" + std::to_string(file) + ".csv";
+    std::ofstream ofs(name);
+    ofs << "id,value\n";
+    for (int64_t idx = splits[file]; idx < splits[file + 1]; ++idx) {
+      ofs << idx << "," << idx * 0.5 << "\n";
+    }
+    ofs.close();
+    MakeCompressedFile(name, arrow::Compression::GZIP, ".data");
+    std::remove(name.c_str());
+  }
+  return path;
+}
+
+void TestMultiFileRead(std::string const& location) {
+  CHECK(MultiFileIOAdaptor::IsMultiFile(location));
+  int64_t lines = 0, rows = 0, sum = 0;
+  for (int index = 0; index < part_num; ++index) {
+    MultiFileIOAdaptor adaptor(location + "#header_row=true");
+    VINEYARD_CHECK_OK(adaptor.Configure("min_split_size", "4096"));
+    VINEYARD_CHECK_OK(adaptor.SetPartialRead(index, part_num));
+    VINEYARD_CHECK_OK(adaptor.Open());
+
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(adaptor.ReadTable(&table));
+    if (table != nullptr) {
+      rows += table->num_rows();
+    }
+
+    std::string line;
+    while (adaptor.ReadLine(line).ok()) {
+      CHECK_EQ(line.back(), '\n');
+      sum += std::stoll(line.substr(0, line.find(',')));
+      lines += 1;
+    }
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+  CHECK_EQ(lines, row_num);
+  CHECK_EQ(rows, row_num);
+  CHECK_EQ(sum, row_num * (row_num - 1) / 2);
+
+  LOG(INFO) << "Passed multiple file read tests with " << location;
+}
+
+// the compressed files are never split, although larger than the
+// "min_split_size"
+void TestCompressedMultiFileRead(std::string const& location) {
+  TestMultiFileRead(location);
+  size_t files = 0;
+  for (int index = 0; index < part_num; ++index) {
+    MultiFileIOAdaptor adaptor(location);
+    VINEYARD_CHECK_OK(adaptor.Configure("min_split_size", "4096"));
+    VINEYARD_CHECK_OK(adaptor.SetPartialRead(index, part_num));
+    VINEYARD_CHECK_OK(adaptor.Open());
+    for (auto const& range : adaptor.ranges()) {
+      // skips the empty range of the workers that have no files
+      if (range.end > range.begin) {
+        CHECK_EQ(range.begin, 0);
+        CHECK_EQ(range.end, std::numeric_limits<int64_t>::max());
+        files += 1;
+      }
+    }
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+  CHECK_EQ(files, 2);
+}
+
+void TestWriteTable(std::string const& path) {
+  std::shared_ptr<arrow::Table> table;
+  {
+    LocalIOAdaptor adaptor(path + "#header_row=true");
+    VINEYARD_CHECK_OK(adaptor.SetPartialRead(0, 1));
+    VINEYARD_CHECK_OK(adaptor.Open());
+    VINEYARD_CHECK_OK(adaptor.ReadTable(&table));
+  }
+  // with strings to be quoted, and nulls, which are written as empty fields
+  // and thus read back as empty strings
+  arrow::StringBuilder builder, expected_builder;
+  for (int64_t idx = 0; idx < row_num; ++idx) {
+    if (idx % 7 == 0) {
+      CHECK_ARROW_ERROR(builder.AppendNull());
+      CHECK_ARROW_ERROR(expected_builder.Append(""));
+    } else {
+      std::string name = idx % 3 == 0 ? "a,\"b\"" : std::to_string(idx);
+      CHECK_ARROW_ERROR(builder.Append(name));
+      CHECK_ARROW_ERROR(expected_builder.Append(name));
+    }
+  }
+  std::shared_ptr<arrow::Array> names, expected_names;
+  CHECK_ARROW_ERROR(builder.Finish(&names));
+  CHECK_ARROW_ERROR(expected_builder.Finish(&expected_names));
+  auto name_field = arrow::field("name", arrow::utf8());
+  std::shared_ptr<arrow::Table> expected;
+  CHECK_ARROW_ERROR_AND_ASSIGN(
+      expected,
+      table->AddColumn(2, name_field,
+                       std::make_shared<arrow::ChunkedArray>(expected_names)));
+  CHECK_ARROW_ERROR_AND_ASSIGN(
+      table, table->AddColumn(2, name_field,
+                              std::make_shared<arrow::ChunkedArray>(names)));
+
+  std::string output = path + ".out.csv";
+  {
+    LocalIOAdaptor adaptor(output + "#header_row=true");
+    VINEYARD_CHECK_OK(adaptor.Configure("write_concurrency", "4"));
+    VINEYARD_CHECK_OK(adaptor.Open("w"));
+    // in two tables, the header is written once
+    VINEYARD_CHECK_OK(adaptor.WriteTable(table->Slice(0, row_num / 3)));
+    VINEYARD_CHECK_OK(adaptor.WriteTable(table->Slice(row_num / 3)));
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+
+  std::shared_ptr<arrow::Table> result;
+  {
+    LocalIOAdaptor adaptor(output + "#header_row=true");
+    VINEYARD_CHECK_OK(adaptor.SetPartialRead(0, 1));
+    VINEYARD_CHECK_OK(adaptor.Open());
+    VINEYARD_CHECK_OK(adaptor.ReadTable(&result));
+  }
+  CHECK_EQ(result->num_rows(), row_num);
+  CHECK(result->schema()->Equals(expected->schema()));
+  CHECK(result->Equals(*expected));
+
+  // tab-separated, as written by the local consumers of dataframe streams
+  std::string tsv = path + ".out.tsv";
+  {
+    LocalIOAdaptor adaptor(tsv + "#delimiter=\\t");
+    VINEYARD_CHECK_OK(adaptor.Open("w"));
+    VINEYARD_CHECK_OK(adaptor.WriteTable(table));
+    VINEYARD_CHECK_OK(adaptor.Close());
+  }
+  std::string content = ReadFile(tsv);
+  CHECK_EQ(std::count(content.begin(), content.end(), '\n'), row_num);
+  CHECK_EQ(std::count(content.begin(), content.end(), '\t'),
+           row_num * (table->num_columns() - 1));
+  {
+    LocalIOAdaptor adaptor(tsv + "#delimiter=\\t");
+    VINEYARD_CHECK_OK(adaptor.SetPartialRead(0, 1));
+    VINEYARD_CHECK_OK(adaptor.Open());
+    VINEYARD_CHECK_OK(adaptor.ReadTable(&result));
+  }
+  CHECK_EQ(result->num_rows(), row_num);
+  CHECK_EQ(result->num_columns(), table->num_columns());
+
+  LOG(INFO) << "Passed write table tests";
+}
+
+int main(int argc, char** argv) {
+  std::string path = MakeCSVFile();
+
+  TestPartialRead(path, "true");
+  TestPartialRead(path, "false");
+  TestStreamingRead(path);
+  TestWriteTable(path);
+
+  std::string bgzf = MakeBGZFFile(path);
+  std::string gzip = MakeCompressedFile(path, arrow::Compression::GZIP, ".gz");
+  std::string zstd = MakeCompressedFile(path, arrow::Compression::ZSTD, ".zst");
+  size_t size = ReadFile(path).size();
+  TestBlockDecompressor(path, bgzf, (size + 16383) / 16384);
+  TestBlockDecompressor(path, gzip, 0);
+  TestBlockDecompressor(path, zstd, (size + 65535) / 65536);
+
+  // split points are found on the decompressed content
+  for (auto const& compressed : {bgzf, gzip, zstd}) {
+    TestPartialRead(compressed, "true");
+    TestStreamingRead(compressed);
+  }
+
+  std::string directory = MakeCSVDirectory();
+  TestMultiFileRead(directory);
+  TestMultiFileRead(directory + "/part-*.csv*");
+  TestCompressedMultiFileRead(MakeCompressedDirectory() +
+                              "#compression=gzip");
+
+  LOG(INFO) << "Passed local io adaptor tests...";
+
+  return 0;
+}
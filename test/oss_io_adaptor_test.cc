@@ -0,0 +1,256 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "io/io/oss_io_adaptor.h"
+
+#ifdef OSS_ENABLED
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+constexpr int64_t line_num = 10000;
+constexpr int64_t chunk_size = 16384;
+
+// A stand-in of the OSS server, which serves the objects of a bucket, and
+// breaks the first response of every range halfway, thus every range is
+// retried once.
+class StandInServer {
+ public:
+  StandInServer(std::string const& bucket,
+                std::map<std::string, std::string> const& objects)
+      : bucket_(bucket), objects_(objects) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    CHECK_GE(listen_fd_, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    CHECK_EQ(bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), addr_len),
+             0);
+    CHECK_EQ(listen(listen_fd_, 64), 0);
+    CHECK_EQ(
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len),
+        0);
+    port_ = ntohs(addr.sin_port);
+    thread_ = std::thread([this]() {
+      while (true) {
+        int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+          return;
+        }
+        serve(fd);
+        close(fd);
+      }
+    });
+  }
+
+  ~StandInServer() {
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+    thread_.join();
+  }
+
+  int port() const { return port_; }
+
+  size_t failures() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return broken_.size();
+  }
+
+ private:
+  void serve(int fd) {
+    std::string request;
+    char buffer[4096];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+      ssize_t size = recv(fd, buffer, sizeof(buffer), 0);
+      if (size <= 0) {
+        return;
+      }
+      request.append(buffer, size);
+    }
+    std::string target = request.substr(request.find(' ') + 1);
+    target = target.substr(0, target.find(' '));
+
+    if (target.find("prefix=") != std::string::npos) {
+      std::string body =
+          "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+          "<ListBucketResult><Name>" +
+          bucket_ + "</Name><Prefix></Prefix><Marker></Marker>" +
+          "<MaxKeys>100</MaxKeys><Delimiter></Delimiter>" +
+          "<IsTruncated>false</IsTruncated>";
+      for (auto const& object : objects_) {
+        body += "<Contents><Key>" + object.first +
+                "</Key><LastModified>2020-01-01T00:00:00.000Z</LastModified>" +
+                "<ETag>\"etag\"</ETag><Type>Normal</Type><Size>" +
+                std::to_string(object.second.size()) +
+                "</Size><StorageClass>Standard</StorageClass></Contents>";
+      }
+      body += "</ListBucketResult>";
+      respond(fd, "200 OK", "Content-Type: application/xml\r\n", body,
+              body.size());
+      return;
+    }
+
+    // "/<bucket>/<key>", as the endpoint is an ip
+    std::string key = target.substr(0, target.find('?'));
+    key = key.substr(bucket_.size() + 2);
+    auto object = objects_.find(key);
+    CHECK(object != objects_.end()) << "Unknown object: " << key;
+    std::string const& content = object->second;
+
+    // "Range: bytes=<begin>-<end>", the end is inclusive
+    size_t pos = request.find("bytes=");
+    CHECK_NE(pos, std::string::npos) << "Expect ranged downloads";
+    size_t begin = std::stoul(request.substr(pos + 6));
+    size_t end = std::stoul(request.substr(request.find('-', pos) + 1)) + 1;
+    end = std::min(end, content.size());
+    std::string body = content.substr(begin, end - begin);
+    std::string headers = "Content-Range: bytes " + std::to_string(begin) +
+                          "-" + std::to_string(end - 1) + "/" +
+                          std::to_string(content.size()) + "\r\n";
+    bool broken = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      broken = broken_.insert(std::make_pair(key, begin)).second;
+    }
+    // the client gets a partial response, and retries
+    respond(fd, "206 Partial Content", headers, body,
+            broken ? body.size() / 2 : body.size());
+  }
+
+  void respond(int fd, std::string const& status, std::string const& headers,
+               std::string const& body, size_t const sent) {
+    std::string response = "HTTP/1.1 " + status +
+                           "\r\nx-oss-request-id: stand-in\r\n" + headers +
+                           "Content-Length: " + std::to_string(body.size()) +
+                           "\r\nConnection: close\r\n\r\n" +
+                           body.substr(0, sent);
+    size_t offset = 0;
+    while (offset < response.size()) {
+      ssize_t size = send(fd, response.data() + offset,
+                          response.size() - offset, MSG_NOSIGNAL);
+      if (size <= 0) {
+        return;
+      }
+      offset += size;
+    }
+  }
+
+  std::string bucket_;
+  std::map<std::string, std::string> objects_;
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::thread thread_;
+  std::mutex mutex_;
+  // the ranges whose first response is broken
+  std::set<std::pair<std::string, size_t>> broken_;
+};
+
+std::string MakeContent(int64_t const begin, int64_t const end) {
+  std::string content;
+  for (int64_t idx = begin; idx < end; ++idx) {
+    content += "line-" + std::to_string(idx) + "\n";
+  }
+  return content;
+}
+
+std::string ReadAll(OSSIOAdaptor& adaptor) {
+  VINEYARD_CHECK_OK(adaptor.Configure("chunk_size",
+                                      std::to_string(chunk_size)));
+  VINEYARD_CHECK_OK(adaptor.Open());
+  std::string line, lines;
+  while (adaptor.ReadLine(line).ok()) {
+    lines += line + "\n";
+  }
+  VINEYARD_CHECK_OK(adaptor.Close());
+  return lines;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage ./oss_io_adaptor_test <ipc_socket>");
+    return 1;
+  }
+
+  std::string content = MakeContent(0, line_num);
+  StandInServer server("bucket", {{"prefix/data.csv", content}});
+
+  // an ip endpoint, thus the bucket is in the path rather than the host
+  FLAGS_oss_endpoint = "http://127.0.0.1:" + std::to_string(server.port());
+  FLAGS_oss_access_key_id = "id";
+  FLAGS_oss_access_key_secret = "secret";
+  OSSIOAdaptor::Init();
+  {
+    OSSIOAdaptor adaptor("oss:///bucket/prefix");
+    std::string lines = ReadAll(adaptor);
+
+    // every range has been retried, and the retries start over
+    CHECK_EQ(server.failures(),
+             (content.size() + chunk_size - 1) / chunk_size);
+    CHECK(lines == content) << "The retried downloads are corrupted";
+  }
+
+  // the objects of unequal sizes are split by their own sizes in partial reads
+  {
+    std::vector<std::string> contents{MakeContent(0, 1000),
+                                      MakeContent(1000, 11000),
+                                      MakeContent(11000, 14000)};
+    StandInServer parts_server("bucket", {{"parts/part-0.csv", contents[0]},
+                                          {"parts/part-1.csv", contents[1]},
+                                          {"parts/part-2.csv", contents[2]}});
+    FLAGS_oss_endpoint =
+        "http://127.0.0.1:" + std::to_string(parts_server.port());
+
+    OSSIOAdaptor first("oss:///bucket/parts");
+    VINEYARD_CHECK_OK(first.SetPartialRead(0, 2));
+    CHECK(ReadAll(first) == contents[0] + contents[2]);
+
+    OSSIOAdaptor second("oss:///bucket/parts");
+    VINEYARD_CHECK_OK(second.SetPartialRead(1, 2));
+    CHECK(ReadAll(second) == contents[1])
+        << "The object is read by the size of another object";
+  }
+  OSSIOAdaptor::Finalize();
+
+  LOG(INFO) << "Passed oss io adaptor tests...";
+  return 0;
+}
+
+#else
+
+int main(int argc, char** argv) {
+  LOG(INFO) << "Skipped oss io adaptor tests, oss is not enabled";
+  return 0;
+}
+
+#endif  // OSS_ENABLED
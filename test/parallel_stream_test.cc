@@ -0,0 +1,334 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <unistd.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/status.h"
+#include "arrow/util/io_util.h"
+#include "arrow/util/logging.h"
+#include "glog/logging.h"
+
+#include "basic/ds/arrow_utils.h"
+#include "basic/stream/byte_stream.h"
+#include "basic/stream/dataframe_stream.h"
+#include "basic/stream/parallel_stream.h"
+#include "client/client.h"
+#include "client/ds/object_meta.h"
+
+using namespace vineyard;  // NOLINT(build/namespaces)
+
+constexpr size_t stream_num = 3;
+constexpr size_t chunk_num = 16;
+constexpr size_t reader_num = 4;
+
+ObjectID MakeParallelStream(Client& client) {
+  ParallelStreamBuilder<ByteStream> builder(client);
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    ByteStreamBuilder stream_builder(client);
+    stream_builder.SetParams(std::unordered_map<std::string, std::string>{
+        {"kind", "test"}, {"test_name", "parallel_stream_test"}});
+    builder.AddStream(stream_builder.Seal(client)->id());
+  }
+  return builder.Seal(client)->id();
+}
+
+// every chunk carries the index of its sub-stream and its sequence.
+void Produce(std::string const& ipc_socket, ObjectID const stream_id,
+             size_t const index) {
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  auto pstream = std::dynamic_pointer_cast<ParallelStream<ByteStream>>(
+      client.GetObject(stream_id));
+  CHECK(pstream != nullptr);
+  auto writer = pstream->GetStream(index)->OpenWriter(client);
+  for (size_t seq = 0; seq < chunk_num; ++seq) {
+    std::unique_ptr<arrow::MutableBuffer> buffer = nullptr;
+    VINEYARD_CHECK_OK(writer->GetNext(2 * sizeof(size_t), buffer));
+    auto data = reinterpret_cast<size_t*>(buffer->mutable_data());
+    data[0] = index;
+    data[1] = seq;
+    if (index == 0) {
+      // a skewed producer
+      usleep(50 * 1000);
+    }
+  }
+  VINEYARD_CHECK_OK(writer->Finish());
+}
+
+void TestWorkStealing(Client& client, std::string const& ipc_socket,
+                      bool const ordered) {
+  ObjectID stream_id = MakeParallelStream(client);
+
+  std::vector<std::thread> producers;
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    producers.emplace_back(Produce, ipc_socket, stream_id, idx);
+  }
+
+  auto pstream = std::dynamic_pointer_cast<ParallelStream<ByteStream>>(
+      client.GetObject(stream_id));
+  auto reader = pstream->OpenReader(client, ordered);
+
+  std::vector<std::atomic<size_t>> received(stream_num), inflight(stream_num);
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    received[idx] = 0;
+    inflight[idx] = 0;
+  }
+  // claimed[stream][reader]
+  std::vector<std::vector<size_t>> claimed(
+      stream_num, std::vector<size_t>(reader_num, 0));
+  std::vector<size_t> claimed_by_reader(reader_num, 0);
+  std::vector<std::thread> readers;
+  for (size_t ridx = 0; ridx < reader_num; ++ridx) {
+    readers.emplace_back([&, ridx]() {
+      ParallelStreamReader<ByteStream>::Claim claim;
+      while (true) {
+        if (claim.stream_index != ParallelStreamReader<ByteStream>::npos) {
+          inflight[claim.stream_index] -= 1;
+        }
+        auto status = reader->ReadNext(claim);
+        if (status.IsEndOfFile()) {
+          break;
+        }
+        VINEYARD_CHECK_OK(status);
+        auto data = reinterpret_cast<const size_t*>(claim.item->data());
+        CHECK_EQ(data[0], claim.stream_index);
+        CHECK_EQ(data[1], claim.sequence);
+        size_t concurrent = (inflight[claim.stream_index] += 1);
+        if (ordered) {
+          CHECK_EQ(concurrent, 1);
+        }
+        received[claim.stream_index] += 1;
+        claimed[claim.stream_index][ridx] += 1;
+        claimed_by_reader[ridx] += 1;
+        // the first reader is a slow one
+        usleep((ridx == 0 ? 40 : 5) * 1000);
+      }
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  for (auto& reader_thrd : readers) {
+    reader_thrd.join();
+  }
+
+  size_t total = 0;
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    CHECK_EQ(received[idx], chunk_num);
+  }
+  for (size_t ridx = 0; ridx < reader_num; ++ridx) {
+    total += claimed_by_reader[ridx];
+  }
+  CHECK_EQ(total, stream_num * chunk_num);
+
+  // no sub-stream is bound to a reader, and the other readers take over the
+  // items the slow reader would otherwise hold back
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    size_t readers_of_stream = 0;
+    for (size_t ridx = 0; ridx < reader_num; ++ridx) {
+      readers_of_stream += claimed[idx][ridx] > 0 ? 1 : 0;
+    }
+    CHECK_GT(readers_of_stream, 1);
+  }
+  for (size_t ridx = 1; ridx < reader_num; ++ridx) {
+    CHECK_LT(claimed_by_reader[0], claimed_by_reader[ridx]);
+  }
+
+  LOG(INFO) << "Passed parallel stream tests with ordered = " << ordered;
+}
+
+// the producers keep writing until the stream fails
+void ProduceUntilFailed(std::string const& ipc_socket,
+                        ObjectID const stream_id, size_t const index,
+                        std::atomic<size_t>& failed) {
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  auto pstream = std::dynamic_pointer_cast<ParallelStream<ByteStream>>(
+      client.GetObject(stream_id));
+  auto writer = pstream->GetStream(index)->OpenWriter(client);
+  for (size_t seq = 0; seq < 1024 * chunk_num; ++seq) {
+    std::unique_ptr<arrow::MutableBuffer> buffer = nullptr;
+    if (!writer->GetNext(2 * sizeof(size_t), buffer).ok()) {
+      failed += 1;
+      return;
+    }
+    if (index == 0) {
+      usleep(50 * 1000);
+    }
+  }
+  VINEYARD_CHECK_OK(writer->Finish());
+}
+
+// a consumer that gives up early neither hangs nor blocks the producers
+void TestEarlyStop(Client& client, std::string const& ipc_socket) {
+  ObjectID stream_id = MakeParallelStream(client);
+
+  std::atomic<size_t> failed(0);
+  std::vector<std::thread> producers;
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    producers.emplace_back(ProduceUntilFailed, ipc_socket, stream_id, idx,
+                           std::ref(failed));
+  }
+
+  auto pstream = std::dynamic_pointer_cast<ParallelStream<ByteStream>>(
+      client.GetObject(stream_id));
+  {
+    auto reader = pstream->OpenReader(client);
+    ParallelStreamReader<ByteStream>::Claim claim;
+    for (size_t idx = 0; idx < chunk_num; ++idx) {
+      VINEYARD_CHECK_OK(reader->ReadNext(claim));
+    }
+    // the queues are full, and the slow sub-stream is being pulled
+    usleep(100 * 1000);
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  CHECK_EQ(failed, stream_num);
+
+  LOG(INFO) << "Passed parallel stream early stop tests";
+}
+
+ObjectID MakeParallelDataframeStream(Client& client) {
+  ParallelStreamBuilder<DataframeStream> builder(client);
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    DataframeStreamBuilder stream_builder(client);
+    stream_builder.SetParams(std::unordered_map<std::string, std::string>{
+        {"kind", "test"}, {"test_name", "parallel_stream_test"}});
+    builder.AddStream(stream_builder.Seal(client)->id());
+  }
+  return builder.Seal(client)->id();
+}
+
+// every batch carries the index of its sub-stream and its sequence in its
+// columns.
+void ProduceDataframe(std::string const& ipc_socket, ObjectID const stream_id,
+                      size_t const index) {
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  auto pstream = std::dynamic_pointer_cast<ParallelStream<DataframeStream>>(
+      client.GetObject(stream_id));
+  CHECK(pstream != nullptr);
+  auto writer = pstream->GetStream(index)->OpenWriter(client);
+  auto schema = arrow::schema({arrow::field("index", arrow::int64()),
+                               arrow::field("sequence", arrow::int64())});
+  for (size_t seq = 0; seq < chunk_num; ++seq) {
+    arrow::Int64Builder index_builder, seq_builder;
+    CHECK_ARROW_ERROR(index_builder.Append(index));
+    CHECK_ARROW_ERROR(seq_builder.Append(seq));
+    std::shared_ptr<arrow::Array> index_array, seq_array;
+    CHECK_ARROW_ERROR(index_builder.Finish(&index_array));
+    CHECK_ARROW_ERROR(seq_builder.Finish(&seq_array));
+    auto batch = arrow::RecordBatch::Make(schema, 1, {index_array, seq_array});
+    VINEYARD_CHECK_OK(writer->WriteBatch(batch));
+    if (index == 0) {
+      // a skewed producer
+      usleep(50 * 1000);
+    }
+  }
+  VINEYARD_CHECK_OK(writer->Finish());
+}
+
+void TestDataframeWorkStealing(Client& client, std::string const& ipc_socket) {
+  using batch_t = std::shared_ptr<arrow::RecordBatch>;
+  using reader_t = ParallelStreamReader<DataframeStream, batch_t>;
+
+  ObjectID stream_id = MakeParallelDataframeStream(client);
+
+  std::vector<std::thread> producers;
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    producers.emplace_back(ProduceDataframe, ipc_socket, stream_id, idx);
+  }
+
+  auto pstream = std::dynamic_pointer_cast<ParallelStream<DataframeStream>>(
+      client.GetObject(stream_id));
+  auto reader = pstream->OpenReader<batch_t>(client, true);
+
+  std::vector<std::atomic<size_t>> received(stream_num);
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    received[idx] = 0;
+  }
+  std::vector<std::thread> readers;
+  for (size_t ridx = 0; ridx < reader_num; ++ridx) {
+    readers.emplace_back([&]() {
+      reader_t::Claim claim;
+      while (true) {
+        auto status = reader->ReadNext(claim);
+        if (status.IsEndOfFile()) {
+          break;
+        }
+        VINEYARD_CHECK_OK(status);
+        auto const& batch = claim.item;
+        CHECK_EQ(batch->num_rows(), 1);
+        auto index =
+            std::dynamic_pointer_cast<arrow::Int64Array>(batch->column(0));
+        auto sequence =
+            std::dynamic_pointer_cast<arrow::Int64Array>(batch->column(1));
+        CHECK_EQ(index->Value(0), claim.stream_index);
+        CHECK_EQ(sequence->Value(0), claim.sequence);
+        // items of a sub-stream are processed in order
+        CHECK_EQ(received[claim.stream_index], claim.sequence);
+        received[claim.stream_index] += 1;
+        usleep(5 * 1000);
+      }
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  for (auto& reader_thrd : readers) {
+    reader_thrd.join();
+  }
+  for (size_t idx = 0; idx < stream_num; ++idx) {
+    CHECK_EQ(received[idx], chunk_num);
+  }
+
+  LOG(INFO) << "Passed parallel dataframe stream tests";
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage ./parallel_stream_test <ipc_socket>");
+    return 1;
+  }
+  std::string ipc_socket = std::string(argv[1]);
+
+  Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+  LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
+
+  TestWorkStealing(client, ipc_socket, false);
+  TestWorkStealing(client, ipc_socket, true);
+  TestDataframeWorkStealing(client, ipc_socket);
+  TestEarlyStop(client, ipc_socket);
+
+  LOG(INFO) << "Passed parallel stream tests...";
+
+  client.Disconnect();
+
+  return 0;
+}
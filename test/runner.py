@@ -190,15 +190,24 @@ def run_single_vineyardd_tests(etcd_endpoints):
                          default_ipc_socket=VINEYARD_CI_IPC_SOCKET) as (_, rpc_socket_port):
         run_test('array_test')
         run_test('arrow_data_structure_test')
+        run_test('arrow_ipc_io_adaptor_test')
+        run_test('columnar_io_adaptor_test')
+        run_test('csv_chunk_parser_test')
         run_test('dataframe_test')
+        run_test('dataframe_stream_test')
         run_test('delete_test')
         run_test('get_wait_test')
         run_test('get_object_test')
         run_test('hashmap_test')
         run_test('id_test')
+        run_test('io_pipeline_test')
+        run_test('kafka_io_adaptor_test')
         run_test('list_object_test')
+        run_test('local_io_adaptor_test')
         run_test('name_test')
+        run_test('oss_io_adaptor_test')
         run_test('pair_test')
+        run_test('parallel_stream_test')
         run_test('ptree_utils_test')
         run_test('rpc_delete_test', '127.0.0.1:%d' % rpc_socket_port)
         run_test('rpc_get_object_test', '127.0.0.1:%d' % rpc_socket_port)
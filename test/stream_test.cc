@@ -104,6 +104,32 @@ int main(int argc, char** argv) {
     CHECK_EQ(send_chunks_size[idx], recv_chunks_size[idx]);
   }
 
+  // when stream is compressed
+  {
+    ByteStreamBuilder builder(client);
+    builder.SetParams(std::unordered_map<std::string, std::string>{
+        {"kind", "test"},
+        {"test_name", "stream_test"},
+        {"compression", "lz4"}});
+    auto bstream = std::dynamic_pointer_cast<ByteStream>(builder.Seal(client));
+
+    auto writer = bstream->OpenWriter(client);
+    writer->SetBufferSizeLimit(1024);
+    std::unique_ptr<arrow::MutableBuffer> buffer = nullptr;
+    CHECK(writer->GetNext(1024, buffer).IsInvalid());
+    for (size_t idx = 0; idx < 1000; ++idx) {
+      VINEYARD_CHECK_OK(writer->WriteLine(std::to_string(idx) + "\n"));
+    }
+    VINEYARD_CHECK_OK(writer->Finish());
+
+    auto reader = bstream->OpenReader(client);
+    std::string line;
+    for (size_t idx = 0; idx < 1000; ++idx) {
+      VINEYARD_CHECK_OK(reader->ReadLine(line));
+      CHECK_EQ(line, std::to_string(idx));
+    }
+  }
+
   // when stream fail
   {
     ByteStreamBuilder builder(client);